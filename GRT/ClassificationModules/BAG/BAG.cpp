@@ -136,12 +136,13 @@ bool BAG::train_(ClassificationData &trainingData){
 
     //Train the ensemble
     for(UINT i=0; i<ensembleSize; i++){
-        ClassificationData boostedDataset = trainingData.getBootstrappedDataset();
+        //Get a bootstrapped dataset, this is a view of the training data so the samples are only copied by classifiers that need to modify them
+        ClassificationDataView boostedDataset( trainingData, trainingData.getBootstrappedIndexes() );
         
         trainingLog << "Training ensemble " << i+1 << ". Ensemble type: " << ensemble[i]->getClassType() << endl;
         
         //Train the classifier with the bootstrapped dataset
-        if( !ensemble[i]->train( boostedDataset ) ){
+        if( !ensemble[i]->train_( boostedDataset ) ){
             errorLog << "train_(ClassificationData &trainingData) - The classifier at ensemble index " << i << " failed training!" << endl;
             return false;
         }
@@ -19,6 +19,8 @@
  */
 
 #include "DTW.h"
+#include <cstring>
+#include <stdint.h>
 
 using namespace std;
 
@@ -27,6 +29,52 @@ namespace GRT{
 //Register the DTW module with the Classifier base class
 RegisterClassifierModule< DTW > DTW::registerModule("DTW");
 
+//The header and template table of the binary model file, see saveModelToBinaryFile for the layout of the file
+#define GRT_DTW_BINARY_FILE_FORMAT "GRT_DTW_Model_File_BIN"
+#define GRT_DTW_BINARY_FILE_VERSION 1
+#define GRT_DTW_BINARY_FILE_BYTE_ORDER_MARK 0x01020304
+#define GRT_DTW_BINARY_FILE_ALIGNMENT 64
+
+struct DTWBinaryModelHeader{
+    char fileFormat[24];                //GRT_DTW_BINARY_FILE_FORMAT, padded with zeros
+    uint32_t version;                   //GRT_DTW_BINARY_FILE_VERSION
+    uint32_t byteOrderMark;             //GRT_DTW_BINARY_FILE_BYTE_ORDER_MARK, written in the byte order of the machine that saved the file
+    uint32_t headerSize;                //sizeof(DTWBinaryModelHeader)
+    uint32_t templateHeaderSize;        //sizeof(DTWBinaryTemplateHeader)
+    uint32_t useScaling;
+    uint32_t numInputDimensions;
+    uint32_t numOutputDimensions;
+    uint32_t useNullRejection;
+    uint32_t classifierMode;
+    uint32_t numClasses;
+    uint32_t distanceMethod;
+    uint32_t useSmoothing;
+    uint32_t smoothingFactor;
+    uint32_t useZNormalisation;
+    uint32_t offsetUsingFirstSample;
+    uint32_t constrainWarpingPath;
+    uint32_t rejectionMode;
+    uint32_t numTemplates;
+    uint32_t averageTemplateLength;
+    uint32_t reserved;
+    double nullRejectionCoeff;
+    double radius;
+    uint64_t rangesOffset;              //The offset in bytes of the ranges (2 doubles per dimension), only used if useScaling is true
+    uint64_t templatesOffset;           //The offset in bytes of the template table
+    uint64_t fileSize;                  //The size of the file in bytes, used to check the file is complete
+};
+
+struct DTWBinaryTemplateHeader{
+    uint32_t classLabel;
+    uint32_t timeSeriesLength;
+    uint32_t averageTemplateLength;
+    uint32_t reserved;
+    double nullRejectionThreshold;
+    double trainingMu;
+    double trainingSigma;
+    uint64_t dataOffset;                //The offset in bytes of the timeseries, aligned to GRT_DTW_BINARY_FILE_ALIGNMENT
+};
+
 DTW::DTW(bool useScaling,bool useNullRejection,double nullRejectionCoeff,UINT rejectionMode,bool constrainWarpingPath,double radius,bool offsetUsingFirstSample,bool useSmoothing,UINT smoothingFactor,double nullRejectionLikelihoodThreshold)
 {
     this->useScaling=useScaling;
@@ -45,12 +93,20 @@ DTW::DTW(bool useScaling,bool useNullRejection,double nullRejectionCoeff,UINT re
 	useZNormalisation=false;
 	constrainZNorm=false;
     trimTrainingData = false;
+    useStreamingPrediction = false;
+    storeWarpingPaths = false;
+    useLowerBoundPruning = false;
+    useSinglePrecisionDistances = false;
+    useParallelPrediction = false;
+    useParallelTraining = true;
+    costBands.resize(1);
 
 	zNormConstrainThreshold=0.2;
 	trimThreshold = 0.1;
 	maximumTrimPercentage = 90;
 
 	numTemplates=0;
+    numStreamingSamples=0;
 	distanceMethod=EUCLIDEAN_DIST;
 
 	averageTemplateLength =0;
@@ -65,6 +121,7 @@ DTW::DTW(bool useScaling,bool useNullRejection,double nullRejectionCoeff,UINT re
 }
 
 DTW::DTW(const DTW &rhs){
+    costBands.resize(1);
     *this = rhs;
 }
 
@@ -80,12 +137,20 @@ DTW& DTW::operator=(const DTW &rhs){
         this->distanceMatrices = rhs.distanceMatrices;
         this->warpPaths = rhs.warpPaths;
         this->continuousInputDataBuffer = rhs.continuousInputDataBuffer;
+        this->streamingColumns = rhs.streamingColumns;
         this->numTemplates = rhs.numTemplates;
+        this->numStreamingSamples = rhs.numStreamingSamples;
         this->useSmoothing = rhs.useSmoothing;
         this->useZNormalisation = rhs.useZNormalisation;
         this->constrainZNorm = rhs.constrainZNorm;
         this->constrainWarpingPath = rhs.constrainWarpingPath;
         this->trimTrainingData = rhs.trimTrainingData;
+        this->useStreamingPrediction = rhs.useStreamingPrediction;
+        this->storeWarpingPaths = rhs.storeWarpingPaths;
+        this->useLowerBoundPruning = rhs.useLowerBoundPruning;
+        this->useSinglePrecisionDistances = rhs.useSinglePrecisionDistances;
+        this->useParallelPrediction = rhs.useParallelPrediction;
+        this->useParallelTraining = rhs.useParallelTraining;
         this->zNormConstrainThreshold = rhs.zNormConstrainThreshold;
         this->radius = rhs.radius;
         this->offsetUsingFirstSample = rhs.offsetUsingFirstSample;
@@ -114,12 +179,20 @@ bool DTW::deepCopyFrom(const Classifier *classifier){
         this->distanceMatrices = ptr->distanceMatrices;
         this->warpPaths = ptr->warpPaths;
         this->continuousInputDataBuffer = ptr->continuousInputDataBuffer;
+        this->streamingColumns = ptr->streamingColumns;
         this->numTemplates = ptr->numTemplates;
+        this->numStreamingSamples = ptr->numStreamingSamples;
         this->useSmoothing = ptr->useSmoothing;
         this->useZNormalisation = ptr->useZNormalisation;
         this->constrainZNorm = ptr->constrainZNorm;
         this->constrainWarpingPath = ptr->constrainWarpingPath;
         this->trimTrainingData = ptr->trimTrainingData;
+        this->useStreamingPrediction = ptr->useStreamingPrediction;
+        this->storeWarpingPaths = ptr->storeWarpingPaths;
+        this->useLowerBoundPruning = ptr->useLowerBoundPruning;
+        this->useSinglePrecisionDistances = ptr->useSinglePrecisionDistances;
+        this->useParallelPrediction = ptr->useParallelPrediction;
+        this->useParallelTraining = ptr->useParallelTraining;
         this->zNormConstrainThreshold = ptr->zNormConstrainThreshold;
         this->radius = ptr->radius;
         this->offsetUsingFirstSample = ptr->offsetUsingFirstSample;
@@ -168,6 +241,11 @@ bool DTW::train_(TimeSeriesClassificationData &labelledTrainingData){
         errorLog << "train_(TimeSeriesClassificationData &labelledTrainingData) - Can't train model as there are no samples in training data!" << endl;
         return false;
     }
+    
+    if( distanceMethod != ABSOLUTE_DIST && distanceMethod != EUCLIDEAN_DIST && distanceMethod != NORM_ABSOLUTE_DIST ){
+        errorLog << "train_(TimeSeriesClassificationData &labelledTrainingData) - Unknown distance method: " << distanceMethod << endl;
+        return false;
+    }
 
 	//Assign
     numClasses = labelledTrainingData.getNumClasses();
@@ -186,21 +264,16 @@ bool DTW::train_(TimeSeriesClassificationData &labelledTrainingData){
 	if( useScaling ) scaleData( trainingData );
 	if( useZNormalisation ) znormData( trainingData );
 
-	//For each class, run a one-to-one DTW and find the template the best describes the data
+	//Get the training examples for each class, and apply any smoothing or offset to each example once, so the distance between each pair
+	//of examples can be computed on any thread
+	vector< TimeSeriesClassificationData > classData( numTemplates );
+	vector< vector< MatrixDouble > > classExamples( numTemplates );
+	vector< MatrixDouble > classDistanceResults( numTemplates );
 	for(UINT k=0; k<numTemplates; k++){
         //Get the class label for the cth class
         UINT classLabel = trainingData.getClassTracker()[k].classLabel;
-        TimeSeriesClassificationData classData = trainingData.getClassData( classLabel );
-		UINT numExamples = classData.getNumSamples();
-		bestIndex = 0;
-
-        //Set the class label of this template
-        templatesBuffer[k].classLabel = classLabel;
-
-        //Set the kth class label
-        classLabels[k] = classLabel;
-        
-        trainingLog << "Training Template: " << k << " Class: " << classLabel << endl;
+        classData[k] = trainingData.getClassData( classLabel );
+		UINT numExamples = classData[k].getNumSamples();
 
 		//Check to make sure we actually have some training examples
 		if( numExamples < 1 ){
@@ -212,13 +285,49 @@ bool DTW::train_(TimeSeriesClassificationData &labelledTrainingData){
             errorLog << "train_(TimeSeriesClassificationData &labelledTrainingData) - Can not train model as there is only 1 example in class: " << classLabel << ". Turn off null rejection if you want to use DTW with only 1 training sample per class." << endl;
 			return false;
 		}
+        
+        if( numExamples > 1 ){
+            classExamples[k].resize( numExamples );
+            for(UINT m=0; m<numExamples; m++){
+                //Smooth the data if required
+                if( useSmoothing ) smoothData(classData[k][m].getData(),smoothingFactor,classExamples[k][m]);
+                else classExamples[k][m] = classData[k][m].getData();
+                
+                if( offsetUsingFirstSample ){
+                    offsetTimeseries(classExamples[k][m]);
+                }
+            }
+            classDistanceResults[k].resize(numExamples,numExamples);
+        }
+	}
+    
+    //Compute the distance between each pair of examples in each class, this is where most of the training time is spent
+    if( !computeClassTrainingDistances(classExamples,classDistanceResults) ){
+        errorLog << "train_(TimeSeriesClassificationData &labelledTrainingData) - Failed to compute the distances between the training examples!" << endl;
+        return false;
+    }
+
+	//For each class, use the one-to-one DTW distances to find the template the best describes the data
+	for(UINT k=0; k<numTemplates; k++){
+        //Get the class label for the cth class
+        UINT classLabel = trainingData.getClassTracker()[k].classLabel;
+		UINT numExamples = classData[k].getNumSamples();
+		bestIndex = 0;
+
+        //Set the class label of this template
+        templatesBuffer[k].classLabel = classLabel;
+
+        //Set the kth class label
+        classLabels[k] = classLabel;
+        
+        trainingLog << "Training Template: " << k << " Class: " << classLabel << endl;
 
 		if( numExamples == 1 ){//If we have just one training example then we have to use it as the template
             bestIndex = 0;
             nullRejectionThresholds[k] = 0.0;//TODO-We need a better way of calculating this!
 		}else{
             //Search for the best training example for this class
-			if( !train_NDDTW(classData,templatesBuffer[k],bestIndex) ){
+			if( !train_NDDTW(classData[k],classDistanceResults[k],templatesBuffer[k],bestIndex) ){
                 errorLog << "train_(LabelledTimeSeriesClassificationData &labelledTrainingData) - Failed to train template for class with label: " << classLabel << endl;
                 return false;
             }
@@ -230,11 +339,11 @@ bool DTW::train_(TimeSeriesClassificationData &labelledTrainingData){
 
 		switch (trainingMethod) {
 			case(0)://Standard Training
-				templatesBuffer[k].timeSeries = classData[bestIndex].getData();
+				templatesBuffer[k].timeSeries = classData[k][bestIndex].getData();
 				break;
 			case(1)://Training using Smoothing
 				//Smooth the data, reducing its size by a factor set by smoothFactor
-				smoothData(classData[ bestIndex ].getData(),smoothingFactor,templatesBuffer[k].timeSeries);
+				smoothData(classData[k][ bestIndex ].getData(),smoothingFactor,templatesBuffer[k].timeSeries);
 				break;
 			default:
 				cout<<"Can not train model: Unknown training method \n";
@@ -260,6 +369,8 @@ bool DTW::train_(TimeSeriesClassificationData &labelledTrainingData){
     //Resize the prediction results to make sure it is setup for realtime prediction
     continuousInputDataBuffer.clear();
     continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numInputDimensions,0));
+    resetStreamingSearch();
+    computeTemplateEnvelopes(averageTemplateLength);
     classLikelihoods.resize(numTemplates,DEFAULT_NULL_LIKELIHOOD_VALUE);
     classDistances.resize(numTemplates,0);
     predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
@@ -269,48 +380,23 @@ bool DTW::train_(TimeSeriesClassificationData &labelledTrainingData){
 	return true;
 }
 
-bool DTW::train_NDDTW(TimeSeriesClassificationData &trainingData,DTWTemplate &dtwTemplate,UINT &bestIndex){
+bool DTW::train_NDDTW(TimeSeriesClassificationData &trainingData,MatrixDouble &distanceResults,DTWTemplate &dtwTemplate,UINT &bestIndex){
 
    UINT numExamples = trainingData.getNumSamples();
    VectorDouble results(numExamples,0.0);
-   MatrixDouble distanceResults(numExamples,numExamples);
    dtwTemplate.averageTemplateLength = 0;
     
    for(UINT m=0; m<numExamples; m++){
        
-	   MatrixDouble templateA; //The m'th template
-	   MatrixDouble templateB; //The n'th template
 	   dtwTemplate.averageTemplateLength += trainingData[m].getLength();
 
-	   //Smooth the data if required
-	   if( useSmoothing ) smoothData(trainingData[m].getData(),smoothingFactor,templateA);
-	   else templateA = trainingData[m].getData();
-       
-       if( offsetUsingFirstSample ){
-           offsetTimeseries(templateA);
-       }
-
 	   for(UINT n=0; n<numExamples; n++){
 		if(m!=n){
-		    //Smooth the data if required
-		    if( useSmoothing ) smoothData(trainingData[n].getData(),smoothingFactor,templateB);
-		    else templateB = trainingData[n].getData();
-            
-            if( offsetUsingFirstSample ){
-                offsetTimeseries(templateB);
-            }
-
-			//Compute the distance between the two time series
-            MatrixDouble distanceMatrix(templateA.getNumRows(),templateB.getNumRows());
-            vector< IndexDist > warpPath;
-			double dist = computeDistance(templateA,templateB,distanceMatrix,warpPath);
-            
-            trainingLog << "Template: " << m << " Timeseries: " << n << " Dist: " << dist << endl;
+            trainingLog << "Template: " << m << " Timeseries: " << n << " Dist: " << distanceResults[m][n] << endl;
 
 			//Update the results values
-			distanceResults[m][n] = dist;
-			results[m] += dist;
-		}else distanceResults[m][n] = 0; //The distance is zero because the two timeseries are the same
+			results[m] += distanceResults[m][n];
+		}
 	   }
    }
 
@@ -352,6 +438,72 @@ bool DTW::train_NDDTW(TimeSeriesClassificationData &trainingData,DTWTemplate &dt
 	return true;
 }
 
+    
+bool DTW::computeClassTrainingDistances(vector< vector< MatrixDouble > > &classExamples,vector< MatrixDouble > &classDistanceResults){
+    
+    const UINT numClassesToTrain = (UINT)classExamples.size();
+    
+    if( !useParallelTraining || ThreadPool::getThreadPoolSize() <= 1 ){
+        DTWDistanceWarnings warnings;
+        bool result = true;
+        for(UINT k=0; k<numClassesToTrain && result; k++){
+            for(UINT m=0; m<classExamples[k].size() && result; m++){
+                result = computeTrainingDistances(classExamples[k],classDistanceResults[k],m,warnings);
+            }
+        }
+        logDistanceWarnings( warnings );
+        return result;
+    }
+    
+    if( threadPool.get() == NULL ) threadPool.reset( new ThreadPool( ThreadPool::getThreadPoolSize() ) );
+    
+    //Each row of the distance matrix of each class is a separate task, so all the classes are trained at the same time and the threads
+    //stay busy even if some classes have more examples than others.  Each task counts its own warnings, which are logged on this thread
+    UINT numTasks = 0;
+    for(UINT k=0; k<numClassesToTrain; k++) numTasks += (UINT)classExamples[k].size();
+    vector< DTWDistanceWarnings > taskWarnings( numTasks );
+    vector< std::future< bool > > trainingTasks;
+    for(UINT k=0; k<numClassesToTrain; k++){
+        for(UINT m=0; m<classExamples[k].size(); m++){
+            DTWDistanceWarnings &warnings = taskWarnings[ trainingTasks.size() ];
+            trainingTasks.push_back( threadPool->enqueue( &DTW::computeTrainingDistances, this, std::ref(classExamples[k]), std::ref(classDistanceResults[k]), m, std::ref(warnings) ) );
+        }
+    }
+    
+    bool result = true;
+    DTWDistanceWarnings warnings;
+    for(UINT t=0; t<trainingTasks.size(); t++){
+        if( !trainingTasks[t].get() ) result = false;
+        warnings += taskWarnings[t];
+    }
+    logDistanceWarnings( warnings );
+    
+    return result;
+}
+    
+bool DTW::computeTrainingDistances(vector< MatrixDouble > &examples,MatrixDouble &distanceResults,const UINT m,DTWDistanceWarnings &warnings){
+    
+    const UINT numExamples = (UINT)examples.size();
+    DTWCostBand costBand;
+    
+    //Without a warping window the cost matrix of the pair (n,m) is the transpose of the cost matrix of the pair (m,n), so both distances can be
+    //found from one cost matrix.  The warping window depends on which timeseries is the template, so with a window each pair is computed twice
+    const bool useSymmetry = !constrainWarpingPath;
+    
+    distanceResults[m][m] = 0; //The distance is zero because the two timeseries are the same
+    for(UINT n=useSymmetry ? m+1 : 0; n<numExamples; n++){
+        if( n == m ) continue;
+        if( useSymmetry ){
+            distanceResults[m][n] = computeDistance(examples[m],examples[n],NULL,NULL,costBand,&distanceResults[n][m]);
+        }else distanceResults[m][n] = computeDistance(examples[m],examples[n],NULL,NULL,costBand);
+    }
+    
+    //This can run on the thread pool, so the warnings are passed back to be logged by the calling thread
+    warnings += costBand.warnings;
+    
+    return true;
+}
+
 
 bool DTW::predict_(MatrixDouble &inputTimeSeries){
 
@@ -374,11 +526,14 @@ bool DTW::predict_(MatrixDouble &inputTimeSeries){
         errorLog << "predict_(MatrixDouble &inputTimeSeries) - The number of features in the model (" << numInputDimensions << ") do not match that of the input time series (" << inputTimeSeries.getNumCols() << ")" << endl;
         return false;
     }
+    
+    if( distanceMethod != ABSOLUTE_DIST && distanceMethod != EUCLIDEAN_DIST && distanceMethod != NORM_ABSOLUTE_DIST ){
+        errorLog << "predict_(MatrixDouble &inputTimeSeries) - Unknown distance method: " << distanceMethod << endl;
+        return false;
+    }
 
-	//Perform any preprocessing if requried
+	//Perform any preprocessing if requried, the processed timeseries are kept in member buffers so they are only allocated when the input size changes
     MatrixDouble *timeSeriesPtr = &inputTimeSeries;
-    MatrixDouble processedTimeSeries;
-    MatrixDouble tempMatrix;
 	if(useScaling){
         scaleData(*timeSeriesPtr,processedTimeSeries);
         timeSeriesPtr = &processedTimeSeries;
@@ -392,8 +547,8 @@ bool DTW::predict_(MatrixDouble &inputTimeSeries){
 
 	//Smooth the data if required
 	if( useSmoothing ){
-		smoothData(*timeSeriesPtr,smoothingFactor,tempMatrix);
-		timeSeriesPtr = &tempMatrix;
+		smoothData(*timeSeriesPtr,smoothingFactor,smoothedTimeSeries);
+		timeSeriesPtr = &smoothedTimeSeries;
 	}
     
     //Offset the timeseries if required
@@ -402,17 +557,112 @@ bool DTW::predict_(MatrixDouble &inputTimeSeries){
     }
 
 	//Make the prediction by finding the closest template
-    double sum = 0;
-    if( distanceMatrices.size() != numTemplates ) distanceMatrices.resize( numTemplates );
-    if( warpPaths.size() != numTemplates ) warpPaths.resize( numTemplates );
+    if( storeWarpingPaths ){
+        if( distanceMatrices.size() != numTemplates ) distanceMatrices.resize( numTemplates );
+        if( warpPaths.size() != numTemplates ) warpPaths.resize( numTemplates );
+    }else{
+        distanceMatrices.clear();
+        warpPaths.clear();
+    }
     
-	//Test the timeSeries against all the templates in the timeSeries buffer
-	for(UINT k=0; k<numTemplates; k++){
-		//Perform DTW
-		classDistances[k] = computeDistance(templatesBuffer[k].timeSeries,*timeSeriesPtr,distanceMatrices[k],warpPaths[k]);
+    //Lower bound pruning can only be used if the rejection does not depend on the likelihood of every template
+    const bool usePruning = useLowerBoundPruning && !useSinglePrecisionDistances && ( !useNullRejection || rejectionMode == TEMPLATE_THRESHOLDS );
+    
+    //Test the timeSeries against all the templates in the timeSeries buffer, splitting the templates across the thread pool if needed
+    UINT numThreads = 1;
+    if( useParallelPrediction ){
+        numThreads = ThreadPool::getThreadPoolSize();
+        if( numThreads > numTemplates ) numThreads = numTemplates;
+        if( numThreads == 0 ) numThreads = 1;
+    }
+    if( costBands.size() < numThreads ) costBands.resize( numThreads );
+    
+    if( numThreads == 1 ){
+        const bool result = computeTemplateDistances(*timeSeriesPtr,0,numTemplates,costBands[0],usePruning);
+        logDistanceWarnings( costBands[0].warnings );
+        if( !result ){
+            errorLog << "predict_(MatrixDouble &inputTimeSeries) - Failed to compute the template distances!" << endl;
+            return false;
+        }
+        return predictFromClassDistances(usePruning);
+    }
+    
+    if( threadPool.get() == NULL ) threadPool.reset( new ThreadPool( ThreadPool::getThreadPoolSize() ) );
+    
+    predictionTasks.clear();
+    for(UINT t=0; t<numThreads; t++){
+        const UINT start = (t*numTemplates)/numThreads;
+        const UINT end = ((t+1)*numTemplates)/numThreads;
+        predictionTasks.push_back( threadPool->enqueue( &DTW::computeTemplateDistances, this, std::ref(*timeSeriesPtr), start, end, std::ref(costBands[t]), usePruning ) );
+    }
+    
+    //Wait for all the templates to be tested before making the prediction, any problems found by the tasks are logged on this thread
+    bool result = true;
+    DTWDistanceWarnings warnings;
+    for(UINT t=0; t<predictionTasks.size(); t++){
+        if( !predictionTasks[t].get() ) result = false;
+        warnings += costBands[t].warnings;
+        costBands[t].warnings.clear();
+    }
+    predictionTasks.clear();
+    logDistanceWarnings( warnings );
+    
+    if( !result ){
+        errorLog << "predict_(MatrixDouble &inputTimeSeries) - Failed to compute the template distances!" << endl;
+        return false;
+    }
+
+    return predictFromClassDistances(usePruning);
+}
+
+bool DTW::computeTemplateDistances(MatrixDouble &timeSeries,const UINT start,const UINT end,DTWCostBand &costBand,const bool usePruning){
+    
+    //The nearest distance is local to this block of templates, so each block can be tested on its own thread
+    double nearestDistance = 0;
+    
+    for(UINT k=start; k<end; k++){
+        //Skip the full DTW search if this template can not be closer than the nearest template found so far
+        if( usePruning && k > start ){
+            const double lowerBound = computeLowerBound(templatesBuffer[k],timeSeries,nearestDistance,costBand);
+            if( lowerBound >= nearestDistance ){
+                classDistances[k] = lowerBound;
+                if( storeWarpingPaths ){
+                    distanceMatrices[k].clear();
+                    warpPaths[k].clear();
+                }
+                continue;
+            }
+        }
+        
+        //Perform DTW
+        if( storeWarpingPaths ) classDistances[k] = computeDistance(templatesBuffer[k].timeSeries,timeSeries,&distanceMatrices[k],&warpPaths[k],costBand);
+        else classDistances[k] = computeDistance(templatesBuffer[k].timeSeries,timeSeries,NULL,NULL,costBand);
+        
+        if( k == start || classDistances[k] < nearestDistance ) nearestDistance = classDistances[k];
+    }
+    
+    return true;
+}
+
+void DTW::logDistanceWarnings(DTWDistanceWarnings &warnings){
+    
+    if( warnings.numInvalidDistances > 0 ){
+        warningLog << "computeDistance(...) - Distance Matrix Values are INF for " << warnings.numInvalidDistances << " distances!" << endl;
+    }
+    if( warnings.numWarpPathFailures > 0 ){
+        warningLog << "computeDistance(...) - Could not compute a warping path for " << warnings.numWarpPathFailures << " distances!" << endl;
+    }
+    warnings.clear();
+}
+
+bool DTW::predictFromClassDistances(const bool usePruning){
+
+    //Compute the class likelihoods from the distance to each template
+    double sum = 0;
+    for(UINT k=0; k<numTemplates; k++){
         classLikelihoods[k] = 1.0 / classDistances[k];
         sum += classLikelihoods[k];
-	}
+    }
 
 	//See which gave the min distance
 	UINT closestTemplateIndex = 0;
@@ -427,7 +677,11 @@ bool DTW::predict_(MatrixDouble &inputTimeSeries){
     //Normalize the class likelihoods and check which class has the maximum likelihood
     UINT maxLikelihoodIndex = 0;
     maxLikelihood = 0;
-    if( sum > 0 ){
+    if( usePruning ){
+        //The distances of the templates that were skipped are only lower bounds, so the likelihoods can not be computed
+        std::fill(classLikelihoods.begin(),classLikelihoods.end(),DEFAULT_NULL_LIKELIHOOD_VALUE);
+        maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
+    }else if( sum > 0 ){
         for(UINT k=0; k<numTemplates; k++){
             classLikelihoods[k] /= sum;
             if( classLikelihoods[k] > maxLikelihood ){
@@ -454,7 +708,7 @@ bool DTW::predict_(MatrixDouble &inputTimeSeries){
                 else predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
                 break;
             default:
-                errorLog << "predict_(MatrixDouble &timeSeries) - Unknown RejectionMode!" << endl;
+                errorLog << "predictFromClassDistances(const bool usePruning) - Unknown RejectionMode!" << endl;
                 return false;
                 break;
         }
@@ -480,6 +734,11 @@ bool DTW::predict_(VectorDouble &inputVector){
         return false;
     }
 
+    //Update the streaming search with the new input if needed
+    if( useStreamingPrediction ){
+        return predictStreaming_( inputVector );
+    }
+
     //Add the new input to the circular buffer
     continuousInputDataBuffer.push_back( inputVector );
 
@@ -488,10 +747,12 @@ bool DTW::predict_(VectorDouble &inputVector){
         return true;
     }
 
-    //Copy the data into a temporary matrix
+    //Copy the data into the prediction matrix, this is only resized if the buffer size has changed
     const UINT M = continuousInputDataBuffer.getSize();
     const UINT N = numInputDimensions;
-    MatrixDouble predictionTimeSeries(M,N);
+    if( predictionTimeSeries.getNumRows() != M || predictionTimeSeries.getNumCols() != N ){
+        predictionTimeSeries.resize(M,N);
+    }
     for(UINT i=0; i<M; i++){
         for(UINT j=0; j<N; j++){
             predictionTimeSeries[i][j] = continuousInputDataBuffer[i][j];
@@ -499,14 +760,180 @@ bool DTW::predict_(VectorDouble &inputVector){
     }
 
     //Run the prediction
-    return predict( predictionTimeSeries );
+    return predict_( predictionTimeSeries );
+
+}
+
+bool DTW::predictStreaming_(VectorDouble &inputVector){
+
+    if( !getStreamingPredictionSupported() ){
+        errorLog << "predictStreaming_(VectorDouble &inputVector) - The streaming search can not be used with z-normalization, smoothing or offsetUsingFirstSample!" << endl;
+        return false;
+    }
+
+    if( distanceMethod != ABSOLUTE_DIST && distanceMethod != EUCLIDEAN_DIST && distanceMethod != NORM_ABSOLUTE_DIST ){
+        errorLog << "predictStreaming_(VectorDouble &inputVector) - Unknown distance method: " << distanceMethod << endl;
+        return false;
+    }
+
+    //Make sure the cost columns match the current templates
+    if( streamingColumns.size() != numTemplates ) resetStreamingSearch();
+
+    //Scale the input vector if needed
+    if( useScaling ){
+        for(UINT j=0; j<numInputDimensions; j++){
+            inputVector[j] = scale(inputVector[j],ranges[j].minValue,ranges[j].maxValue,0.0,1.0);
+        }
+    }
+
+    //Update the cumulative cost column of each template with the new sample. The column holds the last column of a DTW cost matrix
+    //between the template and the input stream, where a new warping path can start at any sample in the stream
+    const UINT C = numInputDimensions;
+    const UINT metric = distanceMethod == EUCLIDEAN_DIST ? DistanceKernels::SQUARED_DISTANCE : DistanceKernels::ABSOLUTE_DISTANCE;
+    const double maxCost = numeric_limits<double>::max();
+    for(UINT k=0; k<numTemplates; k++){
+        DTWStreamingColumn &column = streamingColumns[k];
+        const UINT M = templatesBuffer[k].timeSeries.getNumRows();
+        if( M == 0 ) continue;
+
+        //Compute the distance between the new sample and every template sample at once
+        DistanceKernels::computeDistances(metric,&inputVector[0],&column.templateColumns[0],M,C,0,M-1,&column.localDistances[0]);
+        convertKernelDistances(&column.localDistances[0],M,averageTemplateLength);
+
+        //The diagonal values hold the previous column values for the template sample before the current one
+        double diagCost = maxCost;
+        double diagPathCost = 0;
+        UINT diagPathLength = 0;
+        UINT diagMatchLength = 0;
+        for(UINT i=0; i<M; i++){
+            const double localDist = column.localDistances[i];
+            const double leftCost = column.cost[i];
+            const double leftPathCost = column.pathCost[i];
+            const UINT leftPathLength = column.pathLength[i];
+            const UINT leftMatchLength = column.matchLength[i];
+            const UINT minMatchLength = column.minMatchLength[i];
+            const UINT maxMatchLength = column.maxMatchLength[i];
+
+            //Find the minimum cell to move from, using the same order as the warping path search in computeDistance. A cell can only be
+            //used if the warping path through it spans a number of input samples inside the warping window of this template sample
+            double minCost = maxCost;
+            double minPathCost = 0;
+            UINT minPathLength = 0;
+            UINT minMatch = 0;
+            if( i == 0 ){
+                //Any sample in the input stream can be the start of a match, so the first template sample starts a new warping path if it can
+                if( minMatchLength <= 1 && maxMatchLength >= 1 ){
+                    minCost = 0;
+                    minMatch = 1;
+                }else if( leftCost < maxCost && leftMatchLength+1 >= minMatchLength && leftMatchLength+1 <= maxMatchLength ){
+                    minCost = leftCost; minPathCost = leftPathCost; minPathLength = leftPathLength; minMatch = leftMatchLength+1;
+                }
+            }else{
+                const UINT upMatchLength = column.matchLength[i-1];
+                if( column.cost[i-1] < maxCost && upMatchLength >= minMatchLength && upMatchLength <= maxMatchLength ){
+                    minCost = column.cost[i-1]; minPathCost = column.pathCost[i-1]; minPathLength = column.pathLength[i-1]; minMatch = upMatchLength;
+                }
+                if( leftCost < minCost && leftMatchLength+1 >= minMatchLength && leftMatchLength+1 <= maxMatchLength ){
+                    minCost = leftCost; minPathCost = leftPathCost; minPathLength = leftPathLength; minMatch = leftMatchLength+1;
+                }
+                if( diagCost < maxCost && diagCost <= minCost && diagMatchLength+1 >= minMatchLength && diagMatchLength+1 <= maxMatchLength ){
+                    minCost = diagCost; minPathCost = diagPathCost; minPathLength = diagPathLength; minMatch = diagMatchLength+1;
+                }
+            }
+
+            if( minMatch > 0 ){
+                column.cost[i] = localDist + minCost;
+                column.pathCost[i] = minPathCost + column.cost[i];
+                column.pathLength[i] = minPathLength + 1;
+                column.matchLength[i] = minMatch;
+            }else{
+                //No warping path can reach this cell
+                column.cost[i] = maxCost;
+                column.pathCost[i] = 0;
+                column.pathLength[i] = 0;
+                column.matchLength[i] = 0;
+            }
+
+            diagCost = leftCost;
+            diagPathCost = leftPathCost;
+            diagPathLength = leftPathLength;
+            diagMatchLength = leftMatchLength;
+        }
+    }
+
+    if( numStreamingSamples < averageTemplateLength ) numStreamingSamples++;
+    if( numStreamingSamples < averageTemplateLength ){
+        //We haven't got enough samples yet so can't do the prediction
+        return true;
+    }
+
+    if( classLikelihoods.size() != numTemplates ) classLikelihoods.resize(numTemplates);
+    if( classDistances.size() != numTemplates ) classDistances.resize(numTemplates);
+
+    //The distance to each template is the mean cost along the best warping path that ends at the last sample of the template
+    for(UINT k=0; k<numTemplates; k++){
+        const DTWStreamingColumn &column = streamingColumns[k];
+        const UINT M = (UINT)column.cost.size();
+        if( M == 0 || column.pathLength[M-1] == 0 ) classDistances[k] = INFINITY;
+        else classDistances[k] = column.pathCost[M-1] / column.pathLength[M-1];
+    }
+
+    return predictFromClassDistances(false);
+}
 
+bool DTW::resetStreamingSearch(){
+
+    //A match must span about the same number of input samples as the input window of the standard search
+    const UINT N = averageTemplateLength;
+    const UINT lengthRadius = UINT( ceil( N*radius ) );
+    const UINT minLength = lengthRadius < N ? N - lengthRadius : 1;
+    const UINT maxLength = N + lengthRadius > 0 ? N + lengthRadius : 1;
+
+    streamingColumns.resize( numTemplates );
+    for(UINT k=0; k<numTemplates; k++){
+        const MatrixDouble &timeSeries = templatesBuffer[k].timeSeries;
+        const UINT M = timeSeries.getNumRows();
+        const UINT C = timeSeries.getNumCols();
+        DTWStreamingColumn &column = streamingColumns[k];
+
+        column.templateColumns.resize( M*C );
+        for(UINT i=0; i<M; i++){
+            for(UINT j=0; j<C; j++){
+                column.templateColumns[j*M+i] = timeSeries[i][j];
+            }
+        }
+        column.localDistances.resize( M );
+        column.cost.assign( M, numeric_limits<double>::max() );
+        column.pathCost.assign( M, 0 );
+        column.pathLength.assign( M, 0 );
+        column.matchLength.assign( M, 0 );
+        column.minMatchLength.assign( M, 1 );
+        column.maxMatchLength.assign( M, maxLength );
+        if( M > 1 ) column.minMatchLength[M-1] = minLength;
+
+        //Apply the warping window of the standard search, relative to the start of the match
+        if( constrainWarpingPath && M > 1 && N > 0 ){
+            const double r = ceil( min(M,N)*radius );
+            for(UINT i=0; i<M; i++){
+                const double center = -getWarpingWindowOffset(i,0,M,N);
+                const double start = max( 0.0, ceil( center-r ) );
+                const double end = floor( center+r );
+                column.minMatchLength[i] = max( column.minMatchLength[i], UINT(start)+1 );
+                if( end < 0 ) column.maxMatchLength[i] = 0;
+                else column.maxMatchLength[i] = min( column.maxMatchLength[i], UINT(end)+1 );
+            }
+        }
+    }
+    numStreamingSamples = 0;
+
+    return true;
 }
 
 bool DTW::reset(){
     continuousInputDataBuffer.clear();
     if( trained ){
         continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numInputDimensions,0));
+        resetStreamingSearch();
         recomputeNullRejectionThresholds();
     }
     return true;
@@ -522,6 +949,8 @@ bool DTW::clear(){
     distanceMatrices.clear();
     warpPaths.clear();
     continuousInputDataBuffer.clear();
+    streamingColumns.clear();
+    numStreamingSamples = 0;
     
     return true;
 }
@@ -550,6 +979,10 @@ bool DTW::setModels( vector< DTWTemplate > newTemplates ){
 		for(UINT i=0; i<templatesBuffer.size(); i++){
 			classLabels[i] = templatesBuffer[i].classLabel;
 		}
+        if( trained ){
+            resetStreamingSearch();
+            computeTemplateEnvelopes(averageTemplateLength);
+        }
 		return true;
 	}
 	return false;
@@ -557,81 +990,153 @@ bool DTW::setModels( vector< DTWTemplate > newTemplates ){
 
 ////////////////////////// computeDistance ///////////////////////////////////////////
 
-double DTW::computeDistance(MatrixDouble &timeSeriesA,MatrixDouble &timeSeriesB,MatrixDouble &distanceMatrix,vector< IndexDist > &warpPath){
+double DTW::computeDistance(MatrixDouble &timeSeriesA,MatrixDouble &timeSeriesB,MatrixDouble *distanceMatrix,vector< IndexDist > *warpPath,DTWCostBand &costBand,double *transposedDistance){
 
 	const int M = timeSeriesA.getNumRows();
 	const int N = timeSeriesB.getNumRows();
-	const int C = timeSeriesA.getNumCols();
-	int i,j,k,index = 0;
-	double totalDist,v,normFactor = 0.;
+	int i,j,index = 0;
+    
+    if( warpPath != NULL ) warpPath->clear();
+
+    //The distance method is checked before any distances are computed, as this can run on the thread pool where nothing can be logged
+    if( distanceMethod != ABSOLUTE_DIST && distanceMethod != EUCLIDEAN_DIST && distanceMethod != NORM_ABSOLUTE_DIST ){
+        return -1;
+    }
     
-    warpPath.clear();
-    if( int(distanceMatrix.getNumRows()) != M || int(distanceMatrix.getNumCols()) != N ){
-        distanceMatrix.resize(M, N);
+    //Find the cells in each row that are inside the warping window
+    const UINT numCells = computeWarpingWindow(M,N,costBand);
+    if( costBand.cost.size() < numCells ){
+        costBand.cost.resize( numCells );
+        costBand.reachable.resize( numCells );
     }
+    if( int(costBand.localDistances.size()) < N ) costBand.localDistances.resize( N );
+    
+    //Store the input timeseries column by column, so the distances to a whole row of the cost matrix can be computed at once
+    setDistanceKernelInput(timeSeriesB,costBand);
 
-	switch (distanceMethod) {
-		case (ABSOLUTE_DIST):
-			for(i=0; i<M; i++){
-				for(j=0; j<N; j++){
-					distanceMatrix[i][j] = 0.0;
-					for(k=0; k< C; k++){
-					   distanceMatrix[i][j] += fabs(timeSeriesA[i][k]-timeSeriesB[j][k]);
-					}
-				}
-			}
-			break;
-		case (EUCLIDEAN_DIST):
-			//Calculate Euclidean Distance for all possible values
-			for(i=0; i<M; i++){
-				for(j=0; j<N; j++){
-					distanceMatrix[i][j] = 0.0;
-					for(k=0; k< C; k++){
-						distanceMatrix[i][j] += SQR( timeSeriesA[i][k]-timeSeriesB[j][k] );
-					}
-					distanceMatrix[i][j] = sqrt( distanceMatrix[i][j] );
-				}
-			}
-			break;
-		case (NORM_ABSOLUTE_DIST):
-			for(i=0; i<M; i++){
-				for(j=0; j<N; j++){
-					distanceMatrix[i][j] = 0.0;
-					for(k=0; k< C; k++){
-					   distanceMatrix[i][j] += fabs(timeSeriesA[i][k]-timeSeriesB[j][k]);
-					}
-					distanceMatrix[i][j]/=N;
-				}
-			}
-			break;
-		default:
-			errorLog<<"ERROR: Unknown distance method: "<<distanceMethod<<endl;
-			return -1;
-			break;
-	}
+    //Build the cost matrix inside the warping window, the cells outside of the window are treated as unreachable
+    for(i=0; i<M; i++){
+        const int start = costBand.rowStart[i];
+        const int end = costBand.rowEnd[i];
+        const int prevStart = i > 0 ? costBand.rowStart[i-1] : 0;
+        const int prevEnd = i > 0 ? costBand.rowEnd[i-1] : -1;
+        double *cost = &costBand.cost[0] + costBand.rowOffset[i] - start;
+        const double *prevCost = i > 0 ? &costBand.cost[0] + costBand.rowOffset[i-1] - prevStart : NULL;
+        const double *localDistances = &costBand.localDistances[0] - start;
+        computeLocalDistances(timeSeriesA,i,start,end,N,&costBand.localDistances[0],costBand);
+        for(j=start; j<=end; j++){
+            const double localDist = localDistances[j];
+            if( grt_isnan( localDist ) ){
+                cost[j] = NAN;
+            }else if( i == 0 && j == 0 ){
+                cost[j] = localDist;
+            }else if( i == 0 ){
+                cost[j] = localDist + ( j-1 >= start ? cost[j-1] : NAN );
+            }else if( j == 0 ){
+                cost[j] = localDist + ( j >= prevStart && j <= prevEnd ? prevCost[j] : NAN );
+            }else{
+                //Find the minimum cell to move from, cells flagged as unreachable are ignored
+                const double contribDist1 = j-1 >= prevStart && j-1 <= prevEnd ? prevCost[j-1] : NAN;
+                const double contribDist2 = j >= prevStart && j <= prevEnd ? prevCost[j] : NAN;
+                const double contribDist3 = j-1 >= start ? cost[j-1] : NAN;
+                double minValue = numeric_limits<double>::max();
+                index = 0;
+                if( contribDist1 < minValue ){ minValue = contribDist1; index = 1; }
+                if( contribDist2 < minValue ){ minValue = contribDist2; index = 2; }
+                if( contribDist3 < minValue ){ minValue = contribDist3; index = 3; }
+                cost[j] = index != 0 ? localDist + minValue : 0;
+            }
+        }
+    }
 
-    //Run the recursive search function to build the cost matrix
-    double distance = sqrt( d(M-1,N-1,distanceMatrix,M,N) );
+    //Flag the cells that can be reached by searching back from the end of the cost matrix. Any cell outside of the warping window that is
+    //reached also flags the cells beyond it (in the direction away from the window) as unreachable
+    std::fill(costBand.reachable.begin(),costBand.reachable.begin()+numCells,0);
+    costBand.upperRejectedColumn.assign(M,N);
+    costBand.lowerRejectedColumn.assign(M,0);
+    costBand.reachable[ costBand.rowOffset[M-1] + (N-1-costBand.rowStart[M-1]) ] = 1;
+    for(i=M-1; i>=0; i--){
+        const int start = costBand.rowStart[i];
+        const int prevStart = i > 0 ? costBand.rowStart[i-1] : 0;
+        const int prevEnd = i > 0 ? costBand.rowEnd[i-1] : -1;
+        const double *cost = &costBand.cost[0] + costBand.rowOffset[i] - start;
+        char *reachable = &costBand.reachable[0] + costBand.rowOffset[i] - start;
+        char *prevReachable = i > 0 ? &costBand.reachable[0] + costBand.rowOffset[i-1] - prevStart : NULL;
+        for(j=costBand.rowEnd[i]; j>=start; j--){
+            if( !reachable[j] ) continue;
+            if( grt_isnan( cost[j] ) && grt_isnan( computeLocalDistance(timeSeriesA,i,j,N,costBand) ) ) continue;
+            if( i == 0 && j == 0 ) continue;
+            if( i > 0 ){
+                //Move up
+                if( j >= prevStart && j <= prevEnd ) prevReachable[j] = 1;
+                else flagRejectedCell(timeSeriesA,i-1,j,M,N,costBand);
+            }
+            if( i > 0 && j > 0 ){
+                //Move diagonally
+                if( j-1 >= prevStart && j-1 <= prevEnd ) prevReachable[j-1] = 1;
+                else flagRejectedCell(timeSeriesA,i-1,j-1,M,N,costBand);
+            }
+            if( j > 0 ){
+                //Move left
+                if( j-1 >= start ) reachable[j-1] = 1;
+                else flagRejectedCell(timeSeriesA,i,j-1,M,N,costBand);
+            }
+        }
+    }
+
+    //A cell above the window is unreachable if a cell in a later row at, or before, its column was reached.  A cell below the window is
+    //unreachable if a cell in the same or an earlier row after its column was reached
+    int rejectedColumn = N;
+    for(i=M-1; i>=0; i--){
+        const int rowColumn = costBand.upperRejectedColumn[i];
+        costBand.upperRejectedColumn[i] = rejectedColumn;
+        if( rowColumn < rejectedColumn ) rejectedColumn = rowColumn;
+    }
+    rejectedColumn = 0;
+    for(i=0; i<M; i++){
+        if( costBand.lowerRejectedColumn[i] > rejectedColumn ) rejectedColumn = costBand.lowerRejectedColumn[i];
+        costBand.lowerRejectedColumn[i] = rejectedColumn;
+    }
+
+    //Store the full cost matrix if needed
+    if( distanceMatrix != NULL ){
+        if( int(distanceMatrix->getNumRows()) != M || int(distanceMatrix->getNumCols()) != N ){
+            distanceMatrix->resize(M, N);
+        }
+        for(i=0; i<M; i++){
+            for(j=0; j<N; j++){
+                (*distanceMatrix)[i][j] = getCostMatrixValue(timeSeriesA,i,j,M,N,costBand);
+            }
+        }
+    }
+
+    double distance = sqrt( getBandCost(M-1,N-1,costBand) );
 
     if( grt_isinf(distance) || grt_isnan(distance) ){
-        warningLog << "DTW computeDistance(...) - Distance Matrix Values are INF!" << endl;
+        costBand.warnings.numInvalidDistances++;
+        if( transposedDistance != NULL ) *transposedDistance = INFINITY;
         return INFINITY;
     }
     
-    //cout << "DIST: " << distance << endl;
-
-    //The distMatrix values are negative so make them positive
-    for(i=0; i<M; i++){
-        for(j=0; j<N; j++){
-            distanceMatrix[i][j] = fabs( distanceMatrix[i][j] );
-        }
+    //The cost matrix is the same for both orders of the timeseries (apart from being transposed), only the warping path can differ
+    if( transposedDistance != NULL ){
+        *transposedDistance = computeWarpPathDistance(timeSeriesA,M,N,NULL,costBand,true);
     }
 
-	//Now Create the Warp Path through the cost matrix, starting at the end
+	return computeWarpPathDistance(timeSeriesA,M,N,warpPath,costBand,false);
+}
+
+double DTW::computeWarpPathDistance(MatrixDouble &timeSeriesA,const int M,const int N,vector< IndexDist > *warpPath,DTWCostBand &costBand,const bool transposed){
+    
+    int i,j,index = 0;
+    double totalDist,v,normFactor = 0.;
+    
+	//Now Create the Warp Path through the cost matrix, starting at the end.  If transposed is true then the path is the path that would be found
+    //if timeSeriesA and timeSeriesB were swapped, where moving up in the swapped cost matrix is moving left in this one
     i=M-1;
 	j=N-1;
-	totalDist = distanceMatrix[i][j];
-    warpPath.push_back( IndexDist(i,j,distanceMatrix[i][j]) );
+	totalDist = getCostMatrixValue(timeSeriesA,i,j,M,N,costBand);
+    if( warpPath != NULL ) warpPath->push_back( IndexDist(i,j,totalDist) );
     
 	//Use dynamic programming to navigate through the cost matrix until [0][0] has been reached
     normFactor = 1;
@@ -642,136 +1147,290 @@ double DTW::computeDistance(MatrixDouble &timeSeriesA,MatrixDouble &timeSeriesB,
             if( j==0 ) i--;
             else{
                 //Find the minimum cell to move to
+                const double upDist = getCostMatrixValue(timeSeriesA,i-1,j,M,N,costBand);
+                const double leftDist = getCostMatrixValue(timeSeriesA,i,j-1,M,N,costBand);
+                const double diagDist = getCostMatrixValue(timeSeriesA,i-1,j-1,M,N,costBand);
+                const double firstDist = transposed ? leftDist : upDist;
+                const double secondDist = transposed ? upDist : leftDist;
                 v = numeric_limits<double>::max();
                 index = 0;
-                if( distanceMatrix[i-1][j] < v ){ v = distanceMatrix[i-1][j]; index = 1; }
-                if( distanceMatrix[i][j-1] < v ){ v = distanceMatrix[i][j-1]; index = 2; }
-                if( distanceMatrix[i-1][j-1] <= v ){ index = 3; }
+                if( firstDist < v ){ v = firstDist; index = 1; }
+                if( secondDist < v ){ v = secondDist; index = 2; }
+                if( diagDist <= v ){ index = 3; }
                 switch(index){
                     case(1):
-                        i--;
+                        if( transposed ) j--;
+                        else i--;
                         break;
                     case(2):
-                        j--;
+                        if( transposed ) i--;
+                        else j--;
                         break;
                     case(3):
                         i--;
                         j--;
                         break;
                     default:
-                        warningLog << "DTW computeDistance(...) - Could not compute a warping path for the input matrix! Dist: " << distanceMatrix[i-1][j] << " i: " << i << " j: " << j << endl;
+                        //Could not compute a warping path for the input matrix
+                        costBand.warnings.numWarpPathFailures++;
                         return INFINITY;
                         break;
                 }
             }
         }
         normFactor++;
-		totalDist += distanceMatrix[i][j];
-		warpPath.push_back( IndexDist(i,j,distanceMatrix[i][j]) );
+        const double dist = getCostMatrixValue(timeSeriesA,i,j,M,N,costBand);
+		totalDist += dist;
+		if( warpPath != NULL ) warpPath->push_back( IndexDist(i,j,dist) );
 	}
 
 	return totalDist/normFactor;
 }
 
-double DTW::d(int m,int n,MatrixDouble &distanceMatrix,const int M,const int N){
-    double dist = 0;
-    //The following is based on Matlab code by Eamonn Keogh and Michael Pazzani
-    
-    //If this cell is NAN then it has already been flagged as unreachable
-    if( grt_isnan( distanceMatrix[m][n] ) ){
-        return NAN;
-    }
-
-    if( constrainWarpingPath ){
-        double r = ceil( min(M,N)*radius );
-        //Test to see if the current cell is outside of the warping window
-        if( fabs( n-((N-1)/((M-1)/double(m))) ) > r ){
-            if( n-((N-1)/((M-1)/double(m))) > 0 ){
-                for(int i=0; i<m; i++){
-                    for(int j=n; j<N; j++){
-                        distanceMatrix[i][j] = NAN;
-                    }
-                }
+UINT DTW::computeWarpingWindow(const int M,const int N,DTWCostBand &costBand){
+    
+    //Find the cells in each row that are inside the warping window, these are always contiguous
+    const double r = ceil( min(M,N)*radius );
+    UINT numCells = 0;
+    costBand.rowStart.resize(M);
+    costBand.rowEnd.resize(M);
+    costBand.rowOffset.resize(M);
+    for(int i=0; i<M; i++){
+        int start = 0;
+        int end = N-1;
+        const double center = -getWarpingWindowOffset(i,0,M,N);
+        if( constrainWarpingPath && !grt_isnan(center) ){
+            start = int( max( 0.0, ceil( center-r ) ) );
+            if( start > N-1 ) start = N-1;
+            while( start > 0 && !( fabs( (start-1)-center ) > r ) ) start--;
+            while( start < N-1 && fabs( start-center ) > r && start < center ) start++;
+            if( fabs( start-center ) > r ){
+                //There are no cells in this row inside the warping window
+                start = 0;
+                end = -1;
             }else{
-                for(int i=m; i<M; i++){
-                    for(int j=0; j<n; j++){
-                        distanceMatrix[i][j] = NAN;
-                    }
-                }
+                end = start;
+                while( end < N-1 && !( fabs( (end+1)-center ) > r ) ) end++;
             }
-            return NAN;
         }
+        costBand.rowStart[i] = start;
+        costBand.rowEnd[i] = end;
+        costBand.rowOffset[i] = numCells;
+        numCells += UINT(end-start+1);
     }
+    return numCells;
+}
 
-    //If this cell contains a negative value then it has already been searched
-    //The cost is therefore the absolute value of the negative value so return it
-    if( distanceMatrix[m][n] < 0 ){
-        dist = fabs( distanceMatrix[m][n] );
-        return dist;
+bool DTW::setDistanceKernelInput(MatrixDouble &timeSeries,DTWCostBand &costBand){
+    
+    const UINT N = timeSeries.getNumRows();
+    const UINT C = timeSeries.getNumCols();
+    
+    if( useSinglePrecisionDistances ){
+        costBand.inputColumnsFloat.resize(N*C);
+        for(UINT j=0; j<N; j++){
+            for(UINT k=0; k<C; k++){
+                costBand.inputColumnsFloat[k*N+j] = float( timeSeries[j][k] );
+            }
+        }
+        costBand.sampleFloat.resize(C);
+    }else{
+        costBand.inputColumns.resize(N*C);
+        for(UINT j=0; j<N; j++){
+            for(UINT k=0; k<C; k++){
+                costBand.inputColumns[k*N+j] = timeSeries[j][k];
+            }
+        }
     }
+    
+    return true;
+}
 
-    //Case 1: A warping path has reached the end
-    //Return the contribution of distance
-    //Negate the value, to record the fact that this cell has been visited
-    //End of recursion
-    if( m == 0 && n == 0 ){
-        dist = distanceMatrix[0][0];
-        distanceMatrix[0][0] = -distanceMatrix[0][0];
-        return dist;
+bool DTW::computeLocalDistances(MatrixDouble &timeSeriesA,const int m,const int start,const int end,const int N,double *distances,DTWCostBand &costBand){
+    
+    if( end < start ) return true;
+    
+    const UINT C = timeSeriesA.getNumCols();
+    const UINT metric = distanceMethod == EUCLIDEAN_DIST ? DistanceKernels::SQUARED_DISTANCE : DistanceKernels::ABSOLUTE_DISTANCE;
+    
+    if( useSinglePrecisionDistances ){
+        for(UINT k=0; k<C; k++) costBand.sampleFloat[k] = float( timeSeriesA[m][k] );
+        DistanceKernels::computeDistances(metric,C > 0 ? &costBand.sampleFloat[0] : NULL,C > 0 ? &costBand.inputColumnsFloat[0] : NULL,N,C,start,end,distances);
+    }else{
+        DistanceKernels::computeDistances(metric,timeSeriesA[m],C > 0 ? &costBand.inputColumns[0] : NULL,N,C,start,end,distances);
     }
+    
+    convertKernelDistances(distances,end-start+1,N);
+    
+    return true;
+}
 
-    //Case 2: we are somewhere in the top row of the matrix
-    //Only need to consider moving left
-    if( m == 0 ){
-        double contribDist = d(m,n-1,distanceMatrix,M,N);
+void DTW::convertKernelDistances(double *distances,const int numDistances,const int N){
+    
+    //The kernels compute the squared distance for EUCLIDEAN_DIST, and the absolute distance for the other methods
+    switch( distanceMethod ){
+        case (EUCLIDEAN_DIST):
+            for(int j=0; j<numDistances; j++) distances[j] = sqrt( distances[j] );
+            break;
+        case (NORM_ABSOLUTE_DIST):
+            for(int j=0; j<numDistances; j++) distances[j] /= N;
+            break;
+    }
+}
 
-        dist = distanceMatrix[m][n] + contribDist;
+inline double DTW::computeLocalDistance(MatrixDouble &timeSeriesA,const int m,const int n,const int N,DTWCostBand &costBand){
+    double dist = 0;
+    computeLocalDistances(timeSeriesA,m,n,n,N,&dist,costBand);
+    return dist;
+}
 
-        distanceMatrix[m][n] = -dist;
-        return dist;
-    }else{
-        //Case 3: we are somewhere in the left column of the matrix
-        //Only need to consider moving down
-        if ( n == 0) {
-            double contribDist = d(m-1,n,distanceMatrix,M,N);
-
-            dist = distanceMatrix[m][n] + contribDist;
-
-            distanceMatrix[m][n] = -dist;
-            return dist;
-        }else{
-            //Case 4: We are somewhere away from the edges so consider moving in the three main directions
-            double contribDist1 = d(m-1,n-1,distanceMatrix,M,N);
-            double contribDist2 = d(m-1,n,distanceMatrix,M,N);
-            double contribDist3 = d(m,n-1,distanceMatrix,M,N);
-            double minValue = numeric_limits<double>::max();
-            int index = 0;
-            if( contribDist1 < minValue ){ minValue = contribDist1; index = 1; }
-			if( contribDist2 < minValue ){ minValue = contribDist2; index = 2; }
-			if( contribDist3 < minValue ){ minValue = contribDist3; index = 3; }
-
-            switch ( index ) {
-                case 1:
-                    dist = distanceMatrix[m][n] + minValue;
-                    break;
-                case 2:
-                    dist = distanceMatrix[m][n] + minValue;
-                    break;
-                case 3:
-                    dist = distanceMatrix[m][n] + minValue;
-                    break;
-
-                default:
-                    break;
+inline double DTW::computeLocalDistance(const double *a,const double *b,const int C,const int N){
+    double dist = 0.0;
+    switch (distanceMethod) {
+		case (ABSOLUTE_DIST):
+            for(int k=0; k<C; k++){
+                dist += fabs(a[k]-b[k]);
+            }
+			break;
+		case (EUCLIDEAN_DIST):
+            for(int k=0; k<C; k++){
+                dist += SQR( a[k]-b[k] );
             }
+            dist = sqrt( dist );
+			break;
+		case (NORM_ABSOLUTE_DIST):
+            for(int k=0; k<C; k++){
+                dist += fabs(a[k]-b[k]);
+            }
+            dist/=N;
+			break;
+	}
+    return dist;
+}
+
+inline double DTW::getWarpingWindowOffset(const int m,const int n,const int M,const int N){
+    //The distance of the cell from the main diagonal of the cost matrix, this is NAN if the first timeseries only has one sample
+    return n-((N-1)/((M-1)/double(m)));
+}
+
+inline double DTW::getBandCost(const int m,const int n,DTWCostBand &costBand){
+    if( n < costBand.rowStart[m] || n > costBand.rowEnd[m] ) return NAN;
+    return costBand.cost[ costBand.rowOffset[m] + (n-costBand.rowStart[m]) ];
+}
+
+void DTW::flagRejectedCell(MatrixDouble &timeSeriesA,const int m,const int n,const int M,const int N,DTWCostBand &costBand){
+    
+    //The cell is outside of the warping window, cells that contain NAN are never searched
+    if( grt_isnan( computeLocalDistance(timeSeriesA,m,n,N,costBand) ) ) return;
+    if( getWarpingWindowOffset(m,n,M,N) > 0 ){
+        if( n < costBand.upperRejectedColumn[m] ) costBand.upperRejectedColumn[m] = n;
+    }else{
+        if( n > costBand.lowerRejectedColumn[m] ) costBand.lowerRejectedColumn[m] = n;
+    }
+}
 
-            distanceMatrix[m][n] = -dist; //Negate the value to record that it has been visited
-            return dist;
+double DTW::getCostMatrixValue(MatrixDouble &timeSeriesA,const int m,const int n,const int M,const int N,DTWCostBand &costBand){
+    if( n >= costBand.rowStart[m] && n <= costBand.rowEnd[m] ){
+        const UINT cell = costBand.rowOffset[m] + (n-costBand.rowStart[m]);
+        if( costBand.reachable[cell] ) return fabs( costBand.cost[cell] );
+    }else if( getWarpingWindowOffset(m,n,M,N) > 0 ){
+        if( n >= costBand.upperRejectedColumn[m] ) return NAN;
+    }else{
+        if( n < costBand.lowerRejectedColumn[m] ) return NAN;
+    }
+    
+    //Cells that were never searched contain the distance between the two samples
+    return computeLocalDistance(timeSeriesA,m,n,N,costBand);
+}
+
+bool DTW::computeTemplateEnvelope(DTWTemplate &dtwTemplate,const UINT N,DTWCostBand &costBand){
+    
+    const int M = dtwTemplate.timeSeries.getNumRows();
+    const int C = dtwTemplate.timeSeries.getNumCols();
+    dtwTemplate.envelopeLength = N;
+    dtwTemplate.lowerEnvelope.clear();
+    dtwTemplate.upperEnvelope.clear();
+    
+    if( M == 0 || N == 0 || C == 0 ) return false;
+    
+    computeWarpingWindow(M,N,costBand);
+    
+    //The lower bounds are only valid if every cell inside the warping window (apart from the first) can be reached from a neighbouring cell that is
+    //also inside the window, otherwise the cost matrix can contain cells with zero cost and the DTW cost is not the sum along the warping path
+    for(int i=1; i<M; i++){
+        if( costBand.rowEnd[i] < costBand.rowStart[i] ) return false;
+        if( costBand.rowStart[i] < costBand.rowStart[i-1] || costBand.rowStart[i] > costBand.rowEnd[i-1]+1 ) return false;
+    }
+    
+    //Find the minimum and maximum template values that each input sample can be warped to
+    dtwTemplate.lowerEnvelope.resize(N,C);
+    dtwTemplate.upperEnvelope.resize(N,C);
+    dtwTemplate.lowerEnvelope.setAllValues( numeric_limits<double>::max() );
+    dtwTemplate.upperEnvelope.setAllValues( -numeric_limits<double>::max() );
+    for(int i=0; i<M; i++){
+        for(int j=costBand.rowStart[i]; j<=costBand.rowEnd[i]; j++){
+            for(int k=0; k<C; k++){
+                if( dtwTemplate.timeSeries[i][k] < dtwTemplate.lowerEnvelope[j][k] ) dtwTemplate.lowerEnvelope[j][k] = dtwTemplate.timeSeries[i][k];
+                if( dtwTemplate.timeSeries[i][k] > dtwTemplate.upperEnvelope[j][k] ) dtwTemplate.upperEnvelope[j][k] = dtwTemplate.timeSeries[i][k];
+            }
         }
     }
+    
+    return true;
+}
 
-    //This should not happen!
-    return dist;
+bool DTW::computeTemplateEnvelopes(const UINT N){
+    for(UINT k=0; k<templatesBuffer.size(); k++){
+        computeTemplateEnvelope(templatesBuffer[k],N,costBands[0]);
+    }
+    return true;
+}
+
+double DTW::computeLowerBound(DTWTemplate &dtwTemplate,MatrixDouble &timeSeries,const double bestDistance,DTWCostBand &costBand){
+    
+    const int M = dtwTemplate.timeSeries.getNumRows();
+    const int N = timeSeries.getNumRows();
+    const int C = timeSeries.getNumCols();
+    
+    if( dtwTemplate.envelopeLength != UINT(N) ) computeTemplateEnvelope(dtwTemplate,N,costBand);
+    
+    //If the envelopes could not be computed then there is no lower bound
+    if( int(dtwTemplate.lowerEnvelope.getNumRows()) != N || int(dtwTemplate.lowerEnvelope.getNumCols()) != C ) return 0;
+    
+    //The distance is the mean of the cost matrix values on the warping path.  The path can leave the warping window through cells that hold the
+    //local distance rather than a cumulative cost, so the only cumulative cost that is always on the path is the full DTW cost in the last cell.
+    //The path has at most M+N-1 cells, so the DTW cost divided by M+N-1 is a lower bound on the distance.  A cumulative bound on every cell of
+    //the path is not used, as it is larger than the distance whenever the path leaves the window.  The bound is reduced very slightly to account
+    //for the different order the costs are summed in
+    const double scale = (1.0 - 1.0e-10) / (M+N-1);
+    
+    //LB_Kim: the warping path must start at the first samples and end at the last samples of the two timeseries
+    double kimBound = computeLocalDistance(dtwTemplate.timeSeries[0],timeSeries[0],C,N);
+    if( M > 1 || N > 1 ) kimBound += computeLocalDistance(dtwTemplate.timeSeries[M-1],timeSeries[N-1],C,N);
+    if( kimBound*scale >= bestDistance ) return kimBound*scale;
+    
+    //LB_Keogh: each input sample must be warped to at least one template sample inside the warping window
+    double keoghBound = 0;
+    for(int j=0; j<N; j++){
+        const double *lower = dtwTemplate.lowerEnvelope[j];
+        const double *upper = dtwTemplate.upperEnvelope[j];
+        double dist = 0;
+        for(int k=0; k<C; k++){
+            double delta = 0;
+            if( timeSeries[j][k] > upper[k] ) delta = timeSeries[j][k] - upper[k];
+            else if( timeSeries[j][k] < lower[k] ) delta = lower[k] - timeSeries[j][k];
+            if( distanceMethod == EUCLIDEAN_DIST ) dist += SQR( delta );
+            else dist += delta;
+        }
+        if( distanceMethod == EUCLIDEAN_DIST ) dist = sqrt( dist );
+        else if( distanceMethod == NORM_ABSOLUTE_DIST ) dist /= N;
+        keoghBound += dist;
+        
+        //Stop as soon as the bound is large enough to skip this template
+        if( keoghBound*scale >= bestDistance ) break;
+    }
+    
+    return max(kimBound,keoghBound)*scale;
 }
 
 inline double DTW::MIN_(double a,double b, double c){
@@ -890,10 +1549,18 @@ void DTW::smoothData(MatrixDouble &data,UINT smoothFactor,MatrixDouble &resultsD
 	const UINT M = data.getNumRows();
 	const UINT C = data.getNumCols();
 	const UINT N = (UINT) floor(double(M)/double(smoothFactor));
-	resultsData.resize(N,C);
 
-	if(smoothFactor==1 || M<smoothFactor){
-		resultsData = data;
+	//The data that does not fit into the last window is averaged into one extra row, the results are only resized if their size has changed
+	const bool copyData = smoothFactor==1 || M<smoothFactor;
+	const UINT numRows = copyData ? M : ( M%smoothFactor != 0 ? N+1 : N );
+	if( resultsData.getNumRows() != numRows || resultsData.getNumCols() != C ){
+		resultsData.resize(numRows,C);
+	}
+
+	if( copyData ){
+		for(UINT i=0; i<M; i++)
+			for(UINT j=0; j<C; j++)
+				resultsData[i][j] = data[i][j];
 		return;
 	}
 
@@ -910,21 +1577,11 @@ void DTW::smoothData(MatrixDouble &data,UINT smoothFactor,MatrixDouble &resultsD
 
 	//Add on the data that does not fit into the window
 	if(M%smoothFactor!=0.0){
-		VectorDouble mean(C,0.0);
 		for(UINT j=0; j<C; j++){
-		 for(UINT i=N*smoothFactor; i<M; i++) mean[j] += data[i][j];
-		 mean[j]/=M-(N*smoothFactor);
+		 double mean = 0.0;
+		 for(UINT i=N*smoothFactor; i<M; i++) mean += data[i][j];
+		 resultsData[N][j] = mean/(M-(N*smoothFactor));
 		}
-
-		//Add one row to the end of the Matrix
-		MatrixDouble tempMatrix(N+1,C);
-
-		for(UINT i=0; i<N; i++)
-			for(UINT j=0; j<C; j++)
-				tempMatrix[i][j] = resultsData[i][j];
-
-        for(UINT j=0; j<C; j++) tempMatrix[N][j] = mean[j];
-		resultsData = tempMatrix;
 	}
 
 }
@@ -1209,6 +1866,8 @@ bool DTW::loadModelFromFile( fstream &file ){
         //Resize the prediction results to make sure it is setup for realtime prediction
         continuousInputDataBuffer.clear();
         continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numInputDimensions,0));
+        resetStreamingSearch();
+        computeTemplateEnvelopes(averageTemplateLength);
         maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
         bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
         classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
@@ -1217,6 +1876,252 @@ bool DTW::loadModelFromFile( fstream &file ){
     
     return true;
 }
+bool DTW::loadModelFromFile(string filename){
+    
+    //Check the start of the file to see if this is a binary model file
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    
+    if( !file.is_open() ){
+        errorLog << "loadModelFromFile(string filename) - Failed to open file: " << filename << endl;
+        return false;
+    }
+    
+    char fileFormat[ sizeof(GRT_DTW_BINARY_FILE_FORMAT) ];
+    file.read( fileFormat, sizeof(fileFormat) );
+    const bool isBinaryFile = file.gcount() == (std::streamsize)sizeof(fileFormat) && memcmp( fileFormat, GRT_DTW_BINARY_FILE_FORMAT, sizeof(fileFormat) ) == 0;
+    file.close();
+    
+    if( isBinaryFile ){
+        return loadModelFromBinaryFile( filename );
+    }
+    
+    return MLBase::loadModelFromFile( filename );
+}
+    
+bool DTW::saveModelToBinaryFile(string filename) const{
+    
+    if( !trained ){
+        errorLog << "saveModelToBinaryFile(string filename) - The DTW model has not been trained!" << endl;
+        return false;
+    }
+    
+    //Work out where each block will be stored in the file
+    DTWBinaryModelHeader header;
+    memset( &header, 0, sizeof(header) );
+    strncpy( header.fileFormat, GRT_DTW_BINARY_FILE_FORMAT, sizeof(header.fileFormat) );
+    header.version = GRT_DTW_BINARY_FILE_VERSION;
+    header.byteOrderMark = GRT_DTW_BINARY_FILE_BYTE_ORDER_MARK;
+    header.headerSize = sizeof(DTWBinaryModelHeader);
+    header.templateHeaderSize = sizeof(DTWBinaryTemplateHeader);
+    header.useScaling = useScaling ? 1 : 0;
+    header.numInputDimensions = numInputDimensions;
+    header.numOutputDimensions = numOutputDimensions;
+    header.useNullRejection = useNullRejection ? 1 : 0;
+    header.classifierMode = classifierMode;
+    header.numClasses = numClasses;
+    header.distanceMethod = distanceMethod;
+    header.useSmoothing = useSmoothing ? 1 : 0;
+    header.smoothingFactor = smoothingFactor;
+    header.useZNormalisation = useZNormalisation ? 1 : 0;
+    header.offsetUsingFirstSample = offsetUsingFirstSample ? 1 : 0;
+    header.constrainWarpingPath = constrainWarpingPath ? 1 : 0;
+    header.rejectionMode = rejectionMode;
+    header.numTemplates = numTemplates;
+    header.averageTemplateLength = averageTemplateLength;
+    header.nullRejectionCoeff = nullRejectionCoeff;
+    header.radius = radius;
+    header.rangesOffset = sizeof(DTWBinaryModelHeader);
+    header.templatesOffset = header.rangesOffset + (useScaling ? (uint64_t)numInputDimensions * 2 * sizeof(double) : 0);
+    
+    vector< DTWBinaryTemplateHeader > templateHeaders( numTemplates );
+    uint64_t offset = header.templatesOffset + numTemplates * sizeof(DTWBinaryTemplateHeader);
+    for(UINT i=0; i<numTemplates; i++){
+        offset = ((offset + GRT_DTW_BINARY_FILE_ALIGNMENT - 1) / GRT_DTW_BINARY_FILE_ALIGNMENT) * GRT_DTW_BINARY_FILE_ALIGNMENT;
+        memset( &templateHeaders[i], 0, sizeof(DTWBinaryTemplateHeader) );
+        templateHeaders[i].classLabel = templatesBuffer[i].classLabel;
+        templateHeaders[i].timeSeriesLength = templatesBuffer[i].timeSeries.getNumRows();
+        templateHeaders[i].averageTemplateLength = templatesBuffer[i].averageTemplateLength;
+        templateHeaders[i].nullRejectionThreshold = nullRejectionThresholds[i];
+        templateHeaders[i].trainingMu = templatesBuffer[i].trainingMu;
+        templateHeaders[i].trainingSigma = templatesBuffer[i].trainingSigma;
+        templateHeaders[i].dataOffset = offset;
+        offset += (uint64_t)templateHeaders[i].timeSeriesLength * numInputDimensions * sizeof(double);
+    }
+    header.fileSize = offset;
+    
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out | std::ios::binary);
+    
+    if( !file.is_open() ){
+        errorLog << "saveModelToBinaryFile(string filename) - Could not open file to save data: " << filename << endl;
+        return false;
+    }
+    
+    file.write( (const char*)&header, sizeof(header) );
+    
+    if( useScaling ){
+        for(UINT j=0; j<numInputDimensions; j++){
+            file.write( (const char*)&ranges[j].minValue, sizeof(double) );
+            file.write( (const char*)&ranges[j].maxValue, sizeof(double) );
+        }
+    }
+    
+    file.write( (const char*)&templateHeaders[0], numTemplates * sizeof(DTWBinaryTemplateHeader) );
+    
+    //Write each timeseries as one block, padding the file so each block starts at an aligned offset
+    const char padding[ GRT_DTW_BINARY_FILE_ALIGNMENT ] = {0};
+    uint64_t position = header.templatesOffset + numTemplates * sizeof(DTWBinaryTemplateHeader);
+    for(UINT i=0; i<numTemplates; i++){
+        file.write( padding, templateHeaders[i].dataOffset - position );
+        const uint64_t blockSize = (uint64_t)templateHeaders[i].timeSeriesLength * numInputDimensions * sizeof(double);
+        if( blockSize > 0 ){
+            file.write( (const char*)&templatesBuffer[i].timeSeries[0][0], blockSize );
+        }
+        position = templateHeaders[i].dataOffset + blockSize;
+    }
+    
+    if( !file.good() ){
+        errorLog << "saveModelToBinaryFile(string filename) - Failed to write the model to the file: " << filename << endl;
+        file.close();
+        return false;
+    }
+    
+    file.close();
+    
+    return true;
+}
+    
+bool DTW::loadModelFromBinaryFile(string filename){
+    
+    MemoryMappedFile file;
+    
+    if( !file.open( filename ) ){
+        errorLog << "loadModelFromBinaryFile(string filename) - Failed to open file: " << filename << endl;
+        return false;
+    }
+    
+    const char *data = file.getData();
+    const uint64_t fileSize = file.getSize();
+    
+    //Check the header
+    DTWBinaryModelHeader header;
+    if( fileSize < sizeof(header) ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The file is too small to be a binary DTW model!" << endl;
+        return false;
+    }
+    memcpy( &header, data, sizeof(header) );
+    
+    if( memcmp( header.fileFormat, GRT_DTW_BINARY_FILE_FORMAT, sizeof(GRT_DTW_BINARY_FILE_FORMAT) ) != 0 ){
+        errorLog << "loadModelFromBinaryFile(string filename) - Unknown file header!" << endl;
+        return false;
+    }
+    
+    if( header.byteOrderMark != GRT_DTW_BINARY_FILE_BYTE_ORDER_MARK ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The file was saved on a machine with a different byte order, use the text format instead!" << endl;
+        return false;
+    }
+    
+    if( header.version != GRT_DTW_BINARY_FILE_VERSION || header.headerSize != sizeof(DTWBinaryModelHeader) || header.templateHeaderSize != sizeof(DTWBinaryTemplateHeader) ){
+        errorLog << "loadModelFromBinaryFile(string filename) - Unsupported file version: " << header.version << endl;
+        return false;
+    }
+    
+    if( header.fileSize != fileSize ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The size of the file (" << fileSize << ") does not match the size in the header (" << header.fileSize << "), the file may be incomplete!" << endl;
+        return false;
+    }
+    
+    if( header.numInputDimensions == 0 || header.numTemplates == 0 ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The model has no input dimensions or no templates!" << endl;
+        return false;
+    }
+    
+    const uint64_t rangesSize = header.useScaling ? (uint64_t)header.numInputDimensions * 2 * sizeof(double) : 0;
+    const uint64_t templatesSize = (uint64_t)header.numTemplates * sizeof(DTWBinaryTemplateHeader);
+    if( header.rangesOffset + rangesSize > fileSize || header.templatesOffset + templatesSize > fileSize ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The ranges or template table are outside the file!" << endl;
+        return false;
+    }
+    
+    //Clear any previous model and load the settings
+    clear();
+    
+    useScaling = header.useScaling != 0;
+    numInputDimensions = header.numInputDimensions;
+    numOutputDimensions = header.numOutputDimensions;
+    useNullRejection = header.useNullRejection != 0;
+    classifierMode = header.classifierMode;
+    numClasses = header.numClasses;
+    nullRejectionCoeff = header.nullRejectionCoeff;
+    distanceMethod = header.distanceMethod;
+    useSmoothing = header.useSmoothing != 0;
+    smoothingFactor = header.smoothingFactor;
+    useZNormalisation = header.useZNormalisation != 0;
+    offsetUsingFirstSample = header.offsetUsingFirstSample != 0;
+    constrainWarpingPath = header.constrainWarpingPath != 0;
+    radius = header.radius;
+    rejectionMode = header.rejectionMode;
+    numTemplates = header.numTemplates;
+    averageTemplateLength = header.averageTemplateLength;
+    
+    if( useScaling ){
+        ranges.resize( numInputDimensions );
+        const char *rangesData = data + header.rangesOffset;
+        for(UINT j=0; j<numInputDimensions; j++){
+            memcpy( &ranges[j].minValue, rangesData + (2*j)*sizeof(double), sizeof(double) );
+            memcpy( &ranges[j].maxValue, rangesData + (2*j+1)*sizeof(double), sizeof(double) );
+        }
+    }
+    
+    //Load each template, the timeseries are copied from the mapped file with one copy per template
+    templatesBuffer.resize(numTemplates);
+    classLabels.resize(numTemplates);
+    nullRejectionThresholds.resize(numTemplates);
+    
+    for(UINT i=0; i<numTemplates; i++){
+        DTWBinaryTemplateHeader templateHeader;
+        memcpy( &templateHeader, data + header.templatesOffset + i * sizeof(DTWBinaryTemplateHeader), sizeof(templateHeader) );
+        
+        const uint64_t blockSize = (uint64_t)templateHeader.timeSeriesLength * numInputDimensions * sizeof(double);
+        if( templateHeader.timeSeriesLength == 0 || templateHeader.dataOffset + blockSize > fileSize ){
+            clear();
+            errorLog << "loadModelFromBinaryFile(string filename) - The timeseries of template " << i+1 << " is empty or outside the file!" << endl;
+            return false;
+        }
+        
+        templatesBuffer[i].classLabel = templateHeader.classLabel;
+        templatesBuffer[i].averageTemplateLength = templateHeader.averageTemplateLength;
+        templatesBuffer[i].trainingMu = templateHeader.trainingMu;
+        templatesBuffer[i].trainingSigma = templateHeader.trainingSigma;
+        classLabels[i] = templateHeader.classLabel;
+        nullRejectionThresholds[i] = templateHeader.nullRejectionThreshold;
+        
+        if( !templatesBuffer[i].timeSeries.resize( templateHeader.timeSeriesLength, numInputDimensions ) ){
+            clear();
+            errorLog << "loadModelFromBinaryFile(string filename) - Failed to resize the timeseries of template " << i+1 << endl;
+            return false;
+        }
+        memcpy( &templatesBuffer[i].timeSeries[0][0], data + templateHeader.dataOffset, blockSize );
+    }
+    
+    file.close();
+    
+    trained = true;
+    
+    //Resize the prediction results to make sure it is setup for realtime prediction
+    continuousInputDataBuffer.clear();
+    continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numInputDimensions,0));
+    resetStreamingSearch();
+    computeTemplateEnvelopes(averageTemplateLength);
+    maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
+    bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
+    classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
+    classDistances.resize(numClasses,DEFAULT_NULL_DISTANCE_VALUE);
+    
+    return true;
+}
+    
 bool DTW::setRejectionMode(UINT rejectionMode){
     if( rejectionMode == TEMPLATE_THRESHOLDS || rejectionMode == CLASS_LIKELIHOODS || rejectionMode == THRESHOLDS_AND_LIKELIHOODS ){
         this->rejectionMode = rejectionMode;
@@ -1238,11 +2143,44 @@ bool DTW::setOffsetTimeseriesUsingFirstSample(bool offsetUsingFirstSample){
     
 bool DTW::setContrainWarpingPath(bool constrain){
     this->constrainWarpingPath = constrain;
+    if( trained ) computeTemplateEnvelopes(averageTemplateLength);
     return true;
 }
     
 bool DTW::setWarpingRadius(double radius){
     this->radius = radius;
+    if( trained ) computeTemplateEnvelopes(averageTemplateLength);
+    return true;
+}
+    
+bool DTW::enableStreamingPrediction(bool useStreamingPrediction){
+    this->useStreamingPrediction = useStreamingPrediction;
+    if( trained ) resetStreamingSearch();
+    return true;
+}
+
+bool DTW::enableWarpingPathStorage(bool storeWarpingPaths){
+    this->storeWarpingPaths = storeWarpingPaths;
+    return true;
+}
+
+bool DTW::enableLowerBoundPruning(bool useLowerBoundPruning){
+    this->useLowerBoundPruning = useLowerBoundPruning;
+    return true;
+}
+
+bool DTW::enableSinglePrecisionDistances(bool useSinglePrecisionDistances){
+    this->useSinglePrecisionDistances = useSinglePrecisionDistances;
+    return true;
+}
+
+bool DTW::enableParallelPrediction(const bool useParallelPrediction){
+    this->useParallelPrediction = useParallelPrediction;
+    return true;
+}
+
+bool DTW::enableParallelTraining(const bool useParallelTraining){
+    this->useParallelTraining = useParallelTraining;
     return true;
 }
 
@@ -1517,6 +2455,8 @@ bool DTW::loadLegacyModelFromFile( fstream &file ){
     //Resize the prediction results to make sure it is setup for realtime prediction
     continuousInputDataBuffer.clear();
     continuousInputDataBuffer.resize(averageTemplateLength,vector<double>(numInputDimensions,0));
+    resetStreamingSearch();
+    computeTemplateEnvelopes(averageTemplateLength);
     maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
     bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
     classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
@@ -45,6 +45,8 @@
 
 #include "../../CoreModules/Classifier.h"
 #include "../../Util/TimeSeriesClassificationSampleTrimmer.h"
+#include "../../Util/DistanceKernels.h"
+#include "../../Util/MemoryMappedFile.h"
 
 namespace GRT{
     
@@ -70,6 +72,69 @@ public:
     double dist;
 };
 
+///////////////// DTW Cost Band /////////////////
+//Stores the cells of a DTW cost matrix that are inside the warping window, row by row, so the cost matrix can be computed without
+//allocating or visiting the full M x N matrix when the warping path is constrained
+///////////////// DTW Distance Warnings /////////////////
+//Counts the problems found while computing DTW distances.  The distances can be computed on the thread pool, where nothing can be written to
+//the logs, so the problems are counted and then logged by the calling thread, see DTW::logDistanceWarnings
+class DTWDistanceWarnings{
+public:
+	DTWDistanceWarnings(){ clear(); }
+	~DTWDistanceWarnings(){}
+    
+    void clear(){
+        numInvalidDistances = 0;
+        numWarpPathFailures = 0;
+    }
+    
+    DTWDistanceWarnings& operator+=(const DTWDistanceWarnings &rhs){
+        numInvalidDistances += rhs.numInvalidDistances;
+        numWarpPathFailures += rhs.numWarpPathFailures;
+        return *this;
+    }
+
+    UINT numInvalidDistances;           //The number of distances that were INF or NAN
+    UINT numWarpPathFailures;           //The number of warping paths that could not be computed
+};
+
+class DTWCostBand{
+public:
+	DTWCostBand(){}
+	~DTWCostBand(){}
+
+    vector< int > rowStart;             //The first column inside the warping window for each row
+    vector< int > rowEnd;               //The last column inside the warping window for each row (less than rowStart if the row is empty)
+    vector< UINT > rowOffset;           //The index of the first cell of each row in the cost buffer
+    vector< double > cost;              //The cumulative cost of each cell inside the warping window
+    vector< char > reachable;           //Flags if each cell inside the warping window can be reached from the end of the cost matrix
+    vector< int > upperRejectedColumn;  //For each row, the columns from this column onwards are flagged as unreachable above the warping window
+    vector< int > lowerRejectedColumn;  //For each row, the columns before this column are flagged as unreachable below the warping window
+    vector< double > inputColumns;      //The input timeseries stored column by column, used by the distance kernels
+    vector< float > inputColumnsFloat;  //The input timeseries stored column by column in single precision, used by the distance kernels
+    vector< float > sampleFloat;        //A single template sample in single precision, used by the distance kernels
+    vector< double > localDistances;    //The distances between a template sample and a row of input samples
+    DTWDistanceWarnings warnings;       //The problems found by the distances computed with this band since they were last logged
+};
+
+///////////////// DTW Streaming Column /////////////////
+//Stores the state of the streaming subsequence search for one template: the last column of the cost matrix between the template and the
+//input stream, and the number of input samples a warping path can span to reach each template sample
+class DTWStreamingColumn{
+public:
+	DTWStreamingColumn(){}
+	~DTWStreamingColumn(){}
+
+    vector< double > templateColumns;   //The template stored column by column, used by the distance kernels
+    vector< double > localDistances;    //The distances between the latest input sample and each template sample
+    vector< double > cost;              //The cumulative cost of the best warping path ending at each template sample
+    vector< double > pathCost;          //The sum of the cumulative costs along the best warping path ending at each template sample
+    vector< UINT > pathLength;          //The number of cells in the best warping path ending at each template sample
+    vector< UINT > matchLength;         //The number of input samples spanned by the best warping path ending at each template sample
+    vector< UINT > minMatchLength;      //The minimum number of input samples a warping path must span to reach each template sample
+    vector< UINT > maxMatchLength;      //The maximum number of input samples a warping path can span to reach each template sample
+};
+
 ///////////////// DTW Template /////////////////
 class DTWTemplate{
 public:
@@ -78,6 +143,7 @@ public:
 		trainingMu = 0.0;
 		trainingSigma = 0.0;
 		averageTemplateLength=0;
+		envelopeLength=0;
 	}
 	~DTWTemplate(){};
 
@@ -86,6 +152,9 @@ public:
 	double trainingMu;                  //The mean distance value of the training data with the trained template 
 	double trainingSigma;               //The sigma of the distance value of the training data with the trained template 
 	UINT averageTemplateLength;          //The average length of the examples used to train this template
+	MatrixDouble lowerEnvelope;         //The minimum template value inside the warping window for each input sample, used to compute LB_Keogh
+	MatrixDouble upperEnvelope;         //The maximum template value inside the warping window for each input sample, used to compute LB_Keogh
+	UINT envelopeLength;                //The input timeseries length the envelopes were computed for (0 if the envelopes need to be computed)
 };
 
 class DTW : public Classifier
@@ -199,6 +268,37 @@ public:
      */
     virtual bool loadModelFromFile(fstream &file);
     
+    /**
+     This loads a trained DTW model from a file.  The file can either be a text file saved by saveModelToFile or a binary file saved by
+     saveModelToBinaryFile, the format is detected from the start of the file.
+     This overrides the loadModelFromFile function in the MLBase class.
+     
+     @param string filename: the name of the file the DTW model will be loaded from
+     @return returns true if the model was loaded successfully, false otherwise
+     */
+    virtual bool loadModelFromFile(string filename);
+    
+    /**
+     This saves the trained DTW model to a binary file.  The binary file starts with a fixed size header, followed by the ranges (if scaling
+     is used), a table with the settings of each template, and the timeseries of each template.  Each timeseries is stored as one contiguous
+     block of doubles, aligned to 64 bytes, so the model can be loaded by mapping the file into memory and copying each block, without parsing
+     any text.  The binary format uses the byte order of the machine that saved it, so the text format should be used to move a model
+     between different platforms.
+     
+     @param string filename: the name of the file the DTW model will be saved to
+     @return returns true if the model was saved successfully, false otherwise
+     */
+    bool saveModelToBinaryFile(string filename) const;
+    
+    /**
+     This loads a trained DTW model from a binary file saved by saveModelToBinaryFile.  The file is mapped into memory, so the load time is
+     mostly spent reading the pages of the file rather than parsing it.
+     
+     @param string filename: the name of the file the DTW model will be loaded from
+     @return returns true if the model was loaded successfully, false otherwise
+     */
+    bool loadModelFromBinaryFile(string filename);
+    
     /**
      This recomputes the null rejection thresholds for each of the classes in the DTW model.
      This will be called automatically if the setGamma(double gamma) function is called.
@@ -257,6 +357,133 @@ public:
      */
     bool setWarpingRadius(double radius);
 
+    /**
+     Sets if the realtime prediction function, predict_(VectorDouble &inputVector), should use a streaming subsequence search instead of running
+     a full DTW over the continuous input buffer each time a new sample arrives.
+
+     The streaming search is based on the SPRING algorithm (Sakurai, Faloutsos & Yamamuro, 2007).  One cumulative cost column is kept for each template
+     and updated in O(template length) for each new sample, so the cost of each prediction does not depend on the length of the input window.  A match
+     can start at any sample in the input stream, and the distance for each template is normalized along the best warping path in the same way as the
+     standard DTW distance.
+
+     To keep the distances close to the distances of the standard search, which the null rejection thresholds are computed from, a match must span
+     between averageTemplateLength*(1-radius) and averageTemplateLength*(1+radius) input samples.  If the warping path is constrained, the warping
+     window is applied relative to the start of each match, as if the match was an input window of averageTemplateLength samples.  Only the best
+     warping path into each cell is kept, so the distances are close to, but not always the same as, the distances of the standard search.
+
+     The streaming search is a low-latency alternative to the standard search, not a drop-in replacement for it.  The standard search compares the
+     templates against the last averageTemplateLength samples, while the streaming search compares them against the best matching subsequence that
+     ends at the current sample, so the two searches will not always make the same prediction for the same input stream, with or without null
+     rejection.  The null rejection thresholds are computed for the standard search, so they should be checked against the streaming distances of
+     your own data before the streaming search is used with null rejection.
+
+     The streaming search can not be used with z-normalization, smoothing, or offsetting the timeseries by the first sample, as these all need the full
+     input window, see getStreamingPredictionSupported().
+
+     @param bool useStreamingPrediction: if true then predict_(VectorDouble &inputVector) will use the streaming subsequence search
+     @return returns true if the streaming prediction parameter was updated successfully, false otherwise
+     */
+    bool enableStreamingPrediction(bool useStreamingPrediction);
+
+    /**
+     Sets if lower bounds should be used to skip the full DTW search for templates that can not be the closest template to the input timeseries.
+
+     A cascade of two lower bounds is tested for each template before the full DTW distance is computed: LB_Kim, which only uses the first and
+     last samples of the timeseries, followed by LB_Keogh, which uses the upper and lower envelope of the template inside the warping window.
+     The envelopes are computed for each template at train/load time, and are recomputed if the length of the input timeseries changes.  If the
+     lower bound for a template is not less than the best distance found so far then the full DTW search is skipped for that template.
+
+     The distance is the mean of the cost matrix values along the warping path, and the path can leave the warping window through cells that
+     only hold the local distance, so the bounds have to be divided by the maximum length of the path.  This keeps the predictions exact, but
+     it makes the bounds much smaller than the distances, so templates are only skipped if they are much further from the input than the
+     closest template.  Pruning should only be enabled if the templates are very different from each other.
+
+     The predicted class label and best distance are the same as without pruning, but the class distance of a template that was skipped is set to
+     its lower bound.  The class likelihoods can not be computed from these bounds, so while pruning is used the class likelihoods and maximum
+     likelihood are set to DEFAULT_NULL_LIKELIHOOD_VALUE.  For this reason pruning is only used if null rejection is disabled or the rejection
+     mode is TEMPLATE_THRESHOLDS, as the other rejection modes need the exact likelihood of every template.
+
+     @param bool useLowerBoundPruning: if true then lower bounds will be used to skip the full DTW search for templates that can not be the closest
+     @return returns true if the lower bound pruning parameter was updated successfully, false otherwise
+     */
+    bool enableLowerBoundPruning(bool useLowerBoundPruning);
+
+    /**
+     Gets if lower bounds should be used to skip the full DTW search for templates that can not be the closest template to the input timeseries.
+
+     @return returns true if lower bound pruning is enabled, false otherwise
+     */
+    bool getLowerBoundPruningEnabled(){ return useLowerBoundPruning; }
+
+    /**
+     Sets if the distance between each template sample and input sample should be computed in single precision.  The samples are converted to
+     32-bit floats before the distance is computed, which doubles the number of samples the SIMD distance kernels can process at once.  The
+     cumulative DTW cost is still computed in double precision.  This is useful for low precision sensor data, but the distances will differ
+     slightly from the default double precision distances.  Lower bound pruning is not used if this is enabled.
+
+     @param bool useSinglePrecisionDistances: if true then the distance between each template sample and input sample will use single precision
+     @return returns true if the single precision parameter was updated successfully, false otherwise
+     */
+    bool enableSinglePrecisionDistances(bool useSinglePrecisionDistances);
+
+    /**
+     Gets if the distance between each template sample and input sample should be computed in single precision.
+
+     @return returns true if single precision distances are enabled, false otherwise
+     */
+    bool getSinglePrecisionDistancesEnabled(){ return useSinglePrecisionDistances; }
+
+    /**
+     Sets if the distance to each template should be computed in parallel.  If enabled, the templates are split into one block per thread in the
+     GRT ThreadPool and each block is tested on its own thread, with its own cost matrix buffers.  The predictions are the same as the serial
+     prediction, but this is only useful if the model has several templates and the CPU has more than one core.  Unlike the serial prediction,
+     which reuses its buffers, each parallel prediction allocates the tasks it adds to the ThreadPool.
+
+     @param const bool useParallelPrediction: if true then the distance to each template will be computed in parallel
+     @return returns true if the parallel prediction parameter was updated successfully, false otherwise
+     */
+    virtual bool enableParallelPrediction(const bool useParallelPrediction);
+
+    /**
+     Gets if the distance to each template should be computed in parallel.
+
+     @return returns true if parallel prediction is enabled, false otherwise
+     */
+    virtual bool getParallelPredictionEnabled() const{ return useParallelPrediction; }
+
+    /**
+     Sets if the distances between the training examples should be computed in parallel.  Training compares every example of a class with every
+     other example of that class, which is where most of the training time is spent.  If enabled, these comparisons are split into tasks on the
+     GRT ThreadPool, and the examples of all the classes are compared at the same time.  The trained model is the same as the serial training.
+     Parallel training is enabled by default.
+
+     @param const bool useParallelTraining: if true then the distances between the training examples will be computed in parallel
+     @return returns true if the parallel training parameter was updated successfully, false otherwise
+     */
+    virtual bool enableParallelTraining(const bool useParallelTraining);
+
+    /**
+     Gets if the distances between the training examples should be computed in parallel.
+
+     @return returns true if parallel training is enabled, false otherwise
+     */
+    virtual bool getParallelTrainingEnabled() const{ return useParallelTraining; }
+
+    /**
+     Gets if the realtime prediction function should use the streaming subsequence search.
+
+     @return returns true if the streaming subsequence search is enabled, false otherwise
+     */
+    bool getStreamingPredictionEnabled(){ return useStreamingPrediction; }
+
+    /**
+     Gets if the streaming subsequence search can be used with the current settings.  The streaming search can not be used if z-normalization,
+     smoothing or offsetting the timeseries by the first sample are enabled, as these all need the full input window.
+
+     @return returns true if the streaming subsequence search can be used, false otherwise
+     */
+    bool getStreamingPredictionSupported(){ return !useZNormalisation && !useSmoothing && !offsetUsingFirstSample; }
+
     /**
      Gets the rejection mode used for null rejection. The rejection mode will be one of the RejectionModes enums.
      
@@ -312,8 +539,19 @@ public:
      */
     vector< VectorDouble > getInputDataBuffer(){ return continuousInputDataBuffer.getDataAsVector(); }
 
+    /**
+     Sets if the full distance matrix and warping path should be stored for each template during the prediction phase.  By default these are not
+     stored, so the DTW cost matrix only needs to be computed for the cells inside the warping window.  Enable this if you need to access the
+     distance matrices or warping paths from the last prediction.
+     
+     @param bool storeWarpingPaths: if true then the distance matrix and warping path for each template will be stored during the prediction phase
+     @return returns true if the storeWarpingPaths parameter was updated successfully, false otherwise
+     */
+    bool enableWarpingPathStorage(bool storeWarpingPaths);
+
     /**
      Gets the distances matrices from the last prediction.  Each element in the vector represents the distance matrices for each corresponding class.
+     The distance matrices are only stored if warping path storage has been enabled, see enableWarpingPathStorage(bool storeWarpingPaths).
      
      @return returns a vector of MatrixDouble containing the distance matrices from the last prediction, or an empty vector if no prediction has been made
      */
@@ -321,6 +559,7 @@ public:
 
     /**
      Gets the warping paths from the last prediction.  Each element in the vector represents the warping path for each corresponding class.
+     The warping paths are only stored if warping path storage has been enabled, see enableWarpingPathStorage(bool storeWarpingPaths).
      
      @return returns a vector of vectors containing the warping paths from the last prediction, or an empty vector if no prediction has been made
      */
@@ -334,11 +573,31 @@ public:
 
 private:
 	//Public training and prediction methods
-	bool train_NDDTW(TimeSeriesClassificationData &trainingData,DTWTemplate &dtwTemplate,UINT &bestIndex);
+	bool train_NDDTW(TimeSeriesClassificationData &trainingData,MatrixDouble &distanceResults,DTWTemplate &dtwTemplate,UINT &bestIndex);
+    bool computeClassTrainingDistances(vector< vector< MatrixDouble > > &classExamples,vector< MatrixDouble > &classDistanceResults);
+    bool computeTrainingDistances(vector< MatrixDouble > &examples,MatrixDouble &distanceResults,const UINT m,DTWDistanceWarnings &warnings);
+    bool predictStreaming_(VectorDouble &inputVector);
+    bool predictFromClassDistances(const bool usePruning);
+    bool computeTemplateDistances(MatrixDouble &timeSeries,const UINT start,const UINT end,DTWCostBand &costBand,const bool usePruning);
+    void logDistanceWarnings(DTWDistanceWarnings &warnings);
+    bool resetStreamingSearch();
 
 	//The actual DTW function
-	double computeDistance(MatrixDouble &timeSeriesA,MatrixDouble &timeSeriesB,MatrixDouble &distanceMatrix,vector< IndexDist > &warpPath);
-    double d(int m,int n,MatrixDouble &distanceMatrix,const int M,const int N);
+	double computeDistance(MatrixDouble &timeSeriesA,MatrixDouble &timeSeriesB,MatrixDouble *distanceMatrix,vector< IndexDist > *warpPath,DTWCostBand &costBand,double *transposedDistance = NULL);
+    double computeWarpPathDistance(MatrixDouble &timeSeriesA,const int M,const int N,vector< IndexDist > *warpPath,DTWCostBand &costBand,const bool transposed);
+    double inline computeLocalDistance(const double *a,const double *b,const int C,const int N);
+    void convertKernelDistances(double *distances,const int numDistances,const int N);
+    double inline computeLocalDistance(MatrixDouble &timeSeriesA,const int m,const int n,const int N,DTWCostBand &costBand);
+    bool computeLocalDistances(MatrixDouble &timeSeriesA,const int m,const int start,const int end,const int N,double *distances,DTWCostBand &costBand);
+    bool setDistanceKernelInput(MatrixDouble &timeSeries,DTWCostBand &costBand);
+    double inline getWarpingWindowOffset(const int m,const int n,const int M,const int N);
+    UINT computeWarpingWindow(const int M,const int N,DTWCostBand &costBand);
+    bool computeTemplateEnvelope(DTWTemplate &dtwTemplate,const UINT N,DTWCostBand &costBand);
+    bool computeTemplateEnvelopes(const UINT N);
+    double computeLowerBound(DTWTemplate &dtwTemplate,MatrixDouble &timeSeries,const double bestDistance,DTWCostBand &costBand);
+    double inline getBandCost(const int m,const int n,DTWCostBand &costBand);
+    void flagRejectedCell(MatrixDouble &timeSeriesA,const int m,const int n,const int M,const int N,DTWCostBand &costBand);
+    double getCostMatrixValue(MatrixDouble &timeSeriesA,const int m,const int n,const int M,const int N,DTWCostBand &costBand);
 	double inline MIN_(double a,double b, double c);
 
 	//Private Scaling and Utility Functions
@@ -358,9 +617,17 @@ protected:
 	vector< DTWTemplate > templatesBuffer;		//A buffer to store the templates for each time series
     vector< MatrixDouble > distanceMatrices;
     vector< vector< IndexDist > > warpPaths;
+    vector< DTWCostBand > costBands;                //The cells of the cost matrix inside the warping window, one buffer for each prediction thread
     CircularBuffer< VectorDouble > continuousInputDataBuffer;
+    MatrixDouble predictionTimeSeries;              //The contents of the continuous input buffer, reused by each realtime prediction
+    MatrixDouble processedTimeSeries;               //The scaled and/or z-normalized input timeseries, reused by each prediction
+    MatrixDouble smoothedTimeSeries;                //The smoothed input timeseries, reused by each prediction
+    vector< DTWStreamingColumn > streamingColumns;  //The state of the streaming search for each template
 	UINT				numTemplates;			//The number of templates in our buffer
+    UINT                numStreamingSamples;    //The number of samples the streaming search has seen since the last reset
     UINT                rejectionMode;          //The rejection mode used to reject null gestures during the prediction phase
+    std::unique_ptr< ThreadPool > threadPool;   //The thread pool used for parallel prediction, this is only created when it is first needed
+    vector< std::future< bool > > predictionTasks; //The pending template blocks for the current parallel prediction
 
 	//Flags
 	bool				useSmoothing;			//A flag to check if we need to smooth the data
@@ -369,6 +636,12 @@ protected:
 	bool				constrainZNorm;			//A flag to check if we need to constrain zNorm (only zNorm if stdDev > zNormConstrainThreshold)
 	bool				constrainWarpingPath;	//A flag to check if we need to constrain the dtw cost matrix and search
     bool                trimTrainingData;       //A flag to check if we need to trim the training data first before training
+    bool                useStreamingPrediction; //A flag to check if the realtime prediction should use the streaming subsequence search
+    bool                storeWarpingPaths;      //A flag to check if the distance matrix and warping path should be stored for each template
+    bool                useLowerBoundPruning;   //A flag to check if lower bounds should be used to skip the full DTW search for some templates
+    bool                useSinglePrecisionDistances; //A flag to check if the distance between each template and input sample should use single precision
+    bool                useParallelPrediction;  //A flag to check if the distance to each template should be computed on the thread pool
+    bool                useParallelTraining;    //A flag to check if the distances between the training examples should be computed on the thread pool
 
 	double				zNormConstrainThreshold;//The threshold value to be used if constrainZNorm is turned on
     double              radius;
@@ -94,6 +94,7 @@ DecisionTree& DecisionTree::operator=(const DecisionTree &rhs){
         this->trainingMode = rhs.trainingMode;
         this->numSplittingSteps = rhs.numSplittingSteps;
         this->nodeClusters = rhs.nodeClusters;
+        this->flatTree = rhs.flatTree;
 
         //Copy the base classifier variables
         copyBaseVariables( (Classifier*)&rhs );
@@ -130,6 +131,7 @@ bool DecisionTree::deepCopyFrom(const Classifier *classifier){
         this->trainingMode = ptr->trainingMode;
         this->numSplittingSteps = ptr->numSplittingSteps;
         this->nodeClusters = ptr->nodeClusters;
+        this->flatTree = ptr->flatTree;
         
         //Copy the base classifier variables
         return copyBaseVariables( classifier );
@@ -142,23 +144,11 @@ bool DecisionTree::train_(ClassificationData &trainingData){
     //Clear any previous model
     clear();
     
-    if( decisionTreeNode == NULL ){
-        Classifier::errorLog << "train_(ClassificationData &trainingData) - The decision tree node has not been set! You must set this first before training a model." << endl;
-        return false;
-    }
-    
-    const unsigned int M = trainingData.getNumSamples();
-    const unsigned int N = trainingData.getNumDimensions();
-    const unsigned int K = trainingData.getNumClasses();
-    
-    if( M == 0 ){
+    if( trainingData.getNumSamples() == 0 ){
         Classifier::errorLog << "train_(ClassificationData &trainingData) - Training data has zero samples!" << endl;
         return false;
     }
     
-    numInputDimensions = N;
-    numClasses = K;
-    classLabels = trainingData.getClassLabels();
     ranges = trainingData.getRanges();
     
     //Scale the training data if needed
@@ -167,31 +157,79 @@ bool DecisionTree::train_(ClassificationData &trainingData){
         trainingData.scale(0, 1);
     }
     
-    //If we are using null rejection, then we need a copy of the training dataset for later
-    ClassificationData trainingDataCopy;
-    if( useNullRejection ){
-        trainingDataCopy = trainingData;
+    //Build the columns of the training data for the split search, unless the caller has already built them.  The columns are a second
+    //copy of the data, so they are freed as soon as the tree has been built
+    const bool buildColumns = !trainingData.getColumnStorageBuilt();
+    if( buildColumns ) trainingData.buildColumnStorage();
+    
+    //The tree is built from a view of the training data, so the samples are not copied at each node
+    ClassificationDataView data( trainingData );
+    const bool result = trainTree( data );
+    
+    if( buildColumns ) trainingData.clearColumnStorage();
+    
+    return result;
+}
+
+bool DecisionTree::train_(ClassificationDataView &trainingData){
+    
+    //The samples in the view can not be scaled without changing the parent dataset, so scaling needs a copy of the data
+    if( useScaling ){
+        ClassificationData data = trainingData.getDataset();
+        return train_( data );
+    }
+    
+    //Clear any previous model
+    clear();
+    
+    if( trainingData.getNumSamples() == 0 ){
+        Classifier::errorLog << "train_(ClassificationDataView &trainingData) - Training data has zero samples!" << endl;
+        return false;
+    }
+    
+    ranges = trainingData.getRanges();
+    
+    return trainTree( trainingData );
+}
+
+bool DecisionTree::trainTree(const ClassificationDataView &trainingData){
+    
+    if( decisionTreeNode == NULL ){
+        Classifier::errorLog << "trainTree(const ClassificationDataView &trainingData) - The decision tree node has not been set! You must set this first before training a model." << endl;
+        return false;
     }
     
+    const unsigned int M = trainingData.getNumSamples();
+    const unsigned int N = trainingData.getNumDimensions();
+    const unsigned int K = trainingData.getNumClasses();
+    
+    numInputDimensions = N;
+    numClasses = K;
+    classLabels = trainingData.getClassLabels();
+    
     //Setup the valid features - at this point all features can be used
     vector< UINT > features(N);
     for(UINT i=0; i<N; i++){
         features[i] = i;
     }
     
-    //Build the tree
+    //Build the tree, the tree building clears the data at each node so it gets its own copy of the view
+    ClassificationDataView nodeData( trainingData );
     UINT nodeID = 0;
-    tree = buildTree( trainingData, NULL, features, classLabels, nodeID );
+    tree = buildTree( nodeData, NULL, features, classLabels, nodeID );
     
     if( tree == NULL ){
         clear();
-        Classifier::errorLog << "train_(ClassificationData &trainingData) - Failed to build tree!" << endl;
+        Classifier::errorLog << "trainTree(const ClassificationDataView &trainingData) - Failed to build tree!" << endl;
         return false;
     }
     
     //Flag that the algorithm has been trained
     trained = true;
     
+    //Build the flat copy of the tree that is used for prediction
+    buildFlatTree();
+    
     //Compute the null rejection thresholds if null rejection is enabled
     if( useNullRejection ){
         VectorDouble classLikelihoods( numClasses );
@@ -202,14 +240,14 @@ bool DecisionTree::train_(ClassificationData &trainingData){
         //Run over the training dataset and compute the distance between each training sample and the predicted node cluster
         for(UINT i=0; i<M; i++){
             //Run the prediction for this sample
-            if( !tree->predict( trainingDataCopy[i].getSample(), classLikelihoods ) ){
+            if( !tree->predict( trainingData[i].getSample(), classLikelihoods ) ){
                 Classifier::errorLog << "predict_(VectorDouble &inputVector) - Failed to predict!" << endl;
                 return false;
             }
             
             //Store the predicted class index and cluster distance
             predictions[i] = Util::getMaxIndex( classLikelihoods );
-            distances[i] = getNodeDistance(trainingDataCopy[i].getSample(), tree->getPredictedNodeID() );
+            distances[i] = getNodeDistance(trainingData[i].getSample(), tree->getPredictedNodeID() );
             
             classCounter[ predictions[i] ]++;
         }
@@ -274,10 +312,16 @@ bool DecisionTree::predict_(VectorDouble &inputVector){
     if( classLikelihoods.size() != numClasses ) classLikelihoods.resize(numClasses,0);
     if( classDistances.size() != numClasses ) classDistances.resize(numClasses,0);
     
-    //Run the decision tree prediction
-    if( !tree->predict( inputVector, classLikelihoods ) ){
-        Classifier::errorLog << "predict_(VectorDouble &inputVector) - Failed to predict!" << endl;
-        return false;
+    //Run the decision tree prediction, using the flat copy of the tree if it has been built
+    UINT predictedNodeID = 0;
+    if( flatTree.getIsBuilt() ){
+        flatTree.predictTree( 0, inputVector, classLikelihoods, predictedNodeID );
+    }else{
+        if( !tree->predict( inputVector, classLikelihoods ) ){
+            Classifier::errorLog << "predict_(VectorDouble &inputVector) - Failed to predict!" << endl;
+            return false;
+        }
+        predictedNodeID = tree->getPredictedNodeID();
     }
     
     //Find the maximum likelihood
@@ -295,7 +339,7 @@ bool DecisionTree::predict_(VectorDouble &inputVector){
     if( useNullRejection ){
         
         //Get the distance between the input and the leaf mean
-        double leafDistance = getNodeDistance( inputVector, tree->getPredictedNodeID() );
+        double leafDistance = getNodeDistance( inputVector, predictedNodeID );
         
         if( grt_isnan(leafDistance) ){
             Classifier::errorLog << "predict_(VectorDouble &inputVector) - Failed to match leaf node ID to compute node distance!" << endl;
@@ -327,6 +371,9 @@ bool DecisionTree::clear(){
     //Clear the node clusters
     nodeClusters.clear();
     
+    //Clear the flat copy of the tree
+    flatTree.clear();
+    
     //Delete the tree if it exists
     if( tree != NULL ){
         tree->clear();
@@ -632,6 +679,9 @@ bool DecisionTree::loadModelFromFile(fstream &file){
             recomputeNullRejectionThresholds();
         }
         
+        //Build the flat copy of the tree that is used for prediction
+        buildFlatTree();
+        
         //Resize the prediction results to make sure it is setup for realtime prediction
         maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
         bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
@@ -683,10 +733,14 @@ bool DecisionTree::setDecisionTreeNode( const DecisionTreeNode &node ){
     return true;
 }
     
-DecisionTreeNode* DecisionTree::buildTree(ClassificationData &trainingData,DecisionTreeNode *parent,vector< UINT > features,const vector< UINT > &classLabels, UINT nodeID){
+bool DecisionTree::setRandomSeed( const unsigned long long seed ){
+    random.setSeed( seed );
+    return true;
+}
+    
+DecisionTreeNode* DecisionTree::buildTree(ClassificationDataView &trainingData,DecisionTreeNode *parent,vector< UINT > features,const vector< UINT > &classLabels, UINT nodeID){
     
     const UINT M = trainingData.getNumSamples();
-    const UINT N = trainingData.getNumDimensions();
     
     //Update the nodeID
     nodeID++;
@@ -707,14 +761,23 @@ DecisionTreeNode* DecisionTree::buildTree(ClassificationData &trainingData,Decis
     if( node == NULL )
         return NULL;
 
+    //Seed the node from the tree's random number generator, so the whole tree only depends on the seed of the tree
+    node->setRandomSeed( (unsigned long long)random.getRandomNumberInt( 1, numeric_limits< int >::max() ) );
+
     //Get the class probabilities
     VectorDouble classProbs = trainingData.getClassProbabilities( classLabels ); 
     
+    //The view lists all the classes of the training data, so count how many classes actually have samples at this node
+    UINT numClassesAtNode = 0;
+    for(size_t k=0; k<classProbs.size(); k++){
+        if( classProbs[k] > 0 ) numClassesAtNode++;
+    }
+    
     //Set the parent
     node->initNode( parent, depth, nodeID );
     
     //If all the training data belongs to the same class or there are no features left then create a leaf node and return
-    if( trainingData.getNumClasses() == 1 || features.size() == 0 || M < minNumSamplesPerNode || depth >= maxDepth ){
+    if( numClassesAtNode == 1 || features.size() == 0 || M < minNumSamplesPerNode || depth >= maxDepth ){
        
         //Set the node
         node->setLeafNode( trainingData.getNumSamples(), classProbs );
@@ -725,7 +788,7 @@ DecisionTreeNode* DecisionTree::buildTree(ClassificationData &trainingData,Decis
         }
      
         string info = "Reached leaf node.";
-        if( trainingData.getNumClasses() == 1 ) info = "Reached pure leaf node.";
+        if( numClassesAtNode == 1 ) info = "Reached pure leaf node.";
         else if( features.size() == 0 ) info = "Reached leaf node, no remaining features.";
         else if( M < minNumSamplesPerNode ) info = "Reached leaf node, hit min-samples-per-node limit.";
         else if( depth >= maxDepth ) info = "Reached leaf node, max depth reached.";
@@ -767,18 +830,19 @@ DecisionTreeNode* DecisionTree::buildTree(ClassificationData &trainingData,Decis
         }
     }
     
-    //Split the data into a left and right dataset
-    ClassificationData lhs(N);
-    ClassificationData rhs(N);
-    
-    //Reserve the memory to speed up the allocation of large datasets
-    lhs.reserve( M );
-    rhs.reserve( M );
-    
-    for(UINT i=0; i<M; i++){
-        if( node->predict( trainingData[i].getSample() ) ){
-            rhs.addSample(trainingData[i].getClassLabel(), trainingData[i].getSample());
-        }else lhs.addSample(trainingData[i].getClassLabel(), trainingData[i].getSample());
+    //Split the data into a left and right dataset, each dataset is a view of the samples in the original training data
+    ClassificationDataView lhs;
+    ClassificationDataView rhs;
+    {
+        vector< UINT > lhsIndexes;
+        vector< UINT > rhsIndexes;
+        for(UINT i=0; i<M; i++){
+            if( node->predict( trainingData[i].getSample() ) ){
+                rhsIndexes.push_back( trainingData.getIndex(i) );
+            }else lhsIndexes.push_back( trainingData.getIndex(i) );
+        }
+        lhs = ClassificationDataView( *trainingData.getData(), lhsIndexes );
+        rhs = ClassificationDataView( *trainingData.getData(), rhsIndexes );
     }
     
     //Clear the parent dataset so we do not run out of memory with very large datasets (with very deep trees)
@@ -826,6 +890,17 @@ double DecisionTree::getNodeDistance( const VectorDouble &x, const VectorDouble
     return distance;
 }
     
+bool DecisionTree::buildFlatTree(){
+    
+    flatTree.clear();
+    
+    DecisionTreeNode *node = dynamic_cast< DecisionTreeNode* >( tree );
+    if( node == NULL ) return false;
+    
+    //The flat tree is only built for node types that split on a single feature, other node types are predicted with the tree itself
+    return flatTree.build( vector< DecisionTreeNode* >(1,node), numInputDimensions, numClasses );
+}
+    
 bool DecisionTree::loadLegacyModelFromFile_v1( fstream &file ){
     
     string word;
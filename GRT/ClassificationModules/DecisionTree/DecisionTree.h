@@ -41,6 +41,7 @@
 #include "DecisionTreeThresholdNode.h"
 #include "DecisionTreeClusterNode.h"
 #include "DecisionTreeTripleFeatureNode.h"
+#include "FlatDecisionForest.h"
 
 namespace GRT{
 
@@ -97,6 +98,15 @@ public:
      @return returns true if the DecisionTree model was trained, false otherwise
     */
     virtual bool train_(ClassificationData &trainingData);
+
+    /**
+     This trains the DecisionTree model, using a view of the labelled classification data.  The samples are not copied unless
+     scaling is enabled, so several trees can be trained from views of the same dataset (for example in a RandomForests model).
+     
+     @param ClassificationDataView &trainingData: a reference to a view of the training data
+     @return returns true if the DecisionTree model was trained, false otherwise
+    */
+    virtual bool train_(ClassificationDataView &trainingData);
     
     /**
      This predicts the class of the inputVector.
@@ -180,6 +190,15 @@ public:
      */
     bool setDecisionTreeNode( const DecisionTreeNode &node );
     
+    /**
+     Sets the seed of the random number generator used to train the tree.  Each node in the tree is seeded from this generator, so training
+     the tree with the same seed and the same data will always result in the same tree.  By default the seed is set using the system time.
+     
+     @param const unsigned long long seed: the new seed, if this is zero then the seed will be set using the current system time
+     @return returns true if the seed was set, false otherwise
+     */
+    bool setRandomSeed( const unsigned long long seed );
+    
     //Tell the compiler we are using the base class train method to stop hidden virtual function warnings
     using MLBase::saveModelToFile;
     using MLBase::loadModelFromFile;
@@ -192,12 +211,16 @@ protected:
     bool loadLegacyModelFromFile_v2( fstream &file );
     bool loadLegacyModelFromFile_v3( fstream &file );
     
-    DecisionTreeNode* buildTree(ClassificationData &trainingData, DecisionTreeNode *parent, vector< UINT > features, const vector< UINT > &classLabels, UINT nodeID );
+    bool trainTree(const ClassificationDataView &trainingData);
+    DecisionTreeNode* buildTree(ClassificationDataView &trainingData, DecisionTreeNode *parent, vector< UINT > features, const vector< UINT > &classLabels, UINT nodeID );
     double getNodeDistance( const VectorDouble &x, const UINT nodeID );
     double getNodeDistance( const VectorDouble &x, const VectorDouble &y );
+    bool buildFlatTree();
     
     DecisionTreeNode* decisionTreeNode;
+    FlatDecisionForest flatTree;        ///< A flat copy of the tree that is used for prediction, this is empty if the node type can not be flattened
     std::map< UINT, VectorDouble > nodeClusters;
+    Random random;
     VectorDouble classClusterMean;
     VectorDouble classClusterStdDev;
     static RegisterClassifierModule< DecisionTree > registerModule;
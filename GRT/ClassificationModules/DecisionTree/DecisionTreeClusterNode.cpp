@@ -154,17 +154,17 @@ bool DecisionTreeClusterNode::set(const UINT nodeSize,const UINT featureIndex,co
     return true;
 }
 
-bool DecisionTreeClusterNode::computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+bool DecisionTreeClusterNode::computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
 
     return computeBestSpilt( numSplittingSteps, trainingData, features, classLabels, featureIndex, minError);
 }
 
-bool DecisionTreeClusterNode::computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+bool DecisionTreeClusterNode::computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
 
     return computeBestSpilt( numSplittingSteps, trainingData, features, classLabels, featureIndex, minError);
 }
 
-bool DecisionTreeClusterNode::computeBestSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+bool DecisionTreeClusterNode::computeBestSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
 
     const UINT M = trainingData.getNumSamples();
     const UINT N = (UINT)features.size();
@@ -173,7 +173,6 @@ bool DecisionTreeClusterNode::computeBestSpilt( const UINT &numSplittingSteps, c
     if( N == 0 ) return false;
 
     minError = numeric_limits<double>::max();
-    Random random;
     UINT bestFeatureIndex = 0;
     double bestThreshold = 0;
     double error = 0;
@@ -212,7 +211,15 @@ bool DecisionTreeClusterNode::computeBestSpilt( const UINT &numSplittingSteps, c
         //Disable the logging to clean things up
         kmeans.setTrainingLoggingEnabled( false );
 
-        if( !kmeans.train( data ) ){
+        //Pick two random samples as the starting clusters, using the node's random number generator so the split only depends on the seed
+        MatrixDouble initialClusters(2,1);
+        UINT indexA = random.getRandomNumberInt(0,M);
+        UINT indexB = M > 1 ? (indexA + random.getRandomNumberInt(1,M)) % M : indexA;
+        initialClusters[0][0] = data[indexA][0];
+        initialClusters[1][0] = data[indexB][0];
+        kmeans.setClusters( initialClusters );
+
+        if( !kmeans.trainModel( data ) ){
             errorLog << "computeBestSpilt() - Failed to train KMeans model for feature: " << featureIndex << endl;
             return false;
         }
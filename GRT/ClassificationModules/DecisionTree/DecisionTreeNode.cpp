@@ -51,10 +51,14 @@ bool DecisionTreeNode::predict(const VectorDouble &x,VectorDouble &classLikeliho
         }
     }
     
-    return false;
+    //The split did not send any training samples to this side, so there is no child and this node's class probabilities are used instead
+    classLikelihoods = classProbabilities;
+    predictedNodeID = nodeID;
+    
+    return true;
 }
 
-bool DecisionTreeNode::computeBestSpilt( const UINT &trainingMode, const UINT &numSplittingSteps,const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+bool DecisionTreeNode::computeBestSpilt( const UINT &trainingMode, const UINT &numSplittingSteps,const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
     
     switch( trainingMode ){
         case Tree::BEST_ITERATIVE_SPILT:
@@ -172,6 +176,11 @@ bool DecisionTreeNode::setClassProbabilities(const VectorDouble &classProbabilit
     return true;
 }
     
+bool DecisionTreeNode::setRandomSeed(const unsigned long long seed){
+    random.setSeed( seed );
+    return true;
+}
+    
 UINT DecisionTreeNode::getClassLabelIndexValue(UINT classLabel,const vector< UINT > &classLabels){
     const UINT N = (UINT)classLabels.size();
     for(UINT i=0; i<N; i++){
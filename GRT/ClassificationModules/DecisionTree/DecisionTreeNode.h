@@ -33,7 +33,7 @@
 
 #include "../../CoreAlgorithms/Tree/Node.h"
 #include "../../CoreAlgorithms/Tree/Tree.h"
-#include "../../DataStructures/ClassificationData.h"
+#include "../../DataStructures/ClassificationDataView.h"
 
 namespace GRT{
     
@@ -71,14 +71,14 @@ public:
      
      @param const UINT &trainingMode: the training mode to use, this should be one of the
      @param const UINT &numSplittingSteps: sets the number of iterations that will be used to search for the best threshold
-     @param const ClassificationData &trainingData: the training data to use for the best split search
+     @param const ClassificationDataView &trainingData: the training data to use for the best split search
      @param const const vector< UINT > &features: a vector containing the indexs of the features that can be used for the search
      @param const vector< UINT > &classLabels: a vector containing the class labels for the search
      @param UINT &featureIndex: this will store the best feature index found during the search
      @param double &minError: this will store the minimum error found during the search
      @return returns true if the best spliting algorithm found a split, false otherwise
      */
-    virtual bool computeBestSpilt( const UINT &trainingMode, const UINT &numSplittingSteps,const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError );
+    virtual bool computeBestSpilt( const UINT &trainingMode, const UINT &numSplittingSteps,const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError );
 
     /**
      This functions cleans up any dynamic memory assigned by the node.
@@ -159,19 +159,28 @@ public:
      */
     bool setClassProbabilities(const VectorDouble &classProbabilities);
     
+    /**
+     This function sets the seed of the random number generator used to search for the best split.  The DecisionTree sets the seed of each
+     node from its own random number generator, so a tree trained with the same seed and data is always the same.
+     
+     @param const unsigned long long seed: the new seed, if this is zero then the seed will be set using the current system time
+     @return returns true if the seed was set, false otherwise
+     */
+    bool setRandomSeed(const unsigned long long seed);
+    
     static UINT getClassLabelIndexValue(UINT classLabel,const vector< UINT > &classLabels);
     
     using Node::predict;
     
 protected:
-    virtual bool computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+    virtual bool computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
         
         errorLog << "computeBestSpiltBestIterativeSpilt(...) - Base class not overwritten!" << endl;
         
         return false;
     }
     
-    virtual bool computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+    virtual bool computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
         
         errorLog << "computeBestSpiltBestRandomSpilt(...) - Base class not overwritten!" << endl;
         
@@ -260,6 +269,7 @@ protected:
     
     UINT nodeSize;
     VectorDouble classProbabilities;
+    Random random;                          ///< Used by the best split search, this is seeded by the DecisionTree before the node is trained
     
     static RegisterNode< DecisionTreeNode > registerModule;
 };
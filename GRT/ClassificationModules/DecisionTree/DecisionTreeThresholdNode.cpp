@@ -126,74 +126,48 @@ bool DecisionTreeThresholdNode::set(const UINT nodeSize,const UINT featureIndex,
     return true;
 }
 
-bool DecisionTreeThresholdNode::computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+bool DecisionTreeThresholdNode::computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
     
     const UINT M = trainingData.getNumSamples();
     const UINT N = (UINT)features.size();
     const UINT K = (UINT)classLabels.size();
     
-    if( N == 0 ) return false;
+    if( N == 0 || M == 0 ) return false;
     
     minError = numeric_limits<double>::max();
     UINT bestFeatureIndex = 0;
     double bestThreshold = 0;
-    double error = 0;
-    double minRange = 0;
-    double maxRange = 0;
-    double step = 0;
-    double giniIndexL = 0;
-    double giniIndexR = 0;
-    double weightL = 0;
-    double weightR = 0;
-    vector< UINT > groupIndex(M);
-    VectorDouble groupCounter(2,0);
     vector< MinMax > ranges = trainingData.getRanges();
-    
-    MatrixDouble classProbabilities(K,2);
+    vector< UINT > classIndex(M);
+    VectorDouble featureBuffer;
+    VectorDouble thresholds;
+    VectorDouble errors;
+    SplitSearch splitSearch;
+
+    //Find the class index of each sample once, rather than searching the class labels for every threshold
+    for(UINT i=0; i<M; i++){
+        classIndex[i] = getClassLabelIndexValue(trainingData[i].getClassLabel(),classLabels);
+    }
     
     //Loop over each feature and try and find the best split point
     for(UINT n=0; n<N; n++){
-        minRange = ranges[n].minValue;
-        maxRange = ranges[n].maxValue;
-        step = (maxRange-minRange)/double(numSplittingSteps);
-        threshold = minRange;
         featureIndex = features[n];
-        while( threshold <= maxRange ){
-            
-            //Iterate over each sample and work out if it should be in the lhs (0) or rhs (1) group
-            groupCounter[0] = groupCounter[1] = 0;
-            classProbabilities.setAllValues(0);
-            for(UINT i=0; i<M; i++){
-                groupIndex[i] = trainingData[ i ][ featureIndex ] >= threshold ? 1 : 0;
-                groupCounter[ groupIndex[i] ]++;
-                classProbabilities[ getClassLabelIndexValue(trainingData[i].getClassLabel(),classLabels) ][ groupIndex[i] ]++;
-            }
-            
-            //Compute the class probabilities for the lhs group and rhs group
-            for(UINT k=0; k<K; k++){
-                classProbabilities[k][0] = groupCounter[0]>0 ? classProbabilities[k][0]/groupCounter[0] : 0;
-                classProbabilities[k][1] = groupCounter[1]>0 ? classProbabilities[k][1]/groupCounter[1] : 0;
-            }
-            
-            //Compute the Gini index for the lhs and rhs groups
-            giniIndexL = giniIndexR = 0;
-            for(UINT k=0; k<K; k++){
-                giniIndexL += classProbabilities[k][0] * (1.0-classProbabilities[k][0]);
-                giniIndexR += classProbabilities[k][1] * (1.0-classProbabilities[k][1]);
-            }
-            weightL = groupCounter[0]/M;
-            weightR = groupCounter[1]/M;
-            error = (giniIndexL*weightL) + (giniIndexR*weightR);
-            
-            //Store the best threshold and feature index
-            if( error < minError ){
-                minError = error;
-                bestThreshold = threshold;
+        
+        //Step through the range of the feature, the values are sorted once and then swept to find the error of every threshold
+        SplitSearch::getIterativeThresholds( ranges[featureIndex].minValue, ranges[featureIndex].maxValue, numSplittingSteps, thresholds );
+        splitSearch.sortFeature( getFeatureColumn( trainingData, featureIndex, featureBuffer ), M );
+        if( !splitSearch.computeGiniErrors( classIndex, K, thresholds, errors ) ){
+            errorLog << "computeBestSpiltBestIterativeSpilt(...) - Failed to compute the split errors for feature: " << featureIndex << endl;
+            return false;
+        }
+        
+        //Store the best threshold and feature index
+        for(UINT t=0; t<errors.size(); t++){
+            if( errors[t] < minError ){
+                minError = errors[t];
+                bestThreshold = thresholds[t];
                 bestFeatureIndex = featureIndex;
             }
-            
-            //Update the threshold
-            threshold += step;
         }
     }
     
@@ -206,65 +180,48 @@ bool DecisionTreeThresholdNode::computeBestSpiltBestIterativeSpilt( const UINT &
     return true;
 }
 
-bool DecisionTreeThresholdNode::computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
+bool DecisionTreeThresholdNode::computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError ){
     
     const UINT M = trainingData.getNumSamples();
     const UINT N = (UINT)features.size();
     const UINT K = (UINT)classLabels.size();
     
-    if( N == 0 ) return false;
+    if( N == 0 || M == 0 ) return false;
     
     minError = numeric_limits<double>::max();
     UINT bestFeatureIndex = 0;
     double bestThreshold = 0;
-    double error = 0;
-    double giniIndexL = 0;
-    double giniIndexR = 0;
-    double weightL = 0;
-    double weightR = 0;
-    Random random;
-    vector< UINT > groupIndex(M);
-    VectorDouble groupCounter(2,0);
     vector< MinMax > ranges = trainingData.getRanges();
-    
-    MatrixDouble classProbabilities(K,2);
+    vector< UINT > classIndex(M);
+    VectorDouble featureBuffer;
+    VectorDouble thresholds( numSplittingSteps );
+    VectorDouble errors;
+    SplitSearch splitSearch;
+
+    //Find the class index of each sample once, rather than searching the class labels for every threshold
+    for(UINT i=0; i<M; i++){
+        classIndex[i] = getClassLabelIndexValue(trainingData[i].getClassLabel(),classLabels);
+    }
     
     //Loop over each feature and try and find the best split point
     for(UINT n=0; n<N; n++){
         featureIndex = features[n];
+        
+        //Randomly choose the thresholds, then sort the values once and sweep them to find the error of every threshold
         for(UINT m=0; m<numSplittingSteps; m++){
-            //Randomly choose the threshold
-            threshold = random.getRandomNumberUniform(ranges[n].minValue,ranges[n].maxValue);
-            
-            //Iterate over each sample and work out if it should be in the lhs (0) or rhs (1) group
-            groupCounter[0] = groupCounter[1] = 0;
-            classProbabilities.setAllValues(0);
-            for(UINT i=0; i<M; i++){
-                groupIndex[i] = trainingData[ i ][ featureIndex ] >= threshold ? 1 : 0;
-                groupCounter[ groupIndex[i] ]++;
-                classProbabilities[ getClassLabelIndexValue(trainingData[i].getClassLabel(),classLabels) ][ groupIndex[i] ]++;
-            }
-            
-            //Compute the class probabilities for the lhs group and rhs group
-            for(UINT k=0; k<K; k++){
-                classProbabilities[k][0] = groupCounter[0]>0 ? classProbabilities[k][0]/groupCounter[0] : 0;
-                classProbabilities[k][1] = groupCounter[1]>0 ? classProbabilities[k][1]/groupCounter[1] : 0;
-            }
-            
-            //Compute the Gini index for the lhs and rhs groups
-            giniIndexL = giniIndexR = 0;
-            for(UINT k=0; k<K; k++){
-                giniIndexL += classProbabilities[k][0] * (1.0-classProbabilities[k][0]);
-                giniIndexR += classProbabilities[k][1] * (1.0-classProbabilities[k][1]);
-            }
-            weightL = groupCounter[0]/M;
-            weightR = groupCounter[1]/M;
-            error = (giniIndexL*weightL) + (giniIndexR*weightR);
-            
-            //Store the best threshold and feature index
-            if( error < minError ){
-                minError = error;
-                bestThreshold = threshold;
+            thresholds[m] = random.getRandomNumberUniform(ranges[featureIndex].minValue,ranges[featureIndex].maxValue);
+        }
+        splitSearch.sortFeature( getFeatureColumn( trainingData, featureIndex, featureBuffer ), M );
+        if( !splitSearch.computeGiniErrors( classIndex, K, thresholds, errors ) ){
+            errorLog << "computeBestSpiltBestRandomSpilt(...) - Failed to compute the split errors for feature: " << featureIndex << endl;
+            return false;
+        }
+        
+        //Store the best threshold and feature index
+        for(UINT m=0; m<numSplittingSteps; m++){
+            if( errors[m] < minError ){
+                minError = errors[m];
+                bestThreshold = thresholds[m];
                 bestFeatureIndex = featureIndex;
             }
         }
@@ -279,6 +236,26 @@ bool DecisionTreeThresholdNode::computeBestSpiltBestRandomSpilt( const UINT &num
     return true;
 }
 
+const double* DecisionTreeThresholdNode::getFeatureColumn( const ClassificationDataView &trainingData, const UINT featureIndex, VectorDouble &featureBuffer ){
+
+    const UINT M = trainingData.getNumSamples();
+    featureBuffer.resize( M );
+
+    //Copy the feature to a contiguous buffer, so it can be streamed for each threshold.  If the columns of the training data have been built
+    //then the feature is gathered from the column, otherwise it is read from each sample
+    const double *column = trainingData.getData()->getColumn( featureIndex );
+    if( column != NULL ){
+        for(UINT i=0; i<M; i++){
+            featureBuffer[i] = column[ trainingData.getIndex(i) ];
+        }
+    }else{
+        for(UINT i=0; i<M; i++){
+            featureBuffer[i] = trainingData[i][featureIndex];
+        }
+    }
+    return &featureBuffer[0];
+}
+
 bool DecisionTreeThresholdNode::saveParametersToFile(fstream &file) const{
     
     if(!file.is_open())
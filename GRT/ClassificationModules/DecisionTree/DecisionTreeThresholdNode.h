@@ -130,9 +130,20 @@ public:
     
 protected:
     
-    virtual bool computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError );
+    virtual bool computeBestSpiltBestIterativeSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError );
     
-    virtual bool computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationData &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError );
+    virtual bool computeBestSpiltBestRandomSpilt( const UINT &numSplittingSteps, const ClassificationDataView &trainingData, const vector< UINT > &features, const vector< UINT > &classLabels, UINT &featureIndex, double &minError );
+
+    /**
+     Copies the values of one feature for all the samples in the training data to the featureBuffer.  If the columns of the training data
+     have been built then the values are gathered from the column, otherwise they are read from each sample.
+
+     @param const ClassificationDataView &trainingData: the training data, this must contain at least one sample
+     @param const UINT featureIndex: the index of the feature
+     @param VectorDouble &featureBuffer: the buffer the feature will be copied to
+     @return returns a pointer to the values of the feature in the featureBuffer
+     */
+    static const double* getFeatureColumn( const ClassificationDataView &trainingData, const UINT featureIndex, VectorDouble &featureBuffer );
     
     /**
      This saves the DecisionTreeNode custom parameters to a file. It will be called automatically by the Node base class
@@ -0,0 +1,426 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "FlatDecisionForest.h"
+#include <cstring>
+
+namespace GRT{
+
+//The number of trees that are searched at the same time by predict
+#define GRT_FLAT_DECISION_FOREST_NUM_LANES 4
+
+//The value returned by flattenNode if a tree can not be flattened
+#define GRT_FLAT_DECISION_FOREST_INVALID_NODE 0xFFFFFFFF
+
+//The header of the binary layout, see saveToBinaryFile for the layout
+struct FlatDecisionForestHeader{
+    uint32_t numTrees;
+    uint32_t numNodes;
+    uint32_t numInputDimensions;
+    uint32_t numClasses;
+};
+
+FlatDecisionForest::FlatDecisionForest(){
+    errorLog.setProceedingText("[ERROR FlatDecisionForest]");
+    clear();
+}
+
+FlatDecisionForest::~FlatDecisionForest(){
+}
+
+bool FlatDecisionForest::build( const vector< DecisionTreeNode* > &trees, const UINT numInputDimensions, const UINT numClasses ){
+
+    clear();
+
+    if( trees.size() == 0 || numInputDimensions == 0 || numClasses == 0 ){
+        errorLog << "build(...) - There are no trees, input dimensions or classes!" << endl;
+        return false;
+    }
+
+    this->numInputDimensions = numInputDimensions;
+    this->numClasses = numClasses;
+    this->trees.resize( trees.size() );
+
+    for(size_t i=0; i<trees.size(); i++){
+        if( trees[i] == NULL ){
+            clear();
+            errorLog << "build(...) - Tree " << i << " is NULL!" << endl;
+            return false;
+        }
+
+        UINT maxDepth = 0;
+        const UINT rootIndex = flattenNode( trees[i], 0, maxDepth );
+
+        if( rootIndex == GRT_FLAT_DECISION_FOREST_INVALID_NODE ){
+            clear();
+            return false;
+        }
+
+        this->trees[i].rootIndex = rootIndex;
+        this->trees[i].depth = maxDepth;
+    }
+
+    return true;
+}
+
+bool FlatDecisionForest::clear(){
+
+    numInputDimensions = 0;
+    numClasses = 0;
+    trees.clear();
+    nodes.clear();
+    nodeInfo.clear();
+    classProbabilities.clear();
+
+    return true;
+}
+
+bool FlatDecisionForest::predict( const VectorDouble &x, VectorDouble &classDistances ) const{
+
+    const UINT numTrees = (UINT)trees.size();
+
+    if( numTrees == 0 ) return false;
+
+    if( classDistances.size() != numClasses ) classDistances.resize( numClasses );
+    std::fill(classDistances.begin(),classDistances.end(),0);
+
+    const FlatDecisionTreeNode *nodeData = &nodes[0];
+    const double *probabilityData = &classProbabilities[0];
+    const double *inputData = &x[0];
+    UINT nodeIndex[ GRT_FLAT_DECISION_FOREST_NUM_LANES ];
+
+    //Search a few trees at the same time, the trees are independent so the loads of each tree can overlap
+    for(UINT i=0; i<numTrees; i+=GRT_FLAT_DECISION_FOREST_NUM_LANES){
+        const UINT numLanes = numTrees-i < GRT_FLAT_DECISION_FOREST_NUM_LANES ? numTrees-i : GRT_FLAT_DECISION_FOREST_NUM_LANES;
+
+        UINT depth = 0;
+        for(UINT j=0; j<numLanes; j++){
+            nodeIndex[j] = trees[i+j].rootIndex;
+            if( trees[i+j].depth > depth ) depth = trees[i+j].depth;
+        }
+
+        //A leaf points to itself, so every tree can take the same number of steps
+        for(UINT d=0; d<depth; d++){
+            for(UINT j=0; j<numLanes; j++){
+                const FlatDecisionTreeNode &node = nodeData[ nodeIndex[j] ];
+                nodeIndex[j] = node.children[ inputData[ node.featureIndex ] >= node.threshold ? 1 : 0 ];
+            }
+        }
+
+        //Add the leaf probabilities in the order of the trees, so the sum matches searching the trees one at a time
+        for(UINT j=0; j<numLanes; j++){
+            const double *p = probabilityData + (size_t)nodeIndex[j]*numClasses;
+            for(UINT k=0; k<numClasses; k++){
+                classDistances[k] += p[k];
+            }
+        }
+    }
+
+    return true;
+}
+
+bool FlatDecisionForest::predict( const MatrixDouble &X, MatrixDouble &classDistances ) const{
+
+    const UINT numTrees = (UINT)trees.size();
+    const UINT M = X.getNumRows();
+
+    if( numTrees == 0 ) return false;
+
+    if( M > 0 && X.getNumCols() < numInputDimensions ){
+        errorLog << "predict(const MatrixDouble &X,MatrixDouble &classDistances) - The number of columns in X (" << X.getNumCols() << ") is less than the number of input dimensions (" << numInputDimensions << ")!" << endl;
+        return false;
+    }
+
+    classDistances.resize( M, numClasses );
+    classDistances.setAllValues( 0 );
+
+    const FlatDecisionTreeNode *nodeData = &nodes[0];
+    const double *probabilityData = &classProbabilities[0];
+
+    //Run all the inputs through one tree before moving to the next tree, so each tree is only loaded into the cache once
+    for(UINT i=0; i<numTrees; i++){
+        const UINT rootIndex = trees[i].rootIndex;
+        const UINT depth = trees[i].depth;
+
+        for(UINT n=0; n<M; n++){
+            const double *inputData = X[n];
+            UINT nodeIndex = rootIndex;
+            for(UINT d=0; d<depth; d++){
+                const FlatDecisionTreeNode &node = nodeData[ nodeIndex ];
+                nodeIndex = node.children[ inputData[ node.featureIndex ] >= node.threshold ? 1 : 0 ];
+            }
+
+            const double *p = probabilityData + (size_t)nodeIndex*numClasses;
+            double *y = classDistances[n];
+            for(UINT k=0; k<numClasses; k++){
+                y[k] += p[k];
+            }
+        }
+    }
+
+    return true;
+}
+
+bool FlatDecisionForest::predictTree( const UINT treeIndex, const VectorDouble &x, VectorDouble &classLikelihoods, UINT &predictedNodeID ) const{
+
+    if( treeIndex >= trees.size() ) return false;
+
+    UINT nodeIndex = trees[ treeIndex ].rootIndex;
+    const UINT depth = trees[ treeIndex ].depth;
+    for(UINT d=0; d<depth; d++){
+        const FlatDecisionTreeNode &node = nodes[ nodeIndex ];
+        nodeIndex = node.children[ x[ node.featureIndex ] >= node.threshold ? 1 : 0 ];
+    }
+
+    if( classLikelihoods.size() != numClasses ) classLikelihoods.resize( numClasses );
+    std::copy(classProbabilities.begin() + (size_t)nodeIndex*numClasses, classProbabilities.begin() + (size_t)(nodeIndex+1)*numClasses, classLikelihoods.begin());
+    predictedNodeID = nodeInfo[ nodeIndex ].nodeID;
+
+    return true;
+}
+
+bool FlatDecisionForest::getTrees( const DecisionTreeNode &node, vector< DecisionTreeNode* > &trees ) const{
+
+    if( dynamic_cast< const DecisionTreeThresholdNode* >( &node ) == NULL && dynamic_cast< const DecisionTreeClusterNode* >( &node ) == NULL ){
+        errorLog << "getTrees(...) - The trees can only be rebuilt with a DecisionTreeThresholdNode or DecisionTreeClusterNode!" << endl;
+        return false;
+    }
+
+    const UINT numNodes = (UINT)nodes.size();
+    vector< DecisionTreeNode* > newNodes( numNodes, NULL );
+    VectorDouble nodeProbabilities( numClasses );
+
+    //Create every node, then link each node to its children.  A child that points back to its parent was missing in the original tree.
+    for(UINT i=0; i<numNodes; i++){
+        newNodes[i] = dynamic_cast< DecisionTreeNode* >( node.createNewInstance() );
+        if( newNodes[i] == NULL ){
+            for(UINT j=0; j<i; j++) delete newNodes[j];
+            errorLog << "getTrees(...) - Failed to create a new node!" << endl;
+            return false;
+        }
+
+        std::copy(classProbabilities.begin() + (size_t)i*numClasses, classProbabilities.begin() + (size_t)(i+1)*numClasses, nodeProbabilities.begin());
+
+        DecisionTreeThresholdNode *thresholdNode = dynamic_cast< DecisionTreeThresholdNode* >( newNodes[i] );
+        DecisionTreeClusterNode *clusterNode = dynamic_cast< DecisionTreeClusterNode* >( newNodes[i] );
+        const UINT featureIndex = nodeInfo[i].isLeafNode ? 0 : nodes[i].featureIndex;
+        const double threshold = nodeInfo[i].isLeafNode ? 0 : nodes[i].threshold;
+        if( thresholdNode != NULL ) thresholdNode->set( nodeInfo[i].nodeSize, featureIndex, threshold, nodeProbabilities );
+        if( clusterNode != NULL ) clusterNode->set( nodeInfo[i].nodeSize, featureIndex, threshold, nodeProbabilities );
+
+        newNodes[i]->setDepth( nodeInfo[i].depth );
+        newNodes[i]->setNodeID( nodeInfo[i].nodeID );
+        newNodes[i]->setIsLeafNode( nodeInfo[i].isLeafNode != 0 );
+    }
+
+    for(UINT i=0; i<numNodes; i++){
+        if( nodeInfo[i].isLeafNode ) continue;
+        for(UINT j=0; j<2; j++){
+            const UINT childIndex = nodes[i].children[j];
+            if( childIndex == i ) continue;
+            newNodes[ childIndex ]->setParent( newNodes[i] );
+            if( j == 0 ) newNodes[i]->setLeftChild( newNodes[ childIndex ] );
+            else newNodes[i]->setRightChild( newNodes[ childIndex ] );
+        }
+    }
+
+    trees.resize( this->trees.size() );
+    for(size_t i=0; i<this->trees.size(); i++){
+        trees[i] = newNodes[ this->trees[i].rootIndex ];
+    }
+
+    return true;
+}
+
+uint64_t FlatDecisionForest::getBinarySize() const{
+    return sizeof(FlatDecisionForestHeader) + trees.size() * sizeof(FlatDecisionTreeInfo) + nodes.size() * (sizeof(FlatDecisionTreeNode) + sizeof(FlatDecisionTreeNodeInfo)) + classProbabilities.size() * sizeof(double);
+}
+
+bool FlatDecisionForest::saveToBinaryFile( fstream &file ) const{
+
+    if( !file.is_open() ){
+        errorLog << "saveToBinaryFile(fstream &file) - The file is not open!" << endl;
+        return false;
+    }
+
+    if( !getIsBuilt() ){
+        errorLog << "saveToBinaryFile(fstream &file) - The layout has not been built!" << endl;
+        return false;
+    }
+
+    //The layout is the header, the tree table, the nodes, the node settings and then the class probabilities of each node
+    FlatDecisionForestHeader header;
+    memset( &header, 0, sizeof(header) );
+    header.numTrees = (uint32_t)trees.size();
+    header.numNodes = (uint32_t)nodes.size();
+    header.numInputDimensions = numInputDimensions;
+    header.numClasses = numClasses;
+
+    file.write( (const char*)&header, sizeof(header) );
+    file.write( (const char*)&trees[0], trees.size() * sizeof(FlatDecisionTreeInfo) );
+    file.write( (const char*)&nodes[0], nodes.size() * sizeof(FlatDecisionTreeNode) );
+    file.write( (const char*)&nodeInfo[0], nodeInfo.size() * sizeof(FlatDecisionTreeNodeInfo) );
+    file.write( (const char*)&classProbabilities[0], classProbabilities.size() * sizeof(double) );
+
+    return file.good();
+}
+
+bool FlatDecisionForest::loadFromBinaryData( const char *data, const uint64_t size ){
+
+    clear();
+
+    FlatDecisionForestHeader header;
+    if( data == NULL || size < sizeof(header) ){
+        errorLog << "loadFromBinaryData(...) - There is not enough data for the header!" << endl;
+        return false;
+    }
+    memcpy( &header, data, sizeof(header) );
+
+    if( header.numTrees == 0 || header.numNodes == 0 || header.numInputDimensions == 0 || header.numClasses == 0 ){
+        errorLog << "loadFromBinaryData(...) - The layout has no trees, nodes, input dimensions or classes!" << endl;
+        return false;
+    }
+
+    const uint64_t treesSize = (uint64_t)header.numTrees * sizeof(FlatDecisionTreeInfo);
+    const uint64_t nodesSize = (uint64_t)header.numNodes * sizeof(FlatDecisionTreeNode);
+    const uint64_t nodeInfoSize = (uint64_t)header.numNodes * sizeof(FlatDecisionTreeNodeInfo);
+    const uint64_t probabilitiesSize = (uint64_t)header.numNodes * header.numClasses * sizeof(double);
+    if( sizeof(header) + treesSize + nodesSize + nodeInfoSize + probabilitiesSize > size ){
+        errorLog << "loadFromBinaryData(...) - The layout is larger than the data!" << endl;
+        return false;
+    }
+
+    numInputDimensions = header.numInputDimensions;
+    numClasses = header.numClasses;
+    trees.resize( header.numTrees );
+    nodes.resize( header.numNodes );
+    nodeInfo.resize( header.numNodes );
+    classProbabilities.resize( (size_t)header.numNodes * header.numClasses );
+
+    const char *position = data + sizeof(header);
+    memcpy( &trees[0], position, treesSize );
+    position += treesSize;
+    memcpy( &nodes[0], position, nodesSize );
+    position += nodesSize;
+    memcpy( &nodeInfo[0], position, nodeInfoSize );
+    position += nodeInfoSize;
+    memcpy( &classProbabilities[0], position, probabilitiesSize );
+
+    if( !validate() ){
+        clear();
+        errorLog << "loadFromBinaryData(...) - The layout contains an invalid node!" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+UINT FlatDecisionForest::flattenNode( const DecisionTreeNode *node, const UINT depth, UINT &maxDepth ){
+
+    if( node->getNumClasses() != numClasses ){
+        errorLog << "flattenNode(...) - The node has " << node->getNumClasses() << " class probabilities, expected " << numClasses << "!" << endl;
+        return GRT_FLAT_DECISION_FOREST_INVALID_NODE;
+    }
+
+    //Add this node, the children are added after it so the indexes are only known once they have been flattened
+    const UINT index = (UINT)nodes.size();
+    FlatDecisionTreeNode flatNode;
+    memset( &flatNode, 0, sizeof(flatNode) );
+    flatNode.children[0] = flatNode.children[1] = index;
+    nodes.push_back( flatNode );
+
+    FlatDecisionTreeNodeInfo info;
+    info.nodeID = node->getNodeID();
+    info.nodeSize = node->getNodeSize();
+    info.depth = node->getDepth();
+    info.isLeafNode = node->getIsLeafNode() ? 1 : 0;
+    nodeInfo.push_back( info );
+
+    const VectorDouble nodeProbabilities = node->getClassProbabilities();
+    classProbabilities.insert( classProbabilities.end(), nodeProbabilities.begin(), nodeProbabilities.end() );
+
+    if( node->getIsLeafNode() ){
+        if( depth > maxDepth ) maxDepth = depth;
+        return index;
+    }
+
+    const DecisionTreeThresholdNode *thresholdNode = dynamic_cast< const DecisionTreeThresholdNode* >( node );
+    const DecisionTreeClusterNode *clusterNode = dynamic_cast< const DecisionTreeClusterNode* >( node );
+
+    if( thresholdNode != NULL ){
+        nodes[ index ].featureIndex = thresholdNode->getFeatureIndex();
+        nodes[ index ].threshold = thresholdNode->getThreshold();
+    }else if( clusterNode != NULL ){
+        nodes[ index ].featureIndex = clusterNode->getFeatureIndex();
+        nodes[ index ].threshold = clusterNode->getThreshold();
+    }else return GRT_FLAT_DECISION_FOREST_INVALID_NODE; //Other nodes do not split on a single feature, so the tree can not be flattened
+
+    if( nodes[ index ].featureIndex >= numInputDimensions ){
+        errorLog << "flattenNode(...) - The feature index of the node (" << nodes[ index ].featureIndex << ") is out of bounds!" << endl;
+        return GRT_FLAT_DECISION_FOREST_INVALID_NODE;
+    }
+
+    //A missing child is left pointing at this node, so a search that goes that way stops here
+    if( depth + 1 > maxDepth ) maxDepth = depth + 1;
+
+    const Node *children[2] = { node->getLeftChild(), node->getRightChild() };
+    for(UINT j=0; j<2; j++){
+        if( children[j] == NULL ) continue;
+
+        const UINT childIndex = flattenNode( dynamic_cast< const DecisionTreeNode* >( children[j] ), depth + 1, maxDepth );
+        if( childIndex == GRT_FLAT_DECISION_FOREST_INVALID_NODE ) return GRT_FLAT_DECISION_FOREST_INVALID_NODE;
+        nodes[ index ].children[j] = childIndex;
+    }
+
+    return index;
+}
+
+bool FlatDecisionForest::validate() const{
+
+    const UINT numNodes = (UINT)nodes.size();
+
+    if( nodeInfo.size() != numNodes || classProbabilities.size() != (size_t)numNodes*numClasses ) return false;
+
+    //Each node must be the root of one tree or the child of one node, and a child must come after its parent, so the trees have no loops
+    vector< UINT > numParents( numNodes, 0 );
+
+    for(size_t i=0; i<trees.size(); i++){
+        if( trees[i].rootIndex >= numNodes || trees[i].depth > numNodes ) return false;
+        numParents[ trees[i].rootIndex ]++;
+    }
+
+    for(UINT i=0; i<numNodes; i++){
+        if( nodes[i].featureIndex >= numInputDimensions ) return false;
+        for(UINT j=0; j<2; j++){
+            const UINT childIndex = nodes[i].children[j];
+            if( childIndex == i ) continue;
+            if( nodeInfo[i].isLeafNode || childIndex <= i || childIndex >= numNodes ) return false;
+            numParents[ childIndex ]++;
+        }
+    }
+
+    for(UINT i=0; i<numNodes; i++){
+        if( numParents[i] != 1 ) return false;
+    }
+
+    return true;
+}
+
+} //End of namespace GRT
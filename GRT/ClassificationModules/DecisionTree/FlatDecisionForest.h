@@ -0,0 +1,201 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The FlatDecisionForest class stores one or more trained decision trees in a compact layout that is used for prediction.
+
+ A trained DecisionTree is a set of DecisionTreeNode objects, linked by pointers and spread over the heap, with a virtual function call at
+ each node.  The FlatDecisionForest copies the trees into one contiguous array of nodes, where each node only holds the feature index, the
+ threshold and the index of its two children.  The class probabilities of each node are stored in a separate array, so they do not take
+ up space in the cache while the trees are searched.
+
+ Each tree is searched with a fixed number of steps (the depth of the tree).  A leaf node points to itself, so a search that reaches a leaf
+ early stays at the leaf, and the next node is picked by indexing the children with the result of the comparison rather than with a branch.
+ The trees are searched a few at a time in an interleaved loop, so the memory loads of several trees can be in flight at the same time.
+
+ Only trees built from DecisionTreeThresholdNode or DecisionTreeClusterNode nodes can be flattened, as these nodes split on a single
+ feature and threshold.  The predictions of the FlatDecisionForest are the same as the predictions of the original trees.
+
+ Example:
+ @code
+ FlatDecisionForest flatForest;
+ flatForest.build( forest, numInputDimensions, numClasses );
+
+ VectorDouble classDistances;
+ flatForest.predict( inputVector, classDistances );
+ @endcode
+ */
+
+/**
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_FLAT_DECISION_FOREST_HEADER
+#define GRT_FLAT_DECISION_FOREST_HEADER
+
+#include "DecisionTreeNode.h"
+#include "DecisionTreeThresholdNode.h"
+#include "DecisionTreeClusterNode.h"
+#include <stdint.h>
+
+namespace GRT{
+
+//A node in the flat layout, a leaf node has both children set to its own index
+struct FlatDecisionTreeNode{
+    double threshold;
+    uint32_t featureIndex;
+    uint32_t children[2];               //The index of the left child (x[featureIndex] < threshold) and the right child
+    uint32_t reserved;
+};
+
+//The root node and number of search steps of each tree in the flat layout
+struct FlatDecisionTreeInfo{
+    uint32_t rootIndex;
+    uint32_t depth;
+};
+
+//The settings of each node that are only needed to rebuild the original tree, these are not used for prediction
+struct FlatDecisionTreeNodeInfo{
+    uint32_t nodeID;
+    uint32_t nodeSize;
+    uint32_t depth;
+    uint32_t isLeafNode;
+};
+
+class FlatDecisionForest{
+public:
+    /**
+     Default Constructor
+     */
+    FlatDecisionForest();
+
+    /**
+     Default Destructor
+     */
+    ~FlatDecisionForest();
+
+    /**
+     Builds the flat layout from the trees.  Any previous layout will be cleared.  This will fail if any of the nodes are not a
+     DecisionTreeThresholdNode or DecisionTreeClusterNode (no error is logged in this case, as it is expected for other node types), in which
+     case the trees should be used for prediction instead.
+
+     @param const vector< DecisionTreeNode* > &trees: the trees that will be flattened
+     @param const UINT numInputDimensions: the number of input dimensions of the model
+     @param const UINT numClasses: the number of classes of the model, each node must have one class probability for each class
+     @return returns true if the layout was built, false otherwise
+     */
+    bool build( const vector< DecisionTreeNode* > &trees, const UINT numInputDimensions, const UINT numClasses );
+
+    /**
+     Clears the layout.
+
+     @return returns true if the layout was cleared, false otherwise
+     */
+    bool clear();
+
+    /**
+     Computes the sum of the class probabilities of the leaf that x reaches in each tree.  The size of x is not checked, it must
+     have at least numInputDimensions values.
+
+     @param const VectorDouble &x: the input vector
+     @param VectorDouble &classDistances: this will store the sum of the class probabilities over all the trees
+     @return returns true if the prediction was computed, false otherwise
+     */
+    bool predict( const VectorDouble &x, VectorDouble &classDistances ) const;
+
+    /**
+     Computes the sum of the class probabilities over all the trees for each row of X.  The trees are searched one at a time for all
+     the rows, so each tree is only loaded into the cache once.
+
+     @param const MatrixDouble &X: the input vectors, with one row per input vector
+     @param MatrixDouble &classDistances: this will store the sum of the class probabilities of each input vector, with one row per input vector
+     @return returns true if the predictions were computed, false otherwise
+     */
+    bool predict( const MatrixDouble &X, MatrixDouble &classDistances ) const;
+
+    /**
+     Gets the class probabilities and the node ID of the leaf that x reaches in one tree.
+
+     @param const UINT treeIndex: the index of the tree
+     @param const VectorDouble &x: the input vector
+     @param VectorDouble &classLikelihoods: this will store the class probabilities of the leaf
+     @param UINT &predictedNodeID: this will store the node ID of the leaf
+     @return returns true if the prediction was computed, false otherwise
+     */
+    bool predictTree( const UINT treeIndex, const VectorDouble &x, VectorDouble &classLikelihoods, UINT &predictedNodeID ) const;
+
+    /**
+     Rebuilds the linked trees from the flat layout.  Each node is created as a new instance of the node argument, which must be a
+     DecisionTreeThresholdNode or DecisionTreeClusterNode.  The caller owns the new trees.
+
+     @param const DecisionTreeNode &node: the type of node that will be used to rebuild the trees
+     @param vector< DecisionTreeNode* > &trees: this will store the new trees
+     @return returns true if the trees were rebuilt, false otherwise
+     */
+    bool getTrees( const DecisionTreeNode &node, vector< DecisionTreeNode* > &trees ) const;
+
+    /**
+     Gets the number of bytes that saveToBinaryFile will write.
+
+     @return returns the size of the binary layout in bytes
+     */
+    uint64_t getBinarySize() const;
+
+    /**
+     Writes the layout to a binary file, as a small header followed by the tree table, the nodes, the node settings and the
+     class probabilities.  The file must already be open.
+
+     @param fstream &file: the file the layout will be written to
+     @return returns true if the layout was written, false otherwise
+     */
+    bool saveToBinaryFile( fstream &file ) const;
+
+    /**
+     Loads the layout from a block of memory written by saveToBinaryFile, such as part of a memory mapped file.  The indexes
+     of the nodes are checked so a corrupt file can not be used to read outside the layout.
+
+     @param const char *data: a pointer to the start of the layout
+     @param const uint64_t size: the number of bytes available at data
+     @return returns true if the layout was loaded, false otherwise
+     */
+    bool loadFromBinaryData( const char *data, const uint64_t size );
+
+    bool getIsBuilt() const{ return trees.size() > 0; }
+    UINT getNumTrees() const{ return (UINT)trees.size(); }
+    UINT getNumNodes() const{ return (UINT)nodes.size(); }
+    UINT getNumInputDimensions() const{ return numInputDimensions; }
+    UINT getNumClasses() const{ return numClasses; }
+
+protected:
+    UINT flattenNode( const DecisionTreeNode *node, const UINT depth, UINT &maxDepth );
+    bool validate() const;
+
+    UINT numInputDimensions;
+    UINT numClasses;
+    vector< FlatDecisionTreeInfo > trees;                   ///< The root and depth of each tree
+    vector< FlatDecisionTreeNode > nodes;                   ///< The nodes of all the trees, each tree is stored in depth first order
+    vector< FlatDecisionTreeNodeInfo > nodeInfo;            ///< The settings of each node that are only used to rebuild the trees
+    VectorDouble classProbabilities;                        ///< The class probabilities of each node, stored as a numNodes x numClasses buffer
+    ErrorLog errorLog;
+};
+
+} //End of namespace GRT
+
+#endif //GRT_FLAT_DECISION_FOREST_HEADER
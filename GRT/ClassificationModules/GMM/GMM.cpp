@@ -120,34 +120,38 @@ bool GMM::predict_(VectorDouble &x){
     }
 
 	UINT bestIndex = 0;
-	maxLikelihood = 0;
-    bestDistance = 0;
-    double sum = 0;
+    double bestLogLikelihood = -numeric_limits< double >::infinity();
 	for(UINT k=0; k<numClasses; k++){
-        classDistances[k] = computeMixtureLikelihood(x,k);
-        
-        //cout << "K: " << k << " Dist: " << classDistances[k] << endl;
-        classLikelihoods[k] = classDistances[k];
-        sum += classLikelihoods[k];
-		if( classLikelihoods[k] > bestDistance ){
-			bestDistance = classLikelihoods[k];
+        //Compute the log likelihood of each class, these are stored in the classLikelihoods until they are normalized below
+        classLikelihoods[k] = models[k].computeMixtureLogLikelihood(x);
+		if( classLikelihoods[k] > bestLogLikelihood ){
+			bestLogLikelihood = classLikelihoods[k];
 			bestIndex = k;
 		}
 	}
     
-    //Normalize the likelihoods
-    for(unsigned int k=0; k<numClasses; k++){
-        classLikelihoods[k] /= sum;
+    //Normalize the likelihoods relative to the best class, so the normalization does not fail if every class likelihood underflows
+    double sum = 0;
+    for(UINT k=0; k<numClasses; k++){
+        classDistances[k] = exp( classLikelihoods[k] );
+        classLikelihoods[k] = bestLogLikelihood > -numeric_limits< double >::infinity() ? exp( classLikelihoods[k] - bestLogLikelihood ) : 0;
+        sum += classLikelihoods[k];
+    }
+    if( sum > 0 ){
+        for(UINT k=0; k<numClasses; k++){
+            classLikelihoods[k] /= sum;
+        }
     }
+    bestDistance = classDistances[bestIndex];
     maxLikelihood = classLikelihoods[bestIndex];
     
     if( useNullRejection ){
         
         //cout << "Dist: " << classDistances[bestIndex] << " RejectionThreshold: " << models[bestIndex].getRejectionThreshold() << endl;
         
-        //If the best distance is below the modles rejection threshold then set the predicted class label as the best class label
+        //If the best log likelihood is above the models rejection threshold then set the predicted class label as the best class label
         //Otherwise set the predicted class label as the default null rejection class label of 0
-        if( classDistances[bestIndex] >= models[bestIndex].getNullRejectionThreshold() ){
+        if( bestLogLikelihood >= models[bestIndex].getLogNullRejectionThreshold() ){
             predictedClassLabel = models[bestIndex].getClassLabel();
         }else predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
    }else{
@@ -177,11 +181,14 @@ bool GMM::train_(ClassificationData &trainingData){
         warningLog << "train_(ClassificationData &trainingData) - The number of features in your training data is high (" << numInputDimensions << ").  The GMMClassifier does not work well with high dimensional data, you might get better results from one of the other classifiers." << endl;
     }
     
-    //Get the ranges of the training data if the training data is going to be scaled
+    //Get the ranges of the training data if the training data is going to be scaled, predict_ only scales the input if useScaling is
+    //true, so the training data must not be scaled otherwise
 	ranges = trainingData.getRanges();
-    if( !trainingData.scale(GMM_MIN_SCALE_VALUE, GMM_MAX_SCALE_VALUE) ){
-        errorLog << "train_(ClassificationData &trainingData) - Failed to scale training data!" << endl;
-        return false;
+    if( useScaling ){
+        if( !trainingData.scale(GMM_MIN_SCALE_VALUE, GMM_MAX_SCALE_VALUE) ){
+            errorLog << "train_(ClassificationData &trainingData) - Failed to scale training data!" << endl;
+            return false;
+        }
     }
 
     //Fit a Mixture Model to each class (independently)
@@ -217,18 +224,26 @@ bool GMM::train_(ClassificationData &trainingData){
                 return false;
             }
             models[k][j].det = ludcmp.det();
+            
+            //Compute the Cholesky factor, which is used to compute the log likelihood for the realtime prediction
+            if( !models[k][j].computeCholeskyFactor() ){
+                models.clear();
+                errorLog << "train_(ClassificationData &trainingData) - Failed to compute the Cholesky factor for class " << classLabel << ", the covariance matrix is not positive definite!" << endl;
+                return false;
+            }
         }
         
         //Compute the normalize factor
         models[k].recomputeNormalizationFactor();
         
-        //Compute the rejection thresholds
+        //Compute the rejection thresholds from the log likelihoods of the training data, the likelihoods of high dimensional data
+        //underflow in linear space
         double mu = 0;
         double sigma = 0;
         VectorDouble predictionResults(classData.getNumSamples(),0);
         for(UINT i=0; i<classData.getNumSamples(); i++){
             vector< double > sample = classData[i].getSample();
-            predictionResults[i] = models[k].computeMixtureLikelihood( sample );
+            predictionResults[i] = models[k].computeMixtureLogLikelihood( sample );
             mu += predictionResults[i];
         }
         
@@ -236,10 +251,11 @@ bool GMM::train_(ClassificationData &trainingData){
         mu /= double( classData.getNumSamples() );
         
         //Calculate the standard deviation
-        for(UINT i=0; i<classData.getNumSamples(); i++) 
-            sigma += SQR( (predictionResults[i]-mu) );
-        sigma = sqrt( sigma / (double(classData.getNumSamples())-1.0) );
-        sigma = 0.2;
+        if( classData.getNumSamples() > 1 ){
+            for(UINT i=0; i<classData.getNumSamples(); i++)
+                sigma += SQR( (predictionResults[i]-mu) );
+            sigma = sqrt( sigma / (double(classData.getNumSamples())-1.0) );
+        }
         
         //Set the models training mu and sigma 
         models[k].setTrainingMuAndSigma(mu,sigma);
@@ -278,6 +294,49 @@ double GMM::computeMixtureLikelihood(const VectorDouble &x,const UINT k){
     return models[k].computeMixtureLikelihood(x);
 }
     
+bool GMM::computeLogLikelihoods(const MatrixDouble &X,MatrixDouble &logLikelihoods){
+    
+    if( !trained ){
+        errorLog << "computeLogLikelihoods(const MatrixDouble &X,MatrixDouble &logLikelihoods) - Mixture Models have not been trained!" << endl;
+        return false;
+    }
+    
+    if( X.getNumCols() != numInputDimensions ){
+        errorLog << "computeLogLikelihoods(const MatrixDouble &X,MatrixDouble &logLikelihoods) - The number of columns in X (" << X.getNumCols() << ") does not match that of the number of features the model was trained with (" << numInputDimensions << ")." << endl;
+        return false;
+    }
+    
+    const UINT M = X.getNumRows();
+    logLikelihoods.resize(M,numClasses);
+    if( M == 0 ) return true;
+    
+    //Scale a copy of the data, so the input matrix is not changed
+    MatrixDouble scaledData;
+    if( useScaling ){
+        scaledData = X;
+        for(UINT i=0; i<M; i++){
+            for(UINT j=0; j<numInputDimensions; j++){
+                scaledData[i][j] = scale(X[i][j], ranges[j].minValue, ranges[j].maxValue, GMM_MIN_SCALE_VALUE, GMM_MAX_SCALE_VALUE);
+            }
+        }
+    }
+    const MatrixDouble &data = useScaling ? scaledData : X;
+    
+    //Each class writes its log likelihoods into a column buffer, which is then copied into the output matrix
+    VectorDouble classLogLikelihoods(M);
+    for(UINT k=0; k<numClasses; k++){
+        if( !models[k].computeMixtureLogLikelihoods(data,&classLogLikelihoods[0]) ){
+            errorLog << "computeLogLikelihoods(const MatrixDouble &X,MatrixDouble &logLikelihoods) - Failed to compute the log likelihoods for class " << models[k].getClassLabel() << endl;
+            return false;
+        }
+        for(UINT i=0; i<M; i++){
+            logLikelihoods[i][k] = classLogLikelihoods[i];
+        }
+    }
+    
+    return true;
+}
+    
 bool GMM::saveModelToFile(fstream &file) const{
     
     if( !trained ){
@@ -291,8 +350,8 @@ bool GMM::saveModelToFile(fstream &file) const{
         return false;
     }
     
-    //Write the header info
-    file << "GRT_GMM_MODEL_FILE_V2.0\n";
+    //Write the header info, the training mu and sigma are the statistics of the log likelihoods from version 3 of the file format
+    file << "GRT_GMM_MODEL_FILE_V3.0\n";
     
     //Write the classifier settings to the file
     if( !Classifier::saveBaseSettingsToFile(file) ){
@@ -368,11 +427,12 @@ bool GMM::loadModelFromFile(fstream &file){
         return loadLegacyModelFromFile( file );
     }
     
-    //Find the file type header
-    if(word != "GRT_GMM_MODEL_FILE_V2.0"){
+    //Find the file type header, version 2 files have the same layout but the training mu and sigma are not in log space
+    if(word != "GRT_GMM_MODEL_FILE_V2.0" && word != "GRT_GMM_MODEL_FILE_V3.0"){
         errorLog << "loadModelFromFile(fstream &file) - Could not find Model File Header" << endl;
         return false;
     }
+    const bool logSpaceTrainingStats = word == "GRT_GMM_MODEL_FILE_V3.0";
     
     //Load the base settings from the file
     if( !Classifier::loadBaseSettingsFromFile(file) ){
@@ -447,9 +507,6 @@ bool GMM::loadModelFromFile(fstream &file){
             }
             file >> trainingSigma;
             
-            //Set the training mu and sigma
-            models[k].setTrainingMuAndSigma(trainingMu, trainingSigma);
-            
             file >> word;
             if(word != "NullRejectionThreshold:"){
                 errorLog << "loadModelFromFile(fstream &file) - Could not find NullRejectionThreshold for model " << k+1 << endl;
@@ -457,8 +514,10 @@ bool GMM::loadModelFromFile(fstream &file){
             }
             file >>rejectionThreshold;
             
-            //Set the rejection threshold
-            models[k].setNullRejectionThreshold(rejectionThreshold);
+            //Set the training mu and sigma and the rejection threshold
+            if( logSpaceTrainingStats ){
+                models[k].setTrainingMuAndSigma(trainingMu, trainingSigma);
+            }else setLegacyNullRejectionThreshold(models[k],rejectionThreshold);
             
             //Resize the buffer for the mixture models
             models[k].resize(K);
@@ -513,6 +572,12 @@ bool GMM::loadModelFromFile(fstream &file){
                 
             }
             
+            //Recompute the Cholesky factors and the normalization factor in log space, these are used for the realtime prediction
+            if( !models[k].recomputeCholeskyFactors() ){
+                errorLog << "loadModelFromFile(fstream &file) - Failed to compute the Cholesky factors for model " << k+1 << endl;
+                return false;
+            }
+            
         }
         
         //Set the null rejection thresholds
@@ -554,6 +619,29 @@ bool GMM::recomputeNullRejectionThresholds(){
     return false;
 }
     
+bool GMM::setNullRejectionThresholds(VectorDouble newRejectionThresholds){
+    
+    if( !trained || newRejectionThresholds.size() != numClasses ){
+        errorLog << "setNullRejectionThresholds(VectorDouble newRejectionThresholds) - The model has not been trained or the number of thresholds does not match the number of classes!" << endl;
+        return false;
+    }
+    
+    //The thresholds are likelihoods, they are compared in log space so they must be greater than zero
+    for(UINT k=0; k<numClasses; k++){
+        if( !(newRejectionThresholds[k] > 0) ){
+            errorLog << "setNullRejectionThresholds(VectorDouble newRejectionThresholds) - The threshold for class " << models[k].getClassLabel() << " must be greater than zero!" << endl;
+            return false;
+        }
+    }
+    
+    for(UINT k=0; k<numClasses; k++){
+        models[k].setNullRejectionThreshold( newRejectionThresholds[k] );
+        nullRejectionThresholds[k] = models[k].getNullRejectionThreshold();
+    }
+    
+    return true;
+}
+    
 UINT GMM::getNumMixtureModels(){
     return numMixtureModels;
 }
@@ -585,6 +673,18 @@ bool GMM::setMaxIter(UINT maxIter){
     return false;
 }
     
+void GMM::setLegacyNullRejectionThreshold(MixtureModel &model,const double rejectionThreshold){
+    
+    //Files saved before version 3 store the training mu and sigma of the likelihoods rather than the log likelihoods, so the saved
+    //threshold is kept instead, whatever the nullRejectionCoeff.  Retrain the model to compute the threshold from the training data.
+    if( !model.setNullRejectionThreshold( rejectionThreshold ) ){
+        warningLog << "loadModelFromFile(fstream &file) - The NullRejectionThreshold for class " << model.getClassLabel() << " is not greater than zero, no samples will be rejected for this class!" << endl;
+        model.setTrainingMuAndSigma( -numeric_limits< double >::infinity(), 0 );
+        return;
+    }
+    model.setTrainingMuAndSigma( model.getLogNullRejectionThreshold(), 0 );
+}
+    
 bool GMM::loadLegacyModelFromFile( fstream &file ){
     
     string word;
@@ -719,9 +819,6 @@ bool GMM::loadLegacyModelFromFile( fstream &file ){
         }
         file >> trainingSigma;
         
-        //Set the training mu and sigma
-        models[k].setTrainingMuAndSigma(trainingMu, trainingSigma);
-        
         file >> word;
         if(word != "NullRejectionThreshold:"){
             errorLog << "loadModelFromFile(fstream &file) - Could not find NullRejectionThreshold for model " << k+1 << endl;
@@ -729,8 +826,8 @@ bool GMM::loadLegacyModelFromFile( fstream &file ){
         }
         file >>rejectionThreshold;
         
-        //Set the rejection threshold
-        models[k].setNullRejectionThreshold(rejectionThreshold);
+        //Set the rejection threshold, the training mu and sigma in legacy files are not in log space so they can not be used
+        setLegacyNullRejectionThreshold(models[k],rejectionThreshold);
         
         //Resize the buffer for the mixture models
         models[k].resize(K);
@@ -785,6 +882,12 @@ bool GMM::loadLegacyModelFromFile( fstream &file ){
             
         }
         
+        //Recompute the Cholesky factors and the normalization factor in log space, these are used for the realtime prediction
+        if( !models[k].recomputeCholeskyFactors() ){
+            errorLog << "loadModelFromFile(fstream &file) - Failed to compute the Cholesky factors for model " << k+1 << endl;
+            return false;
+        }
+        
     }
     
     //Set the null rejection thresholds
@@ -136,6 +136,16 @@ public:
     */
     virtual bool recomputeNullRejectionThresholds();
     
+    /**
+     This function manually sets the null rejection threshold of each class.  The thresholds are likelihoods, the same as the class
+     distances, so they must be greater than zero.
+     This overrides the setNullRejectionThresholds function in the GRT::Classifier base class.
+     
+     @param VectorDouble newRejectionThresholds: the new null rejection thresholds, there must be one threshold per class
+     @return returns true if the nullRejectionThresholds were updated successfully, false otherwise
+     */
+    virtual bool setNullRejectionThresholds(VectorDouble newRejectionThresholds);
+    
     /**
      This function returns the number of mixture models.
      
@@ -177,6 +187,16 @@ public:
      */
     bool setMaxIter(UINT maxIter);
     
+    /**
+     This function computes the log likelihood of each class for a batch of input vectors.  The input vectors are scaled first if
+     useScaling is enabled.  Each class scores all the input vectors at once, which is much faster than calling predict for each vector.
+     
+     @param const MatrixDouble &X: the input vectors, with one row per input vector
+     @param MatrixDouble &logLikelihoods: this will store the log likelihood of each class, with one row per input vector and one column per class
+     @return returns true if the log likelihoods were computed, false otherwise
+     */
+    bool computeLogLikelihoods(const MatrixDouble &X,MatrixDouble &logLikelihoods);
+    
     //Tell the compiler we are using the base class train method to stop hidden virtual function warnings
     using MLBase::saveModelToFile;
     using MLBase::loadModelFromFile;
@@ -186,6 +206,7 @@ public:
 protected:
     double computeMixtureLikelihood(const VectorDouble &x,UINT k);
     bool loadLegacyModelFromFile( fstream &file );
+    void setLegacyNullRejectionThreshold(MixtureModel &model,const double rejectionThreshold);
     
     UINT numMixtureModels;
     UINT maxIter;
@@ -34,6 +34,8 @@
 
 #include "../../CoreModules/Classifier.h"
 #include "../../ClusteringModules/GaussianMixtureModels/GaussianMixtureModels.h"
+#include "../../Util/Cholesky.h"
+#include "../../Util/MatrixKernels.h"
 
 namespace GRT {
     
@@ -41,6 +43,7 @@ class GuassModel{
 public:
     GuassModel(){
         det = 0;
+        logNormalizer = 0;
     }
     
     ~GuassModel(){
@@ -73,10 +76,91 @@ public:
         return true;
     }
     
+    /**
+     Computes the Cholesky factor of sigma and the log of the normalizing constant of the Gaussian, which are used to compute the log density.
+     This should be called whenever sigma is changed.
+     
+     @return returns true if the Cholesky factor was computed, false if sigma is not positive definite
+     */
+    bool computeCholeskyFactor(){
+        const UINT N = (UINT)mu.size();
+        if( N == 0 || sigma.getNumRows() != N || sigma.getNumCols() != N ) return false;
+        
+        Cholesky cholesky( sigma );
+        if( !cholesky.getSuccess() ){
+            choleskyFactor.clear();
+            return false;
+        }
+        choleskyFactor = cholesky.el;
+        
+        //The log of 1/( (2PI)^(N/2) * det^0.5 ), computed from the Cholesky factor so it can not overflow or underflow
+        logNormalizer = -0.5*N*log(TWO_PI) - 0.5*cholesky.logdet();
+        
+        return true;
+    }
+    
+    /**
+     Computes the log of the Gaussian density at x.  The Mahalanobis distance is computed by solving L*y = (x-mu), where L is the
+     Cholesky factor of sigma, so sigma is never inverted.  computeCholeskyFactor must have been called first.
+     
+     @param const VectorDouble &x: the input vector, this must have the same size as mu
+     @param VectorDouble &buffer: a buffer that is used for the triangular solve, this is resized if needed
+     @return returns the log density at x
+     */
+    double computeLogDensity(const VectorDouble &x,VectorDouble &buffer) const{
+        const UINT N = (UINT)mu.size();
+        if( x.size() != N || choleskyFactor.getNumRows() != N ) return -numeric_limits< double >::infinity();
+        if( buffer.size() < N ) buffer.resize( N );
+        for(UINT i=0; i<N; i++) buffer[i] = x[i]-mu[i];
+        
+        MatrixKernels::solveLowerTriangular(N,1,choleskyFactor[0],N,&buffer[0],1);
+        
+        double sum = 0;
+        for(UINT i=0; i<N; i++) sum += buffer[i]*buffer[i];
+        
+        return logNormalizer - 0.5*sum;
+    }
+    
+    /**
+     Computes the log of the Gaussian density at each row of X.  The triangular solve is run over all the rows at once.
+     computeCholeskyFactor must have been called first.
+     
+     @param const MatrixDouble &X: the input vectors, with one row per input vector
+     @param double *logDensities: a pointer to a buffer with at least X.getNumRows() values, the log densities will be written to this buffer
+     @param VectorDouble &buffer: a buffer that is used for the triangular solve, this is resized if needed
+     @return returns true if the log densities were computed, false otherwise
+     */
+    bool computeLogDensities(const MatrixDouble &X,double *logDensities,VectorDouble &buffer) const{
+        const UINT N = (UINT)mu.size();
+        const UINT M = X.getNumRows();
+        if( X.getNumCols() != N || choleskyFactor.getNumRows() != N ) return false;
+        if( M == 0 ) return true;
+        if( buffer.size() < M*N ) buffer.resize( M*N );
+        
+        //Store the differences dimension by dimension, so each column of the buffer is the difference for one row of X
+        for(UINT r=0; r<M; r++){
+            const double *x = X[r];
+            for(UINT i=0; i<N; i++) buffer[ i*M+r ] = x[i]-mu[i];
+        }
+        
+        MatrixKernels::solveLowerTriangular(N,M,choleskyFactor[0],N,&buffer[0],M);
+        
+        for(UINT r=0; r<M; r++) logDensities[r] = 0;
+        for(UINT i=0; i<N; i++){
+            const double *y = &buffer[ i*M ];
+            for(UINT r=0; r<M; r++) logDensities[r] += y[r]*y[r];
+        }
+        for(UINT r=0; r<M; r++) logDensities[r] = logNormalizer - 0.5*logDensities[r];
+        
+        return true;
+    }
+    
     double det;
+    double logNormalizer;               ///< The log of the normalizing constant of the Gaussian
     VectorDouble mu;
     MatrixDouble sigma;
     MatrixDouble invSigma;
+    MatrixDouble choleskyFactor;        ///< The lower triangular Cholesky factor of sigma
 };
     
 class MixtureModel{
@@ -85,7 +169,9 @@ public:
         classLabel = 0;
         K = 0;
         normFactor = 1;
+        logNormFactor = 0;
         nullRejectionThreshold = 0;
+        logNullRejectionThreshold = -numeric_limits< double >::infinity();
         trainingMu = 0;
         trainingSigma = 0;
         gamma = 1;
@@ -103,12 +189,54 @@ public:
 	}
     
     double computeMixtureLikelihood(const vector<double> &x){
-        double sum = 0;
+        return exp( computeMixtureLogLikelihood(x) );
+    }
+    
+    /**
+     Computes the log of the normalized mixture likelihood at x.  The components are summed with the log-sum-exp trick, so the result
+     does not underflow when the likelihood of every component is too small to be stored as a double.
+     
+     @param const VectorDouble &x: the input vector
+     @return returns the log of the normalized mixture likelihood
+     */
+    double computeMixtureLogLikelihood(const VectorDouble &x){
+        if( componentLogDensities.size() < K ) componentLogDensities.resize( K );
+        for(UINT k=0; k<K; k++){
+            componentLogDensities[k] = gaussModels[k].computeLogDensity(x,solveBuffer);
+        }
+        return logSumExp(&componentLogDensities[0],K,1) - logNormFactor;
+    }
+    
+    /**
+     Computes the log of the normalized mixture likelihood at each row of X.
+     
+     @param const MatrixDouble &X: the input vectors, with one row per input vector
+     @param double *logLikelihoods: a pointer to a buffer with at least X.getNumRows() values, the log likelihoods will be written to this buffer
+     @return returns true if the log likelihoods were computed, false otherwise
+     */
+    bool computeMixtureLogLikelihoods(const MatrixDouble &X,double *logLikelihoods){
+        const UINT M = X.getNumRows();
+        if( componentLogDensities.size() < K*M ) componentLogDensities.resize( K*M );
+        for(UINT k=0; k<K; k++){
+            if( !gaussModels[k].computeLogDensities(X,&componentLogDensities[k*M],solveBuffer) ) return false;
+        }
+        for(UINT r=0; r<M; r++){
+            logLikelihoods[r] = logSumExp(&componentLogDensities[r],K,M) - logNormFactor;
+        }
+        return true;
+    }
+    
+    /**
+     Computes the Cholesky factor of each component, and then recomputes the normalization factor.  This should be called whenever
+     the components are changed.
+     
+     @return returns true if the Cholesky factors were computed, false if any of the covariance matrices are not positive definite
+     */
+    bool recomputeCholeskyFactors(){
         for(UINT k=0; k<K; k++){
-            sum += gauss(x,gaussModels[k].det,gaussModels[k].mu,gaussModels[k].invSigma);
+            if( !gaussModels[k].computeCholeskyFactor() ) return false;
         }
-        //Normalize the mixture likelihood
-        return sum/normFactor;
+        return recomputeNormalizationFactor();
     }
     
     bool resize(UINT K){
@@ -121,26 +249,34 @@ public:
         return false;
     }
     
+    /**
+     Recomputes the null rejection threshold from the mean and standard deviation of the log likelihoods of the training data,
+     the threshold is set gamma standard deviations below the mean log likelihood.
+     
+     @param double gamma: the number of standard deviations below the mean log likelihood to set the threshold
+     @return returns true if the null rejection threshold was updated, false if the training mu or sigma are not valid
+     */
     bool recomputeNullRejectionThreshold(double gamma){
-        double newRejectionThreshold = 0;
-        //TODO - Need a way of improving the null rejection threshold for the GMMs!!!!
-        newRejectionThreshold = trainingMu - (trainingSigma*gamma);
-        newRejectionThreshold = 0.02;
+        double newLogRejectionThreshold = trainingMu - (trainingSigma*gamma);
         
-        //Make sure that the new rejection threshold is greater than zero
-        if( newRejectionThreshold > 0 ){
+        //The threshold is in log space, so any finite value is valid
+        if( !grt_isinf( newLogRejectionThreshold ) && !grt_isnan( newLogRejectionThreshold ) ){
             this->gamma = gamma;
-            this->nullRejectionThreshold = newRejectionThreshold;
+            this->logNullRejectionThreshold = newLogRejectionThreshold;
+            this->nullRejectionThreshold = exp( newLogRejectionThreshold );
             return true;
         }
         return false;
     }
     
     bool recomputeNormalizationFactor(){
-        normFactor = 0;
+        //The normalization factor is the sum of the peak density of each component, the density of a component at its mean is its normalizer
+        if( componentLogDensities.size() < K ) componentLogDensities.resize( K );
         for(UINT k=0; k<K; k++){
-            normFactor += gauss(gaussModels[k].mu,gaussModels[k].det,gaussModels[k].mu,gaussModels[k].invSigma);
+            componentLogDensities[k] = gaussModels[k].logNormalizer;
         }
+        logNormFactor = logSumExp(&componentLogDensities[0],K,1);
+        normFactor = exp( logNormFactor );
         return true;
     }
     
@@ -169,10 +305,24 @@ public:
         return nullRejectionThreshold;
     }
     
+    /**
+     Gets the log of the null rejection threshold, this is the value that the log likelihood of an input vector is compared with.
+     Unlike the linear threshold, this does not underflow to zero for high dimensional data.
+     
+     @return returns the log of the null rejection threshold
+     */
+    double getLogNullRejectionThreshold() const {
+        return logNullRejectionThreshold;
+    }
+    
     double getNormalizationFactor() const {
         return normFactor;
     }
     
+    double getLogNormalizationFactor() const {
+        return logNormFactor;
+    }
+    
     bool setClassLabel(const UINT classLabel){
         this->classLabel = classLabel;
         return true;
@@ -180,6 +330,7 @@ public:
     
     bool setNormalizationFactor(const double normFactor){
         this->normFactor = normFactor;
+        this->logNormFactor = log( normFactor );
         return true;
     }
     
@@ -189,41 +340,47 @@ public:
         return true;
     }
     
+    /**
+     Sets the null rejection threshold.  The threshold is a likelihood, so it must be greater than zero.
+     
+     @param const double nullRejectionThreshold: the new null rejection threshold, this must be greater than zero
+     @return returns true if the null rejection threshold was updated, false otherwise
+     */
     bool setNullRejectionThreshold(const double nullRejectionThreshold){
+        if( !(nullRejectionThreshold > 0) || grt_isinf( nullRejectionThreshold ) ) return false;
         this->nullRejectionThreshold = nullRejectionThreshold;
+        this->logNullRejectionThreshold = log( nullRejectionThreshold );
         return true;
     }
     
 private:    
-    double gauss(const VectorDouble &x,double det,const VectorDouble &mu,const MatrixDouble &invSigma){
-        
-        double y = 0;
+    //Computes log( sum_k exp( values[k*stride] ) ) for k in [0 K-1], without underflow
+    static double logSumExp(const double *values,const UINT K,const UINT stride){
+        if( K == 0 ) return -numeric_limits< double >::infinity();
+        double maxValue = values[0];
+        for(UINT k=1; k<K; k++){
+            if( values[k*stride] > maxValue ) maxValue = values[k*stride];
+        }
+        if( maxValue == -numeric_limits< double >::infinity() ) return maxValue;
         double sum = 0;
-        const UINT N = (UINT)x.size();
-        VectorDouble temp(N,0);
-        
-        //Compute the first part of the equation
-        y = (1.0/pow(TWO_PI,N/2.0)) * (1.0/pow(det,0.5));
-        
-        //Compute the later half    
-        for(UINT i=0; i<N; i++){
-            for(UINT j=0; j<N; j++){
-                temp[i] += (x[j]-mu[j]) * invSigma[j][i];
-            }
-            sum += (x[i]-mu[i]) * temp[i];
+        for(UINT k=0; k<K; k++){
+            sum += exp( values[k*stride] - maxValue );
         }
-        
-        return ( y*exp( -0.5*sum ) );
+        return maxValue + log( sum );
     }
     
     UINT classLabel;
     UINT K;
     double nullRejectionThreshold;
+    double logNullRejectionThreshold;       //The log of the null rejection threshold, this is used for the prediction
     double gamma;                           //The number of standard deviations to use for the threshold
-	double trainingMu;                      //The average confidence value in the training data
-	double trainingSigma;                   //The simga confidence value in the training data
+	double trainingMu;                      //The average log likelihood of the training data
+	double trainingSigma;                   //The standard deviation of the log likelihood of the training data
     double normFactor;
+    double logNormFactor;
     vector< GuassModel > gaussModels;
+    VectorDouble componentLogDensities;     //A buffer for the log density of each component
+    VectorDouble solveBuffer;               //A buffer for the triangular solve
     
 };
     
@@ -33,6 +33,8 @@ ContinuousHiddenMarkovModel::ContinuousHiddenMarkovModel(const UINT downsampleFa
     modelType = HMM_LEFTRIGHT;
 	cThreshold = 0;
     useScaling = false;
+    predictionMode = HMM_BUFFERED_PREDICTION;
+    onlineWindowSize = 0;
     
     debugLog.setProceedingText("[DEBUG ContinuousHiddenMarkovModel]");
     errorLog.setProceedingText("[ERROR ContinuousHiddenMarkovModel]");
@@ -61,6 +63,15 @@ ContinuousHiddenMarkovModel::ContinuousHiddenMarkovModel(const ContinuousHiddenM
 	this->delta = rhs.delta;
 	this->loglikelihood = rhs.loglikelihood;
 	this->cThreshold = rhs.cThreshold;
+    this->predictionMode = rhs.predictionMode;
+    this->onlineWindowSize = rhs.onlineWindowSize;
+    this->onlineSampleCounter = rhs.onlineSampleCounter;
+    this->onlineFrameCounter = rhs.onlineFrameCounter;
+    this->onlineFrame = rhs.onlineFrame;
+    this->onlineAlpha = rhs.onlineAlpha;
+    this->onlineAlphaBuffer = rhs.onlineAlphaBuffer;
+    this->onlineLogEmissions = rhs.onlineLogEmissions;
+    this->onlineFrameLoglikelihoods = rhs.onlineFrameLoglikelihoods;
     
     const MLBase *basePointer = &rhs;
     this->copyMLBaseVariables( basePointer );
@@ -98,6 +109,15 @@ ContinuousHiddenMarkovModel& ContinuousHiddenMarkovModel::operator=(const Contin
         this->delta = rhs.delta;
         this->loglikelihood = rhs.loglikelihood;
         this->cThreshold = rhs.cThreshold;
+        this->predictionMode = rhs.predictionMode;
+        this->onlineWindowSize = rhs.onlineWindowSize;
+        this->onlineSampleCounter = rhs.onlineSampleCounter;
+        this->onlineFrameCounter = rhs.onlineFrameCounter;
+        this->onlineFrame = rhs.onlineFrame;
+        this->onlineAlpha = rhs.onlineAlpha;
+        this->onlineAlphaBuffer = rhs.onlineAlphaBuffer;
+        this->onlineLogEmissions = rhs.onlineLogEmissions;
+        this->onlineFrameLoglikelihoods = rhs.onlineFrameLoglikelihoods;
         
         const MLBase *basePointer = &rhs;
         this->copyMLBaseVariables( basePointer );
@@ -118,6 +138,11 @@ bool ContinuousHiddenMarkovModel::predict_(VectorDouble &x){
         return false;
     }
     
+    //The online modes update the forward variables with each new frame, rather than running the forward algorithm over the whole buffer
+    if( predictionMode != HMM_BUFFERED_PREDICTION ){
+        return predictOnline( x );
+    }
+    
     //Add the new sample to the circular buffer
     observationSequence.push_back( x );
     
@@ -230,6 +255,122 @@ bool ContinuousHiddenMarkovModel::predict_( MatrixDouble &timeseries ){
 
     return true;
 }
+    
+bool ContinuousHiddenMarkovModel::predictOnline(const VectorDouble &x){
+    
+    //Add the sample to the current frame, each frame is the average of downsampleFactor samples (the same as the training data)
+    for(UINT j=0; j<numInputDimensions; j++){
+        onlineFrame[j] += x[j];
+    }
+    
+    //The loglikelihood and phase only change when a frame is complete
+    if( ++onlineSampleCounter < downsampleFactor ){
+        return true;
+    }
+    
+    for(UINT j=0; j<numInputDimensions; j++){
+        onlineFrame[j] /= downsampleFactor;
+    }
+    const double frameLoglikelihood = updateOnlineForward( onlineFrame );
+    std::fill(onlineFrame.begin(),onlineFrame.end(),0);
+    onlineSampleCounter = 0;
+    
+    if( predictionMode == HMM_ONLINE_WINDOW_PREDICTION ){
+        //The window starts filled with zeros, so the sum is only over the frames seen so far
+        onlineFrameLoglikelihoods.push_back( frameLoglikelihood );
+        loglikelihood = 0;
+        for(UINT i=0; i<onlineFrameLoglikelihoods.getSize(); i++){
+            loglikelihood += onlineFrameLoglikelihoods[i];
+        }
+    }else{
+        loglikelihood = onlineFrameCounter == 1 ? frameLoglikelihood : loglikelihood + frameLoglikelihood;
+    }
+    
+    return true;
+}
+    
+double ContinuousHiddenMarkovModel::updateOnlineForward(const VectorDouble &frame){
+    
+    UINT i,j,n = 0;
+    
+    //Predict the state distribution of the new frame, the first frame starts from pi
+    for(j=0; j<numStates; j++){
+        if( onlineFrameCounter == 0 ){
+            onlineAlphaBuffer[j] = pi[j];
+        }else{
+            onlineAlphaBuffer[j] = 0;
+            for(i=0; i<numStates; i++){
+                onlineAlphaBuffer[j] += onlineAlpha[i] * a[i][j];
+            }
+        }
+    }
+    
+    //Compute the log emission of each state, the emissions are scaled by the largest emission of the reachable states so they do not underflow
+    double maxLogEmission = -numeric_limits< double >::infinity();
+    for(j=0; j<numStates; j++){
+        onlineLogEmissions[j] = 0;
+        for(n=0; n<numInputDimensions; n++){
+            onlineLogEmissions[j] -= log( sigmaStates[j][n] * SQRT_TWO_PI ) + SQR(b[j][n]-frame[n])/(2.0*SQR(sigmaStates[j][n]));
+        }
+        if( onlineAlphaBuffer[j] > 0 && onlineLogEmissions[j] > maxLogEmission ){
+            maxLogEmission = onlineLogEmissions[j];
+        }
+    }
+    
+    //Update and normalize the forward variables, the normalizing sum is the likelihood of the frame given the previous frames
+    double sum = 0;
+    double maxAlpha = 0;
+    UINT estimatedState = 0;
+    for(j=0; j<numStates; j++){
+        onlineAlpha[j] = onlineAlphaBuffer[j] > 0 ? onlineAlphaBuffer[j] * exp( onlineLogEmissions[j] - maxLogEmission ) : 0;
+        sum += onlineAlpha[j];
+        
+        //Keep track of the best state
+        if( onlineAlpha[j] > maxAlpha ){
+            maxAlpha = onlineAlpha[j];
+            estimatedState = j;
+        }
+    }
+    onlineFrameCounter++;
+    
+    //If no state can be reached then restart from pi at the next frame
+    if( sum <= 0 ){
+        onlineFrameCounter = 0;
+        return -numeric_limits< double >::infinity();
+    }
+    
+    for(j=0; j<numStates; j++) onlineAlpha[j] /= sum;
+    
+    //Set the phase as the estimated state, this will give a phase between [0 1]
+    phase = (estimatedState+1.0)/double(numStates);
+    
+    return log( sum ) + maxLogEmission;
+}
+    
+bool ContinuousHiddenMarkovModel::resetOnlineState(){
+    
+    onlineSampleCounter = 0;
+    onlineFrameCounter = 0;
+    onlineFrame.resize( numInputDimensions );
+    std::fill(onlineFrame.begin(),onlineFrame.end(),0);
+    onlineAlpha.resize( numStates );
+    std::fill(onlineAlpha.begin(),onlineAlpha.end(),0);
+    onlineAlphaBuffer.resize( numStates );
+    onlineLogEmissions.resize( numStates );
+    
+    //Until the first frame is complete there is no evidence for this model
+    if( predictionMode != HMM_BUFFERED_PREDICTION ){
+        loglikelihood = -numeric_limits< double >::infinity();
+        phase = 0;
+    }
+    
+    const UINT windowSize = onlineWindowSize > 0 ? onlineWindowSize : numStates;
+    if( predictionMode == HMM_ONLINE_WINDOW_PREDICTION && windowSize > 0 ){
+        onlineFrameLoglikelihoods.resize( windowSize, 0 );
+    }else onlineFrameLoglikelihoods.clear();
+    
+    return true;
+}
 
 bool ContinuousHiddenMarkovModel::train_(TimeSeriesClassificationSample &trainingData){
 
@@ -360,6 +501,7 @@ bool ContinuousHiddenMarkovModel::train_(TimeSeriesClassificationSample &trainin
     observationSequence.resize( timeseriesLength, VectorDouble(numInputDimensions,0) );
     obsSequence.resize(timeseriesLength,numInputDimensions);
     estimatedStates.resize( numStates );
+    resetOnlineState();
     
     //Finally, flag that the model was trained
     trained = true;
@@ -376,6 +518,7 @@ bool ContinuousHiddenMarkovModel::reset(){
         for(unsigned int i=0; i<observationSequence.getSize(); i++){
             observationSequence.push_back( VectorDouble(numInputDimensions,0) );
         }
+        resetOnlineState();
     }
     
     return true;
@@ -398,6 +541,13 @@ bool ContinuousHiddenMarkovModel::clear(){
     obsSequence.clear();
     estimatedStates.clear();
     sigmaStates.clear();
+    onlineSampleCounter = 0;
+    onlineFrameCounter = 0;
+    onlineFrame.clear();
+    onlineAlpha.clear();
+    onlineAlphaBuffer.clear();
+    onlineLogEmissions.clear();
+    onlineFrameLoglikelihoods.clear();
     
     return true;
 }
@@ -502,6 +652,22 @@ bool ContinuousHiddenMarkovModel::setAutoEstimateSigma(const bool autoEstimateSi
     
     return true;
 }
+    
+bool ContinuousHiddenMarkovModel::setPredictionMode(const UINT predictionMode){
+    if( predictionMode == HMM_BUFFERED_PREDICTION || predictionMode == HMM_ONLINE_PREDICTION || predictionMode == HMM_ONLINE_WINDOW_PREDICTION ){
+        this->predictionMode = predictionMode;
+        if( trained ) resetOnlineState();
+        return true;
+    }
+    warningLog << "setPredictionMode(const UINT predictionMode) - Failed to set prediction mode, unknown mode!" << endl;
+    return false;
+}
+    
+bool ContinuousHiddenMarkovModel::setOnlineWindowSize(const UINT onlineWindowSize){
+    this->onlineWindowSize = onlineWindowSize;
+    if( trained ) resetOnlineState();
+    return true;
+}
 
 double ContinuousHiddenMarkovModel::gauss( const MatrixDouble &x, const MatrixDouble &y, const MatrixDouble &sigma, const unsigned int i,const unsigned int j,const unsigned int N ){
     double z = 1;
@@ -726,6 +892,7 @@ bool ContinuousHiddenMarkovModel::loadModelFromFile(fstream &file){
         observationSequence.resize( timeseriesLength, VectorDouble(numInputDimensions,0) );
         obsSequence.resize(timeseriesLength,numInputDimensions);
         estimatedStates.resize( numStates );
+        resetOnlineState();
     }
 
     return true;
@@ -129,9 +129,44 @@ public:
     
     bool setAutoEstimateSigma(const bool autoEstimateSigma);
     
+    /**
+     This function sets how the realtime prediction (predict_(VectorDouble &x)) is computed.  This should be one of the HMMPredictionModes enums:
+     
+     - HMM_BUFFERED_PREDICTION: the last timeseriesLength samples are buffered and the forward algorithm is run over the whole buffer for
+       each new sample.  This costs O(T*N*N) per sample, where T is the number of downsampled frames and N is the number of states.
+     - HMM_ONLINE_PREDICTION: every downsampleFactor samples are averaged into one frame, and the forward variables are updated with each new
+       frame in O(N*N).  The loglikelihood is the loglikelihood of all the frames since the model was last reset.
+     - HMM_ONLINE_WINDOW_PREDICTION: the same update as HMM_ONLINE_PREDICTION, but the loglikelihood is only summed over the last
+       onlineWindowSize frames (each conditioned on the frames before it), so the score does not keep falling as the stream gets longer.
+     
+     Changing the prediction mode will reset the realtime prediction state, but will NOT clear the trained model.
+     
+     @param const UINT predictionMode: the new prediction mode
+     @return returns true if the parameter was set correctly, false otherwise
+     */
+    bool setPredictionMode(const UINT predictionMode);
+    
+    /**
+     This function sets the number of frames the loglikelihood is summed over when the HMM_ONLINE_WINDOW_PREDICTION mode is used.  If this is
+     zero, then the number of states is used, which matches the length of the buffer used by the HMM_BUFFERED_PREDICTION mode.
+     
+     Changing the window size will reset the realtime prediction state, but will NOT clear the trained model.
+     
+     @param const UINT onlineWindowSize: the new window size, in downsampled frames
+     @return returns true if the parameter was set correctly, false otherwise
+     */
+    bool setOnlineWindowSize(const UINT onlineWindowSize);
+    
+    UINT getPredictionMode() const { return predictionMode; }
+    
+    UINT getOnlineWindowSize() const { return onlineWindowSize; }
+    
 protected:
     
     double gauss( const MatrixDouble &x, const MatrixDouble &y, const MatrixDouble &sigma, const unsigned int i,const unsigned int j,const unsigned int N );
+    bool predictOnline(const VectorDouble &x);
+    double updateOnlineForward(const VectorDouble &frame);
+    bool resetOnlineState();
     
     UINT downsampleFactor;
 	UINT numStates;             ///<The number of states for this model
@@ -155,6 +190,16 @@ protected:
 	double loglikelihood;	///<The log likelihood of an observation sequence given the modal, calculated by the forward method
 	double cThreshold;		///<The classification threshold for this model
     
+    UINT predictionMode;                ///<Controls how the realtime prediction is computed, this should be one of the HMMPredictionModes
+    UINT onlineWindowSize;              ///<The number of frames used by HMM_ONLINE_WINDOW_PREDICTION, zero uses the number of states
+    UINT onlineSampleCounter;           ///<The number of samples added to the current online frame
+    UINT onlineFrameCounter;            ///<The number of frames processed since the online state was reset
+    VectorDouble onlineFrame;           ///<The sum of the samples in the current online frame
+    VectorDouble onlineAlpha;           ///<The scaled forward variables of the last online frame
+    VectorDouble onlineAlphaBuffer;     ///<A buffer for the forward update
+    VectorDouble onlineLogEmissions;    ///<A buffer for the log emission of each state
+    CircularBuffer< double > onlineFrameLoglikelihoods; ///<The loglikelihood of each frame in the online window
+    
 };
 
 }//end of namespace GRT
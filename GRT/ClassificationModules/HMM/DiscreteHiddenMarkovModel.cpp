@@ -35,6 +35,8 @@ DiscreteHiddenMarkovModel::DiscreteHiddenMarkovModel(){
 	modelType = HMM_LEFTRIGHT;
 	logLikelihood = 0.0;
 	minChange = 1.0e-5;
+    useParallelTraining = true;
+    randomSeed = 0;
     
     debugLog.setProceedingText("[DEBUG DiscreteHiddenMarkovModel]");
     errorLog.setProceedingText("[ERROR DiscreteHiddenMarkovModel]");
@@ -52,6 +54,8 @@ DiscreteHiddenMarkovModel::DiscreteHiddenMarkovModel(const UINT numStates,const
 	numRandomTrainingIterations = 5;
 	cThreshold = -1000;
 	logLikelihood = 0.0;
+    useParallelTraining = true;
+    randomSeed = 0;
     
     debugLog.setProceedingText("[DEBUG DiscreteHiddenMarkovModel]");
     errorLog.setProceedingText("[ERROR DiscreteHiddenMarkovModel]");
@@ -71,6 +75,8 @@ DiscreteHiddenMarkovModel::DiscreteHiddenMarkovModel(const MatrixDouble &a,const
 	cThreshold = -1000;
 	logLikelihood = 0.0;
 	minChange = 1.0e-5;
+    useParallelTraining = true;
+    randomSeed = 0;
     
     debugLog.setProceedingText("[DEBUG DiscreteHiddenMarkovModel]");
     errorLog.setProceedingText("[ERROR DiscreteHiddenMarkovModel]");
@@ -92,23 +98,39 @@ DiscreteHiddenMarkovModel::DiscreteHiddenMarkovModel(const MatrixDouble &a,const
 }
     
 DiscreteHiddenMarkovModel::DiscreteHiddenMarkovModel(const DiscreteHiddenMarkovModel &rhs){
-    this->numStates = rhs.numStates;
-	this->numSymbols = rhs.numSymbols;
-	this->delta = rhs.delta;
-	this->numRandomTrainingIterations = rhs.numRandomTrainingIterations;
-	this->cThreshold = rhs.cThreshold;
-	this->modelType = rhs.modelType;
-	this->logLikelihood = rhs.logLikelihood;
-	this->a = rhs.a;
-	this->b = rhs.b;
-	this->pi = rhs.pi;
-    this->trainingLog = rhs.trainingLog;
+    *this = rhs;
 
     debugLog.setProceedingText("[DEBUG DiscreteHiddenMarkovModel]");
     errorLog.setProceedingText("[ERROR DiscreteHiddenMarkovModel]");
     warningLog.setProceedingText("[WARNING DiscreteHiddenMarkovModel]");
     trainingLog.setProceedingText("[TRAINING DiscreteHiddenMarkovModel]");
 }
+
+DiscreteHiddenMarkovModel& DiscreteHiddenMarkovModel::operator=(const DiscreteHiddenMarkovModel &rhs){
+    if( this != &rhs ){
+        this->numStates = rhs.numStates;
+        this->numSymbols = rhs.numSymbols;
+        this->delta = rhs.delta;
+        this->numRandomTrainingIterations = rhs.numRandomTrainingIterations;
+        this->cThreshold = rhs.cThreshold;
+        this->modelType = rhs.modelType;
+        this->logLikelihood = rhs.logLikelihood;
+        this->a = rhs.a;
+        this->b = rhs.b;
+        this->pi = rhs.pi;
+        this->trainingIterationLog = rhs.trainingIterationLog;
+        this->observationSequence = rhs.observationSequence;
+        this->estimatedStates = rhs.estimatedStates;
+        this->useParallelTraining = rhs.useParallelTraining;
+        this->randomSeed = rhs.randomSeed;
+        this->trainingLog = rhs.trainingLog;
+
+        //Copy the base variables, so a copy of a trained model is also trained and uses the same training settings
+        const MLBase *basePointer = &rhs;
+        this->copyMLBaseVariables( basePointer );
+    }
+    return *this;
+}
     
 //Default destructor
 DiscreteHiddenMarkovModel::~DiscreteHiddenMarkovModel(){
@@ -125,6 +147,11 @@ bool DiscreteHiddenMarkovModel::resetModel(const UINT numStates,const UINT numSy
 }
 
 bool DiscreteHiddenMarkovModel::randomizeMatrices(const UINT numStates,const UINT numSymbols){
+    Random random( randomSeed );
+    return randomizeMatrices( numStates, numSymbols, random );
+}
+
+bool DiscreteHiddenMarkovModel::randomizeMatrices(const UINT numStates,const UINT numSymbols,Random &random){
 
 	//Set the model as untrained as everything will now be reset
 	trained = false;
@@ -140,7 +167,6 @@ bool DiscreteHiddenMarkovModel::randomizeMatrices(const UINT numStates,const UIN
 	//Fill Transition and Symbol Matrices randomly
     //It's best to choose values in the range [0.9 1.1] rather than [0 1]
     //That way, no single value will get too large or too small a weight when the values are normalized
-	Random random;
 	for(UINT i=0; i<a.getNumRows(); i++)
 		for(UINT j=0; j<a.getNumCols(); j++)
 			a[i][j] = random.getRandomNumberUniform(0.9,1);
@@ -329,17 +355,44 @@ double DiscreteHiddenMarkovModel::predictLogLikelihood(const vector<UINT> &obs){
 - This method runs one pass of the forward backward algorithm, the hmm training object needs to be resized BEFORE calling this function!
 */
 bool DiscreteHiddenMarkovModel::forwardBackward(HMMTrainingObject &hmm,const vector<UINT> &obs){
+    
+    MatrixDouble aT, bT;
+    if( !computeTransposedMatrices(aT,bT) ){
+        return false;
+    }
+    
+    return computeForwardBackward(hmm,obs,aT,bT);
+}
+    
+bool DiscreteHiddenMarkovModel::computeTransposedMatrices(MatrixDouble &aT,MatrixDouble &bT) const{
+    
+    if( numStates == 0 || numSymbols == 0 || a.getNumRows() != numStates || b.getNumRows() != numStates || b.getNumCols() != numSymbols ){
+        return false;
+    }
+    
+    aT.resize(numStates,numStates);
+    bT.resize(numSymbols,numStates);
+    MatrixKernels::transpose(numStates,numStates,a[0],aT[0]);
+    MatrixKernels::transpose(numStates,numSymbols,b[0],bT[0]);
+    
+    return true;
+}
+    
+bool DiscreteHiddenMarkovModel::computeForwardBackward(HMMTrainingObject &hmm,const vector<UINT> &obs,const MatrixDouble &aT,const MatrixDouble &bT) const{
 
 	const int N = (int)numStates;
 	const int T = (int)obs.size();
 	int t,i,j = 0;
+    double sum = 0;
+    
+    //The rows of aT are the columns of a, and the rows of bT are the emissions of each symbol, so all the inner loops read contiguous memory
 
 	////////////////// Run the forward algorithm ////////////////////////
 	//Step 1: Init at t=0
 	t = 0;
 	hmm.c[t] = 0.0;
 	for(i=0; i<N; i++){
-		hmm.alpha[t][i] = pi[i]*b[i][ obs[t] ];
+		hmm.alpha[t][i] = pi[i]*bT[ obs[t] ][i];
 		hmm.c[t] += hmm.alpha[t][i];
 	}
 
@@ -351,21 +404,25 @@ bool DiscreteHiddenMarkovModel::forwardBackward(HMMTrainingObject &hmm,const vec
     
 	//Step 2: Induction
 	for(t=1; t<T; t++){
+        const double *alphaPrev = hmm.alpha[t-1];
+        const double *emissions = bT[ obs[t] ];
+        double *alpha = hmm.alpha[t];
 		hmm.c[t] = 0.0;
 		for(j=0; j<N; j++){
-			hmm.alpha[t][j] = 0.0;
+            const double *aj = aT[j];
+			sum = 0.0;
 			for(i=0; i<N; i++){
-				hmm.alpha[t][j] +=  hmm.alpha[t-1][i] * a[i][j];
+				sum += alphaPrev[i] * aj[i];
 			}
-            hmm.alpha[t][j] *= b[j][obs[t]];
-            hmm.c[t] += hmm.alpha[t][j];
+            alpha[j] = sum * emissions[j];
+            hmm.c[t] += alpha[j];
 		}
 
 		//Set the scaling coeff
 		hmm.c[t] = 1.0/hmm.c[t];
 
 		//Scale Alpha
-        for(j=0; j<N; j++) hmm.alpha[t][j] *= hmm.c[t];
+        for(j=0; j<N; j++) alpha[j] *= hmm.c[t];
 	}
 
 	//Termination
@@ -387,14 +444,18 @@ bool DiscreteHiddenMarkovModel::forwardBackward(HMMTrainingObject &hmm,const vec
 
 	//Step 2: Induction, from T-1 until 1 (T-2 until 0 as everything is zero based)
 	for(t=T-2; t>=0; t--){
+        const double *betaNext = hmm.beta[t+1];
+        const double *emissions = bT[ obs[t+1] ];
+        double *beta = hmm.beta[t];
 		for(i=0; i<N; i++){
 			//Calculate the backward step for t, using the scaled beta
-			hmm.beta[t][i]=0.0;
+            const double *ai = a[i];
+			sum = 0.0;
 			for(j=0; j<N; j++)
-				hmm.beta[t][i] += a[i][j] * b[j][ obs[t+1] ] * hmm.beta[t+1][j];
+				sum += ai[j] * emissions[j] * betaNext[j];
 
             //Scale B using the same coeff as A
-            hmm.beta[t][i] *= hmm.c[t];
+            beta[i] = sum * hmm.c[t];
 		}
 	}
     
@@ -406,6 +467,16 @@ bool DiscreteHiddenMarkovModel::forwardBackward(HMMTrainingObject &hmm,const vec
 */
 bool DiscreteHiddenMarkovModel::train(const vector< vector<UINT> > &trainingData){
 
+    //The thread pool is kept between calls, so it is only created the first time the model is trained in parallel
+    if( useParallelTraining && ThreadPool::getThreadPoolSize() > 1 && threadPool.get() == NULL ){
+        threadPool.reset( new ThreadPool( ThreadPool::getThreadPoolSize() ) );
+    }
+
+    return train(trainingData,threadPool.get());
+}
+
+bool DiscreteHiddenMarkovModel::train(const vector< vector<UINT> > &trainingData,ThreadPool *threadPool){
+
     //Clear any previous models
     trained = false;
     observationSequence.clear();
@@ -415,26 +486,50 @@ bool DiscreteHiddenMarkovModel::train(const vector< vector<UINT> > &trainingData
 	UINT n,currentIter, bestIndex = 0;
 	double newLoglikelihood, bestLogValue = 0;
     
+    //The thread pool is shared by the random restarts and the final training
+    if( !useParallelTraining || ThreadPool::getThreadPoolSize() <= 1 ) threadPool = NULL;
+    
+    //Draw the seed of each random restart before any of them are trained, so each restart is the same whatever order they are trained in
+    Random random( randomSeed );
+    vector< unsigned long long > restartSeeds( numRandomTrainingIterations > 1 ? numRandomTrainingIterations : 1 );
+    for(n=0; n<restartSeeds.size(); n++){
+        restartSeeds[n] = (unsigned long long)random.getRandomNumberInt( 1, numeric_limits< int >::max() );
+    }
+    
     if( numRandomTrainingIterations > 1 ){
 
         //A buffer to keep track each AB matrix
         vector< MatrixDouble > aTracker( numRandomTrainingIterations );
         vector< MatrixDouble > bTracker( numRandomTrainingIterations );
+        vector< VectorDouble > piTracker( numRandomTrainingIterations );
         vector< double > loglikelihoodTracker( numRandomTrainingIterations );
         
         UINT maxNumTestIter = maxNumEpochs > 10 ? 10 : maxNumEpochs;
 
-        //Try and find the best starting point
-        for(n=0; n<numRandomTrainingIterations; n++){
-            //Reset the model to a new random starting values
-            randomizeMatrices(numStates,numSymbols);
-
-            if( !train_(trainingData,maxNumTestIter,currentIter,newLoglikelihood) ){
-                return false;
+        //Try and find the best starting point, each restart is trained on its own copy of the model
+        bool result = true;
+        if( threadPool == NULL ){
+            for(n=0; n<numRandomTrainingIterations; n++){
+                if( !trainRandomRestart(trainingData,maxNumTestIter,restartSeeds[n],aTracker[n],bTracker[n],piTracker[n],loglikelihoodTracker[n]) ){
+                    result = false;
+                    break;
+                }
             }
-            aTracker[n] = a;
-            bTracker[n] = b;
-            loglikelihoodTracker[n] = newLoglikelihood;
+        }else{
+            vector< std::future< bool > > restartTasks;
+            restartTasks.reserve( numRandomTrainingIterations );
+            for(n=0; n<numRandomTrainingIterations; n++){
+                restartTasks.push_back( threadPool->enqueue( &DiscreteHiddenMarkovModel::trainRandomRestart, this, std::cref(trainingData), maxNumTestIter, restartSeeds[n], std::ref(aTracker[n]), std::ref(bTracker[n]), std::ref(piTracker[n]), std::ref(loglikelihoodTracker[n]) ) );
+            }
+            
+            //Wait for all the restarts to finish, even if one fails, as the tasks use the training data
+            for(n=0; n<numRandomTrainingIterations; n++){
+                if( !restartTasks[n].get() ) result = false;
+            }
+        }
+        
+        if( !result ){
+            return false;
         }
 
         //Get the best result and set it as the a and b starting values
@@ -447,16 +542,18 @@ bool DiscreteHiddenMarkovModel::train(const vector< vector<UINT> > &trainingData
             }
         }
 
-        //Set a and b
+        //Set a, b and pi
         a = aTracker[bestIndex];
         b = bTracker[bestIndex];
+        pi = piTracker[bestIndex];
         
     }else{
-        randomizeMatrices(numStates,numSymbols);
+        Random restartRandom( restartSeeds[0] );
+        randomizeMatrices(numStates,numSymbols,restartRandom);
     }
 
 	//Perform the actual training
-    if( !train_(trainingData,maxNumEpochs,currentIter,newLoglikelihood) ){
+    if( !train_(trainingData,maxNumEpochs,currentIter,newLoglikelihood,threadPool) ){
         return false;
     }
 
@@ -478,35 +575,51 @@ bool DiscreteHiddenMarkovModel::train(const vector< vector<UINT> > &trainingData
 
 	return true;
 }
+    
+bool DiscreteHiddenMarkovModel::trainRandomRestart(const vector< vector<UINT> > &obs,const UINT maxIter,const unsigned long long seed,MatrixDouble &trainedA,MatrixDouble &trainedB,VectorDouble &trainedPi,double &loglikelihood) const{
+    
+    //Each restart is trained on a copy of the model, so several restarts can be trained at the same time
+    DiscreteHiddenMarkovModel model( *this );
+    Random random( seed );
+    UINT currentIter = 0;
+    
+    model.randomizeMatrices(numStates,numSymbols,random);
+    
+    if( !model.train_(obs,maxIter,currentIter,loglikelihood,NULL) ){
+        return false;
+    }
+    
+    trainedA = model.a;
+    trainedB = model.b;
+    trainedPi = model.pi;
+    
+    return true;
+}
 
 bool DiscreteHiddenMarkovModel::train_(const vector< vector<UINT> > &obs,const UINT maxIter, UINT &currentIter,double &newLoglikelihood){
+    return train_(obs,maxIter,currentIter,newLoglikelihood,NULL);
+}
+    
+bool DiscreteHiddenMarkovModel::train_(const vector< vector<UINT> > &obs,const UINT maxIter, UINT &currentIter,double &newLoglikelihood,ThreadPool *threadPool){
     
     const UINT numObs = (unsigned int)obs.size();
-    UINT i,j,k,t = 0;
-    double num,denom,oldLoglikelihood = 0;
+    const UINT numBlocks = (numObs + TRAINING_BLOCK_SIZE - 1) / TRAINING_BLOCK_SIZE;
+    UINT i,j,k = 0;
+    double oldLoglikelihood = 0;
     bool keepTraining = true;
     trainingIterationLog.clear();
     
-    //Create the array to hold the data for each training instance
-    vector< HMMTrainingObject > hmms( numObs );
-    
-    //Create epislon and gamma to hold the re-estimation variables
-    vector< vector< MatrixDouble > > epsilon( numObs );
-    vector< MatrixDouble > gamma( numObs );
-    
-    //Resize the hmms, epsilon and gamma matrices so they are ready to be filled
-    for(k=0; k<numObs; k++){
-        const UINT T = (UINT)obs[k].size();
-        gamma[k].resize(T,numStates);
-        epsilon[k].resize(T);
-        for(t=0; t<T; t++) epsilon[k][t].resize(numStates,numStates);
-        
-        //Resize alpha, beta and phi
-        hmms[k].alpha.resize(T,numStates);
-        hmms[k].beta.resize(T,numStates);
-        hmms[k].c.resize(T);
+    if( numObs == 0 ){
+        errorLog << "train_(...) - There are no training sequences!" << endl;
+        return false;
     }
     
+    //Each block of training sequences has its own re-estimation statistics, which are summed in block order after each pass
+    vector< HMMTrainingStatistics > blockStatistics( numBlocks );
+    vector< std::future< bool > > blockTasks;
+    HMMTrainingStatistics statistics;
+    MatrixDouble aT, bT;
+    
     //For each training seq, run one pass of the forward backward
     //algorithm then reestimate a and b using the Baum-Welch
     oldLoglikelihood = 0;
@@ -514,18 +627,50 @@ bool DiscreteHiddenMarkovModel::train_(const vector< vector<UINT> > &obs,const U
     currentIter = 0;
     
     do{
-        newLoglikelihood = 0.0;
+        //The transposed matrices are shared by all the blocks, so they only need to be computed once per pass
+        if( !computeTransposedMatrices(aT,bT) ){
+            errorLog << "train_(...) - The size of the A and B matrices does not match the number of states and symbols!" << endl;
+            return false;
+        }
         
         //Run the forwardbackward algorithm for each training example
-        for(k=0; k<numObs; k++){
-            if( !forwardBackward(hmms[k],obs[k]) ){
-                return false;
+        bool result = true;
+        if( threadPool == NULL || numBlocks == 1 ){
+            for(k=0; k<numBlocks; k++){
+                if( !accumulateTrainingStatistics(obs,k*TRAINING_BLOCK_SIZE,std::min(numObs,(k+1)*TRAINING_BLOCK_SIZE),aT,bT,blockStatistics[k]) ){
+                    result = false;
+                    break;
+                }
             }
-            newLoglikelihood += hmms[k].pk;
+        }else{
+            blockTasks.clear();
+            for(k=0; k<numBlocks; k++){
+                blockTasks.push_back( threadPool->enqueue( &DiscreteHiddenMarkovModel::accumulateTrainingStatistics, this, std::cref(obs), k*TRAINING_BLOCK_SIZE, std::min(numObs,(k+1)*TRAINING_BLOCK_SIZE), std::cref(aT), std::cref(bT), std::ref(blockStatistics[k]) ) );
+            }
+            for(k=0; k<numBlocks; k++){
+                if( !blockTasks[k].get() ) result = false;
+            }
+        }
+        
+        if( !result ){
+            return false;
+        }
+        
+        //Sum the statistics of each block
+        statistics.reset(numStates,numSymbols);
+        for(k=0; k<numBlocks; k++){
+            for(i=0; i<numStates; i++){
+                for(j=0; j<numStates; j++) statistics.aNumerator[i][j] += blockStatistics[k].aNumerator[i][j];
+                for(j=0; j<numSymbols; j++) statistics.bNumerator[i][j] += blockStatistics[k].bNumerator[i][j];
+                statistics.aDenominator[i] += blockStatistics[k].aDenominator[i];
+                statistics.bDenominator[i] += blockStatistics[k].bDenominator[i];
+                statistics.piNumerator[i] += blockStatistics[k].piNumerator[i];
+            }
+            statistics.loglikelihood += blockStatistics[k].loglikelihood;
         }
         
         //Set the new log likelihood as the average of the observations
-        newLoglikelihood /= numObs;
+        newLoglikelihood = statistics.loglikelihood / numObs;
         
         trainingIterationLog.push_back( newLoglikelihood );
         
@@ -545,27 +690,9 @@ bool DiscreteHiddenMarkovModel::train_(const vector< vector<UINT> > &obs,const U
 
             //Re-estimate A
             for(i=0; i<numStates; i++){
-                
-                //Compute the denominator of A (which is independent of j)
-                denom = 0;
-                for(k=0; k<numObs; k++){
-                    for(t=0; t<obs[k].size()-1; t++){
-                        denom += hmms[k].alpha[t][i] * hmms[k].beta[t][i] / hmms[k].c[t];
-                    }
-                }
-                
-                //Compute the numerator and also update a[i][j]
-                if( denom > 0 ){
+                if( statistics.aDenominator[i] > 0 ){
                     for(j=0; j<numStates; j++){
-                        num = 0;
-                        for(k=0; k<numObs; k++){
-                            for(t=0; t<obs[k].size()-1; t++){
-                                num += hmms[k].alpha[t][i] * a[i][j] * b[j][ obs[k][t+1] ] * hmms[k].beta[t+1][j];
-                            }
-                        }
-                    
-                        //Update a[i][j]
-                        a[i][j] = num/denom;
+                        a[i][j] = statistics.aNumerator[i][j] / statistics.aDenominator[i];
                     }
                 }else{
                     errorLog << "Denom is zero for A!" << endl;
@@ -576,27 +703,15 @@ bool DiscreteHiddenMarkovModel::train_(const vector< vector<UINT> > &obs,const U
             //Re-estimate B
             bool renormB = false;
             for(i=0; i<numStates; i++){
+                if( statistics.bDenominator[i] == 0 ){
+                    errorLog << "Denominator is zero for B!" << endl;
+                    return false;
+                }
                 for(j=0; j<numSymbols; j++){
-                    num=0.0;
-                    denom = 0.0;
-                    for(k=0; k<numObs; k++){
-                        const UINT T = (unsigned int)obs[k].size();
-                        for(t=0; t<T; t++){
-                            if( obs[k][t] == j ){
-                                num += hmms[k].alpha[t][i] * hmms[k].beta[t][i] / hmms[k].c[t];
-                            }
-                            denom += hmms[k].alpha[t][i] * hmms[k].beta[t][i] / hmms[k].c[t];
-                        }
-                    }
-                    
-                    if( denom == 0 ){
-                        errorLog << "Denominator is zero for B!" << endl;
-                        return false;
-                    }
                     //Update b[i][j]
                     //If there are no observations at all for a state then the probabilities will be zero which is bad
                     //So instead we flag that B needs to be renormalized later
-                    if( num > 0 ) b[i][j] = denom > 0 ? num/denom : 1.0e-5;
+                    if( statistics.bNumerator[i][j] > 0 ) b[i][j] = statistics.bNumerator[i][j] / statistics.bDenominator[i];
                     else{ b[i][j] = 0; renormB = true; }
                 }
             }
@@ -615,43 +730,8 @@ bool DiscreteHiddenMarkovModel::train_(const vector< vector<UINT> > &obs,const U
             
             //Re-estimate Pi - only if the model type is HMM_ERGODIC, otherwise Pi[0] == 1 and everything else is 0
             if (modelType==HMM_ERGODIC ){
-                for(k=0; k<numObs; k++){
-                    const UINT T = (unsigned int)obs[k].size();
-                    //Compute epsilon
-                    for(t=0; t<T-1; t++){
-                        denom = 0.0;
-                        for(i=0; i<numStates; i++){
-                            for(j=0; j<numStates; j++){
-                                epsilon[k][t][i][j] = hmms[k].alpha[t][i] * a[i][j] * b[j][ obs[k][t+1] ] * hmms[k].beta[t+1][j];
-                                denom += epsilon[k][t][i][j];
-                            }
-                        }
-                        //Normalize Epsilon
-                        for(i=0; i<numStates; i++){
-                            for(j=0; j<numStates; j++){
-                                if(denom!=0) epsilon[k][t][i][j] /= denom;
-                                else{ epsilon[k][t][i][j] = 0; }
-                            }
-                        }
-                    }
-                    
-                    //Compute gamma
-                    for(t=0; t<T-1; t++){
-                        for(i=0; i<numStates; i++){
-                            gamma[k][t][i]= 0.0;
-                            for(j=0; j<numStates; j++)
-                                gamma[k][t][i] += epsilon[k][t][i][j];
-                        }
-                    }
-                }
-                
-                double sum = 0;
                 for(i=0; i<numStates; i++){
-                    sum=0.0;
-                    for(k=0; k<numObs; k++){
-                        sum += gamma[k][0][i];
-                    }
-                    pi[i] = sum / numObs;
+                    pi[i] = statistics.piNumerator[i] / numObs;
                 }
             }
         }
@@ -662,6 +742,89 @@ bool DiscreteHiddenMarkovModel::train_(const vector< vector<UINT> > &obs,const U
     
 }
     
+bool DiscreteHiddenMarkovModel::accumulateTrainingStatistics(const vector< vector<UINT> > &obs,const UINT startIndex,const UINT endIndex,const MatrixDouble &aT,const MatrixDouble &bT,HMMTrainingStatistics &statistics) const{
+    
+    HMMTrainingObject hmm;
+    UINT i,j,k,t = 0;
+    double gamma, epsilon, denom = 0;
+    statistics.reset(numStates,numSymbols);
+    
+    for(k=startIndex; k<endIndex; k++){
+        const UINT T = (UINT)obs[k].size();
+        if( T == 0 ) return false;
+        
+        //Resize alpha, beta and c
+        if( hmm.alpha.getNumRows() != T ){
+            hmm.alpha.resize(T,numStates);
+            hmm.beta.resize(T,numStates);
+            hmm.c.resize(T);
+        }
+        
+        if( !computeForwardBackward(hmm,obs[k],aT,bT) ){
+            return false;
+        }
+        statistics.loglikelihood += hmm.pk;
+        
+        //The expected number of times in each state, alpha and beta are both scaled by c[t] so this is divided by c[t]
+        for(t=0; t<T; t++){
+            const UINT symbol = obs[k][t];
+            for(i=0; i<numStates; i++){
+                gamma = hmm.alpha[t][i] * hmm.beta[t][i] / hmm.c[t];
+                statistics.bNumerator[i][symbol] += gamma;
+                statistics.bDenominator[i] += gamma;
+                if( t+1 < T ) statistics.aDenominator[i] += gamma;
+            }
+        }
+        
+        //The expected number of transitions between each state, the inner loop reads contiguous rows of a, bT and beta
+        for(t=0; t+1<T; t++){
+            const double *emissions = bT[ obs[k][t+1] ];
+            const double *betaNext = hmm.beta[t+1];
+            for(i=0; i<numStates; i++){
+                const double alpha = hmm.alpha[t][i];
+                const double *ai = a[i];
+                double *numerator = statistics.aNumerator[i];
+                for(j=0; j<numStates; j++){
+                    numerator[j] += alpha * ai[j] * emissions[j] * betaNext[j];
+                }
+            }
+        }
+        
+        //The probability of starting in each state is only re-estimated for an ergodic model
+        if( modelType == HMM_ERGODIC && T > 1 ){
+            const double *emissions = bT[ obs[k][1] ];
+            const double *betaNext = hmm.beta[1];
+            denom = 0;
+            for(i=0; i<numStates; i++){
+                for(j=0; j<numStates; j++){
+                    denom += hmm.alpha[0][i] * a[i][j] * emissions[j] * betaNext[j];
+                }
+            }
+            if( denom != 0 ){
+                for(i=0; i<numStates; i++){
+                    epsilon = 0;
+                    for(j=0; j<numStates; j++){
+                        epsilon += hmm.alpha[0][i] * a[i][j] * emissions[j] * betaNext[j];
+                    }
+                    statistics.piNumerator[i] += epsilon / denom;
+                }
+            }
+        }
+    }
+    
+    return true;
+}
+    
+bool DiscreteHiddenMarkovModel::enableParallelTraining(const bool useParallelTraining){
+    this->useParallelTraining = useParallelTraining;
+    return true;
+}
+    
+bool DiscreteHiddenMarkovModel::setRandomSeed(const unsigned long long randomSeed){
+    this->randomSeed = randomSeed;
+    return true;
+}
+    
 bool DiscreteHiddenMarkovModel::reset(){
 
     for(UINT i=0; i<observationSequence.getSize(); i++){
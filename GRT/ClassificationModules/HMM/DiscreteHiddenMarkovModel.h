@@ -34,6 +34,7 @@
 #include "HMMEnums.h"
 #include "../../Util/GRTCommon.h"
 #include "../../CoreModules/MLBase.h"
+#include "../../Util/MatrixKernels.h"
 
 namespace GRT {
 
@@ -50,6 +51,33 @@ public:
 	double pk;				//P( O | Model )
 };
 
+//This class stores the Baum-Welch re-estimation sums for a block of training sequences, so each block can be processed on its own thread
+class HMMTrainingStatistics{
+public:
+    HMMTrainingStatistics(){
+        loglikelihood = 0;
+    }
+    ~HMMTrainingStatistics(){}
+    
+    void reset(const UINT numStates,const UINT numSymbols){
+        aNumerator.resize(numStates,numStates);
+        aNumerator.setAllValues(0);
+        bNumerator.resize(numStates,numSymbols);
+        bNumerator.setAllValues(0);
+        aDenominator.assign(numStates,0);
+        bDenominator.assign(numStates,0);
+        piNumerator.assign(numStates,0);
+        loglikelihood = 0;
+    }
+    
+    MatrixDouble aNumerator;        //The expected number of transitions from state i to state j
+    MatrixDouble bNumerator;        //The expected number of times symbol k is observed in state i
+    VectorDouble aDenominator;      //The expected number of transitions from state i
+    VectorDouble bDenominator;      //The expected number of times in state i
+    VectorDouble piNumerator;       //The probability of starting in state i
+    double loglikelihood;           //The sum of the loglikelihood of each sequence
+};
+
 class DiscreteHiddenMarkovModel : public MLBase {
 
 public:
@@ -61,6 +89,8 @@ public:
     
     DiscreteHiddenMarkovModel(const DiscreteHiddenMarkovModel &rhs);
     
+    DiscreteHiddenMarkovModel& operator=(const DiscreteHiddenMarkovModel &rhs);
+    
     virtual ~DiscreteHiddenMarkovModel();
     
     double predict(const UINT newSample);
@@ -69,6 +99,16 @@ public:
     bool resetModel(const UINT numStates,const UINT numSymbols,const UINT modelType,const UINT delta);
     bool train(const vector< vector<UINT> > &trainingData);
     
+    /**
+     Trains the model on the thread pool of the caller, rather than on the thread pool of this model.  The HMM classifier uses this so the
+     models of all its classes share one thread pool.  The thread pool is only used if parallel training is enabled.
+     
+     @param const vector< vector<UINT> > &trainingData: the observation sequences the model will be trained with
+     @param ThreadPool *threadPool: the thread pool used for parallel training, if this is NULL then the model is trained serially
+     @return returns true if the model was trained successfully, false otherwise
+     */
+    bool train(const vector< vector<UINT> > &trainingData,ThreadPool *threadPool);
+    
     virtual bool reset();
     
     /**
@@ -95,6 +135,33 @@ public:
     
     VectorDouble getTrainingIterationLog() const;
     
+    /**
+     Sets if the model should be trained in parallel.  If enabled, the random restarts are trained as separate tasks on a GRT ThreadPool,
+     and the Baum-Welch statistics of each block of training sequences are computed as separate tasks.  The statistics of the blocks are
+     summed in order, so the trained model is the same as the serial training.
+     
+     @param const bool useParallelTraining: if true then the model will be trained in parallel
+     @return returns true if the parameter was updated successfully, false otherwise
+     */
+    virtual bool enableParallelTraining(const bool useParallelTraining);
+    
+    /**
+     Gets if the model should be trained in parallel.
+     
+     @return returns true if parallel training is enabled, false otherwise
+     */
+    virtual bool getParallelTrainingEnabled() const{ return useParallelTraining; }
+    
+    /**
+     Sets the seed used to pick the random starting values of the model.  A seed of zero means the seed is set using the system time.
+     
+     @param const unsigned long long randomSeed: the new random seed
+     @return returns true if the parameter was updated successfully, false otherwise
+     */
+    bool setRandomSeed(const unsigned long long randomSeed);
+    
+    unsigned long long getRandomSeed() const{ return randomSeed; }
+    
 	UINT numStates;             //The number of states for this model
 	UINT numSymbols;            //The number of symbols for this model
 	MatrixDouble a;             //The transitions probability matrix
@@ -109,6 +176,21 @@ public:
 	double cThreshold;		//The classification threshold for this model
     CircularBuffer<UINT> observationSequence;
     vector< UINT > estimatedStates;
+    bool useParallelTraining;           //A flag to check if the model should be trained on a thread pool
+    unsigned long long randomSeed;      //The seed used to pick the random starting values, zero means the seed is set using the system time
+    
+protected:
+    std::unique_ptr< ThreadPool > threadPool;   //The thread pool used for parallel training, this is only created when it is first needed
+    
+    //The number of training sequences in each block of the Baum-Welch statistics, this does not depend on the number of threads so the results do not either
+    enum{ TRAINING_BLOCK_SIZE = 8 };
+    
+    bool randomizeMatrices(const UINT numStates,const UINT numSymbols,Random &random);
+    bool train_(const vector< vector<UINT> > &obs,const UINT maxIter, UINT &currentIter,double &newLoglikelihood,ThreadPool *threadPool);
+    bool trainRandomRestart(const vector< vector<UINT> > &obs,const UINT maxIter,const unsigned long long seed,MatrixDouble &trainedA,MatrixDouble &trainedB,VectorDouble &trainedPi,double &loglikelihood) const;
+    bool computeTransposedMatrices(MatrixDouble &aT,MatrixDouble &bT) const;
+    bool computeForwardBackward(HMMTrainingObject &trainingObject,const vector<UINT> &obs,const MatrixDouble &aT,const MatrixDouble &bT) const;
+    bool accumulateTrainingStatistics(const vector< vector<UINT> > &obs,const UINT startIndex,const UINT endIndex,const MatrixDouble &aT,const MatrixDouble &bT,HMMTrainingStatistics &statistics) const;
 };
 
 }//end of namespace GRT
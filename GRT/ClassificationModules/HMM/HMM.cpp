@@ -36,6 +36,8 @@ HMM::HMM(const UINT hmmType,const UINT modelType,const UINT delta,const bool use
     //Default discrete setup
 	numStates = 10;
 	numSymbols = 20;
+    numRandomTrainingIterations = 5;
+    useParallelTraining = true;
 	maxNumEpochs = 1000;
 	minChange = 1.0e-5;
 	
@@ -44,6 +46,8 @@ HMM::HMM(const UINT hmmType,const UINT modelType,const UINT delta,const bool use
     committeeSize = 5;
     sigma = 10.0;
     autoEstimateSigma = true;
+    predictionMode = HMM_BUFFERED_PREDICTION;
+    onlineWindowSize = 0;
     
     supportsNullRejection = false; //TODO - need to add better null rejection support
     classifierMode = TIMESERIES_CLASSIFIER_MODE;
@@ -75,10 +79,14 @@ HMM& HMM::operator=(const HMM &rhs){
         this->delta = rhs.delta;
         this->numStates = rhs.numStates;
         this->numSymbols = rhs.numSymbols;
+        this->numRandomTrainingIterations = rhs.numRandomTrainingIterations;
+        this->useParallelTraining = rhs.useParallelTraining;
         this->downsampleFactor = rhs.downsampleFactor;
         this->committeeSize = rhs.committeeSize;
         this->sigma = rhs.sigma;
         this->autoEstimateSigma = rhs.autoEstimateSigma;
+        this->predictionMode = rhs.predictionMode;
+        this->onlineWindowSize = rhs.onlineWindowSize;
         this->discreteModels = rhs.discreteModels;
         this->continuousModels = rhs.continuousModels;
         
@@ -103,10 +111,14 @@ bool HMM::deepCopyFrom(const Classifier *classifier){
         this->delta = ptr->delta;
         this->numStates = ptr->numStates;
         this->numSymbols = ptr->numSymbols;
+        this->numRandomTrainingIterations = ptr->numRandomTrainingIterations;
+        this->useParallelTraining = ptr->useParallelTraining;
         this->downsampleFactor = ptr->downsampleFactor;
         this->committeeSize = ptr->committeeSize;
         this->sigma = ptr->sigma;
         this->autoEstimateSigma = ptr->autoEstimateSigma;
+        this->predictionMode = ptr->predictionMode;
+        this->onlineWindowSize = ptr->onlineWindowSize;
         this->discreteModels = ptr->discreteModels;
         this->continuousModels = ptr->continuousModels;
         
@@ -158,47 +170,66 @@ bool HMM::train_discrete(TimeSeriesClassificationData &trainingData){
     discreteModels.resize( numClasses );
     classLabels.resize( numClasses );
     
+    //Convert the training data of each class into a list of observation sequences
+    vector< vector< vector< UINT > > > classObservationSequences( numClasses );
+    for(UINT k=0; k<numClasses; k++){
+        //Get the class ID of this gesture
+        UINT classID = trainingData.getClassTracker()[k].classLabel;
+        classLabels[k] = classID;
+        
+        TimeSeriesClassificationData classData = trainingData.getClassData( classID );
+        if( !convertDataToObservationSequence( classData, classObservationSequences[k] ) ){
+            return false;
+        }
+    }
+    
+    //If there are enough classes to keep each thread busy then each class is trained as a task, otherwise each model trains in parallel on its own
+    const UINT numThreads = ThreadPool::getThreadPoolSize();
+    const bool trainClassesInParallel = useParallelTraining && numThreads > 1 && numClasses >= numThreads;
+    
     //Init the models
     for(UINT k=0; k<numClasses; k++){
         discreteModels[k].resetModel(numStates,numSymbols,modelType,delta);
         discreteModels[k].setMaxNumEpochs( maxNumEpochs );
         discreteModels[k].setMinChange( minChange );
+        discreteModels[k].numRandomTrainingIterations = numRandomTrainingIterations;
+        discreteModels[k].enableParallelTraining( useParallelTraining && !trainClassesInParallel );
+    }
+    
+    //The thread pool is shared by the classes, or by the models of each class if they are trained one at a time
+    if( useParallelTraining && numThreads > 1 && threadPool.get() == NULL ){
+        threadPool.reset( new ThreadPool( numThreads ) );
     }
     
     //Train each of the models
-    for(UINT k=0; k<numClasses; k++){
-        //Get the class ID of this gesture
-        UINT classID = trainingData.getClassTracker()[k].classLabel;
-        classLabels[k] = classID;
-        
-        //Convert this classes training data into a list of observation sequences
-        TimeSeriesClassificationData classData = trainingData.getClassData( classID );
-        vector< vector< UINT > > observationSequences;
-        if( !convertDataToObservationSequence( classData, observationSequences ) ){
-            return false;
+    if( trainClassesInParallel ){
+        vector< std::future< bool > > classTasks;
+        classTasks.reserve( numClasses );
+        for(UINT k=0; k<numClasses; k++){
+            classTasks.push_back( threadPool->enqueue( &HMM::trainDiscreteModel, this, k, std::cref(classObservationSequences[k]) ) );
         }
         
-        //Train the model
-        if( !discreteModels[k].train( observationSequences ) ){
-            errorLog << "train_discrete(TimeSeriesClassificationData &trainingData) - Failed to train HMM for class " << classID << endl;
+        //Wait for all the tasks to finish, even if one fails, as the tasks use the observation sequences
+        bool result = true;
+        for(UINT k=0; k<numClasses; k++){
+            if( !classTasks[k].get() ) result = false;
+        }
+        if( !result ){
             return false;
         }
+    }else{
+        for(UINT k=0; k<numClasses; k++){
+            if( !trainDiscreteModel( k, classObservationSequences[k] ) ){
+                return false;
+            }
+        }
     }
     
     //Compute the rejection thresholds
     nullRejectionThresholds.resize(numClasses);
     
     for(UINT k=0; k<numClasses; k++){
-        //Get the class ID of this gesture
-        UINT classID = trainingData.getClassTracker()[k].classLabel;
-        classLabels[k] = classID;
-        
-        //Convert this classes training data into a list of observation sequences
-        TimeSeriesClassificationData classData = trainingData.getClassData( classID );
-        vector< vector< UINT > > observationSequences;
-        if( !convertDataToObservationSequence( classData, observationSequences ) ){
-            return false;
-        }
+        const vector< vector< UINT > > &observationSequences = classObservationSequences[k];
         
         //Test the model
         double loglikelihood = 0;
@@ -217,6 +248,16 @@ bool HMM::train_discrete(TimeSeriesClassificationData &trainingData){
     
 }
     
+bool HMM::trainDiscreteModel( const UINT classIndex, const vector< vector< UINT > > &observationSequences ){
+    
+    if( !discreteModels[classIndex].train( observationSequences, threadPool.get() ) ){
+        errorLog << "train_discrete(TimeSeriesClassificationData &trainingData) - Failed to train HMM for class " << classLabels[classIndex] << endl;
+        return false;
+    }
+    
+    return true;
+}
+    
 bool HMM::train_continuous(TimeSeriesClassificationData &trainingData){
     
     clear();
@@ -253,6 +294,8 @@ bool HMM::train_continuous(TimeSeriesClassificationData &trainingData){
         continuousModels[k].setDelta( delta );
         continuousModels[k].setSigma( sigma );
         continuousModels[k].setAutoEstimateSigma( autoEstimateSigma );
+        continuousModels[k].setPredictionMode( predictionMode );
+        continuousModels[k].setOnlineWindowSize( onlineWindowSize );
         continuousModels[k].enableScaling( false ); //Scaling should always off for the models as we do any scaling in the CHMM
         
         //Train the model
@@ -432,7 +475,9 @@ bool HMM::predict_continuous( VectorDouble &inputVector ){
             classLikelihoods[k] = classDistances[k] / sum;
         }
         
-        //Find the maximum label
+        //Find the maximum label, bestDistance and bestIndex are reset as they currently hold the best model loglikelihood and model index
+        bestDistance = 0;
+        bestIndex = 0;
         for(UINT k=0; k<numClasses; k++){
             if( classDistances[k] > bestDistance ){
                 bestDistance = classDistances[k];
@@ -606,7 +651,9 @@ bool HMM::predict_continuous(MatrixDouble &timeseries){
             classLikelihoods[k] = classDistances[k] / sum;
         }
         
-        //Find the maximum label
+        //Find the maximum label, bestDistance and bestIndex are reset as they currently hold the best model loglikelihood and model index
+        bestDistance = 0;
+        bestIndex = 0;
         for(UINT k=0; k<numClasses; k++){
             if( classDistances[k] > bestDistance ){
                 bestDistance = classDistances[k];
@@ -894,6 +941,10 @@ bool HMM::loadModelFromFile( fstream &file ){
                         errorLog <<"loadModelFromFile(fstream &file) - Failed to load continuous model " << i << " from file!" << endl;
                         return false;
                     }
+                    
+                    //The prediction mode is not saved with the model, so use the current setting
+                    continuousModels[i].setPredictionMode( predictionMode );
+                    continuousModels[i].setOnlineWindowSize( onlineWindowSize );
                 }
             }
             break;
@@ -1039,6 +1090,11 @@ bool HMM::setNumSymbols(const UINT numSymbols){
     return false;
 }
 
+bool HMM::enableParallelTraining(const bool useParallelTraining){
+    this->useParallelTraining = useParallelTraining;
+    return true;
+}
+    
 bool HMM::setNumRandomTrainingIterations(const UINT numRandomTrainingIterations){
     
     clear();
@@ -1071,3 +1127,23 @@ bool HMM::setAutoEstimateSigma(const bool autoEstimateSigma){
     
     return true;
 }
+    
+bool HMM::setPredictionMode(const UINT predictionMode){
+    if( predictionMode == HMM_BUFFERED_PREDICTION || predictionMode == HMM_ONLINE_PREDICTION || predictionMode == HMM_ONLINE_WINDOW_PREDICTION ){
+        this->predictionMode = predictionMode;
+        for(size_t i=0; i<continuousModels.size(); i++){
+            continuousModels[i].setPredictionMode( predictionMode );
+        }
+        return true;
+    }
+    warningLog << "setPredictionMode(const UINT predictionMode) - Unknown prediction mode!" << endl;
+    return false;
+}
+    
+bool HMM::setOnlineWindowSize(const UINT onlineWindowSize){
+    this->onlineWindowSize = onlineWindowSize;
+    for(size_t i=0; i<continuousModels.size(); i++){
+        continuousModels[i].setOnlineWindowSize( onlineWindowSize );
+    }
+    return true;
+}
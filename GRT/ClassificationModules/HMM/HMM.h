@@ -329,6 +329,49 @@ public:
     
     bool setAutoEstimateSigma(const bool autoEstimateSigma);
     
+    /**
+     This function sets how the realtime prediction is computed for a HMM_CONTINUOUS.  This should be one of the HMMPredictionModes enums.
+     
+     HMM_BUFFERED_PREDICTION (the default) runs the forward algorithm over a buffer of the most recent samples for each new sample.  HMM_ONLINE_PREDICTION
+     and HMM_ONLINE_WINDOW_PREDICTION update the forward variables of each model once per downsampled frame, which is much faster for long models.
+     See ContinuousHiddenMarkovModel::setPredictionMode for more details.
+     
+     Modifing the prediction mode will NOT clear the trained model, but it will reset the realtime prediction of each model.
+     
+     @param const UINT predictionMode: the new prediction mode
+     @return returns true if the parameter was set correctly, false otherwise
+     */
+    bool setPredictionMode(const UINT predictionMode);
+    
+    /**
+     This function sets the number of downsampled frames used by the HMM_ONLINE_WINDOW_PREDICTION mode.  If this is zero, then each model
+     uses its number of states as the window size.
+     
+     Modifing the window size will NOT clear the trained model, but it will reset the realtime prediction of each model.
+     
+     @param const UINT onlineWindowSize: the new window size
+     @return returns true if the parameter was set correctly, false otherwise
+     */
+    bool setOnlineWindowSize(const UINT onlineWindowSize);
+    
+    UINT getPredictionMode() const { return predictionMode; }
+    
+    UINT getOnlineWindowSize() const { return onlineWindowSize; }
+    
+    /**
+     This function sets if a HMM_DISCRETE model should be trained in parallel.  If enabled, the model of each class is trained as a separate task
+     on a GRT ThreadPool when there are at least as many classes as threads, otherwise the classes are trained one at a time and the random
+     restarts and Baum-Welch passes of each class are run in parallel instead.  The trained models are the same in both cases.
+     
+     Modifing this will NOT clear the trained model.
+     
+     @param const bool useParallelTraining: sets if parallel training should be used
+     @return returns true if the parameter was set correctly, false otherwise
+     */
+    virtual bool enableParallelTraining(const bool useParallelTraining);
+    
+    virtual bool getParallelTrainingEnabled() const { return useParallelTraining; }
+    
     //Tell the compiler we are using the base class train method to stop hidden virtual function warnings
     using MLBase::saveModelToFile;
     using MLBase::loadModelFromFile;
@@ -343,6 +386,7 @@ protected:
     bool predict_discrete(MatrixDouble &timeseries);
     bool predict_continuous(MatrixDouble &timeseries);
     bool convertDataToObservationSequence( TimeSeriesClassificationData &classData, vector< vector< UINT > > &observationSequences );
+    bool trainDiscreteModel( const UINT classIndex, const vector< vector< UINT > > &observationSequences );
     bool loadLegacyModelFromFile( fstream &file );
 
 	UINT hmmType;           ///<Controls if this is a HMM_DISCRETE or a HMM_CONTINUOUS
@@ -353,13 +397,17 @@ protected:
 	UINT numStates;			//The number of states for each model
 	UINT numSymbols;		//The number of symbols for each model
     UINT numRandomTrainingIterations;
+    bool useParallelTraining;
     vector< DiscreteHiddenMarkovModel > discreteModels;
+    std::unique_ptr< ThreadPool > threadPool;   ///< The thread pool used to train the classes, or the models of each class, in parallel. This is only created when it is first needed
     
     //Continuous HMM variables
     UINT downsampleFactor;
     UINT committeeSize;
     double sigma;
     bool autoEstimateSigma;
+    UINT predictionMode;
+    UINT onlineWindowSize;
     vector< ContinuousHiddenMarkovModel > continuousModels;
     
     static RegisterClassifierModule< HMM > registerModule;
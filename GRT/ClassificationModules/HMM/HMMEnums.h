@@ -35,6 +35,7 @@ namespace GRT {
     
 enum HMMModelTypes{HMM_ERGODIC=0,HMM_LEFTRIGHT};
 enum HMMTypes{HMM_DISCRETE=0,HMM_CONTINUOUS};
+enum HMMPredictionModes{HMM_BUFFERED_PREDICTION=0,HMM_ONLINE_PREDICTION,HMM_ONLINE_WINDOW_PREDICTION};
     
 }//End of namespace GRT
 
@@ -0,0 +1,268 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "KDTree.h"
+
+namespace GRT{
+
+//The relative tolerance used when a node is skipped, this stops the rounding of the lower bound from skipping a node that holds a neighbour
+#define GRT_KDTREE_BOUND_TOLERANCE 1.0e-10
+
+//Sorts the samples in [start end) by the value of one dimension
+class KDTreeSampleComparator{
+public:
+    KDTreeSampleComparator( const MatrixDouble &data, const UINT dimension ) : data( data ), dimension( dimension ){}
+    bool operator()( const UINT a, const UINT b ) const{
+        return data[a][dimension] < data[b][dimension] || (data[a][dimension] == data[b][dimension] && a < b);
+    }
+    const MatrixDouble &data;
+    const UINT dimension;
+};
+
+KDTree::KDTree(){
+    errorLog.setProceedingText("[ERROR KDTree]");
+    clear();
+}
+
+KDTree::~KDTree(){
+}
+
+bool KDTree::build( const MatrixDouble &data, const UINT metric, const UINT leafSize ){
+
+    clear();
+
+    const UINT M = data.getNumRows();
+    const UINT N = data.getNumCols();
+
+    if( M == 0 || N == 0 ){
+        errorLog << "build(...) - The data is empty!" << endl;
+        return false;
+    }
+
+    if( metric != EUCLIDEAN_DISTANCE && metric != MANHATTAN_DISTANCE ){
+        errorLog << "build(...) - Unknown distance metric!" << endl;
+        return false;
+    }
+
+    if( leafSize == 0 ){
+        errorLog << "build(...) - The leaf size must be greater than zero!" << endl;
+        return false;
+    }
+
+    this->metric = metric;
+    this->numSamples = M;
+    this->numDimensions = N;
+
+    sampleIndexes.resize( M );
+    for(UINT i=0; i<M; i++) sampleIndexes[i] = i;
+
+    buildNode( data, 0, M, leafSize );
+
+    //Store the samples column-major in leaf order, so the samples in each leaf are next to each other in each column
+    samples.resize( N*M );
+    for(UINT i=0; i<M; i++){
+        const double *x = data[ sampleIndexes[i] ];
+        for(UINT j=0; j<N; j++){
+            samples[ j*M + i ] = x[j];
+        }
+    }
+
+    return true;
+}
+
+bool KDTree::clear(){
+
+    metric = EUCLIDEAN_DISTANCE;
+    numSamples = 0;
+    numDimensions = 0;
+    maxLeafSize = 0;
+    nodes.clear();
+    sampleIndexes.clear();
+    samples.clear();
+    boxes.clear();
+
+    return true;
+}
+
+bool KDTree::search( const VectorDouble &x, const UINT K, vector< IndexedDouble > &neighbours ) const{
+
+    neighbours.clear();
+
+    if( !getIsBuilt() ){
+        errorLog << "search(...) - The tree has not been built!" << endl;
+        return false;
+    }
+
+    if( x.size() != numDimensions ){
+        errorLog << "search(...) - The size of the input vector " << x.size() << " does not match the number of dimensions " << numDimensions << endl;
+        return false;
+    }
+
+    if( K == 0 || K > numSamples ){
+        errorLog << "search(...) - K must be greater than zero and not more than the number of samples!" << endl;
+        return false;
+    }
+
+    neighbours.reserve( K );
+    VectorDouble distances( maxLeafSize );
+
+    searchNode( 0, &x[0], K, neighbours, &distances[0] );
+    sortNeighbours( neighbours );
+
+    return true;
+}
+
+bool KDTree::addNeighbour( vector< IndexedDouble > &neighbours, const UINT K, const IndexedDouble &neighbour ){
+
+    if( neighbours.size() < K ){
+        neighbours.push_back( neighbour );
+        std::push_heap( neighbours.begin(), neighbours.end(), compareNeighbours );
+        return true;
+    }
+
+    //The front of the heap is the furthest neighbour found so far
+    if( K > 0 && compareNeighbours( neighbour, neighbours.front() ) ){
+        std::pop_heap( neighbours.begin(), neighbours.end(), compareNeighbours );
+        neighbours.back() = neighbour;
+        std::push_heap( neighbours.begin(), neighbours.end(), compareNeighbours );
+        return true;
+    }
+
+    return false;
+}
+
+void KDTree::sortNeighbours( vector< IndexedDouble > &neighbours ){
+    std::sort_heap( neighbours.begin(), neighbours.end(), compareNeighbours );
+}
+
+UINT KDTree::buildNode( const MatrixDouble &data, const UINT start, const UINT end, const UINT leafSize ){
+
+    const UINT N = numDimensions;
+    const UINT nodeIndex = (UINT)nodes.size();
+
+    KDTreeNode node;
+    node.start = start;
+    node.end = end;
+    node.leftChild = 0;
+    node.rightChild = 0;
+    node.isLeafNode = true;
+    nodes.push_back( node );
+
+    //Compute the bounding box of the samples in this node
+    boxes.resize( boxes.size() + N*2 );
+    double *minValues = &boxes[ nodeIndex*N*2 ];
+    double *maxValues = minValues + N;
+    for(UINT j=0; j<N; j++){
+        minValues[j] = maxValues[j] = data[ sampleIndexes[start] ][j];
+    }
+    for(UINT i=start+1; i<end; i++){
+        const double *x = data[ sampleIndexes[i] ];
+        for(UINT j=0; j<N; j++){
+            if( x[j] < minValues[j] ) minValues[j] = x[j];
+            else if( x[j] > maxValues[j] ) maxValues[j] = x[j];
+        }
+    }
+
+    //Split on the dimension with the largest range
+    UINT splitDimension = 0;
+    double maxRange = 0;
+    for(UINT j=0; j<N; j++){
+        if( maxValues[j] - minValues[j] > maxRange ){
+            maxRange = maxValues[j] - minValues[j];
+            splitDimension = j;
+        }
+    }
+
+    //If there are only a few samples left, or they are all the same, then this is a leaf
+    if( end - start <= leafSize || maxRange <= 0 ){
+        if( end - start > maxLeafSize ) maxLeafSize = end - start;
+        return nodeIndex;
+    }
+
+    //Split the samples at the median
+    const UINT middle = start + (end - start)/2;
+    std::nth_element( sampleIndexes.begin()+start, sampleIndexes.begin()+middle, sampleIndexes.begin()+end, KDTreeSampleComparator( data, splitDimension ) );
+
+    const UINT leftChild = buildNode( data, start, middle, leafSize );
+    const UINT rightChild = buildNode( data, middle, end, leafSize );
+
+    nodes[ nodeIndex ].leftChild = leftChild;
+    nodes[ nodeIndex ].rightChild = rightChild;
+    nodes[ nodeIndex ].isLeafNode = false;
+
+    return nodeIndex;
+}
+
+void KDTree::searchNode( const UINT nodeIndex, const double *x, const UINT K, vector< IndexedDouble > &neighbours, double *distances ) const{
+
+    const KDTreeNode &node = nodes[ nodeIndex ];
+
+    if( node.isLeafNode ){
+        //Compute the distance to all the samples in the leaf at once
+        const UINT kernelMetric = metric == EUCLIDEAN_DISTANCE ? DistanceKernels::EUCLIDEAN_DISTANCE : DistanceKernels::ABSOLUTE_DISTANCE;
+        DistanceKernels::computeDistances( kernelMetric, x, &samples[0], numSamples, numDimensions, node.start, node.end-1, distances );
+
+        for(UINT i=node.start; i<node.end; i++){
+            addNeighbour( neighbours, K, IndexedDouble( sampleIndexes[i], distances[i-node.start] ) );
+        }
+        return;
+    }
+
+    //Search the child that is closest to x first, so the furthest neighbour is as close as possible when the other child is tested
+    UINT children[2] = { node.leftChild, node.rightChild };
+    double lowerBounds[2] = { computeLowerBound( node.leftChild, x ), computeLowerBound( node.rightChild, x ) };
+    if( lowerBounds[1] < lowerBounds[0] ){
+        std::swap( children[0], children[1] );
+        std::swap( lowerBounds[0], lowerBounds[1] );
+    }
+
+    for(UINT k=0; k<2; k++){
+        if( neighbours.size() == K ){
+            const double maxDistance = neighbours.front().value;
+            if( lowerBounds[k] > maxDistance + maxDistance*GRT_KDTREE_BOUND_TOLERANCE ) continue;
+        }
+        searchNode( children[k], x, K, neighbours, distances );
+    }
+}
+
+double KDTree::computeLowerBound( const UINT nodeIndex, const double *x ) const{
+
+    //The lower bound is the distance from x to the closest point in the bounding box of the node
+    const UINT N = numDimensions;
+    const double *minValues = &boxes[ nodeIndex*N*2 ];
+    const double *maxValues = minValues + N;
+    double bound = 0;
+    double delta = 0;
+
+    for(UINT j=0; j<N; j++){
+        if( x[j] < minValues[j] ) delta = minValues[j] - x[j];
+        else if( x[j] > maxValues[j] ) delta = x[j] - maxValues[j];
+        else continue;
+        bound += metric == EUCLIDEAN_DISTANCE ? delta*delta : delta;
+    }
+
+    return metric == EUCLIDEAN_DISTANCE ? sqrt( bound ) : bound;
+}
+
+bool KDTree::compareNeighbours( const IndexedDouble &a, const IndexedDouble &b ){
+    return a.value < b.value || (a.value == b.value && a.index < b.index);
+}
+
+} //End of namespace GRT
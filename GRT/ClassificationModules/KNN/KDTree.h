@@ -0,0 +1,148 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The KDTree class is a spatial index used by the KNN classifier to find the K nearest neighbours of an input vector without
+ computing the distance to every training sample.
+
+ The tree is built by recursively splitting the samples at the median of the dimension with the largest range, until each leaf holds
+ at most leafSize samples.  Each node stores the bounding box of its samples, so a node can be skipped when the smallest possible
+ distance between the input vector and its box is greater than the distance to the K'th nearest neighbour found so far.  The samples
+ are stored column-major in leaf order, so the distances to all the samples in a leaf are computed at once with the DistanceKernels.
+
+ The search is exact: the neighbours are the same as a brute force search, with ties in the distance broken by the index of the sample.
+
+ Example:
+ @code
+ KDTree tree;
+ tree.build( data, KDTree::EUCLIDEAN_DISTANCE );
+
+ vector< IndexedDouble > neighbours;
+ tree.search( inputVector, K, neighbours );
+ @endcode
+ */
+
+/**
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_KDTREE_HEADER
+#define GRT_KDTREE_HEADER
+
+#include "../../Util/GRTCommon.h"
+#include "../../Util/DistanceKernels.h"
+
+namespace GRT{
+
+//A node in the tree, a leaf node has no children and holds the samples in [start end)
+struct KDTreeNode{
+    UINT start;
+    UINT end;
+    UINT leftChild;
+    UINT rightChild;
+    bool isLeafNode;
+};
+
+class KDTree{
+public:
+    /**
+     Default Constructor
+     */
+    KDTree();
+
+    /**
+     Default Destructor
+     */
+    ~KDTree();
+
+    /**
+     Builds the tree from the data.  Any previous tree will be cleared.
+
+     @param const MatrixDouble &data: the samples that will be indexed, with one row per sample
+     @param const UINT metric: the distance metric used by the search, this should be one of the DistanceMetrics enums
+     @param const UINT leafSize: the maximum number of samples in each leaf, a leaf can only hold more samples than this if they are all the same. Default value is leafSize = 16
+     @return returns true if the tree was built, false otherwise
+     */
+    bool build( const MatrixDouble &data, const UINT metric, const UINT leafSize = 16 );
+
+    /**
+     Clears the tree.
+
+     @return returns true if the tree was cleared, false otherwise
+     */
+    bool clear();
+
+    /**
+     Finds the K nearest neighbours of x.  The index of each neighbour is the row of the sample in the data used to build the tree,
+     and the value is the distance to the sample.
+
+     @param const VectorDouble &x: the input vector, this must have the same number of dimensions as the data used to build the tree
+     @param const UINT K: the number of neighbours to find, this must be greater than zero and not more than the number of samples
+     @param vector< IndexedDouble > &neighbours: this will store the K nearest neighbours, sorted by distance and then by index
+     @return returns true if the neighbours were found, false otherwise
+     */
+    bool search( const VectorDouble &x, const UINT K, vector< IndexedDouble > &neighbours ) const;
+
+    /**
+     Adds a neighbour to a heap of the K nearest neighbours found so far.  If the heap is full, the neighbour replaces the furthest
+     neighbour in the heap if it is closer (or the same distance but with a smaller index).  The heap can be sorted with sortNeighbours.
+
+     @param vector< IndexedDouble > &neighbours: the heap of the nearest neighbours
+     @param const UINT K: the maximum number of neighbours in the heap
+     @param const IndexedDouble &neighbour: the index and distance of the new neighbour
+     @return returns true if the neighbour was added to the heap, false otherwise
+     */
+    static bool addNeighbour( vector< IndexedDouble > &neighbours, const UINT K, const IndexedDouble &neighbour );
+
+    /**
+     Sorts a heap built with addNeighbour, so the neighbours are in order of distance and then index.
+
+     @param vector< IndexedDouble > &neighbours: the heap of the nearest neighbours
+     */
+    static void sortNeighbours( vector< IndexedDouble > &neighbours );
+
+    bool getIsBuilt() const{ return nodes.size() > 0; }
+    UINT getMetric() const{ return metric; }
+    UINT getNumSamples() const{ return numSamples; }
+    UINT getNumDimensions() const{ return numDimensions; }
+    UINT getNumNodes() const{ return (UINT)nodes.size(); }
+
+    enum DistanceMetrics{EUCLIDEAN_DISTANCE=0,MANHATTAN_DISTANCE};
+
+protected:
+    UINT buildNode( const MatrixDouble &data, const UINT start, const UINT end, const UINT leafSize );
+    void searchNode( const UINT nodeIndex, const double *x, const UINT K, vector< IndexedDouble > &neighbours, double *distances ) const;
+    double computeLowerBound( const UINT nodeIndex, const double *x ) const;
+    static bool compareNeighbours( const IndexedDouble &a, const IndexedDouble &b );
+
+    UINT metric;
+    UINT numSamples;
+    UINT numDimensions;
+    UINT maxLeafSize;                               ///< The number of samples in the largest leaf
+    vector< KDTreeNode > nodes;                     ///< The nodes of the tree, the root is node 0
+    vector< UINT > sampleIndexes;                   ///< The row of each sample in the data used to build the tree, in leaf order
+    VectorDouble samples;                           ///< The samples in leaf order, stored column-major as a numDimensions x numSamples buffer
+    VectorDouble boxes;                             ///< The bounding box of each node, stored as the minimum and then maximum of each dimension
+    ErrorLog errorLog;
+};
+
+} //End of namespace GRT
+
+#endif //GRT_KDTREE_HEADER
@@ -24,6 +24,15 @@ using namespace std;
 
 namespace GRT{
     
+//The search tree is only built if there are at least this many training samples, smaller datasets are faster to search one block at a time
+#define KNN_MIN_NUM_SAMPLES_FOR_SEARCH_TREE 64
+    
+//The search tree is only built if there are at most this many dimensions, and at least 2^numDimensions training samples
+#define KNN_MAX_NUM_DIMENSIONS_FOR_SEARCH_TREE 16
+    
+//The number of training samples compared with each input vector at a time when the training data is searched without the tree
+#define KNN_SAMPLE_BLOCK_SIZE 256
+    
 //Register the DTW module with the Classifier base class
 RegisterClassifierModule< KNN > KNN::registerModule("KNN");
 
@@ -36,6 +45,7 @@ KNN::KNN(unsigned int K,bool useScaling,bool useNullRejection,double nullRejecti
     this->searchForBestKValue = searchForBestKValue;
     this->minKSearchValue = minKSearchValue;
     this->maxKSearchValue = maxKSearchValue;
+    this->useSearchTree = true;
     supportsNullRejection = true;
     classType = "KNN";
     classifierType = classType;
@@ -73,6 +83,10 @@ KNN& KNN::operator=(const KNN &rhs){
         this->trainingData = rhs.trainingData;
         this->trainingMu = rhs.trainingMu;
         this->trainingSigma = rhs.trainingSigma;
+        this->useSearchTree = rhs.useSearchTree;
+        this->trainingSamples = rhs.trainingSamples;
+        this->trainingNorms = rhs.trainingNorms;
+        this->searchTree = rhs.searchTree;
         
         //Classifier variables
         copyBaseVariables( (Classifier*)&rhs );
@@ -96,6 +110,10 @@ bool KNN::deepCopyFrom(const Classifier *classifier){
         this->trainingData = ptr->trainingData;
         this->trainingMu = ptr->trainingMu;
         this->trainingSigma = ptr->trainingSigma;
+        this->useSearchTree = ptr->useSearchTree;
+        this->trainingSamples = ptr->trainingSamples;
+        this->trainingNorms = ptr->trainingNorms;
+        this->searchTree = ptr->searchTree;
         
         //Classifier variables
         return copyBaseVariables( classifier );
@@ -124,8 +142,9 @@ bool KNN::train_(ClassificationData &trainingData){
     this->numInputDimensions = trainingData.getNumDimensions();
     this->numClasses = trainingData.getNumClasses();
     
-    //TODO: In the future need to build a kdtree from the training data to allow better realtime prediction
+    //Store the training data and build the search index, which will be used to find the nearest neighbours
     this->trainingData = trainingData;
+    buildSearchIndex();
     
     //Set the class labels
     classLabels.resize( numClasses );
@@ -233,22 +252,30 @@ bool KNN::train_(const ClassificationData &trainingData,const UINT K){
         trainingSigma.resize( numClasses, 0 );
         nullRejectionThresholds.resize( numClasses, 0 );
 
-        //Compute Mu for each of the classes
+        //Predict all the training examples at once
         const unsigned int numTrainingExamples = trainingData.getNumSamples();
+        vector< UINT > predictedClassLabels;
+        MatrixDouble predictedLikelihoods, predictedDistances;
+        if( !predict( trainingData.getDataAsMatrixDouble(), K, predictedClassLabels, predictedLikelihoods, predictedDistances ) ){
+            errorLog << "train_(const ClassificationData &trainingData,const UINT K) - Failed to predict the training examples for a K value of " << K << endl;
+            useNullRejection = true;
+            trained = false;
+            return false;
+        }
+
+        //Compute Mu for each of the classes
         vector< IndexedDouble > predictionResults( numTrainingExamples );
         for(UINT i=0; i<numTrainingExamples; i++){
-            predict( trainingData[i].getSample(), K);
-
             UINT classLabelIndex = 0;
             for(UINT k=0; k<numClasses; k++){
-                if( predictedClassLabel == classLabels[k] ){
+                if( predictedClassLabels[i] == classLabels[k] ){
                     classLabelIndex = k;
                     break;
                 }
             }
 
             predictionResults[ i ].index = classLabelIndex;
-            predictionResults[ i ].value = classDistances[ classLabelIndex ];
+            predictionResults[ i ].value = predictedDistances[ i ][ classLabelIndex ];
 
             trainingMu[ classLabelIndex ] += predictionResults[ i ].value;
             counter[ classLabelIndex ]++;
@@ -353,61 +380,198 @@ bool KNN::predict(const VectorDouble &inputVector,const UINT K){
         return false;
     }
 
-    //TODO - need to build a kdtree of the training data to allow better realtime prediction
-    const UINT M = trainingData.getNumSamples();
-    vector< IndexedDouble > neighbours;
+    if( !searchNearestNeighbours( inputVector, K, neighbourBuffer ) ){
+        return false;
+    }
 
-    for(UINT i=0; i<M; i++){
-        double dist = 0;
-        UINT classLabel = trainingData[i].getClassLabel();
-        VectorDouble trainingSample = trainingData[i].getSample();
-
-        switch( distanceMethod ){
-            case EUCLIDEAN_DISTANCE:
-                dist = computeEuclideanDistance(inputVector,trainingSample);
-                break;
-            case COSINE_DISTANCE:
-                dist = computeCosineDistance(inputVector,trainingSample);
-                break;
-            case MANHATTAN_DISTANCE:
-                dist = computeManhattanDistance(inputVector, trainingSample);
-                break;
-            default:
-                errorLog << "predict(vector< double > inputVector) - unkown distance measure!" << endl;
+    //Predict the class ID using the labels of the K nearest neighbours
+    if( classLikelihoods.size() != numClasses ) classLikelihoods.resize(numClasses);
+    if( classDistances.size() != numClasses ) classDistances.resize(numClasses);
+    
+    return predictFromNeighbours( neighbourBuffer, &classLikelihoods[0], &classDistances[0], predictedClassLabel, maxLikelihood );
+}
+    
+bool KNN::predict(const MatrixDouble &X,vector< UINT > &predictedClassLabels,MatrixDouble &classLikelihoods,MatrixDouble &classDistances){
+    
+    if( !trained ){
+        errorLog << "predict(const MatrixDouble &X,...) - KNN model has not been trained" << endl;
+        return false;
+    }
+    
+    if( X.getNumCols() != numInputDimensions ){
+        errorLog << "predict(const MatrixDouble &X,...) - The number of columns in X (" << X.getNumCols() << ") does not match the number of features " << numInputDimensions << endl;
+        return false;
+    }
+    
+    //Scale a copy of the data, so the input matrix is not changed
+    if( useScaling ){
+        MatrixDouble scaledData( X );
+        for(UINT i=0; i<scaledData.getNumRows(); i++){
+            for(UINT j=0; j<numInputDimensions; j++){
+                scaledData[i][j] = scale(X[i][j], ranges[j].minValue, ranges[j].maxValue, 0, 1);
+            }
+        }
+        return predict(scaledData,K,predictedClassLabels,classLikelihoods,classDistances);
+    }
+    
+    return predict(X,K,predictedClassLabels,classLikelihoods,classDistances);
+}
+    
+bool KNN::predict(const MatrixDouble &X,const UINT K,vector< UINT > &predictedClassLabels,MatrixDouble &classLikelihoods,MatrixDouble &classDistances){
+    
+    const UINT Q = X.getNumRows();
+    const UINT M = trainingData.getNumSamples();
+    
+    if( K > M ){
+        errorLog << "predict(const MatrixDouble &X,...) - K Is Greater Than The Number Of Training Samples" << endl;
+        return false;
+    }
+    
+    predictedClassLabels.resize( Q );
+    classLikelihoods.resize( Q, numClasses );
+    classDistances.resize( Q, numClasses );
+    if( Q == 0 ) return true;
+    
+    vector< vector< IndexedDouble > > neighbours( Q );
+    VectorDouble x( numInputDimensions );
+    
+    if( getSearchTreeUsable() ){
+        for(UINT q=0; q<Q; q++){
+            std::copy( X[q], X[q]+numInputDimensions, x.begin() );
+            if( !searchTree.search( x, K, neighbours[q] ) ){
+                errorLog << "predict(const MatrixDouble &X,...) - Failed to search the tree!" << endl;
                 return false;
-                break;
+            }
         }
-
-        if( neighbours.size() < K ){
-            neighbours.push_back( IndexedDouble(classLabel,dist) );
-        }else{
-            //Find the maximum value in the neighbours buffer
-            double maxValue = neighbours[0].value;
-            UINT maxIndex = 0;
-            for(UINT n=1; n<neighbours.size(); n++){
-                if( neighbours[n].value > maxValue ){
-                    maxValue = neighbours[n].value;
-                    maxIndex = n;
+    }else{
+        if( trainingSamples.size() != numInputDimensions*M ){
+            errorLog << "predict(const MatrixDouble &X,...) - The training samples have not been stored!" << endl;
+            return false;
+        }
+        
+        //The norm of each input vector is only needed for the cosine distance
+        VectorDouble inputNorms( Q, 0 );
+        if( distanceMethod == COSINE_DISTANCE ){
+            for(UINT q=0; q<Q; q++){
+                double magA = 0;
+                for(UINT j=0; j<numInputDimensions; j++) magA += SQR( X[q][j] );
+                inputNorms[q] = sqrt( magA );
+            }
+        }
+        
+        //Each block of training samples is compared with every input vector before moving on to the next block, so the block stays in the cache
+        distanceBuffer.resize( KNN_SAMPLE_BLOCK_SIZE );
+        for(UINT q=0; q<Q; q++) neighbours[q].reserve( K );
+        for(UINT start=0; start<M; start+=KNN_SAMPLE_BLOCK_SIZE){
+            const UINT end = std::min( M, start+KNN_SAMPLE_BLOCK_SIZE );
+            for(UINT q=0; q<Q; q++){
+                if( !computeNeighbourDistances( X[q], inputNorms[q], start, end, &distanceBuffer[0] ) ){
+                    return false;
+                }
+                for(UINT i=start; i<end; i++){
+                    //The samples are added in order of index, so a sample that is no closer than the furthest neighbour can be skipped
+                    if( neighbours[q].size() < K || distanceBuffer[i-start] < neighbours[q].front().value ){
+                        KDTree::addNeighbour( neighbours[q], K, IndexedDouble(i,distanceBuffer[i-start]) );
+                    }
                 }
             }
-
-            //If the dist is less than the maximum value in the buffer, then replace that value with the new dist
-            if( dist < maxValue ){
-                neighbours[ maxIndex ] = IndexedDouble(classLabel,dist);
+        }
+        for(UINT q=0; q<Q; q++) KDTree::sortNeighbours( neighbours[q] );
+    }
+    
+    for(UINT q=0; q<Q; q++){
+        double likelihood = 0;
+        if( !predictFromNeighbours( neighbours[q], classLikelihoods[q], classDistances[q], predictedClassLabels[q], likelihood ) ){
+            return false;
+        }
+    }
+    
+    return true;
+}
+    
+bool KNN::searchNearestNeighbours(const VectorDouble &x,const UINT K,vector< IndexedDouble > &neighbours){
+    
+    //Use the search tree if it was built for the current distance method, otherwise search each training sample
+    if( getSearchTreeUsable() ){
+        if( !searchTree.search( x, K, neighbours ) ){
+            errorLog << "searchNearestNeighbours(...) - Failed to search the tree!" << endl;
+            return false;
+        }
+        return true;
+    }
+    
+    const UINT M = trainingData.getNumSamples();
+    if( trainingSamples.size() != numInputDimensions*M ){
+        errorLog << "searchNearestNeighbours(...) - The training samples have not been stored!" << endl;
+        return false;
+    }
+    
+    double inputNorm = 0;
+    if( distanceMethod == COSINE_DISTANCE ){
+        for(UINT j=0; j<numInputDimensions; j++) inputNorm += SQR( x[j] );
+        inputNorm = sqrt( inputNorm );
+    }
+    
+    //Keep the K closest samples, ties are broken by the index of the sample so the result matches the search tree
+    neighbours.clear();
+    neighbours.reserve( K );
+    distanceBuffer.resize( KNN_SAMPLE_BLOCK_SIZE );
+    for(UINT start=0; start<M; start+=KNN_SAMPLE_BLOCK_SIZE){
+        const UINT end = std::min( M, start+KNN_SAMPLE_BLOCK_SIZE );
+        if( !computeNeighbourDistances( &x[0], inputNorm, start, end, &distanceBuffer[0] ) ){
+            return false;
+        }
+        for(UINT i=start; i<end; i++){
+            //The samples are added in order of index, so a sample that is no closer than the furthest neighbour can be skipped
+            if( neighbours.size() < K || distanceBuffer[i-start] < neighbours.front().value ){
+                KDTree::addNeighbour( neighbours, K, IndexedDouble(i,distanceBuffer[i-start]) );
             }
         }
     }
-
-    //Predict the class ID using the labels of the K nearest neighbours
-    if( classLikelihoods.size() != numClasses ) classLikelihoods.resize(numClasses);
-    if( classDistances.size() != numClasses ) classDistances.resize(numClasses);
+    KDTree::sortNeighbours( neighbours );
+    
+    return true;
+}
+    
+bool KNN::computeNeighbourDistances(const double *x,const double inputNorm,const UINT start,const UINT end,double *distances) const{
+    
+    const UINT M = trainingData.getNumSamples();
+    UINT metric = 0;
+    
+    switch( distanceMethod ){
+        case EUCLIDEAN_DISTANCE:
+            metric = DistanceKernels::EUCLIDEAN_DISTANCE;
+            break;
+        case COSINE_DISTANCE:
+            metric = DistanceKernels::DOT_PRODUCT;
+            break;
+        case MANHATTAN_DISTANCE:
+            metric = DistanceKernels::ABSOLUTE_DISTANCE;
+            break;
+        default:
+            errorLog << "computeNeighbourDistances(...) - unkown distance measure!" << endl;
+            return false;
+            break;
+    }
     
-    std::fill(classLikelihoods.begin(),classLikelihoods.end(),0);
-    std::fill(classDistances.begin(),classDistances.end(),0);
+    DistanceKernels::computeDistances( metric, x, &trainingSamples[0], M, numInputDimensions, start, end-1, distances );
+    
+    //The kernels sum over the dimensions in the same order as computeEuclideanDistance, computeCosineDistance and computeManhattanDistance
+    if( distanceMethod == COSINE_DISTANCE ){
+        for(UINT i=start; i<end; i++) distances[i-start] = distances[i-start] / (inputNorm * trainingNorms[i]);
+    }
+    
+    return true;
+}
+    
+bool KNN::predictFromNeighbours(const vector< IndexedDouble > &neighbours,double *likelihoods,double *distances,UINT &predictedLabel,double &likelihood) const{
+    
+    std::fill(likelihoods,likelihoods+numClasses,0);
+    std::fill(distances,distances+numClasses,0);
 
-    //Count the classes
+    //Count the classes, the neighbours are sorted by distance and then index so the distances are always summed in the same order
     for(UINT k=0; k<neighbours.size(); k++){
-        UINT classLabel = neighbours[k].index;
+        UINT classLabel = trainingData[ neighbours[k].index ].getClassLabel();
         if( classLabel == 0 ){
             errorLog << "predict(VectorDouble inputVector) - Class label of training example can not be zero!" << endl;
             return false;
@@ -421,42 +585,42 @@ bool KNN::predict(const VectorDouble &inputVector,const UINT K){
 				break;
 			}
 		}
-        classLikelihoods[ classLabelIndex ] += 1;
-        classDistances[ classLabelIndex ] += neighbours[k].value;
+        likelihoods[ classLabelIndex ] += 1;
+        distances[ classLabelIndex ] += neighbours[k].value;
     }
 
     //Get the max count
-    double maxCount = classLikelihoods[0];
+    double maxCount = likelihoods[0];
     UINT maxIndex = 0;
-    for(UINT i=1; i<classLikelihoods.size(); i++){
-        if( classLikelihoods[i] > maxCount ){
-            maxCount = classLikelihoods[i];
+    for(UINT i=1; i<numClasses; i++){
+        if( likelihoods[i] > maxCount ){
+            maxCount = likelihoods[i];
             maxIndex = i;
         }
     }
 
     //Compute the average distances per class
     for(UINT i=0; i<numClasses; i++){
-        if( classLikelihoods[i] > 0 )   classDistances[i] /= classLikelihoods[i];
-        else classDistances[i] = BIG_DISTANCE;
+        if( likelihoods[i] > 0 )   distances[i] /= likelihoods[i];
+        else distances[i] = BIG_DISTANCE;
     }
 
     //Normalize the likelihoods
     for(UINT i=0; i<numClasses; i++){
-        classLikelihoods[i] /= double( neighbours.size() );
+        likelihoods[i] /= double( neighbours.size() );
     }
 
     //Set the maximum likelihood value
-    maxLikelihood = classLikelihoods[ maxIndex ];
+    likelihood = likelihoods[ maxIndex ];
 
     if( useNullRejection ){
-        if( classDistances[ maxIndex ] <= nullRejectionThresholds[ maxIndex ] ){
-            predictedClassLabel = classLabels[maxIndex];
+        if( distances[ maxIndex ] <= nullRejectionThresholds[ maxIndex ] ){
+            predictedLabel = classLabels[maxIndex];
         }else{
-            predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL; //Set the gesture label as the null label
+            predictedLabel = GRT_DEFAULT_NULL_CLASS_LABEL; //Set the gesture label as the null label
         }
     }else{
-        predictedClassLabel = classLabels[maxIndex];
+        predictedLabel = classLabels[maxIndex];
     }
 
     return true;
@@ -471,6 +635,9 @@ bool KNN::clear(){
     trainingData.clear();
     trainingMu.clear();
     trainingSigma.clear();
+    trainingSamples.clear();
+    trainingNorms.clear();
+    searchTree.clear();
     
     return true;
 }
@@ -653,6 +820,9 @@ bool KNN::loadModelFromFile(fstream &file){
             trainingData.addSample(classLabel, sample);
         }
         
+        //The search index is not saved with the model, so rebuild it from the training data
+        buildSearchIndex();
+        
         maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
         bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
         classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
@@ -721,6 +891,54 @@ bool KNN::setDistanceMethod(UINT distanceMethod){
     return false;
 }
 
+bool KNN::enableSearchTree(const bool useSearchTree){
+    this->useSearchTree = useSearchTree;
+    return true;
+}
+    
+bool KNN::buildSearchIndex(){
+    
+    const UINT M = trainingData.getNumSamples();
+    const UINT N = trainingData.getNumDimensions();
+    
+    //Store the training samples column-major, so the distance to a block of samples can be computed at once by the DistanceKernels
+    trainingSamples.resize( N*M );
+    trainingNorms.resize( M );
+    for(UINT i=0; i<M; i++){
+        const ClassificationSample &sample = trainingData[i];
+        double magB = 0;
+        for(UINT j=0; j<N; j++){
+            trainingSamples[ j*M + i ] = sample[j];
+            magB += SQR( sample[j] );
+        }
+        trainingNorms[i] = sqrt( magB );
+    }
+    
+    searchTree.clear();
+    
+    //The cosine distance is not a metric, so the tree can not be used to search for the nearest neighbours
+    if( !useSearchTree || distanceMethod == COSINE_DISTANCE || M < KNN_MIN_NUM_SAMPLES_FOR_SEARCH_TREE ){
+        return true;
+    }
+    
+    //A tree only skips most of the samples when there are many more samples than corners of the bounding boxes, otherwise the block search is faster
+    if( N > KNN_MAX_NUM_DIMENSIONS_FOR_SEARCH_TREE || M < (1u << N) ){
+        return true;
+    }
+    
+    const UINT treeMetric = distanceMethod == MANHATTAN_DISTANCE ? KDTree::MANHATTAN_DISTANCE : KDTree::EUCLIDEAN_DISTANCE;
+    if( !searchTree.build( trainingData.getDataAsMatrixDouble(), treeMetric ) ){
+        warningLog << "buildSearchIndex() - Failed to build the search tree, the training data will be searched one block at a time" << endl;
+    }
+    
+    return true;
+}
+    
+bool KNN::getSearchTreeUsable() const{
+    const UINT treeMetric = distanceMethod == MANHATTAN_DISTANCE ? KDTree::MANHATTAN_DISTANCE : KDTree::EUCLIDEAN_DISTANCE;
+    return useSearchTree && distanceMethod != COSINE_DISTANCE && searchTree.getIsBuilt() && searchTree.getMetric() == treeMetric && searchTree.getNumSamples() == trainingData.getNumSamples();
+}
+
 double KNN::computeEuclideanDistance(const VectorDouble &a,const VectorDouble &b){
     double dist = 0;
     for(UINT j=0; j<numInputDimensions; j++){
@@ -906,6 +1124,9 @@ bool KNN::loadLegacyModelFromFile( fstream &file ){
         trainingData.addSample(classLabel, sample);
     }
     
+    //The search index is not saved with the model, so rebuild it from the training data
+    buildSearchIndex();
+    
     //Flag that the model has been trained
     trained = true;
     
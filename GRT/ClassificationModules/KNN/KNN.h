@@ -14,6 +14,14 @@
  the predicted class label will be set to 0, indicating that the majority class was rejected.  This feature can be enabled or disabled by setting
  the enableNullRejection paramter to false.
  
+ If several training samples are the same distance from the input vector as the Kth nearest neighbour, the samples with the smallest index in
+ the training data are used as the neighbours, with or without the search tree.  Versions of the GRT before the search tree was added kept the
+ first sample found at a given distance and replaced the first of several equally distant neighbours, which depends on the order the samples
+ were searched in.  On data with many repeated distances, such as quantized data, a small number of inputs can therefore be given a different
+ class label than they were by a model trained with an earlier version.  The distances of the neighbours of each class are summed in order of
+ distance (and then index), rather than in the order of the old neighbour buffer, so the class distances can also differ from those of an earlier
+ version in the last bits.
+ 
  @example ClassificationModulesExamples/KNNExample/KNNExample.cpp
  
  @remark This implementation is based on Bishop, Christopher M. Pattern recognition and machine learning. Vol. 1. New York: springer, 2006.
@@ -43,6 +51,7 @@
 #define GRT_KNN_HEADER
 
 #include "../../CoreModules/Classifier.h"
+#include "KDTree.h"
 
 namespace GRT{
     
@@ -213,6 +222,38 @@ public:
      */
     bool setDistanceMethod(UINT distanceMethod);
     
+    /**
+     Sets if a KDTree of the training data should be used to find the nearest neighbours.  The tree is built when the model is trained
+     or loaded, and is only used for the EUCLIDEAN_DISTANCE and MANHATTAN_DISTANCE methods when there are at most 16 dimensions and at least
+     2^numDimensions training samples, otherwise the training data is searched one block at a time.  The predictions are the same with or without the tree.
+     
+     This should be called prior to training a KNN model.
+     
+     @param const bool useSearchTree: sets if the search tree should be used
+     @return returns true if the parameter was updated successfully, false otherwise
+     */
+    bool enableSearchTree(const bool useSearchTree);
+    
+    /**
+     Gets if a KDTree of the training data should be used to find the nearest neighbours.
+     
+     @return returns true if the search tree is enabled, false otherwise
+     */
+    bool getSearchTreeEnabled() const{ return useSearchTree; }
+    
+    /**
+     This predicts the class of each row of X.  If the search tree can not be used, then each block of training samples is compared with all
+     the input vectors before moving on to the next block, which is much faster than predicting each input vector on its own.  The results
+     are the same as calling predict for each row.  The input data will be scaled if useScaling is enabled, but X is not changed.
+     
+     @param const MatrixDouble &X: the input vectors, with one row per input vector
+     @param vector< UINT > &predictedClassLabels: this will store the predicted class label of each input vector
+     @param MatrixDouble &classLikelihoods: this will store the class likelihoods of each input vector, with one row per input vector
+     @param MatrixDouble &classDistances: this will store the average distance to the neighbours of each class, with one row per input vector
+     @return returns true if the predictions were computed, false otherwise
+     */
+    bool predict(const MatrixDouble &X,vector< UINT > &predictedClassLabels,MatrixDouble &classLikelihoods,MatrixDouble &classDistances);
+    
     //Tell the compiler we are using the following functions from the MLBase class to stop hidden virtual function warnings
     using MLBase::saveModelToFile;
     using MLBase::loadModelFromFile;
@@ -225,6 +266,12 @@ protected:
     bool train_(const ClassificationData &trainingData,const UINT K);
     bool predict(const VectorDouble &inputVector,const UINT K);
     bool loadLegacyModelFromFile( fstream &file );
+    bool predict(const MatrixDouble &X,const UINT K,vector< UINT > &predictedClassLabels,MatrixDouble &classLikelihoods,MatrixDouble &classDistances);
+    bool searchNearestNeighbours(const VectorDouble &x,const UINT K,vector< IndexedDouble > &neighbours);
+    bool computeNeighbourDistances(const double *x,const double inputNorm,const UINT start,const UINT end,double *distances) const;
+    bool predictFromNeighbours(const vector< IndexedDouble > &neighbours,double *likelihoods,double *distances,UINT &predictedLabel,double &likelihood) const;
+    bool buildSearchIndex();
+    bool getSearchTreeUsable() const;
     double computeEuclideanDistance(const VectorDouble &a,const VectorDouble &b);
     double computeCosineDistance(const VectorDouble &a,const VectorDouble &b);
     double computeManhattanDistance(const VectorDouble &a,const VectorDouble &b);
@@ -237,6 +284,12 @@ protected:
     ClassificationData trainingData;            ///> Holds the trainingData to perform the predictions
     VectorDouble trainingMu;                    ///> Holds the average max-class distance of the training data for each of classes
     VectorDouble trainingSigma;                 ///> Holds the stddev of the max-class distance of the training data for each of classes
+    bool useSearchTree;                         ///> Sets if the searchTree should be used to find the nearest neighbours
+    KDTree searchTree;                          ///> A spatial index of the trainingData, this is rebuilt from the trainingData when the model is trained or loaded
+    VectorDouble trainingSamples;               ///> The trainingData stored column-major as a numInputDimensions x numSamples buffer, this is rebuilt with the searchTree
+    VectorDouble trainingNorms;                 ///> The magnitude of each training sample, used for the cosine distance
+    VectorDouble distanceBuffer;                ///> A buffer for the distances to a block of training samples
+    vector< IndexedDouble > neighbourBuffer;    ///> A buffer for the nearest neighbours of the last prediction
     
     static RegisterClassifierModule< KNN > registerModule;
     
@@ -196,10 +196,10 @@ bool LDA::train(ClassificationData trainingData){
     return true;
 }
 
-bool LDA::predict(VectorDouble inputVector){
+bool LDA::predict_(VectorDouble &inputVector){
     
     if( !trained ){
-        errorLog << "predict(vector< double > inputVector) - LDA Model Not Trained!" << endl;
+        errorLog << "predict_(VectorDouble &inputVector) - LDA Model Not Trained!" << endl;
         return false;
     }
     
@@ -209,7 +209,7 @@ bool LDA::predict(VectorDouble inputVector){
     if( !trained ) return false;
     
 	if( inputVector.size() != numInputDimensions ){
-        errorLog << "predict(vector< double > inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the num features in the model (" << numInputDimensions << endl;
+        errorLog << "predict_(VectorDouble &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the num features in the model (" << numInputDimensions << endl;
 		return false;
 	}
     
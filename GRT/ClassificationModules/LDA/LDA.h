@@ -119,12 +119,12 @@ public:
     
     /**
      This predicts the class of the inputVector.
-     This overrides the predict function in the Classifier base class.
+     This overrides the predict_ function in the Classifier base class.
      
-     @param VectorDouble inputVector: the input vector to classify
+     @param VectorDouble &inputVector: a reference to the input vector to classify
      @return returns true if the prediction was performed, false otherwise
     */
-    virtual bool predict(VectorDouble inputVector);
+    virtual bool predict_(VectorDouble &inputVector);
     
     /**
      This saves the trained LDA model to a file.
@@ -19,12 +19,43 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
 #include "RandomForests.h"
+#include <cstring>
+#include <stdint.h>
 
 namespace GRT{
 
 //Register the RandomForests module with the Classifier base class
 RegisterClassifierModule< RandomForests >  RandomForests::registerModule("RandomForests");
 
+//The header of the binary model file, see saveModelToBinaryFile for the layout of the file
+#define GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT "GRT_RF_Model_File_BIN"
+#define GRT_RANDOM_FORESTS_BINARY_FILE_VERSION 1
+#define GRT_RANDOM_FORESTS_BINARY_FILE_BYTE_ORDER_MARK 0x01020304
+
+struct RandomForestsBinaryModelHeader{
+    char fileFormat[24];                //GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT, padded with zeros
+    uint32_t version;                   //GRT_RANDOM_FORESTS_BINARY_FILE_VERSION
+    uint32_t byteOrderMark;             //GRT_RANDOM_FORESTS_BINARY_FILE_BYTE_ORDER_MARK, written in the byte order of the machine that saved the file
+    uint32_t headerSize;                //sizeof(RandomForestsBinaryModelHeader)
+    uint32_t useScaling;
+    uint32_t numInputDimensions;
+    uint32_t numOutputDimensions;
+    uint32_t classifierMode;
+    uint32_t numClasses;
+    uint32_t forestSize;
+    uint32_t numRandomSplits;
+    uint32_t minNumSamplesPerNode;
+    uint32_t maxDepth;
+    uint32_t trainingMode;
+    uint32_t removeFeaturesAtEachSpilt;
+    char nodeType[64];                  //The type of DecisionTreeNode used to build the forest, padded with zeros
+    double bootstrappedDatasetWeight;
+    uint64_t classLabelsOffset;         //The offset in bytes of the class labels (1 uint32_t per class)
+    uint64_t rangesOffset;              //The offset in bytes of the ranges (2 doubles per dimension), only used if useScaling is true
+    uint64_t forestOffset;              //The offset in bytes of the flat layout of the forest
+    uint64_t fileSize;                  //The size of the file in bytes, used to check the file is complete
+};
+
 RandomForests::RandomForests(const DecisionTreeNode &decisionTreeNode,const UINT forestSize,const UINT numRandomSplits,const UINT minNumSamplesPerNode,const UINT maxDepth,const UINT trainingMode,const bool removeFeaturesAtEachSpilt,const bool useScaling,const double bootstrappedDatasetWeight)
 {
     this->decisionTreeNode = decisionTreeNode.deepCopy();
@@ -36,6 +67,8 @@ RandomForests::RandomForests(const DecisionTreeNode &decisionTreeNode,const UINT
     this->removeFeaturesAtEachSpilt = removeFeaturesAtEachSpilt;
     this->useScaling = useScaling;
     this->bootstrappedDatasetWeight = bootstrappedDatasetWeight;
+    this->randomSeed = 0;
+    this->useParallelTraining = true;
     classType = "RandomForests";
     classifierType = classType;
     classifierMode = STANDARD_CLASSIFIER_MODE;
@@ -98,6 +131,9 @@ RandomForests& RandomForests::operator=(const RandomForests &rhs){
             this->removeFeaturesAtEachSpilt = rhs.removeFeaturesAtEachSpilt;
             this->bootstrappedDatasetWeight = rhs.bootstrappedDatasetWeight;
             this->trainingMode = rhs.trainingMode;
+            this->randomSeed = rhs.randomSeed;
+            this->useParallelTraining = rhs.useParallelTraining;
+            this->flatForest = rhs.flatForest;
             
         }else errorLog << "deepCopyFrom(const Classifier *classifier) - Failed to copy base variables!" << endl;
 	}
@@ -139,6 +175,9 @@ bool RandomForests::deepCopyFrom(const Classifier *classifier){
             this->removeFeaturesAtEachSpilt = ptr->removeFeaturesAtEachSpilt;
             this->bootstrappedDatasetWeight = ptr->bootstrappedDatasetWeight;
             this->trainingMode = ptr->trainingMode;
+            this->randomSeed = ptr->randomSeed;
+            this->useParallelTraining = ptr->useParallelTraining;
+            this->flatForest = ptr->flatForest;
             
             return true;
         }
@@ -178,43 +217,97 @@ bool RandomForests::train_(ClassificationData &trainingData){
         trainingData.scale(0, 1);
     }
     
+    //Build the columns of the training data once for all the trees, unless the caller has already built them.  The columns are a second
+    //copy of the data, so they are freed as soon as the forest has been trained
+    const bool buildColumns = !trainingData.getColumnStorageBuilt();
+    if( buildColumns ) trainingData.buildColumnStorage();
+    
     //Flag that the main algorithm has been trained encase we need to trigger any callbacks
     trained = true;
     
-    //Train the random forest
-    forest.reserve( forestSize );
+    //Draw the seed of each tree before any of the trees are trained, so each tree is the same whatever order the trees are trained in
+    Random random( randomSeed );
+    vector< unsigned long long > treeSeeds( forestSize );
     for(UINT i=0; i<forestSize; i++){
+        treeSeeds[i] = (unsigned long long)random.getRandomNumberInt( 1, numeric_limits< int >::max() );
+    }
+    
+    //Train the random forest, each tree is stored at its index in the forest so the forest does not depend on the order the trees finish
+    forest.resize( forestSize, NULL );
+    bool result = true;
+    
+    if( !useParallelTraining || ThreadPool::getThreadPoolSize() <= 1 ){
+        for(UINT i=0; i<forestSize; i++){
+            trainingLog << "Training forest " << i+1 << "/" << forestSize << "..." << endl;
+            if( !trainTree( trainingData, i, treeSeeds[i] ) ){
+                errorLog << "train_(ClassificationData &labelledTrainingData) - Failed to train tree at forest index: " << i << endl;
+                result = false;
+                break;
+            }
+        }
+    }else{
+        if( threadPool.get() == NULL ) threadPool.reset( new ThreadPool( ThreadPool::getThreadPoolSize() ) );
         
-        //Get a balanced bootstrapped dataset
-        UINT datasetSize = (UINT)(trainingData.getNumSamples() * bootstrappedDatasetWeight);
-        ClassificationData data = trainingData.getBootstrappedDataset( datasetSize, true );
- 
-        DecisionTree tree;
-        tree.setDecisionTreeNode( *decisionTreeNode );
-        tree.enableScaling( false ); //We have already scaled the training data so we do not need to scale it again
-        tree.setTrainingMode( trainingMode );
-        tree.setNumSplittingSteps( numRandomSplits );
-        tree.setMinNumSamplesPerNode( minNumSamplesPerNode );
-        tree.setMaxDepth( maxDepth );
-        tree.enableNullRejection( useNullRejection );
-        tree.setRemoveFeaturesAtEachSpilt( removeFeaturesAtEachSpilt );
-
-        trainingLog << "Training forest " << i+1 << "/" << forestSize << "..." << endl;
-        
-        //Train this tree
-        if( !tree.train( data ) ){
-            errorLog << "train_(ClassificationData &labelledTrainingData) - Failed to train tree at forest index: " << i << endl;
-            clear();
-            return false;
+        vector< std::future< bool > > trainingTasks;
+        trainingTasks.reserve( forestSize );
+        trainingLog << "Training " << forestSize << " trees on " << ThreadPool::getThreadPoolSize() << " threads..." << endl;
+        for(UINT i=0; i<forestSize; i++){
+            trainingTasks.push_back( threadPool->enqueue( &RandomForests::trainTree, this, std::cref(trainingData), i, treeSeeds[i] ) );
         }
         
-        //Deep copy the tree into the forest
-        forest.push_back( tree.deepCopyTree() );
+        //Wait for all the trees to finish, even if one fails, as the tasks use the training data
+        for(UINT i=0; i<forestSize; i++){
+            if( !trainingTasks[i].get() ){
+                errorLog << "train_(ClassificationData &labelledTrainingData) - Failed to train tree at forest index: " << i << endl;
+                result = false;
+            }
+        }
     }
+    
+    if( buildColumns ) trainingData.clearColumnStorage();
+    
+    if( !result ){
+        clear();
+        return false;
+    }
+    
+    //Build the flat copy of the forest that is used for prediction
+    flatForest.build( forest, numInputDimensions, numClasses );
 
     return true;
 }
 
+bool RandomForests::trainTree( const ClassificationData &trainingData, const UINT treeIndex, const unsigned long long seed ){
+    
+    //The bootstrapped dataset and the random splits of this tree both come from the tree's seed
+    Random random( seed );
+    
+    //Get a balanced bootstrapped dataset, this is a view of the training data so the samples are not copied for each tree
+    UINT datasetSize = (UINT)(trainingData.getNumSamples() * bootstrappedDatasetWeight);
+    ClassificationDataView data( trainingData, trainingData.getBootstrappedIndexes( random, datasetSize, true ) );
+    
+    DecisionTree tree;
+    tree.setDecisionTreeNode( *decisionTreeNode );
+    tree.enableScaling( false ); //We have already scaled the training data so we do not need to scale it again
+    tree.setTrainingMode( trainingMode );
+    tree.setNumSplittingSteps( numRandomSplits );
+    tree.setMinNumSamplesPerNode( minNumSamplesPerNode );
+    tree.setMaxDepth( maxDepth );
+    tree.enableNullRejection( useNullRejection );
+    tree.setRemoveFeaturesAtEachSpilt( removeFeaturesAtEachSpilt );
+    tree.setRandomSeed( (unsigned long long)random.getRandomNumberInt( 1, numeric_limits< int >::max() ) );
+    
+    //Train this tree, this can be called from several threads at the same time so the errors are logged by train_
+    if( !tree.train_( data ) ){
+        return false;
+    }
+    
+    //Deep copy the tree into the forest
+    forest[ treeIndex ] = tree.deepCopyTree();
+    
+    return true;
+}
+
 bool RandomForests::predict_(VectorDouble &inputVector){
     
     predictedClassLabel = 0;
@@ -241,16 +334,20 @@ bool RandomForests::predict_(VectorDouble &inputVector){
     
     std::fill(classDistances.begin(),classDistances.end(),0);
     
-    //Run the prediction for each tree in the forest
-    VectorDouble y;
-    for(UINT i=0; i<forestSize; i++){
-        if( !forest[i]->predict(inputVector, y) ){
-            errorLog << "predict_(VectorDouble &inputVector) - Tree " << i << " failed prediction!" << endl;
-            return false;
-        }
-        
-        for(UINT j=0; j<numClasses; j++){
-            classDistances[j] += y[j];
+    //Run the prediction for each tree in the forest, using the flat copy of the forest if it has been built
+    if( flatForest.getIsBuilt() ){
+        flatForest.predict( inputVector, classDistances );
+    }else{
+        VectorDouble &y = treeLikelihoods;
+        for(UINT i=0; i<forestSize; i++){
+            if( !forest[i]->predict(inputVector, y) ){
+                errorLog << "predict_(VectorDouble &inputVector) - Tree " << i << " failed prediction!" << endl;
+                return false;
+            }
+            
+            for(UINT j=0; j<numClasses; j++){
+                classDistances[j] += y[j];
+            }
         }
     }
     
@@ -278,6 +375,9 @@ bool RandomForests::clear(){
     //Call the classifiers clear function
     Classifier::clear();
     
+    //Clear the flat copy of the forest
+    flatForest.clear();
+    
     //Delete the forest
     for(size_t i=0; i<forest.size(); i++){
         if( forest[i] != NULL ){
@@ -518,11 +618,239 @@ bool RandomForests::loadModelFromFile(fstream &file){
             //Add the tree to the forest
             forest.push_back( tree );
         }
+        
+        //Build the flat copy of the forest that is used for prediction
+        flatForest.build( forest, numInputDimensions, numClasses );
     }
     
     return true;
 }
 
+bool RandomForests::loadModelFromFile(string filename){
+    
+    //Check the start of the file to see if this is a binary model file
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    
+    if( !file.is_open() ){
+        errorLog << "loadModelFromFile(string filename) - Failed to open file: " << filename << endl;
+        return false;
+    }
+    
+    char fileFormat[ sizeof(GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT) ];
+    file.read( fileFormat, sizeof(fileFormat) );
+    const bool isBinaryFile = file.gcount() == (std::streamsize)sizeof(fileFormat) && memcmp( fileFormat, GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT, sizeof(fileFormat) ) == 0;
+    file.close();
+    
+    if( isBinaryFile ){
+        return loadModelFromBinaryFile( filename );
+    }
+    
+    return MLBase::loadModelFromFile( filename );
+}
+    
+bool RandomForests::saveModelToBinaryFile(string filename) const{
+    
+    if( !trained ){
+        errorLog << "saveModelToBinaryFile(string filename) - The RandomForests model has not been trained!" << endl;
+        return false;
+    }
+    
+    if( !flatForest.getIsBuilt() || decisionTreeNode == NULL ){
+        errorLog << "saveModelToBinaryFile(string filename) - Only forests built from DecisionTreeThresholdNode or DecisionTreeClusterNode nodes can be saved in the binary format!" << endl;
+        return false;
+    }
+    
+    const string nodeType = decisionTreeNode->getNodeType();
+    
+    //Work out where each block will be stored in the file
+    RandomForestsBinaryModelHeader header;
+    memset( &header, 0, sizeof(header) );
+    if( nodeType.size() >= sizeof(header.nodeType) ){
+        errorLog << "saveModelToBinaryFile(string filename) - The node type is too long: " << nodeType << endl;
+        return false;
+    }
+    //The header was zeroed above, so the copied strings are always null terminated
+    memcpy( header.fileFormat, GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT, sizeof(GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT) );
+    memcpy( header.nodeType, nodeType.c_str(), nodeType.size() );
+    header.version = GRT_RANDOM_FORESTS_BINARY_FILE_VERSION;
+    header.byteOrderMark = GRT_RANDOM_FORESTS_BINARY_FILE_BYTE_ORDER_MARK;
+    header.headerSize = sizeof(RandomForestsBinaryModelHeader);
+    header.useScaling = useScaling ? 1 : 0;
+    header.numInputDimensions = numInputDimensions;
+    header.numOutputDimensions = numOutputDimensions;
+    header.classifierMode = classifierMode;
+    header.numClasses = numClasses;
+    header.forestSize = forestSize;
+    header.numRandomSplits = numRandomSplits;
+    header.minNumSamplesPerNode = minNumSamplesPerNode;
+    header.maxDepth = maxDepth;
+    header.trainingMode = trainingMode;
+    header.removeFeaturesAtEachSpilt = removeFeaturesAtEachSpilt ? 1 : 0;
+    header.bootstrappedDatasetWeight = bootstrappedDatasetWeight;
+    header.classLabelsOffset = sizeof(RandomForestsBinaryModelHeader);
+    header.rangesOffset = header.classLabelsOffset + ((uint64_t)numClasses * sizeof(uint32_t) + 7) / 8 * 8;
+    header.forestOffset = header.rangesOffset + (useScaling ? (uint64_t)numInputDimensions * 2 * sizeof(double) : 0);
+    header.fileSize = header.forestOffset + flatForest.getBinarySize();
+    
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out | std::ios::binary);
+    
+    if( !file.is_open() ){
+        errorLog << "saveModelToBinaryFile(string filename) - Could not open file to save data: " << filename << endl;
+        return false;
+    }
+    
+    file.write( (const char*)&header, sizeof(header) );
+    
+    //Write the class labels, padded so the ranges start at a multiple of 8 bytes
+    vector< uint32_t > classLabelsBuffer( (header.rangesOffset - header.classLabelsOffset) / sizeof(uint32_t), 0 );
+    for(UINT k=0; k<numClasses; k++){
+        classLabelsBuffer[k] = classLabels[k];
+    }
+    file.write( (const char*)&classLabelsBuffer[0], classLabelsBuffer.size() * sizeof(uint32_t) );
+    
+    if( useScaling ){
+        for(UINT j=0; j<numInputDimensions; j++){
+            file.write( (const char*)&ranges[j].minValue, sizeof(double) );
+            file.write( (const char*)&ranges[j].maxValue, sizeof(double) );
+        }
+    }
+    
+    if( !flatForest.saveToBinaryFile( file ) || !file.good() ){
+        errorLog << "saveModelToBinaryFile(string filename) - Failed to write the model to the file: " << filename << endl;
+        file.close();
+        return false;
+    }
+    
+    file.close();
+    
+    return true;
+}
+    
+bool RandomForests::loadModelFromBinaryFile(string filename){
+    
+    MemoryMappedFile file;
+    
+    if( !file.open( filename ) ){
+        errorLog << "loadModelFromBinaryFile(string filename) - Failed to open file: " << filename << endl;
+        return false;
+    }
+    
+    const char *data = file.getData();
+    const uint64_t fileSize = file.getSize();
+    
+    //Check the header
+    RandomForestsBinaryModelHeader header;
+    if( fileSize < sizeof(header) ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The file is too small to be a binary RandomForests model!" << endl;
+        return false;
+    }
+    memcpy( &header, data, sizeof(header) );
+    
+    if( memcmp( header.fileFormat, GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT, sizeof(GRT_RANDOM_FORESTS_BINARY_FILE_FORMAT) ) != 0 ){
+        errorLog << "loadModelFromBinaryFile(string filename) - Unknown file header!" << endl;
+        return false;
+    }
+    
+    if( header.byteOrderMark != GRT_RANDOM_FORESTS_BINARY_FILE_BYTE_ORDER_MARK ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The file was saved on a machine with a different byte order, use the text format instead!" << endl;
+        return false;
+    }
+    
+    if( header.version != GRT_RANDOM_FORESTS_BINARY_FILE_VERSION || header.headerSize != sizeof(RandomForestsBinaryModelHeader) ){
+        errorLog << "loadModelFromBinaryFile(string filename) - Unsupported file version: " << header.version << endl;
+        return false;
+    }
+    
+    if( header.fileSize != fileSize ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The size of the file (" << fileSize << ") does not match the size in the header (" << header.fileSize << "), the file may be incomplete!" << endl;
+        return false;
+    }
+    
+    const uint64_t classLabelsSize = (uint64_t)header.numClasses * sizeof(uint32_t);
+    const uint64_t rangesSize = header.useScaling ? (uint64_t)header.numInputDimensions * 2 * sizeof(double) : 0;
+    if( header.classLabelsOffset + classLabelsSize > fileSize || header.rangesOffset + rangesSize > fileSize || header.forestOffset > fileSize ){
+        errorLog << "loadModelFromBinaryFile(string filename) - The class labels, ranges or forest are outside the file!" << endl;
+        return false;
+    }
+    
+    header.nodeType[ sizeof(header.nodeType)-1 ] = '\0';
+    DecisionTreeNode *node = dynamic_cast< DecisionTreeNode* >( DecisionTreeNode::createInstanceFromString( header.nodeType ) );
+    if( node == NULL ){
+        errorLog << "loadModelFromBinaryFile(string filename) - Could not create new DecisionTreeNode from type: " << header.nodeType << endl;
+        return false;
+    }
+    
+    //Clear any previous model and load the settings
+    clear();
+    
+    if( decisionTreeNode != NULL ){
+        delete decisionTreeNode;
+    }
+    decisionTreeNode = node;
+    
+    useScaling = header.useScaling != 0;
+    numInputDimensions = header.numInputDimensions;
+    numOutputDimensions = header.numOutputDimensions;
+    classifierMode = header.classifierMode;
+    numClasses = header.numClasses;
+    forestSize = header.forestSize;
+    numRandomSplits = header.numRandomSplits;
+    minNumSamplesPerNode = header.minNumSamplesPerNode;
+    maxDepth = header.maxDepth;
+    trainingMode = header.trainingMode;
+    removeFeaturesAtEachSpilt = header.removeFeaturesAtEachSpilt != 0;
+    bootstrappedDatasetWeight = header.bootstrappedDatasetWeight;
+    
+    classLabels.resize( numClasses );
+    for(UINT k=0; k<numClasses; k++){
+        uint32_t classLabel = 0;
+        memcpy( &classLabel, data + header.classLabelsOffset + k*sizeof(uint32_t), sizeof(uint32_t) );
+        classLabels[k] = classLabel;
+    }
+    
+    if( useScaling ){
+        ranges.resize( numInputDimensions );
+        const char *rangesData = data + header.rangesOffset;
+        for(UINT j=0; j<numInputDimensions; j++){
+            memcpy( &ranges[j].minValue, rangesData + (2*j)*sizeof(double), sizeof(double) );
+            memcpy( &ranges[j].maxValue, rangesData + (2*j+1)*sizeof(double), sizeof(double) );
+        }
+    }
+    
+    //Load the flat layout, then rebuild the trees from it so the model can also be printed, saved as text or combined
+    if( !flatForest.loadFromBinaryData( data + header.forestOffset, fileSize - header.forestOffset ) ){
+        clear();
+        errorLog << "loadModelFromBinaryFile(string filename) - Failed to load the forest!" << endl;
+        return false;
+    }
+    
+    if( flatForest.getNumTrees() != forestSize || flatForest.getNumInputDimensions() != numInputDimensions || flatForest.getNumClasses() != numClasses ){
+        clear();
+        errorLog << "loadModelFromBinaryFile(string filename) - The forest does not match the model settings!" << endl;
+        return false;
+    }
+    
+    if( !flatForest.getTrees( *decisionTreeNode, forest ) ){
+        clear();
+        errorLog << "loadModelFromBinaryFile(string filename) - Failed to rebuild the trees of the forest!" << endl;
+        return false;
+    }
+    
+    file.close();
+    
+    trained = true;
+    
+    //Resize the prediction results to make sure it is setup for realtime prediction
+    maxLikelihood = DEFAULT_NULL_LIKELIHOOD_VALUE;
+    bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
+    classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
+    classDistances.resize(numClasses,DEFAULT_NULL_DISTANCE_VALUE);
+    
+    return true;
+}
+
 bool RandomForests::combineModels( const RandomForests &forest ){
 
     if( !getTrained() ){
@@ -551,6 +879,9 @@ bool RandomForests::combineModels( const RandomForests &forest ){
             forestSize++;
         }
     }
+    
+    //Rebuild the flat copy of the forest so it includes the new trees
+    flatForest.build( this->forest, numInputDimensions, numClasses );
 
     return true;
 }
@@ -700,5 +1031,15 @@ bool RandomForests::setBootstrappedDatasetWeight( const double bootstrappedDatas
     return false;
 }
 
+bool RandomForests::setRandomSeed( const unsigned long long randomSeed ){
+    this->randomSeed = randomSeed;
+    return true;
+}
+
+bool RandomForests::enableParallelTraining( const bool useParallelTraining ){
+    this->useParallelTraining = useParallelTraining;
+    return true;
+}
+
 } //End of namespace GRT
 
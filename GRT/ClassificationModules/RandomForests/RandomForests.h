@@ -36,6 +36,7 @@
 #define GRT_RANDOM_FORESTS_HEADER
 
 #include "../DecisionTree/DecisionTree.h"
+#include "../../Util/MemoryMappedFile.h"
 
 namespace GRT{
 
@@ -142,6 +143,37 @@ public:
      @return returns true if the model was loaded successfully, false otherwise
      */
     virtual bool loadModelFromFile(fstream &file);
+    
+    /**
+     This loads a trained RandomForests model from a file.  The file can either be a text file saved by saveModelToFile or a binary file saved
+     by saveModelToBinaryFile, the format is detected from the start of the file.
+     This overrides the loadModelFromFile function in the MLBase class.
+     
+     @param string filename: the name of the file the RandomForests model will be loaded from
+     @return returns true if the model was loaded successfully, false otherwise
+     */
+    virtual bool loadModelFromFile(string filename);
+    
+    /**
+     This saves the trained RandomForests model to a binary file.  The binary file starts with a fixed size header, followed by the class
+     labels, the ranges (if scaling is used), and the flat layout of the forest (see FlatDecisionForest), so the model can be loaded without
+     parsing any text.  Only forests built from DecisionTreeThresholdNode or DecisionTreeClusterNode nodes can be saved in this format.  The
+     binary format uses the byte order of the machine that saved it, so the text format should be used to move a model between different
+     platforms.
+     
+     @param string filename: the name of the file the RandomForests model will be saved to
+     @return returns true if the model was saved successfully, false otherwise
+     */
+    bool saveModelToBinaryFile(string filename) const;
+    
+    /**
+     This loads a trained RandomForests model from a binary file saved by saveModelToBinaryFile.  The file is mapped into memory and the
+     flat layout is copied from it, the trees of the forest are then rebuilt from the flat layout.
+     
+     @param string filename: the name of the file the RandomForests model will be loaded from
+     @return returns true if the model was loaded successfully, false otherwise
+     */
+    bool loadModelFromBinaryFile(string filename);
 
     /**
      This function enables multiple random forest models to be merged together.  The model in forest will be combined
@@ -191,6 +223,15 @@ public:
     
     const vector< DecisionTreeNode* > getForest() const;
     
+    /**
+     Gets the flat layout of the forest that is used for prediction.  This will be empty if the model has not been trained, or if the
+     trees use a node type that can not be flattened (in which case the trees are used for prediction instead).  The flat layout can
+     be used to predict a batch of input vectors at the same time, the input vectors must already be scaled if scaling is enabled.
+     
+     @return returns a reference to the flat layout of the forest
+     */
+    const FlatDecisionForest& getFlatForest() const{ return flatForest; }
+    
     /**
      Gets if a feature is removed at each spilt so it can not be used again.  If true then the best feature selected at each node will be
      removed so it can not be used in any children of that node.  If false, then the feature that provides the best spilt at each node will
@@ -309,11 +350,46 @@ public:
      */
     bool setBootstrappedDatasetWeight( const double bootstrappedDatasetWeight );
     
+    /**
+     Sets the seed used to train the forest.  The bootstrapped dataset and the random splits of each tree are generated from a seed that
+     is drawn from this seed before any of the trees are trained, so training with the same seed and data will always result in the same
+     forest, regardless of whether the trees are trained in parallel or how many threads are used.
+     
+     @param const unsigned long long randomSeed: the new seed, if this is zero then the seed will be set using the system time each time the forest is trained
+     @return returns true if the seed was updated, false otherwise
+     */
+    bool setRandomSeed( const unsigned long long randomSeed );
+    
+    /**
+     Gets the seed used to train the forest, a value of zero means the seed is set using the system time.
+     
+     @return returns the random seed
+     */
+    unsigned long long getRandomSeed() const{ return randomSeed; }
+    
+    /**
+     Sets if the trees in the forest should be trained in parallel.  If enabled, each tree is trained as a separate task on the GRT ThreadPool.
+     Each tree has its own bootstrapped dataset and random number generator, so the trained forest is the same as the serial training.
+     Parallel training is enabled by default.
+     
+     @param bool useParallelTraining: if true then the trees will be trained in parallel
+     @return returns true if the parallel training parameter was updated successfully, false otherwise
+     */
+    virtual bool enableParallelTraining( const bool useParallelTraining );
+    
+    /**
+     Gets if the trees in the forest should be trained in parallel.
+     
+     @return returns true if parallel training is enabled, false otherwise
+     */
+    virtual bool getParallelTrainingEnabled() const{ return useParallelTraining; }
+    
     //Tell the compiler we are using the base class train method to stop hidden virtual function warnings
     using MLBase::saveModelToFile;
     using MLBase::loadModelFromFile;
     
 protected:
+    bool trainTree( const ClassificationData &trainingData, const UINT treeIndex, const unsigned long long seed );
     
     UINT forestSize;
     UINT numRandomSplits;
@@ -324,6 +400,11 @@ protected:
     double bootstrappedDatasetWeight;
     DecisionTreeNode* decisionTreeNode;
     vector< DecisionTreeNode* > forest;
+    FlatDecisionForest flatForest;      ///< A flat copy of the forest that is used for prediction, this is empty if the node type can not be flattened
+    VectorDouble treeLikelihoods;       ///< Reused by predict_ for the class likelihoods of each tree, so prediction does not allocate
+    unsigned long long randomSeed;      ///< The seed used to train the forest, zero means the seed is set using the system time
+    bool useParallelTraining;           ///< A flag to check if the trees should be trained on the thread pool
+    std::unique_ptr< ThreadPool > threadPool;   ///< The thread pool used for parallel training, this is only created when it is first needed
     
 private:
     static RegisterClassifierModule< RandomForests > registerModule;
@@ -1821,28 +1821,26 @@ static double sigmoid_predict(double decision_value, double A, double B)
 }
 
 // Method 2 from the multiclass_prob paper by Wu, Lin, and Weng
-static void multiclass_probability(int k, double **r, double *p)
+// r, Q are k x k matrices stored row by row, Q and Qp are work buffers
+static void multiclass_probability(int k, const double *r, double *p, double *Q, double *Qp)
 {
 	int t,j;
 	int iter = 0, max_iter=std::max(100,k);
-	double **Q=Malloc(double *,k);
-	double *Qp=Malloc(double,k);
 	double pQp, eps=0.005/k;
 	
 	for (t=0;t<k;t++)
 	{
 		p[t]=1.0/k;  // Valid if k = 1
-		Q[t]=Malloc(double,k);
-		Q[t][t]=0;
+		Q[t*k+t]=0;
 		for (j=0;j<t;j++)
 		{
-			Q[t][t]+=r[j][t]*r[j][t];
-			Q[t][j]=Q[j][t];
+			Q[t*k+t]+=r[j*k+t]*r[j*k+t];
+			Q[t*k+j]=Q[j*k+t];
 		}
 		for (j=t+1;j<k;j++)
 		{
-			Q[t][t]+=r[j][t]*r[j][t];
-			Q[t][j]=-r[j][t]*r[t][j];
+			Q[t*k+t]+=r[j*k+t]*r[j*k+t];
+			Q[t*k+j]=-r[j*k+t]*r[t*k+j];
 		}
 	}
 	for (iter=0;iter<max_iter;iter++)
@@ -1853,7 +1851,7 @@ static void multiclass_probability(int k, double **r, double *p)
 		{
 			Qp[t]=0;
 			for (j=0;j<k;j++)
-				Qp[t]+=Q[t][j]*p[j];
+				Qp[t]+=Q[t*k+j]*p[j];
 			pQp+=p[t]*Qp[t];
 		}
 		double max_error=0;
@@ -1867,21 +1865,18 @@ static void multiclass_probability(int k, double **r, double *p)
 		
 		for (t=0;t<k;t++)
 		{
-			double diff=(-Qp[t]+pQp)/Q[t][t];
+			double diff=(-Qp[t]+pQp)/Q[t*k+t];
 			p[t]+=diff;
-			pQp=(pQp+diff*(diff*Q[t][t]+2*Qp[t]))/(1+diff)/(1+diff);
+			pQp=(pQp+diff*(diff*Q[t*k+t]+2*Qp[t]))/(1+diff)/(1+diff);
 			for (j=0;j<k;j++)
 			{
-				Qp[j]=(Qp[j]+diff*Q[t][j])/(1+diff);
+				Qp[j]=(Qp[j]+diff*Q[t*k+j])/(1+diff);
 				p[j]/=(1+diff);
 			}
 		}
 	}
 	if (iter>=max_iter)
 		info("Exceeds max_iter in multiclass_prob\n");
-	for(t=0;t<k;t++) free(Q[t]);
-	free(Q);
-	free(Qp);
 }
 
 // Cross-validation decision values for probability estimates
@@ -2451,9 +2446,39 @@ double svm_get_svr_probability(const svm_model *model)
 	}
 }
 
-double svm_predict_values(const svm_model *model, const svm_node *x, double* dec_values)
+void svm_compute_kernel_values(const svm_model *model, const svm_node *x, double *kvalue)
+{
+	for(int i=0;i<model->l;i++)
+		kvalue[i] = Kernel::k_function(x,model->SV[i],model->param);
+}
+
+void svm_transform_kernel_values(const svm_model *model, double *kvalue)
+{
+	const svm_parameter& param = model->param;
+	int i;
+	switch(param.kernel_type)
+	{
+		case POLY:
+			for(i=0;i<model->l;i++)
+				kvalue[i] = powi(param.gamma*kvalue[i]+param.coef0,param.degree);
+			break;
+		case RBF:
+			for(i=0;i<model->l;i++)
+				kvalue[i] = exp(-param.gamma*kvalue[i]);
+			break;
+		case SIGMOID:
+			for(i=0;i<model->l;i++)
+				kvalue[i] = tanh(param.gamma*kvalue[i]+param.coef0);
+			break;
+		default:
+			break;
+	}
+}
+
+double svm_predict_values_from_kernel(const svm_model *model, const double *kvalue, struct svm_predict_buffers *buffers)
 {
 	int i;
+	double *dec_values = buffers->dec_values;
 	if(model->param.svm_type == ONE_CLASS ||
 	   model->param.svm_type == EPSILON_SVR ||
 	   model->param.svm_type == NU_SVR)
@@ -2461,7 +2486,7 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 		double *sv_coef = model->sv_coef[0];
 		double sum = 0;
 		for(i=0;i<model->l;i++)
-			sum += sv_coef[i] * Kernel::k_function(x,model->SV[i],model->param);
+			sum += sv_coef[i] * kvalue[i];
 		sum -= model->rho[0];
 		*dec_values = sum;
 
@@ -2473,28 +2498,18 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 	else
 	{
 		int nr_class = model->nr_class;
-		int l = model->l;
-		
-		double *kvalue = Malloc(double,l);
-		for(i=0;i<l;i++)
-			kvalue[i] = Kernel::k_function(x,model->SV[i],model->param);
-
-		int *start = Malloc(int,nr_class);
-		start[0] = 0;
-		for(i=1;i<nr_class;i++)
-			start[i] = start[i-1]+model->nSV[i-1];
-
-		int *vote = Malloc(int,nr_class);
+		int *vote = buffers->vote;
 		for(i=0;i<nr_class;i++)
 			vote[i] = 0;
 
 		int p=0;
+		int si=0;
 		for(i=0;i<nr_class;i++)
+		{
+			int sj = si+model->nSV[i];
 			for(int j=i+1;j<nr_class;j++)
 			{
 				double sum = 0;
-				int si = start[i];
-				int sj = start[j];
 				int ci = model->nSV[i];
 				int cj = model->nSV[j];
 				
@@ -2513,20 +2528,71 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 				else
 					++vote[j];
 				p++;
+				sj += cj;
 			}
+			si += model->nSV[i];
+		}
 
 		int vote_max_idx = 0;
 		for(i=1;i<nr_class;i++)
 			if(vote[i] > vote[vote_max_idx])
 				vote_max_idx = i;
 
-		free(kvalue);
-		free(start);
-		free(vote);
 		return model->label[vote_max_idx];
 	}
 }
 
+double svm_predict_probability_from_kernel(const svm_model *model, const double *kvalue, struct svm_predict_buffers *buffers, double *prob_estimates)
+{
+	if ((model->param.svm_type == C_SVC || model->param.svm_type == NU_SVC) &&
+	    model->probA!=NULL && model->probB!=NULL)
+	{
+		int i;
+		int nr_class = model->nr_class;
+		double *dec_values = buffers->dec_values;
+		double *pairwise_prob = buffers->pairwise_prob;
+		svm_predict_values_from_kernel(model, kvalue, buffers);
+
+		double min_prob=1e-7;
+		int k=0;
+		for(i=0;i<nr_class;i++)
+			for(int j=i+1;j<nr_class;j++)
+			{
+				pairwise_prob[i*nr_class+j]=std::min(std::max(sigmoid_predict(dec_values[k],model->probA[k],model->probB[k]),min_prob),1-min_prob);
+				pairwise_prob[j*nr_class+i]=1-pairwise_prob[i*nr_class+j];
+				k++;
+			}
+		multiclass_probability(nr_class,pairwise_prob,prob_estimates,buffers->Q,buffers->Qp);
+
+		int prob_max_idx = 0;
+		for(i=1;i<nr_class;i++)
+			if(prob_estimates[i] > prob_estimates[prob_max_idx])
+				prob_max_idx = i;
+		return model->label[prob_max_idx];
+	}
+	else 
+		return svm_predict_values_from_kernel(model, kvalue, buffers);
+}
+
+double svm_predict_values(const svm_model *model, const svm_node *x, double* dec_values)
+{
+	int nr_class = model->nr_class;
+	struct svm_predict_buffers buffers;
+	buffers.dec_values = dec_values;
+	buffers.vote = Malloc(int,nr_class);
+	buffers.pairwise_prob = NULL;
+	buffers.Q = NULL;
+	buffers.Qp = NULL;
+
+	double *kvalue = Malloc(double,model->l);
+	svm_compute_kernel_values(model, x, kvalue);
+	double pred_result = svm_predict_values_from_kernel(model, kvalue, &buffers);
+
+	free(kvalue);
+	free(buffers.vote);
+	return pred_result;
+}
+
 double svm_predict(const svm_model *model, const svm_node *x)
 {
 	int nr_class = model->nr_class;
@@ -2548,34 +2614,25 @@ double svm_predict_probability(
 	if ((model->param.svm_type == C_SVC || model->param.svm_type == NU_SVC) &&
 	    model->probA!=NULL && model->probB!=NULL)
 	{
-		int i;
 		int nr_class = model->nr_class;
-		double *dec_values = Malloc(double, nr_class*(nr_class-1)/2);
-		svm_predict_values(model, x, dec_values);
+		struct svm_predict_buffers buffers;
+		buffers.dec_values = Malloc(double, nr_class*(nr_class-1)/2);
+		buffers.vote = Malloc(int, nr_class);
+		buffers.pairwise_prob = Malloc(double, nr_class*nr_class);
+		buffers.Q = Malloc(double, nr_class*nr_class);
+		buffers.Qp = Malloc(double, nr_class);
 
-		double min_prob=1e-7;
-		double **pairwise_prob=Malloc(double *,nr_class);
-		for(i=0;i<nr_class;i++)
-			pairwise_prob[i]=Malloc(double,nr_class);
-		int k=0;
-		for(i=0;i<nr_class;i++)
-			for(int j=i+1;j<nr_class;j++)
-			{
-				pairwise_prob[i][j]=std::min(std::max(sigmoid_predict(dec_values[k],model->probA[k],model->probB[k]),min_prob),1-min_prob);
-				pairwise_prob[j][i]=1-pairwise_prob[i][j];
-				k++;
-			}
-		multiclass_probability(nr_class,pairwise_prob,prob_estimates);
+		double *kvalue = Malloc(double,model->l);
+		svm_compute_kernel_values(model, x, kvalue);
+		double pred_result = svm_predict_probability_from_kernel(model, kvalue, &buffers, prob_estimates);
 
-		int prob_max_idx = 0;
-		for(i=1;i<nr_class;i++)
-			if(prob_estimates[i] > prob_estimates[prob_max_idx])
-				prob_max_idx = i;
-		for(i=0;i<nr_class;i++)
-			free(pairwise_prob[i]);
-		free(dec_values);
-		free(pairwise_prob);	     
-		return model->label[prob_max_idx];
+		free(kvalue);
+		free(buffers.dec_values);
+		free(buffers.vote);
+		free(buffers.pairwise_prob);
+		free(buffers.Q);
+		free(buffers.Qp);
+		return pred_result;
 	}
 	else 
 		return svm_predict(model, x);
@@ -150,6 +150,19 @@ struct svm_model
 				/* 0 if svm_model is created by svm_train */
 };
 
+//
+// svm_predict_buffers: work buffers used by the *_from_kernel prediction functions, so they do not allocate any memory
+// (k is the number of classes in the model)
+//
+struct svm_predict_buffers
+{
+	double *dec_values;	/* decision values (dec_values[k*(k-1)/2], dec_values[1] for one class svm and regression) */
+	int *vote;		/* votes of each class (vote[k]) */
+	double *pairwise_prob;	/* pairwise class probabilities (pairwise_prob[k*k]), only used for probability estimates */
+	double *Q;		/* (Q[k*k]), only used for probability estimates */
+	double *Qp;		/* (Qp[k]), only used for probability estimates */
+};
+
 struct svm_model *svm_train(const struct svm_problem *prob, const struct svm_parameter *param);
 void svm_cross_validation(const struct svm_problem *prob, const struct svm_parameter *param, int nr_fold, double *target);
 
@@ -165,6 +178,13 @@ double svm_predict_values(const struct svm_model *model, const struct svm_node *
 double svm_predict(const struct svm_model *model, const struct svm_node *x);
 double svm_predict_probability(const struct svm_model *model, const struct svm_node *x, double* prob_estimates);
 
+/* kvalue[i] is the kernel value between the input and model->SV[i] */
+void svm_compute_kernel_values(const struct svm_model *model, const struct svm_node *x, double *kvalue);
+/* converts the dot products (linear, poly, sigmoid) or squared distances (rbf) between the input and each SV into kernel values */
+void svm_transform_kernel_values(const struct svm_model *model, double *kvalue);
+double svm_predict_values_from_kernel(const struct svm_model *model, const double *kvalue, struct svm_predict_buffers *buffers);
+double svm_predict_probability_from_kernel(const struct svm_model *model, const double *kvalue, struct svm_predict_buffers *buffers, double *prob_estimates);
+
 void svm_free_model_content(struct svm_model *model_ptr);
 void svm_free_and_destroy_model(struct svm_model **model_ptr_ptr);
 void svm_destroy_param(struct svm_parameter *param);
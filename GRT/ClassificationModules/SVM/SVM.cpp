@@ -22,6 +22,12 @@
 
 namespace GRT{
     
+//The number of input vectors that have their kernel values computed at the same time by the batch predict function
+#define SVM_INPUT_BLOCK_SIZE 64
+    
+//The number of support vectors compared with each input vector at a time by the batch predict function
+#define SVM_SUPPORT_VECTOR_BLOCK_SIZE 256
+    
 //Register the SVM module with the Classifier base class
 RegisterClassifierModule< SVM > SVM::registerModule("SVM");
 
@@ -34,6 +40,7 @@ SVM::SVM(UINT kernelType,UINT svmType,bool useScaling,bool useNullRejection,bool
     prob.l = 0;
     prob.x = NULL;
     prob.y = NULL;
+    useDenseModel = false;
 	trained = false;
 	problemSet = false;
 	param.svm_type = C_SVC;
@@ -76,6 +83,7 @@ SVM::SVM(const SVM &rhs){
     prob.l = 0;
     prob.x = NULL;
     prob.y = NULL;
+    useDenseModel = false;
     classType = "SVM";
     classifierType = classType;
     classifierMode = STANDARD_CLASSIFIER_MODE;
@@ -109,6 +117,9 @@ SVM& SVM::operator=(const SVM &rhs){
         
         //Classifier variables
         copyBaseVariables( (Classifier*)&rhs );
+        
+        //Setup the dense support vectors and prediction buffers for the copied model
+        buildPredictionBuffers();
     }
     return *this;
 }
@@ -134,7 +145,12 @@ bool SVM::deepCopyFrom(const Classifier *classifier){
         this->useCrossValidation = ptr->useCrossValidation;
         
         //Classifier variables
-        return copyBaseVariables( classifier );
+        if( !copyBaseVariables( classifier ) ){
+            return false;
+        }
+        
+        //Setup the dense support vectors and prediction buffers for the copied model
+        return buildPredictionBuffers();
     }
     
     return false;
@@ -196,6 +212,80 @@ bool SVM::predict_(VectorDouble &inputVector){
     return true;
 }
     
+bool SVM::predict(const MatrixDouble &X,vector< UINT > &predictedClassLabels,MatrixDouble &classLikelihoods){
+    
+    if( !trained ){
+        errorLog << "predict(const MatrixDouble &X,...) - The SVM model has not been trained!" << endl;
+        return false;
+    }
+    
+    if( X.getNumCols() != numInputDimensions ){
+        errorLog << "predict(const MatrixDouble &X,...) - The number of columns in X (" << X.getNumCols() << ") does not match the number of features of the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+    
+    const UINT Q = X.getNumRows();
+    const UINT N = numInputDimensions;
+    const UINT numSV = (UINT)model->l;
+    const bool computeProbabilities = param.probability == 1;
+    
+    predictedClassLabels.resize( Q );
+    classLikelihoods.resize( Q, numClasses );
+    classLikelihoods.setAllValues( 0 );
+    if( Q == 0 ) return true;
+    
+    double maxProbability = 0;
+    VectorDouble probabilities;
+    VectorDouble x( N );
+    
+    if( !useDenseModel || numSV == 0 ){
+        for(UINT q=0; q<Q; q++){
+            std::copy( X[q], X[q]+N, x.begin() );
+            if( !computeKernelValues( x, &kernelValues[0] ) || !predictSVM( &kernelValues[0], computeProbabilities, predictedClassLabels[q], maxProbability, probabilities ) ){
+                errorLog << "predict(const MatrixDouble &X,...) - Prediction Failed!" << endl;
+                return false;
+            }
+            for(UINT k=0; k<probabilities.size() && computeProbabilities; k++) classLikelihoods[q][k] = probabilities[k];
+        }
+        return true;
+    }
+    
+    //Compute the kernel values for a block of input vectors at a time, so each block of support vectors is only loaded once per block of inputs
+    const UINT metric = model->param.kernel_type == RBF_KERNEL ? DistanceKernels::SQUARED_DISTANCE : DistanceKernels::DOT_PRODUCT;
+    const UINT inputBlockSize = std::min( Q, (UINT)SVM_INPUT_BLOCK_SIZE );
+    VectorDouble inputs( inputBlockSize*N );
+    VectorDouble blockKernelValues( inputBlockSize*numSV );
+    
+    for(UINT blockStart=0; blockStart<Q; blockStart+=inputBlockSize){
+        const UINT blockSize = std::min( inputBlockSize, Q-blockStart );
+        
+        //Scale the inputs if required
+        for(UINT r=0; r<blockSize; r++){
+            const double *row = X[ blockStart+r ];
+            for(UINT j=0; j<N; j++){
+                inputs[ r*N+j ] = useScaling ? scale(row[j],ranges[j].minValue,ranges[j].maxValue,SVM_MIN_SCALE_RANGE,SVM_MAX_SCALE_RANGE) : row[j];
+            }
+        }
+        
+        for(UINT start=0; start<numSV; start+=SVM_SUPPORT_VECTOR_BLOCK_SIZE){
+            const UINT end = std::min( start+SVM_SUPPORT_VECTOR_BLOCK_SIZE, numSV )-1;
+            for(UINT r=0; r<blockSize; r++){
+                DistanceKernels::computeDistances( metric, &inputs[ r*N ], &supportVectors[0], numSV, N, start, end, &blockKernelValues[ r*numSV + start ] );
+            }
+        }
+        
+        for(UINT r=0; r<blockSize; r++){
+            const UINT q = blockStart+r;
+            double *rowKernelValues = &blockKernelValues[ r*numSV ];
+            svm_transform_kernel_values( model, rowKernelValues );
+            predictSVM( rowKernelValues, computeProbabilities, predictedClassLabels[q], maxProbability, probabilities );
+            for(UINT k=0; k<probabilities.size() && computeProbabilities; k++) classLikelihoods[q][k] = probabilities[k];
+        }
+    }
+    
+    return true;
+}
+    
 bool SVM::init(UINT kernelType,UINT svmType,bool useScaling,bool useNullRejection,bool useAutoGamma,double gamma,UINT degree,double coef0,double nu,double C,bool useCrossValidation,UINT kFoldValue){
     
     //Clear any previous models or problems
@@ -368,6 +458,7 @@ bool SVM::trainSVM(){
         }
         classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
         classDistances.resize(numClasses,DEFAULT_NULL_DISTANCE_VALUE);
+        buildPredictionBuffers();
     }
 
     return trained;
@@ -375,91 +466,142 @@ bool SVM::trainSVM(){
     
 bool SVM::predictSVM(VectorDouble &inputVector){
 
-		if( !trained || inputVector.size() != numInputDimensions ) return false;
-
-		svm_node *x = NULL;
-
-		//Copy the input data into the SVM format
-		x = new svm_node[numInputDimensions+1];
-		for(UINT j=0; j<numInputDimensions; j++){
-			x[j].index = (int)j+1;
-			x[j].value = inputVector[j];
-		}
-		//The last value in the input vector must be set to -1
-		x[numInputDimensions].index = -1;
-		x[numInputDimensions].value = 0;
-
-		//Scale the input data if required
-		if( useScaling ){
-			for(UINT i=0; i<numInputDimensions; i++)
-				x[i].value = scale(x[i].value,ranges[i].minValue,ranges[i].maxValue,SVM_MIN_SCALE_RANGE,SVM_MAX_SCALE_RANGE);
-		}
-
-		//Perform the SVM prediction
-		double predict_label = svm_predict(model,x);
-
-        //We can't do null rejection without the probabilities, so just set the predicted class
-        predictedClassLabel = (UINT)predict_label;
-
-		//Clean up the memory
-		delete[] x;
-
-		return true;
+    if( !trained || inputVector.size() != numInputDimensions ) return false;
+    
+    if( !computeKernelValues( inputVector, &kernelValues[0] ) ) return false;
+    
+    //We can't do null rejection without the probabilities, so just set the predicted class
+    double maxProbability = 0;
+    VectorDouble probabilites;
+    return predictSVM( &kernelValues[0], false, predictedClassLabel, maxProbability, probabilites );
 }
 
 bool SVM::predictSVM(VectorDouble &inputVector,double &maxProbability, VectorDouble &probabilites){
 
-		if( !trained || param.probability == 0 || inputVector.size() != numInputDimensions ) return false;
-
-		double *prob_estimates = NULL;
-		svm_node *x = NULL;
-
-		//Setup the memory for the probability estimates
-		prob_estimates = new double[ model->nr_class ];
-
-		//Copy the input data into the SVM format
-		x = new svm_node[numInputDimensions+1];
-		for(UINT j=0; j<numInputDimensions; j++){
-			x[j].index = (int)j+1;
-			x[j].value = inputVector[j];
-		}
-		//The last value in the input vector must be set to -1
-		x[numInputDimensions].index = -1;
-		x[numInputDimensions].value = 0;
-
-		//Scale the input data if required
-		if( useScaling ){
-			for(UINT j=0; j<numInputDimensions; j++)
-				x[j].value = scale(x[j].value,ranges[j].minValue,ranges[j].maxValue,SVM_MIN_SCALE_RANGE,SVM_MAX_SCALE_RANGE);
-		}
-
-		//Perform the SVM prediction
-		double predict_label = svm_predict_probability(model,x,prob_estimates);
-
-		predictedClassLabel = 0;
-		maxProbability = 0;
-		probabilites.resize(model->nr_class);
-		for(int k=0; k<model->nr_class; k++){
-			if( maxProbability < prob_estimates[k] ){
-				maxProbability = prob_estimates[k];
-                predictedClassLabel = k+1;
-                maxLikelihood = maxProbability;
+    if( !trained || param.probability == 0 || inputVector.size() != numInputDimensions ) return false;
+    
+    if( !computeKernelValues( inputVector, &kernelValues[0] ) ) return false;
+    
+    return predictSVM( &kernelValues[0], true, predictedClassLabel, maxProbability, probabilites );
+}
+    
+bool SVM::predictSVM(const double *kernelValues,const bool computeProbabilities,UINT &predictedClassLabel,double &maxProbability,VectorDouble &probabilites){
+    
+    //Point the LIBSVM work buffers at the prediction buffers, these are sized for the model by buildPredictionBuffers
+    const int K = model->nr_class;
+    struct svm_predict_buffers buffers;
+    buffers.dec_values = &predictionBuffer[0];
+    buffers.vote = &predictionVotes[0];
+    buffers.pairwise_prob = buffers.dec_values + std::max( K*(K-1)/2, 1 );
+    buffers.Q = buffers.pairwise_prob + K*K;
+    buffers.Qp = buffers.Q + K*K;
+    double *prob_estimates = buffers.Qp + K;
+    
+    if( !computeProbabilities ){
+        predictedClassLabel = (UINT)svm_predict_values_from_kernel( model, kernelValues, &buffers );
+        return true;
+    }
+    
+    //Perform the SVM prediction
+    double predict_label = svm_predict_probability_from_kernel( model, kernelValues, &buffers, prob_estimates );
+    
+    predictedClassLabel = 0;
+    maxProbability = 0;
+    probabilites.resize( K );
+    for(int k=0; k<K; k++){
+        if( maxProbability < prob_estimates[k] ){
+            maxProbability = prob_estimates[k];
+            predictedClassLabel = k+1;
+        }
+        probabilites[k] = prob_estimates[k];
+    }
+    
+    if( !useNullRejection ) predictedClassLabel = (UINT)predict_label;
+    else{
+        if( maxProbability >= classificationThreshold ){
+            predictedClassLabel = (UINT)predict_label;
+        }else predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
+    }
+    
+    return true;
+}
+    
+bool SVM::computeKernelValues(const VectorDouble &inputVector,double *kernelValues){
+    
+    const UINT numSV = (UINT)model->l;
+    const double *x = &inputVector[0];
+    
+    //Scale the input data if required
+    if( useScaling ){
+        for(UINT j=0; j<numInputDimensions; j++){
+            inputBuffer[j] = scale(inputVector[j],ranges[j].minValue,ranges[j].maxValue,SVM_MIN_SCALE_RANGE,SVM_MAX_SCALE_RANGE);
+        }
+        x = &inputBuffer[0];
+    }
+    
+    if( numSV == 0 ) return true;
+    
+    if( useDenseModel ){
+        //Compute the dot product (or squared distance for the RBF kernel) with all the support vectors at once, and then apply the kernel
+        const UINT metric = model->param.kernel_type == RBF_KERNEL ? DistanceKernels::SQUARED_DISTANCE : DistanceKernels::DOT_PRODUCT;
+        DistanceKernels::computeDistances( metric, x, &supportVectors[0], numSV, numInputDimensions, 0, numSV-1, kernelValues );
+        svm_transform_kernel_values( model, kernelValues );
+        return true;
+    }
+    
+    //Copy the input data into the SVM format, the last node must have an index of -1
+    for(UINT j=0; j<numInputDimensions; j++){
+        inputNodes[j].index = (int)j+1;
+        inputNodes[j].value = x[j];
+    }
+    inputNodes[numInputDimensions].index = -1;
+    inputNodes[numInputDimensions].value = 0;
+    
+    svm_compute_kernel_values( model, &inputNodes[0], kernelValues );
+    
+    return true;
+}
+    
+bool SVM::buildPredictionBuffers(){
+    
+    useDenseModel = false;
+    supportVectors.clear();
+    inputBuffer.clear();
+    kernelValues.clear();
+    predictionBuffer.clear();
+    predictionVotes.clear();
+    inputNodes.clear();
+    
+    if( model == NULL ) return true;
+    
+    const UINT numSV = (UINT)model->l;
+    const UINT K = (UINT)model->nr_class;
+    
+    inputBuffer.resize( numInputDimensions );
+    kernelValues.resize( std::max( numSV, (UINT)1 ) );
+    predictionBuffer.resize( std::max( K*(K-1)/2, (UINT)1 ) + K*K*2 + K*2 );
+    predictionVotes.resize( std::max( K, (UINT)1 ) );
+    inputNodes.resize( numInputDimensions+1 );
+    
+    //The support vectors can be stored in the dense block if the kernel is computed from the input values, and each support vector
+    //only has values for the input dimensions in increasing order (any missing values are zero)
+    if( model->param.kernel_type == PRECOMPUTED_KERNEL ) return true;
+    
+    supportVectors.resize( numInputDimensions*numSV, 0 );
+    for(UINT i=0; i<numSV; i++){
+        int lastIndex = 0;
+        for(const svm_node *node = model->SV[i]; node->index != -1; node++){
+            if( node->index <= lastIndex || node->index > (int)numInputDimensions ){
+                supportVectors.clear();
+                return true;
             }
-			probabilites[k] = prob_estimates[k];
-		}
-
-        if( !useNullRejection ) predictedClassLabel = (UINT)predict_label;
-        else{
-            if( maxProbability >= classificationThreshold ){
-                predictedClassLabel = (UINT)predict_label;
-            }else predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
+            supportVectors[ (node->index-1)*numSV + i ] = node->value;
+            lastIndex = node->index;
         }
-
-		//Clean up the memory
-		delete[] prob_estimates;
-		delete[] x;
-
-		return true;
+    }
+    useDenseModel = true;
+    
+    return true;
 }
     
 bool SVM::convertClassificationDataToLIBSVMFormat(ClassificationData &trainingData){
@@ -924,6 +1066,9 @@ bool SVM::loadModelFromFile(fstream &file){
         bestDistance = DEFAULT_NULL_DISTANCE_VALUE;
         classLikelihoods.resize(numClasses,DEFAULT_NULL_LIKELIHOOD_VALUE);
         classDistances.resize(numClasses,DEFAULT_NULL_DISTANCE_VALUE);
+        
+        //Setup the dense support vectors and prediction buffers for the loaded model
+        buildPredictionBuffers();
     }
     
     return true;
@@ -939,6 +1084,7 @@ bool SVM::clear(){
     svm_free_and_destroy_model(&model);
     svm_destroy_param(&param);
     deleteProblemSet();
+    buildPredictionBuffers();
     
     return true;
 }
@@ -1637,6 +1783,9 @@ bool SVM::loadLegacyModelFromFile( fstream &file ){
     //The SV have now been loaded so flag that they should be deleted
     model->free_sv = 1;
     
+    //Setup the dense support vectors and prediction buffers for the loaded model
+    buildPredictionBuffers();
+    
     //Finally, flag that the model has been trained to show it has been loaded and can be used for prediction
     trained = true;
     
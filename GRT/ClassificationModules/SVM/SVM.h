@@ -38,6 +38,7 @@
 
 #include "../../CoreModules/Classifier.h"
 #include "LIBSVM/libsvm.h"
+#include "../../Util/DistanceKernels.h"
 
 namespace GRT {
     
@@ -115,6 +116,18 @@ public:
      */
     virtual bool predict_(VectorDouble &inputVector);
     
+    /**
+     This predicts the class of each row of X.  The kernel values are computed for a block of input vectors at a time, with each block of
+     support vectors compared with all the input vectors in the block before moving on to the next block of support vectors.  The results
+     are the same as calling predict for each row.  The input data will be scaled if useScaling is enabled, but X is not changed.
+     
+     @param const MatrixDouble &X: the input vectors, with one row per input vector
+     @param vector< UINT > &predictedClassLabels: this will store the predicted class label of each input vector
+     @param MatrixDouble &classLikelihoods: this will store the class probabilities of each input vector, with one row per input vector, the probabilities are zero if the model does not estimate probabilities
+     @return returns true if the predictions were computed, false otherwise
+     */
+    bool predict(const MatrixDouble &X,vector< UINT > &predictedClassLabels,MatrixDouble &classLikelihoods);
+    
     /**
      Clears any previous model or problem.
      */
@@ -353,6 +366,9 @@ protected:
     
     bool predictSVM(VectorDouble &inputVector);
 	bool predictSVM(VectorDouble &inputVector,double &maxProbability, VectorDouble &probabilites);
+    bool predictSVM(const double *kernelValues,const bool computeProbabilities,UINT &predictedClassLabel,double &maxProbability,VectorDouble &probabilites);
+    bool computeKernelValues(const VectorDouble &inputVector,double *kernelValues);
+    bool buildPredictionBuffers();
     bool loadLegacyModelFromFile( fstream &file );
     
     struct svm_model *deepCopyModel() const;
@@ -368,6 +384,13 @@ protected:
 	double crossValidationResult;
 	bool useAutoGamma;
     bool useCrossValidation;
+    bool useDenseModel;                     ///< True if the support vectors are stored in the dense supportVectors block, which is used to compute the kernel values
+    VectorDouble supportVectors;            ///< The support vectors, stored column-major as a numInputDimensions x numSV buffer
+    VectorDouble inputBuffer;               ///< Buffer used by the prediction functions to scale the input vector
+    VectorDouble kernelValues;              ///< The kernel value between the input vector and each support vector
+    VectorDouble predictionBuffer;          ///< Work buffer for the decision values and probability estimates of the prediction functions
+    vector< int > predictionVotes;          ///< Work buffer for the votes of each class
+    vector< svm_node > inputNodes;          ///< The input vector in the LIBSVM format, only used if the support vectors can not be stored in the dense block
     
     static RegisterClassifierModule< SVM > registerModule;
     
@@ -519,69 +519,37 @@ bool ClusterTree::computeBestSpiltBestIterativeSpilt( const MatrixDouble &traini
     
     //Clusterer::debugLog << "computeBestSpiltBestIterativeSpilt() M: " << M << endl;
     
-    if( N == 0 ) return false;
+    if( N == 0 || M == 0 ) return false;
     
     minError = numeric_limits<double>::max();
     UINT bestFeatureIndex = 0;
-    UINT groupID = 0;
     double bestThreshold = 0;
-    double error = 0;
-    double minRange = 0;
-    double maxRange = 0;
-    double step = 0;
-    vector< UINT > groupIndex(M);
-    vector< double > groupCounter(2);
-    vector< double > groupMean(2);
-    vector< double > groupMSE(2);
     vector< MinMax > ranges = trainingData.getRanges();
+    VectorDouble featureBuffer;
+    VectorDouble thresholds;
+    VectorDouble errors;
+    SplitSearch splitSearch;
 
     //Loop over each feature and try and find the best split point
     for(UINT n=0; n<N; n++){
-        minRange = ranges[n].minValue;
-        maxRange = ranges[n].maxValue;
-        step = (maxRange-minRange)/double(numSplittingSteps);
-        threshold = minRange;
         featureIndex = features[n];
         
-        while( threshold <= maxRange ){
-            
-            //Reset the counters to zero
-            groupCounter[0] = groupCounter[1] = 0;
-            groupMean[0] = groupMean[1] = 0;
-            groupMSE[0] = groupMSE[1] = 0;
-            
-            //Iterate over each sample and work out what group it falls into
-            for(UINT i=0; i<M; i++){
-                groupID = trainingData[i][featureIndex] >= threshold ? 1 : 0;
-                groupIndex[i] = groupID;
-                
-                //Update the group mean and group counters
-                groupMean[ groupID ] += trainingData[i][featureIndex];
-                groupCounter[ groupID ]++;
-            }
-            
-            //Compute the group mean
-            groupMean[0] /= (groupCounter[0] > 0 ? groupCounter[0] : 1);
-            groupMean[1] /= (groupCounter[1] > 0 ? groupCounter[1] : 1);
-            
-            //Compute the MSE for each group
-            for(UINT i=0; i<M; i++){
-                groupMSE[ groupIndex[i] ] += MLBase::SQR( groupMean[ groupIndex[i] ] - trainingData[i][featureIndex] );
-            }
-            groupMSE[0] /= (groupCounter[0] > 0 ? groupCounter[0] : 1);
-            groupMSE[1] /= (groupCounter[1] > 0 ? groupCounter[1] : 1);
-            
-            error = sqrt( groupMSE[0] + groupMSE[1] );
-            
-            //Store the best threshold and feature index
-            if( error < minError ){
-                minError = error;
-                bestThreshold = threshold;
+        //Step through the range of the feature, the error of each threshold is the MSE of the feature in the lhs and rhs groups
+        featureBuffer = trainingData.getColVector( featureIndex );
+        SplitSearch::getIterativeThresholds( ranges[featureIndex].minValue, ranges[featureIndex].maxValue, numSplittingSteps, thresholds );
+        splitSearch.sortFeature( &featureBuffer[0], M );
+        if( !splitSearch.computeMeanSquaredErrors( NULL, 1, thresholds, errors ) ){
+            Clusterer::errorLog << "computeBestSpiltBestIterativeSpilt(...) - Failed to compute the split errors for feature: " << featureIndex << endl;
+            return false;
+        }
+        
+        //Store the best threshold and feature index
+        for(UINT t=0; t<errors.size(); t++){
+            if( errors[t] < minError ){
+                minError = errors[t];
+                bestThreshold = thresholds[t];
                 bestFeatureIndex = featureIndex;
             }
-            
-            //Update the threshold
-            threshold += step;
         }
     }
     
@@ -599,59 +567,38 @@ bool ClusterTree::computeBestSpiltBestRandomSpilt( const MatrixDouble &trainingD
     
     Clusterer::debugLog << "computeBestSpiltBestRandomSpilt() M: " << M << endl;
     
-    if( N == 0 ) return false;
+    if( N == 0 || M == 0 ) return false;
     
     minError = numeric_limits<double>::max();
     UINT bestFeatureIndex = 0;
-    UINT groupID = 0;
     double bestThreshold = 0;
-    double error = 0;
-    vector< UINT > groupIndex(M);
-    vector< double > groupCounter(2);
-    vector< double > groupMean(2);
-    vector< double > groupMSE(2);
     vector< MinMax > ranges = trainingData.getRanges();
+    VectorDouble featureBuffer;
+    VectorDouble thresholds( numSplittingSteps );
+    VectorDouble errors;
+    SplitSearch splitSearch;
     
     //Loop over each feature and try and find the best split point
     for(UINT n=0; n<N; n++){
         featureIndex = features[n];
         
+        //Randomly select the threshold values
         for(UINT m=0; m<numSplittingSteps; m++){
-            //Randomly select a threshold value
-            threshold = random.getRandomNumberUniform(ranges[n].minValue,ranges[n].maxValue);
-            
-            //Reset the counters to zero
-            groupCounter[0] = groupCounter[1] = 0;
-            groupMean[0] = groupMean[1] = 0;
-            groupMSE[0] = groupMSE[1] = 0;
-            
-            //Iterate over each sample and work out what group it falls into
-            for(UINT i=0; i<M; i++){
-                groupID = trainingData[i][featureIndex] >= threshold ? 1 : 0;
-                groupIndex[i] = groupID;
-                
-                //Update the group mean and group counters
-                groupMean[ groupID ] += trainingData[i][featureIndex];
-                groupCounter[ groupID ]++;
-            }
-            
-            //Compute the group mean
-            groupMean[0] /= (groupCounter[0] > 0 ? groupCounter[0] : 1);
-            groupMean[1] /= (groupCounter[1] > 0 ? groupCounter[1] : 1);
-            
-            //Compute the MSE for each group
-            for(UINT i=0; i<M; i++){
-                groupMSE[ groupIndex[i] ] += MLBase::SQR( groupMean[ groupIndex[i] ] - trainingData[i][featureIndex] );
-            }
-            groupMSE[0] /= (groupCounter[0] > 0 ? groupCounter[0] : 1);
-            groupMSE[1] /= (groupCounter[1] > 0 ? groupCounter[1] : 1);
-            
-            error = sqrt( groupMSE[0] + groupMSE[1] );
-            
-            //Store the best threshold and feature index
-            if( error < minError ){
-                minError = error;
-                bestThreshold = threshold;
+            thresholds[m] = random.getRandomNumberUniform(ranges[featureIndex].minValue,ranges[featureIndex].maxValue);
+        }
+        
+        featureBuffer = trainingData.getColVector( featureIndex );
+        splitSearch.sortFeature( &featureBuffer[0], M );
+        if( !splitSearch.computeMeanSquaredErrors( NULL, 1, thresholds, errors ) ){
+            Clusterer::errorLog << "computeBestSpiltBestRandomSpilt(...) - Failed to compute the split errors for feature: " << featureIndex << endl;
+            return false;
+        }
+        
+        //Store the best threshold and feature index
+        for(UINT m=0; m<numSplittingSteps; m++){
+            if( errors[m] < minError ){
+                minError = errors[m];
+                bestThreshold = thresholds[m];
                 bestFeatureIndex = featureIndex;
             }
         }
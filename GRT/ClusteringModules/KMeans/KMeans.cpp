@@ -292,8 +292,11 @@ bool KMeans::trainModel(MatrixDouble &data){
         data.scale(0,1);
     }
 
-    //Init the assign and count vectors
+    //Init the assign and count vectors, these have not been resized yet if the clusters were set using setClusters
     //Assign is set to K+1 so that the nChanged values in the eStep at the first iteration will be updated correctly
+    numTrainingSamples = data.getNumRows();
+    assign.resize( numTrainingSamples );
+    count.resize( numClusters );
     for(UINT m=0; m<numTrainingSamples; m++) assign[m] = numClusters+1;
 	for(UINT k=0; k<numClusters; k++) count[k] = 0;
 
@@ -38,7 +38,7 @@ Gate::~Gate(){
     
 }
 
-bool Gate::process(VectorDouble inputVector){
+bool Gate::process(const VectorDouble &inputVector){
     data = inputVector;
     okToContinue = gateOpen;
     return true;
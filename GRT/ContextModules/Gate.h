@@ -48,7 +48,7 @@ public:
         return false;
     }
     
-    virtual bool process(VectorDouble inputVector);
+    virtual bool process(const VectorDouble &inputVector);
     virtual bool reset();
     
     bool updateContext(bool value){ 
@@ -3,6 +3,27 @@
  @version 1.0
  
  @brief This class implements a basic grid search algorithm. 
+ 
+ The search() function sets each parameter in turn and runs the evaluation function, using one shared model.  The searchModelParameters()
+ function searches model parameters added with addModelParameter instead.  Each candidate point is evaluated on a copy of the model, one
+ fold at a time, and the evaluations are run as separate tasks on a GRT ThreadPool.  Successive halving can be enabled, so each candidate is
+ first evaluated on a few folds and only the best candidates are evaluated on the remaining folds.  The result of each fold is cached, so
+ running the search again (for example after adding more candidates or after loading the results from a file) only evaluates new points.
+ 
+ Example:
+ @code
+ GridSearch< DTW > gridSearch;
+ gridSearch.setModel( DTW() );
+ gridSearch.addModelParameter( [](DTW &dtw,double value){ return dtw.setWarpingRadius( value ); }, GridSearchRange<double>(0.1,1.0,0.1) );
+ gridSearch.addModelParameter( [](DTW &dtw,double value){ return dtw.setNullRejectionCoeff( value ); }, GridSearchRange<double>(1.0,5.0,1.0) );
+ gridSearch.setNumFolds( K );
+ gridSearch.setModelEvaluationFunction( [&](DTW &dtw,const UINT foldIndex){
+     dtw.train( trainingFolds[ foldIndex ] );
+     ...
+     return accuracy;
+ } );
+ gridSearch.searchModelParameters();
+ @endcode
  */
 
 /**
@@ -30,6 +51,8 @@
 
 #include "../../CoreModules/MLBase.h"
 #include "../../CoreModules/GestureRecognitionPipeline.h"
+#include <set>
+#include <type_traits>
 
 namespace GRT {
 
@@ -106,6 +129,29 @@ public:
     GridSearchRange<T> range;
 };
 
+template < class T >
+class GridSearchModelParam {
+public:
+
+    GridSearchModelParam( std::function< bool(T&,double) > func, const VectorDouble &values ){
+        this->func = func;
+        this->values = values;
+    }
+
+    GridSearchModelParam( const GridSearchModelParam &rhs ){
+        this->func = rhs.func;
+        this->values = rhs.values;
+    }
+
+    bool set( T &model, const double value ) const{
+        if( !func ) return false;
+        return func( model, value );
+    }
+
+    std::function< bool(T&,double) > func;
+    VectorDouble values;                        ///< The values of the parameter that will be searched
+};
+
 template< class T >
 class GridSearch : public MLBase{
 public:
@@ -117,6 +163,15 @@ public:
         errorLog.setProceedingText("[ERROR GridSearch");
         trainingLog.setProceedingText("[TRAINING GridSearch]");
         warningLog.setProceedingText("[WARNING GridSearch]");
+        evalType = MaxValueSearch;
+        bestResult = 0;
+        numFolds = 1;
+        minNumFolds = 1;
+        reductionFactor = 2;
+        numRandomCandidates = 0;
+        randomSeed = 0;
+        useParallelSearch = true;
+        useSuccessiveHalving = false;
     }
     
     virtual ~GridSearch(){
@@ -167,6 +222,361 @@ public:
         evalType = type;
         return true;
     }
+    
+    /**
+     Adds a model parameter that will be searched by searchModelParameters.  The function is called with a copy of the model and the value
+     of the parameter for the candidate that is being evaluated.
+     
+     @param std::function< bool(T&,double) > f: the function that sets the parameter of the model, this should return false if the value is not valid
+     @param GridSearchRange< double > range: the range of the parameter, the increment must be greater than zero
+     @return returns true if the parameter was added, false otherwise
+     */
+    bool addModelParameter( std::function< bool(T&,double) > f, GridSearchRange< double > range ){
+        VectorDouble values;
+        if( !getRangeValues( range, values ) ){
+            errorLog << "addModelParameter(...) - The increment of the range must be greater than zero!" << endl;
+            return false;
+        }
+        modelParams.push_back( GridSearchModelParam<T>( f, values ) );
+        return true;
+    }
+    
+    /**
+     Adds an integer model parameter that will be searched by searchModelParameters, such as the K value of a KNN model.
+     
+     @param std::function< bool(T&,unsigned int) > f: the function that sets the parameter of the model, this should return false if the value is not valid
+     @param GridSearchRange< unsigned int > range: the range of the parameter, the increment must be greater than zero
+     @return returns true if the parameter was added, false otherwise
+     */
+    bool addModelParameter( std::function< bool(T&,unsigned int) > f, GridSearchRange< unsigned int > range ){
+        vector< unsigned int > rangeValues;
+        if( !getRangeValues( range, rangeValues ) ){
+            errorLog << "addModelParameter(...) - The increment of the range must be greater than zero!" << endl;
+            return false;
+        }
+        VectorDouble values( rangeValues.begin(), rangeValues.end() );
+        modelParams.push_back( GridSearchModelParam<T>( [f](T &model,double value){ return f( model, (unsigned int)value ); }, values ) );
+        return true;
+    }
+    
+    /**
+     Sets the function used by searchModelParameters to evaluate a candidate on one fold.  The function is called with a copy of the model,
+     with the parameters of the candidate already set, and the index of the fold in the range [0 numFolds-1].  It should train the model on
+     the training data of the fold and return the result of the model on the test data of the fold.  If parallel search is enabled the
+     function is called from several threads at the same time, so it must not modify any shared data.
+     
+     @param std::function< double (T&,const UINT) > f: the evaluation function
+     @param SearchType type: sets if the best candidate has the largest or smallest result.  Default value is type = MaxValueSearch
+     @return returns true if the function was set, false otherwise
+     */
+    bool setModelEvaluationFunction( std::function< double (T&,const UINT) > f, SearchType type = MaxValueSearch ){
+        modelEvalFunc = f;
+        evalType = type;
+        return true;
+    }
+    
+    /**
+     Searches the model parameters added with addModelParameter.  Each candidate is evaluated on a copy of the model, and its result is the
+     mean result of the evaluation function over the folds.  If successive halving is enabled, every candidate is first evaluated on the first
+     minNumFolds folds, then only the best 1/reductionFactor candidates are evaluated on reductionFactor times as many folds, and so on until
+     the remaining candidates have been evaluated on all the folds.  The best model is a copy of the model with the best parameters set, it
+     is not trained.
+     
+     The result of each candidate and fold is cached, so only the candidates and folds that have not been evaluated before are run.  The
+     cache should be cleared with clearResults if the model, the data or the evaluation function is changed.
+     
+     @return returns true if the search was run, false otherwise
+     */
+    bool searchModelParameters(){
+        
+        const UINT numParams = (UINT)modelParams.size();
+        
+        if( numParams == 0 ){
+            warningLog << "searchModelParameters() - No parameters to search! Add some parameters!" << endl;
+            return false;
+        }
+        
+        if( !modelEvalFunc ){
+            errorLog << "searchModelParameters() - The model evaluation function has not been set!" << endl;
+            return false;
+        }
+        
+        if( evalType != MaxValueSearch && evalType != MinValueSearch ){
+            errorLog << "searchModelParameters() - Unknown eval type!" << endl;
+            return false;
+        }
+        
+        //Get the candidates that will be evaluated
+        vector< VectorDouble > candidates;
+        getCandidates( candidates );
+        
+        const UINT numCandidates = (UINT)candidates.size();
+        vector< UINT > candidateIndexs( numCandidates );
+        VectorDouble candidateResults( numCandidates, 0 );
+        for(UINT i=0; i<numCandidates; i++) candidateIndexs[i] = i;
+        
+        UINT numRoundFolds = useSuccessiveHalving ? std::min( std::max( minNumFolds, (UINT)1 ), numFolds ) : numFolds;
+        
+        while( true ){
+            
+            trainingLog << "searchModelParameters() - Evaluating " << candidateIndexs.size() << " candidates on " << numRoundFolds << " folds" << endl;
+            
+            if( !evaluateCandidates( candidates, candidateIndexs, numRoundFolds, candidateResults ) ){
+                return false;
+            }
+            
+            if( numRoundFolds >= numFolds || candidateIndexs.size() <= 1 ) break;
+            
+            //Keep the best candidates, ties are broken by the order of the candidates so the search does not depend on the thread timing
+            const SearchType type = evalType;
+            std::stable_sort( candidateIndexs.begin(), candidateIndexs.end(), [&candidateResults,type](const UINT a,const UINT b){
+                return type == MaxValueSearch ? candidateResults[a] > candidateResults[b] : candidateResults[a] < candidateResults[b];
+            } );
+            const UINT numKeep = std::max( (UINT)ceil( candidateIndexs.size() / double(reductionFactor) ), (UINT)1 );
+            candidateIndexs.resize( numKeep );
+            std::sort( candidateIndexs.begin(), candidateIndexs.end() );
+            
+            numRoundFolds = std::min( numRoundFolds * reductionFactor, numFolds );
+        }
+        
+        //Find the best of the remaining candidates
+        UINT bestIndex = candidateIndexs[0];
+        for(UINT i=1; i<candidateIndexs.size(); i++){
+            const UINT index = candidateIndexs[i];
+            if( evalType == MaxValueSearch ? candidateResults[index] > candidateResults[bestIndex] : candidateResults[index] < candidateResults[bestIndex] ){
+                bestIndex = index;
+            }
+        }
+        
+        bestResult = candidateResults[ bestIndex ];
+        bestParameters = candidates[ bestIndex ];
+        bestModel = model;
+        for(UINT j=0; j<numParams; j++){
+            modelParams[j].set( bestModel, bestParameters[j] );
+        }
+        
+        return true;
+    }
+    
+    /**
+     Clears the cached results of the model parameter search.
+     
+     @return returns true if the results were cleared, false otherwise
+     */
+    bool clearResults(){
+        results.clear();
+        return true;
+    }
+    
+    /**
+     Saves the cached results of the model parameter search to a file, so a search can be resumed later with loadResultsFromFile.
+     
+     @param const string filename: the name of the file the results will be saved to
+     @return returns true if the results were saved, false otherwise
+     */
+    bool saveResultsToFile( const string filename ) const{
+        
+        std::fstream file;
+        file.open( filename.c_str(), std::ios::out );
+        
+        if( !file.is_open() ){
+            errorLog << "saveResultsToFile(const string filename) - Could not open file to save results!" << endl;
+            return false;
+        }
+        
+        file.precision( 17 );
+        file << "GRT_GRID_SEARCH_RESULTS_FILE_V1.0" << endl;
+        file << "NumResults: " << results.size() << endl;
+        file << "Results:" << endl;
+        
+        typename std::map< VectorDouble, std::map< UINT, double > >::const_iterator iter;
+        for(iter = results.begin(); iter != results.end(); ++iter){
+            file << iter->first.size();
+            for(UINT j=0; j<iter->first.size(); j++) file << "\t" << iter->first[j];
+            file << "\t" << iter->second.size();
+            std::map< UINT, double >::const_iterator foldIter;
+            for(foldIter = iter->second.begin(); foldIter != iter->second.end(); ++foldIter){
+                file << "\t" << foldIter->first << "\t" << foldIter->second;
+            }
+            file << endl;
+        }
+        
+        file.close();
+        
+        return true;
+    }
+    
+    /**
+     Loads the cached results of the model parameter search from a file written by saveResultsToFile.  The results are added to any
+     results that are already cached.
+     
+     @param const string filename: the name of the file the results will be loaded from
+     @return returns true if the results were loaded, false otherwise
+     */
+    bool loadResultsFromFile( const string filename ){
+        
+        std::fstream file;
+        file.open( filename.c_str(), std::ios::in );
+        
+        if( !file.is_open() ){
+            errorLog << "loadResultsFromFile(const string filename) - Could not open file to load results!" << endl;
+            return false;
+        }
+        
+        string word;
+        UINT numResults = 0;
+        
+        file >> word;
+        if( word != "GRT_GRID_SEARCH_RESULTS_FILE_V1.0" ){
+            errorLog << "loadResultsFromFile(const string filename) - Invalid file format!" << endl;
+            return false;
+        }
+        
+        file >> word;
+        if( word != "NumResults:" ){
+            errorLog << "loadResultsFromFile(const string filename) - Failed to find NumResults header!" << endl;
+            return false;
+        }
+        file >> numResults;
+        
+        file >> word;
+        if( word != "Results:" ){
+            errorLog << "loadResultsFromFile(const string filename) - Failed to find Results header!" << endl;
+            return false;
+        }
+        
+        for(UINT i=0; i<numResults; i++){
+            UINT numValues = 0;
+            UINT numFoldResults = 0;
+            UINT foldIndex = 0;
+            double value = 0;
+            
+            file >> numValues;
+            VectorDouble point( numValues );
+            for(UINT j=0; j<numValues; j++) file >> point[j];
+            
+            file >> numFoldResults;
+            std::map< UINT, double > &foldResults = results[ point ];
+            for(UINT k=0; k<numFoldResults; k++){
+                file >> foldIndex;
+                file >> value;
+                foldResults[ foldIndex ] = value;
+            }
+            
+            if( !file.good() ){
+                errorLog << "loadResultsFromFile(const string filename) - Failed to read result " << i << "!" << endl;
+                return false;
+            }
+        }
+        
+        file.close();
+        
+        return true;
+    }
+    
+    /**
+     Sets the number of folds each candidate is evaluated on by searchModelParameters.
+     
+     @param const UINT numFolds: the number of folds, this must be greater than zero
+     @return returns true if the parameter was set, false otherwise
+     */
+    bool setNumFolds( const UINT numFolds ){
+        if( numFolds == 0 ){
+            errorLog << "setNumFolds(const UINT numFolds) - The number of folds must be greater than zero!" << endl;
+            return false;
+        }
+        this->numFolds = numFolds;
+        return true;
+    }
+    
+    /**
+     Sets the number of folds each candidate is evaluated on in the first round of successive halving.
+     
+     @param const UINT minNumFolds: the number of folds in the first round, this must be greater than zero
+     @return returns true if the parameter was set, false otherwise
+     */
+    bool setMinNumFolds( const UINT minNumFolds ){
+        if( minNumFolds == 0 ){
+            errorLog << "setMinNumFolds(const UINT minNumFolds) - The number of folds must be greater than zero!" << endl;
+            return false;
+        }
+        this->minNumFolds = minNumFolds;
+        return true;
+    }
+    
+    /**
+     Sets the reduction factor of successive halving.  After each round, only the best 1/reductionFactor candidates are kept, and they are
+     evaluated on reductionFactor times as many folds.
+     
+     @param const UINT reductionFactor: the reduction factor, this must be at least 2
+     @return returns true if the parameter was set, false otherwise
+     */
+    bool setReductionFactor( const UINT reductionFactor ){
+        if( reductionFactor < 2 ){
+            errorLog << "setReductionFactor(const UINT reductionFactor) - The reduction factor must be at least 2!" << endl;
+            return false;
+        }
+        this->reductionFactor = reductionFactor;
+        return true;
+    }
+    
+    /**
+     Sets the number of candidates that are picked at random from the grid by searchModelParameters.  If this is zero, or not less than
+     the number of points in the grid, then every point in the grid is evaluated.
+     
+     @param const UINT numRandomCandidates: the number of random candidates
+     @return returns true if the parameter was set, false otherwise
+     */
+    bool setNumRandomCandidates( const UINT numRandomCandidates ){
+        this->numRandomCandidates = numRandomCandidates;
+        return true;
+    }
+    
+    /**
+     Sets the seed used to pick the random candidates.  If the seed is zero the current time is used, so a random search should set a
+     seed if it will be resumed from the cached results.
+     
+     @param const unsigned long long randomSeed: the random seed
+     @return returns true if the parameter was set, false otherwise
+     */
+    bool setRandomSeed( const unsigned long long randomSeed ){
+        this->randomSeed = randomSeed;
+        return true;
+    }
+    
+    /**
+     Sets if the candidates of searchModelParameters should be evaluated in parallel on a GRT ThreadPool.  When the candidates are evaluated
+     in parallel, the parallel training and parallel prediction of each candidate's copy of an MLBase model are disabled, so the search does
+     not use more threads than the ThreadPool.
+     
+     @param const bool useParallelSearch: sets if parallel search should be used
+     @return returns true if the parameter was set, false otherwise
+     */
+    bool enableParallelSearch( const bool useParallelSearch ){
+        this->useParallelSearch = useParallelSearch;
+        return true;
+    }
+    
+    /**
+     Sets if searchModelParameters should use successive halving to stop evaluating the worst candidates early.
+     
+     @param const bool useSuccessiveHalving: sets if successive halving should be used
+     @return returns true if the parameter was set, false otherwise
+     */
+    bool enableSuccessiveHalving( const bool useSuccessiveHalving ){
+        this->useSuccessiveHalving = useSuccessiveHalving;
+        return true;
+    }
+    
+    VectorDouble getBestParameters() const { return bestParameters; }
+    
+    UINT getNumFolds() const { return numFolds; }
+    
+    UINT getNumResults() const { return (UINT)results.size(); }
+    
+    bool getParallelSearchEnabled() const { return useParallelSearch; }
+    
+    bool getSuccessiveHalvingEnabled() const { return useSuccessiveHalving; }
  
 protected:
 
@@ -239,12 +649,166 @@ protected:
         return params[ paramIndex ].reset();
     }
 
+    template< class V >
+    static bool getRangeValues( GridSearchRange< V > range, vector< V > &values ){
+        values.clear();
+        if( range.min < range.max && range.inc <= 0 ) return false;
+        range.reset();
+        while( true ){
+            values.push_back( range.get() );
+            if( range.getExpired() ) break;
+            range.next();
+        }
+        return true;
+    }
+    
+    void getCandidates( vector< VectorDouble > &candidates ) const{
+        
+        const UINT numParams = (UINT)modelParams.size();
+        double gridSize = 1;
+        for(UINT j=0; j<numParams; j++) gridSize *= modelParams[j].values.size();
+        
+        candidates.clear();
+        VectorDouble point( numParams );
+        
+        if( numRandomCandidates > 0 && numRandomCandidates < gridSize ){
+            //Pick distinct points from the grid at random, the points are sorted so they are in the same order as the full grid
+            Random random( randomSeed );
+            std::set< VectorDouble > points;
+            while( points.size() < numRandomCandidates ){
+                for(UINT j=0; j<numParams; j++){
+                    point[j] = modelParams[j].values[ random.getRandomNumberInt( 0, (int)modelParams[j].values.size() ) ];
+                }
+                points.insert( point );
+            }
+            candidates.assign( points.begin(), points.end() );
+            return;
+        }
+        
+        //Add every point in the grid, with the first parameter changing the slowest
+        vector< UINT > valueIndexs( numParams, 0 );
+        while( true ){
+            for(UINT j=0; j<numParams; j++) point[j] = modelParams[j].values[ valueIndexs[j] ];
+            candidates.push_back( point );
+            
+            UINT j = numParams;
+            while( j > 0 ){
+                j--;
+                if( ++valueIndexs[j] < modelParams[j].values.size() ) break;
+                valueIndexs[j] = 0;
+                if( j == 0 ) return;
+            }
+        }
+    }
+    
+    bool evaluateCandidates( const vector< VectorDouble > &candidates, const vector< UINT > &candidateIndexs, const UINT numRoundFolds, VectorDouble &candidateResults ){
+        
+        //Find the folds that have not been evaluated for each candidate
+        vector< UINT > taskCandidates;
+        vector< UINT > taskFolds;
+        for(UINT i=0; i<candidateIndexs.size(); i++){
+            const std::map< UINT, double > &foldResults = results[ candidates[ candidateIndexs[i] ] ];
+            for(UINT k=0; k<numRoundFolds; k++){
+                if( foldResults.find( k ) == foldResults.end() ){
+                    taskCandidates.push_back( candidateIndexs[i] );
+                    taskFolds.push_back( k );
+                }
+            }
+        }
+        
+        const UINT numTasks = (UINT)taskCandidates.size();
+        const UINT numThreads = ThreadPool::getThreadPoolSize();
+        VectorDouble taskResults( numTasks, 0 );
+        bool result = true;
+        
+        if( useParallelSearch && numThreads > 1 && numTasks > 1 ){
+            if( threadPool.get() == NULL ){
+                threadPool.reset( new ThreadPool( numThreads ) );
+            }
+            
+            vector< std::future< bool > > tasks;
+            tasks.reserve( numTasks );
+            for(UINT t=0; t<numTasks; t++){
+                tasks.push_back( threadPool->enqueue( &GridSearch::evaluateCandidate, this, std::cref(candidates[ taskCandidates[t] ]), taskFolds[t], true, std::ref(taskResults[t]) ) );
+            }
+            
+            //Wait for all the tasks to finish, even if one fails, as the tasks use the candidates and results
+            for(UINT t=0; t<numTasks; t++){
+                if( !tasks[t].get() ) result = false;
+            }
+        }else{
+            for(UINT t=0; t<numTasks && result; t++){
+                result = evaluateCandidate( candidates[ taskCandidates[t] ], taskFolds[t], false, taskResults[t] );
+            }
+        }
+        
+        if( !result ){
+            errorLog << "evaluateCandidates(...) - Failed to set the parameters of a candidate!" << endl;
+            return false;
+        }
+        
+        //Cache the new results and compute the mean result of each candidate over the folds of this round
+        for(UINT t=0; t<numTasks; t++){
+            results[ candidates[ taskCandidates[t] ] ][ taskFolds[t] ] = taskResults[t];
+        }
+        
+        for(UINT i=0; i<candidateIndexs.size(); i++){
+            const std::map< UINT, double > &foldResults = results[ candidates[ candidateIndexs[i] ] ];
+            double sum = 0;
+            for(UINT k=0; k<numRoundFolds; k++){
+                sum += foldResults.find( k )->second;
+            }
+            candidateResults[ candidateIndexs[i] ] = sum / numRoundFolds;
+        }
+        
+        return true;
+    }
+    
+    bool evaluateCandidate( const VectorDouble &point, const UINT foldIndex, const bool parallelSearch, double &result ) const{
+        
+        //Evaluate the candidate on its own copy of the model, so the candidates can be evaluated at the same time
+        T candidateModel( model );
+        for(UINT j=0; j<modelParams.size(); j++){
+            if( !modelParams[j].set( candidateModel, point[j] ) ) return false;
+        }
+        
+        //If the candidates are already being evaluated on the thread pool, then each copy of the model should train and predict on its own
+        //thread, otherwise every candidate would start its own parallel tasks on top of the search
+        if( parallelSearch ){
+            disableModelParallelism( candidateModel, std::is_base_of< MLBase, T >() );
+        }
+        
+        result = modelEvalFunc( candidateModel, foldIndex );
+        
+        return true;
+    }
+    
+    static void disableModelParallelism( T &candidateModel, std::true_type ){
+        candidateModel.enableParallelTraining( false );
+        candidateModel.enableParallelPrediction( false );
+    }
+    
+    static void disableModelParallelism( T &candidateModel, std::false_type ){}
+
     std::vector< GridSearchParam<unsigned int> > params;
     std::function< double () >  evalFunc; 
     SearchType evalType;
     double bestResult;
     T model;
     T bestModel;
+    
+    std::vector< GridSearchModelParam<T> > modelParams;
+    std::function< double (T&,const UINT) > modelEvalFunc;
+    VectorDouble bestParameters;
+    UINT numFolds;
+    UINT minNumFolds;
+    UINT reductionFactor;
+    UINT numRandomCandidates;
+    unsigned long long randomSeed;
+    bool useParallelSearch;
+    bool useSuccessiveHalving;
+    std::map< VectorDouble, std::map< UINT, double > > results;     ///< The cached result of each candidate point for each fold that has been evaluated
+    std::unique_ptr< ThreadPool > threadPool;                       ///< The thread pool used to evaluate the candidates in parallel, this is only created when it is first needed
 };
 
 }
@@ -0,0 +1,209 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "SplitSearch.h"
+
+namespace GRT{
+
+SplitSearch::SplitSearch(){
+}
+
+SplitSearch::~SplitSearch(){
+}
+
+bool SplitSearch::sortFeature( const double *x, const UINT M ){
+
+    if( x == NULL && M > 0 ) return false;
+
+    sortedValues.resize( M );
+    for(UINT i=0; i<M; i++){
+        sortedValues[i].index = i;
+        sortedValues[i].value = x[i];
+    }
+    std::sort(sortedValues.begin(),sortedValues.end(),IndexedDouble::sortIndexedDoubleByValueAscending);
+
+    return true;
+}
+
+bool SplitSearch::computeGiniErrors( const vector< UINT > &classIndex, const UINT K, const VectorDouble &thresholds, VectorDouble &errors ){
+
+    const UINT M = (UINT)sortedValues.size();
+    const UINT T = (UINT)thresholds.size();
+
+    if( M == 0 || K == 0 || classIndex.size() != M ) return false;
+
+    errors.resize( T );
+    sortThresholds( thresholds );
+
+    //All the samples start in the right group, the counts of the left group are stored at [0 K-1] and the right group at [K 2K-1]
+    classCounts.resize( K*2 );
+    std::fill(classCounts.begin(),classCounts.end(),0);
+    for(UINT i=0; i<M; i++){
+        classCounts[ K + classIndex[i] ]++;
+    }
+
+    double groupCounterL = 0;
+    double groupCounterR = M;
+    double classProbabilityL = 0;
+    double classProbabilityR = 0;
+    double giniIndexL = 0;
+    double giniIndexR = 0;
+    UINT i = 0;
+
+    for(UINT t=0; t<T; t++){
+        const double threshold = sortedThresholds[t].value;
+
+        //Move any samples that are below this threshold to the left group
+        while( i < M && sortedValues[i].value < threshold ){
+            const UINT k = classIndex[ sortedValues[i].index ];
+            classCounts[ k ]++;
+            classCounts[ K + k ]--;
+            groupCounterL++;
+            groupCounterR--;
+            i++;
+        }
+
+        //Compute the Gini index for the lhs and rhs groups
+        giniIndexL = giniIndexR = 0;
+        for(UINT k=0; k<K; k++){
+            classProbabilityL = groupCounterL>0 ? classCounts[k]/groupCounterL : 0;
+            classProbabilityR = groupCounterR>0 ? classCounts[K+k]/groupCounterR : 0;
+            giniIndexL += classProbabilityL * (1.0-classProbabilityL);
+            giniIndexR += classProbabilityR * (1.0-classProbabilityR);
+        }
+
+        errors[ sortedThresholds[t].index ] = (giniIndexL*(groupCounterL/M)) + (giniIndexR*(groupCounterR/M));
+    }
+
+    return true;
+}
+
+bool SplitSearch::computeMeanSquaredErrors( const double *y, const UINT D, const VectorDouble &thresholds, VectorDouble &errors, const bool weightGroups ){
+
+    const UINT M = (UINT)sortedValues.size();
+    const UINT T = (UINT)thresholds.size();
+    const UINT numDimensions = y == NULL ? 1 : D;
+
+    if( M == 0 || numDimensions == 0 ) return false;
+
+    errors.resize( T );
+    sortThresholds( thresholds );
+
+    //The responses are centered on their mean before they are summed, to reduce the rounding error of the sum of squares
+    responseMean.resize( numDimensions );
+    std::fill(responseMean.begin(),responseMean.end(),0);
+    for(UINT i=0; i<M; i++){
+        for(UINT d=0; d<numDimensions; d++){
+            responseMean[d] += y == NULL ? sortedValues[i].value : y[ i*numDimensions + d ];
+        }
+    }
+    for(UINT d=0; d<numDimensions; d++) responseMean[d] /= M;
+
+    //All the samples start in the right group, the sums of the left group are stored at [0 D-1] and the right group at [D 2D-1]
+    responseSums.resize( numDimensions*2 );
+    std::fill(responseSums.begin(),responseSums.end(),0);
+    double sumSquaresL = 0;
+    double sumSquaresR = 0;
+    double value = 0;
+    for(UINT i=0; i<M; i++){
+        for(UINT d=0; d<numDimensions; d++){
+            value = (y == NULL ? sortedValues[i].value : y[ sortedValues[i].index*numDimensions + d ]) - responseMean[d];
+            responseSums[ numDimensions + d ] += value;
+            sumSquaresR += value*value;
+        }
+    }
+
+    double groupCounterL = 0;
+    double groupCounterR = M;
+    double groupMSEL = 0;
+    double groupMSER = 0;
+    UINT i = 0;
+
+    for(UINT t=0; t<T; t++){
+        const double threshold = sortedThresholds[t].value;
+
+        //Move any samples that are below this threshold to the left group
+        while( i < M && sortedValues[i].value < threshold ){
+            for(UINT d=0; d<numDimensions; d++){
+                value = (y == NULL ? sortedValues[i].value : y[ sortedValues[i].index*numDimensions + d ]) - responseMean[d];
+                responseSums[ d ] += value;
+                responseSums[ numDimensions + d ] -= value;
+                sumSquaresL += value*value;
+                sumSquaresR -= value*value;
+            }
+            groupCounterL++;
+            groupCounterR--;
+            i++;
+        }
+
+        //The MSE of each group is the mean of the squares minus the square of the mean, summed over each dimension of the response
+        groupMSEL = groupMSER = 0;
+        if( groupCounterL > 0 ){
+            groupMSEL = sumSquaresL;
+            for(UINT d=0; d<numDimensions; d++) groupMSEL -= responseSums[d]*responseSums[d]/groupCounterL;
+            groupMSEL = groupMSEL > 0 ? groupMSEL/groupCounterL : 0;
+        }
+        if( groupCounterR > 0 ){
+            groupMSER = sumSquaresR;
+            for(UINT d=0; d<numDimensions; d++) groupMSER -= responseSums[numDimensions+d]*responseSums[numDimensions+d]/groupCounterR;
+            groupMSER = groupMSER > 0 ? groupMSER/groupCounterR : 0;
+        }
+
+        if( weightGroups ){
+            errors[ sortedThresholds[t].index ] = sqrt( (groupMSEL*groupCounterL + groupMSER*groupCounterR)/M );
+        }else errors[ sortedThresholds[t].index ] = sqrt( groupMSEL + groupMSER );
+    }
+
+    return true;
+}
+
+bool SplitSearch::getIterativeThresholds( const double minValue, const double maxValue, const UINT numSteps, VectorDouble &thresholds ){
+
+    thresholds.clear();
+
+    if( numSteps == 0 ) return false;
+
+    //The thresholds are accumulated one step at a time, so each threshold matches the previous iterative search exactly
+    const double step = (maxValue-minValue)/double(numSteps);
+    double threshold = minValue;
+    thresholds.reserve( numSteps+1 );
+    while( threshold <= maxValue ){
+        thresholds.push_back( threshold );
+
+        //If the range is empty (or too small to step through) then there is only one threshold
+        if( threshold + step <= threshold ) break;
+        threshold += step;
+    }
+
+    return true;
+}
+
+void SplitSearch::sortThresholds( const VectorDouble &thresholds ){
+
+    const UINT T = (UINT)thresholds.size();
+    sortedThresholds.resize( T );
+    for(UINT t=0; t<T; t++){
+        sortedThresholds[t].index = t;
+        sortedThresholds[t].value = thresholds[t];
+    }
+    std::sort(sortedThresholds.begin(),sortedThresholds.end(),IndexedDouble::sortIndexedDoubleByValueAscending);
+}
+
+} //End of namespace GRT
@@ -0,0 +1,129 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The SplitSearch class finds the error of splitting the samples at a tree node with a number of candidate thresholds.  It is used by
+ the DecisionTree, RegressionTree and ClusterTree to search for the best spilt of each feature.
+
+ The values of the feature are sorted once, then the candidate thresholds are tested in ascending order while sweeping through the sorted
+ values, so each sample only moves from the right group to the left group once.  This means the cost of testing every threshold of a feature
+ is O(M log M + T) rather than O(M * T), where M is the number of samples and T is the number of thresholds.  The error of each threshold is
+ the same as testing the samples against each threshold one at a time, with a sample in the right group if its value is >= the threshold.
+
+ Example:
+ @code
+ SplitSearch splitSearch;
+
+ //Sort the values of the feature (x is a buffer with one value per sample)
+ splitSearch.sortFeature( x, M );
+
+ //Compute the Gini error of each threshold (classIndex holds the index of the class of each sample)
+ VectorDouble errors;
+ splitSearch.computeGiniErrors( classIndex, K, thresholds, errors );
+ @endcode
+ */
+
+/**
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_SPLIT_SEARCH_HEADER
+#define GRT_SPLIT_SEARCH_HEADER
+
+#include "../../Util/GRTCommon.h"
+
+namespace GRT{
+
+class SplitSearch{
+public:
+    /**
+     Default Constructor
+     */
+    SplitSearch();
+
+    /**
+     Default Destructor
+     */
+    ~SplitSearch();
+
+    /**
+     Sorts the values of the feature that will be split.  This should be called once for each feature, before the errors are computed.
+
+     @param const double *x: a pointer to the value of the feature for each sample
+     @param const UINT M: the number of samples
+     @return returns true if the values were sorted, false otherwise
+     */
+    bool sortFeature( const double *x, const UINT M );
+
+    /**
+     Computes the weighted Gini index of splitting the samples with each threshold.  The thresholds can be in any order.
+
+     @param const vector< UINT > &classIndex: the index of the class of each sample, each index must be in the range [0 K-1]
+     @param const UINT K: the number of classes
+     @param const VectorDouble &thresholds: the thresholds that will be tested
+     @param VectorDouble &errors: this will store the error of each threshold
+     @return returns true if the errors were computed, false otherwise
+     */
+    bool computeGiniErrors( const vector< UINT > &classIndex, const UINT K, const VectorDouble &thresholds, VectorDouble &errors );
+
+    /**
+     Computes the error of splitting the samples with each threshold, based on the mean squared error (MSE) of the left group and the right
+     group.  The MSE of a group is the mean squared distance between the response of each sample in the group and the mean response of
+     the group.  If weightGroups is false then the error is the square root of the sum of the MSE of the two groups, otherwise the MSE of
+     each group is weighted by the size of the group, so the error is the root mean squared error of all the samples after the split.
+     The thresholds can be in any order.
+
+     @param const double *y: the response of each sample, stored as a M x D row-major buffer.  If NULL then the values of the feature are used as the response
+     @param const UINT D: the number of dimensions of each response, this is ignored if y is NULL
+     @param const VectorDouble &thresholds: the thresholds that will be tested
+     @param VectorDouble &errors: this will store the error of each threshold
+     @param const bool weightGroups: if true then the MSE of each group is weighted by the size of the group. Default value = false
+     @return returns true if the errors were computed, false otherwise
+     */
+    bool computeMeanSquaredErrors( const double *y, const UINT D, const VectorDouble &thresholds, VectorDouble &errors, const bool weightGroups = false );
+
+    /**
+     Gets the thresholds from minValue to maxValue (inclusive) at each step, in the same way as the BEST_ITERATIVE_SPILT training mode
+     has always stepped through the range of a feature.
+
+     @param const double minValue: the first threshold
+     @param const double maxValue: the maximum threshold
+     @param const UINT numSteps: the number of steps that the range will be divided into
+     @param VectorDouble &thresholds: this will store the thresholds
+     @return returns true if the thresholds were computed, false otherwise
+     */
+    static bool getIterativeThresholds( const double minValue, const double maxValue, const UINT numSteps, VectorDouble &thresholds );
+
+protected:
+    /**
+     Sorts the thresholds so they can be tested in ascending order.
+     */
+    void sortThresholds( const VectorDouble &thresholds );
+
+    vector< IndexedDouble > sortedValues;           ///< The value and index of each sample, sorted by value
+    vector< IndexedDouble > sortedThresholds;       ///< The value and index of each threshold, sorted by value
+    VectorDouble classCounts;                       ///< The number of samples of each class in the left and right groups
+    VectorDouble responseSums;                      ///< The sum of the responses in the left and right groups
+    VectorDouble responseMean;                      ///< The mean response of all the samples, used to center the responses
+};
+
+} //End of namespace GRT
+
+#endif //GRT_SPLIT_SEARCH_HEADER
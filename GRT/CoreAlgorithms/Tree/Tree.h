@@ -32,6 +32,7 @@
 #define GRT_TREE_HEADER
 
 #include "Node.h"
+#include "SplitSearch.h"
 
 namespace GRT{
 
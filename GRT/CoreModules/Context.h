@@ -81,7 +81,7 @@ public:
         return true;
     }
 
-    virtual bool process(VectorDouble inputVector){ return false; }
+    virtual bool process(const VectorDouble &inputVector){ return false; }
 
     virtual bool reset(){ return false; }
     
@@ -93,7 +93,7 @@ public:
 	UINT getNumOutputDimensions() const { return numOutputDimensions; }
 	bool getInitialized() const { return initialized; }
 	bool getOK() const { return okToContinue; }
-	VectorDouble getProcessedData() const { return data; }
+	const VectorDouble& getProcessedData() const { return data; }
     
     /**
      Defines a map between a string (which will contain the name of the context module, such as Gate) and a function returns a new instance of that context
@@ -178,7 +178,12 @@ bool FeatureExtraction::getFeatureDataReady() const{
     return featureDataReady;
 }
 
-VectorDouble FeatureExtraction::getFeatureVector() const{ 
+bool FeatureExtraction::computeFeatures(const RowSpan &inputVector){
+    inputVector.copyTo( spanInputVector );
+    return computeFeatures( spanInputVector );
+}
+
+const VectorDouble& FeatureExtraction::getFeatureVector() const{ 
     return featureVector; 
 }
     
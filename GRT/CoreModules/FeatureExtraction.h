@@ -73,6 +73,16 @@ public:
      */
     virtual bool computeFeatures(const VectorDouble &inputVector){ return false; }
     
+    /**
+     This function is called by the GestureRecognitionPipeline to compute the features for a row of a matrix without copying the row to a new vector.
+     By default the row is copied to a vector that is reused for every call, which is then passed to the VectorDouble computeFeatures function.
+     The derived class can overwrite this function to use the span directly.
+     
+     @param const RowSpan &inputVector: a span of the inputVector that should be processed
+     @return returns true if the data was processed, false otherwise
+     */
+    virtual bool computeFeatures(const RowSpan &inputVector);
+    
     /**
      This function is called by the GestureRecognitionPipeline's reset function.
      This function should be overwritten by the derived class.
@@ -146,7 +156,7 @@ public:
      
      @return returns the current feature vector, this vector will be empty if the module has not been initialized
      */
-    VectorDouble getFeatureVector() const;
+    const VectorDouble& getFeatureVector() const;
     
     /**
      Defines a map between a string (which will contain the name of the featureExtraction module, such as FFT) and a function returns a new instance of that featureExtraction
@@ -197,6 +207,7 @@ protected:
     bool initialized;
     bool featureDataReady;
     VectorDouble featureVector;
+    VectorDouble spanInputVector;
     
     static StringFeatureExtractionMap *getMap() {
         if( !stringFeatureExtractionMap ){ stringFeatureExtractionMap = new StringFeatureExtractionMap; } 
@@ -45,6 +45,7 @@ GestureRecognitionPipeline::GestureRecognitionPipeline(void)
     classifier = NULL;
     regressifier = NULL;
     clusterer = NULL;
+    useParallelCrossValidation = false;
     contextModules.resize( NUM_CONTEXT_LEVELS );
 
     debugLog.setProceedingText("[DEBUG GRP]");
@@ -76,6 +77,7 @@ GestureRecognitionPipeline::GestureRecognitionPipeline(const GestureRecognitionP
     classifier = NULL;
     regressifier = NULL;
     clusterer = NULL;
+    useParallelCrossValidation = false;
     contextModules.resize( NUM_CONTEXT_LEVELS );
     
     debugLog.setProceedingText("[DEBUG GRP]");
@@ -119,6 +121,7 @@ GestureRecognitionPipeline& GestureRecognitionPipeline::operator=(const GestureR
 	    this->testConfusionMatrix = rhs.testConfusionMatrix;
         this->crossValidationResults = rhs.crossValidationResults;
         this->testResults = rhs.testResults;
+        this->useParallelCrossValidation = rhs.useParallelCrossValidation;
 
         //Copy the GRT Base variables
         this->debugLog = rhs.debugLog;
@@ -177,18 +180,22 @@ GestureRecognitionPipeline::~GestureRecognitionPipeline(void)
 } 
     
 bool GestureRecognitionPipeline::train(const ClassificationData &trainingData){
+    return train( ClassificationDataView( trainingData ) );
+}
+    
+bool GestureRecognitionPipeline::train(const ClassificationDataView &trainingData){
     
     trained = false;
     trainingTime = 0;
     clearTestResults();
     
     if( !getIsClassifierSet() ){
-        errorLog << "train(ClassificationData trainingData) - Failed To Train Classifier, the classifier has not been set!" << endl;
+        errorLog << "train(const ClassificationDataView &trainingData) - Failed To Train Classifier, the classifier has not been set!" << endl;
         return false;
     }
     
     if( trainingData.getNumSamples() == 0 ){
-        errorLog << "train(ClassificationData trainingData) - Failed To Train Classifier, there is no training data!" << endl;
+        errorLog << "train(const ClassificationDataView &trainingData) - Failed To Train Classifier, there is no training data!" << endl;
         return false;
     }
     
@@ -214,6 +221,27 @@ bool GestureRecognitionPipeline::train(const ClassificationData &trainingData){
     Timer timer;
     timer.start();
     
+    //If there are no preprocessing or feature extraction modules then the classifier is trained directly from the view, so the
+    //samples are only copied if the classifier needs to modify them
+    if( !getIsPreProcessingSet() && !getIsFeatureExtractionSet() ){
+        
+        //Store the number of training samples
+        numTrainingSamples = trainingData.getNumSamples();
+        
+        //Train the classifier
+        ClassificationDataView data( trainingData );
+        trained = classifier->train_( data );
+        if( !trained ){
+            errorLog << "train(const ClassificationDataView &trainingData) - Failed To Train Classifier: " << classifier->getLastErrorMessage() << endl;
+            return false;
+        }
+        
+        //Store the training time
+        trainingTime = timer.getMilliSeconds();
+        
+        return true;
+    }
+    
     ClassificationData processedTrainingData( numDimensions );
     
     for(UINT i=0; i<trainingData.getNumSamples(); i++){
@@ -225,7 +253,7 @@ bool GestureRecognitionPipeline::train(const ClassificationData &trainingData){
         if( getIsPreProcessingSet() ){
             for(UINT moduleIndex=0; moduleIndex<preProcessingModules.size(); moduleIndex++){
                 if( !preProcessingModules[moduleIndex]->process( trainingSample ) ){
-                    errorLog << "train(ClassificationData trainingData) - Failed to PreProcess Training Data. PreProcessingModuleIndex: ";
+                    errorLog << "train(const ClassificationDataView &trainingData) - Failed to PreProcess Training Data. PreProcessingModuleIndex: ";
                     errorLog << moduleIndex;
                     errorLog << endl;
                     return false;
@@ -238,7 +266,7 @@ bool GestureRecognitionPipeline::train(const ClassificationData &trainingData){
         if( getIsFeatureExtractionSet() ){
             for(UINT moduleIndex=0; moduleIndex<featureExtractionModules.size(); moduleIndex++){
                 if( !featureExtractionModules[moduleIndex]->computeFeatures( trainingSample ) ){
-                    errorLog << "train(ClassificationData trainingData) - Failed to Compute Features from Training Data. FeatureExtractionModuleIndex ";
+                    errorLog << "train(const ClassificationDataView &trainingData) - Failed to Compute Features from Training Data. FeatureExtractionModuleIndex ";
                     errorLog << moduleIndex;
                     errorLog << endl;
                     return false;
@@ -261,7 +289,7 @@ bool GestureRecognitionPipeline::train(const ClassificationData &trainingData){
     
     if( processedTrainingData.getNumSamples() != trainingData.getNumSamples() ){
         
-        warningLog << "train(ClassificationData trainingData) - Lost " << trainingData.getNumSamples()-processedTrainingData.getNumSamples() << " of " << trainingData.getNumSamples() << " training samples due to the processing stage!" << endl;
+        warningLog << "train(const ClassificationDataView &trainingData) - Lost " << trainingData.getNumSamples()-processedTrainingData.getNumSamples() << " of " << trainingData.getNumSamples() << " training samples due to the processing stage!" << endl;
     }
 
     //Store the number of training samples
@@ -270,7 +298,7 @@ bool GestureRecognitionPipeline::train(const ClassificationData &trainingData){
     //Train the classifier
     trained = classifier->train_( processedTrainingData );
     if( !trained ){
-        errorLog << "train(ClassificationData trainingData) - Failed To Train Classifier: " << classifier->getLastErrorMessage() << endl;
+        errorLog << "train(const ClassificationDataView &trainingData) - Failed To Train Classifier: " << classifier->getLastErrorMessage() << endl;
         return false;
     }
     
@@ -315,27 +343,76 @@ bool GestureRecognitionPipeline::train(const ClassificationData &trainingData,co
     
     //Run the k-fold training and testing
     double crossValidationAccuracy = 0;
-    ClassificationData foldTrainingData;
     ClassificationData foldTestData;
     vector< TestResult > cvResults(kFoldValue);
+    const UINT numThreads = ThreadPool::getThreadPoolSize();
 
-    for(UINT k=0; k<kFoldValue; k++){
-        ///Train the classification system
-		foldTrainingData = data.getTrainingFoldData(k);
+    if( useParallelCrossValidation && kFoldValue > 1 && numThreads > 1 ){
+        //Each fold is trained and tested in its own copy of the pipeline, the training folds are views of the data so the samples are not copied for each fold
+        vector< GestureRecognitionPipeline > foldPipelines( kFoldValue, *this );
         
-        if( !train( foldTrainingData ) ){
-            return false;
+        //The folds already keep the threads busy, so the classifier in each fold is trained serially rather than on its own thread pool
+        const bool classifierParallelTraining = classifier->getParallelTrainingEnabled();
+        for(UINT k=0; k<kFoldValue; k++){
+            foldPipelines[k].getClassifier()->enableParallelTraining( false );
+        }
+        vector< ClassificationDataView > foldTrainingData( kFoldValue );
+        vector< ClassificationData > foldTestData( kFoldValue );
+        for(UINT k=0; k<kFoldValue; k++){
+            foldTrainingData[k] = ClassificationDataView( data, data.getTrainingFoldIndexes(k) );
+            foldTestData[k] = data.getTestFoldData(k);
         }
         
-        //Test the classification system
-        foldTestData = data.getTestFoldData(k);
+        if( threadPool.get() == NULL ){
+            threadPool.reset( new ThreadPool( numThreads ) );
+        }
         
-        if( !test( foldTestData ) ){
+        vector< std::future< bool > > foldTasks;
+        foldTasks.reserve( kFoldValue );
+        for(UINT k=0; k<kFoldValue; k++){
+            foldTasks.push_back( threadPool->enqueue( &GestureRecognitionPipeline::trainAndTestFold, &foldPipelines[k], std::cref(foldTrainingData[k]), std::cref(foldTestData[k]) ) );
+        }
+        
+        //Wait for all the folds to finish, even if one fails, as the tasks use the fold data
+        bool result = true;
+        for(UINT k=0; k<kFoldValue; k++){
+            if( !foldTasks[k].get() ){
+                errorLog << "train(const ClassificationData &trainingData,const UINT kFoldValue,const bool useStratifiedSampling) - Failed to train and test pipeline for fold " << k << "." << endl;
+                result = false;
+            }
+        }
+        if( !result ){
             return false;
         }
         
-        crossValidationAccuracy += getTestAccuracy();
-        cvResults[k] = getTestResults();
+        //Merge the results in fold order
+        for(UINT k=0; k<kFoldValue; k++){
+            crossValidationAccuracy += foldPipelines[k].getTestAccuracy();
+            cvResults[k] = foldPipelines[k].getTestResults();
+        }
+        
+        //Keep the model and test results of the last fold, the same as the serial loop
+        *this = foldPipelines.back();
+        classifier->enableParallelTraining( classifierParallelTraining );
+    }else{
+        for(UINT k=0; k<kFoldValue; k++){
+            ///Train the classification system, the training fold is a view of the data so the samples are not copied for each fold
+            ClassificationDataView foldTrainingData( data, data.getTrainingFoldIndexes(k) );
+            
+            if( !train( foldTrainingData ) ){
+                return false;
+            }
+            
+            //Test the classification system
+            foldTestData = data.getTestFoldData(k);
+            
+            if( !test( foldTestData ) ){
+                return false;
+            }
+            
+            crossValidationAccuracy += getTestAccuracy();
+            cvResults[k] = getTestResults();
+        }
     }
 
     //Flag that the model has been trained
@@ -581,27 +658,80 @@ bool GestureRecognitionPipeline::train(const TimeSeriesClassificationData &train
     
     //Run the k-fold training and testing
     double crossValidationAccuracy = 0;
-    TimeSeriesClassificationData foldTrainingData;
-    TimeSeriesClassificationData foldTestData;
+    vector< TestResult > cvResults(kFoldValue);
+    const UINT numThreads = ThreadPool::getThreadPoolSize();
     
-    for(UINT k=0; k<kFoldValue; k++){
-        ///Train the classification system
-		foldTrainingData = data.getTrainingFoldData(k);
+    if( useParallelCrossValidation && kFoldValue > 1 && numThreads > 1 ){
+        //Each fold is trained and tested in its own copy of the pipeline
+        vector< GestureRecognitionPipeline > foldPipelines( kFoldValue, *this );
         
-        if( !train( foldTrainingData ) ){
-            errorLog << "train(const TimeSeriesClassificationData &trainingData,const UINT kFoldValue,const bool useStratifiedSampling) - Failed to train pipeline for fold " << k << "." << endl;
-            return false;
+        //The folds already keep the threads busy, so the classifier in each fold is trained serially rather than on its own thread pool
+        const bool classifierParallelTraining = classifier->getParallelTrainingEnabled();
+        for(UINT k=0; k<kFoldValue; k++){
+            foldPipelines[k].getClassifier()->enableParallelTraining( false );
+        }
+        vector< TimeSeriesClassificationData > foldTrainingData( kFoldValue );
+        vector< TimeSeriesClassificationData > foldTestData( kFoldValue );
+        for(UINT k=0; k<kFoldValue; k++){
+            foldTrainingData[k] = data.getTrainingFoldData(k);
+            foldTestData[k] = data.getTestFoldData(k);
         }
         
-        //Test the classification system
-        foldTestData = data.getTestFoldData(k);
+        if( threadPool.get() == NULL ){
+            threadPool.reset( new ThreadPool( numThreads ) );
+        }
         
-        if( !test( foldTestData ) ){
-            errorLog << "train(const TimeSeriesClassificationData &trainingData,const UINT kFoldValue,const bool useStratifiedSampling) - Failed to test pipeline for fold " << k << "." << endl;
+        vector< std::future< bool > > foldTasks;
+        foldTasks.reserve( kFoldValue );
+        for(UINT k=0; k<kFoldValue; k++){
+            foldTasks.push_back( threadPool->enqueue( &GestureRecognitionPipeline::trainAndTestTimeSeriesFold, &foldPipelines[k], std::cref(foldTrainingData[k]), std::cref(foldTestData[k]) ) );
+        }
+        
+        //Wait for all the folds to finish, even if one fails, as the tasks use the fold data
+        bool result = true;
+        for(UINT k=0; k<kFoldValue; k++){
+            if( !foldTasks[k].get() ){
+                errorLog << "train(const TimeSeriesClassificationData &trainingData,const UINT kFoldValue,const bool useStratifiedSampling) - Failed to train and test pipeline for fold " << k << "." << endl;
+                result = false;
+            }
+        }
+        if( !result ){
             return false;
         }
         
-        crossValidationAccuracy += getTestAccuracy();
+        //Merge the results in fold order
+        for(UINT k=0; k<kFoldValue; k++){
+            crossValidationAccuracy += foldPipelines[k].getTestAccuracy();
+            cvResults[k] = foldPipelines[k].getTestResults();
+        }
+        
+        //Keep the model and test results of the last fold, the same as the serial loop
+        *this = foldPipelines.back();
+        classifier->enableParallelTraining( classifierParallelTraining );
+    }else{
+        TimeSeriesClassificationData foldTrainingData;
+        TimeSeriesClassificationData foldTestData;
+        
+        for(UINT k=0; k<kFoldValue; k++){
+            ///Train the classification system
+            foldTrainingData = data.getTrainingFoldData(k);
+            
+            if( !train( foldTrainingData ) ){
+                errorLog << "train(const TimeSeriesClassificationData &trainingData,const UINT kFoldValue,const bool useStratifiedSampling) - Failed to train pipeline for fold " << k << "." << endl;
+                return false;
+            }
+            
+            //Test the classification system
+            foldTestData = data.getTestFoldData(k);
+            
+            if( !test( foldTestData ) ){
+                errorLog << "train(const TimeSeriesClassificationData &trainingData,const UINT kFoldValue,const bool useStratifiedSampling) - Failed to test pipeline for fold " << k << "." << endl;
+                return false;
+            }
+            
+            crossValidationAccuracy += getTestAccuracy();
+            cvResults[k] = getTestResults();
+        }
     }
 
     //Flag that the model has been trained
@@ -609,6 +739,7 @@ bool GestureRecognitionPipeline::train(const TimeSeriesClassificationData &train
     
     //Set the accuracy of the classification system averaged over the kfolds
     testAccuracy = crossValidationAccuracy / double(kFoldValue);
+    crossValidationResults = cvResults;
     
     //Store the training time
     trainingTime = timer.getMilliSeconds();
@@ -1282,25 +1413,44 @@ bool GestureRecognitionPipeline::predict(const VectorDouble &inputVector){
 }
 
 bool GestureRecognitionPipeline::predict(const MatrixDouble &input){
+    
+    //Create a view of the input matrix, this does not copy the data
+    const UINT numRows = input.getNumRows();
+    MatrixView inputView( numRows > 0 ? input.getDataPointer() : NULL, numRows, input.getNumCols() );
+    
+    return predict( inputView );
+}
+
+bool GestureRecognitionPipeline::predict(const MatrixView &input){
 	
 	//Make sure the classification model has been trained
     if( !trained ){
-        errorLog << "predict(const MatrixDouble &inputMatrix) - The classifier has not been trained" << endl;
+        errorLog << "predict(const MatrixView &inputMatrix) - The classifier has not been trained" << endl;
         return false;
     }
     
     //Make sure the dimensionality of the input matrix matches the inputVectorDimensions
     if( input.getNumCols() != inputVectorDimensions ){
-        errorLog << "predict(const MatrixDouble &inputMatrix) - The dimensionality of the input matrix (" << input.getNumCols() << ") does not match that of the input vector dimensions of the pipeline (" << inputVectorDimensions << ")" << endl;
+        errorLog << "predict(const MatrixView &inputMatrix) - The dimensionality of the input matrix (" << input.getNumCols() << ") does not match that of the input vector dimensions of the pipeline (" << inputVectorDimensions << ")" << endl;
         return false;
     }
 
 	if( !getIsClassifierSet() ){
-        errorLog << "predict(const MatrixDouble &inputMatrix) - A classifier has not been set" << endl;
+        errorLog << "predict(const MatrixView &inputMatrix) - A classifier has not been set" << endl;
 		return false;
     }
+    
+    if( input.getNumRows() == 0 ){
+        errorLog << "predict(const MatrixView &inputMatrix) - The input matrix is empty" << endl;
+        return false;
+    }
 
-	MatrixDouble inputMatrix = input;
+    //Each module reads its input from one of the prediction buffers and writes its output to the other buffer, so the data is never
+    //copied between the modules and the buffers are only reallocated if the size of the input changes
+    MatrixView inputMatrix = input;
+    MatrixDouble *predictionMatrix = NULL;
+    UINT bufferIndex = 0;
+	const UINT numRows = input.getNumRows();
 
 	predictedClassLabel = 0;
     
@@ -1311,18 +1461,29 @@ bool GestureRecognitionPipeline::predict(const MatrixDouble &input){
     if( getIsPreProcessingSet() ){
 		
         for(UINT moduleIndex=0; moduleIndex<preProcessingModules.size(); moduleIndex++){
-			MatrixDouble tmpMatrix( inputMatrix.getNumRows(), preProcessingModules[moduleIndex]->getNumOutputDimensions() );
+            const UINT numOutputDimensions = preProcessingModules[moduleIndex]->getNumOutputDimensions();
+            predictionMatrix = &predictionBuffers[ bufferIndex ];
+            if( !predictionMatrix->resize( numRows, numOutputDimensions ) ){
+                errorLog << "predict(const MatrixView &inputMatrix) - Failed to resize the prediction buffer. PreProcessingModuleIndex: " << moduleIndex << endl;
+                return false;
+            }
 			
-			for(UINT i=0; i<inputMatrix.getNumRows(); i++){
-            	if( !preProcessingModules[moduleIndex]->process( inputMatrix.getRowVector(i) ) ){
-                    errorLog << "predict(const MatrixDouble &inputMatrix) - Failed to PreProcess Input Matrix. PreProcessingModuleIndex: " << moduleIndex << endl;
+			for(UINT i=0; i<numRows; i++){
+            	if( !preProcessingModules[moduleIndex]->process( inputMatrix.getRowSpan(i) ) ){
+                    errorLog << "predict(const MatrixView &inputMatrix) - Failed to PreProcess Input Matrix. PreProcessingModuleIndex: " << moduleIndex << endl;
                 	return false;
             	}
-            	tmpMatrix.setRowVector( preProcessingModules[moduleIndex]->getProcessedData(), i );
+                const VectorDouble &processedData = preProcessingModules[moduleIndex]->getProcessedData();
+                if( processedData.size() != numOutputDimensions ){
+                    errorLog << "predict(const MatrixView &inputMatrix) - The size of the processed data (" << processedData.size() << ") does not match the number of output dimensions. PreProcessingModuleIndex: " << moduleIndex << endl;
+                    return false;
+                }
+                std::copy( processedData.begin(), processedData.end(), (*predictionMatrix)[i] );
 			}
 			
 			//Update the input matrix with the preprocessed data
-			inputMatrix = tmpMatrix;
+			inputMatrix = MatrixView( *predictionMatrix );
+            bufferIndex = 1 - bufferIndex;
         }
     }
     
@@ -1334,18 +1495,38 @@ bool GestureRecognitionPipeline::predict(const MatrixDouble &input){
     if( getIsFeatureExtractionSet() ){
 	
 	    for(UINT moduleIndex=0; moduleIndex<featureExtractionModules.size(); moduleIndex++){
-			MatrixDouble tmpMatrix( inputMatrix.getNumRows(), featureExtractionModules[moduleIndex]->getNumOutputDimensions() );
+            const UINT numOutputDimensions = featureExtractionModules[moduleIndex]->getNumOutputDimensions();
+            predictionMatrix = &predictionBuffers[ bufferIndex ];
+            if( !predictionMatrix->resize( numRows, numOutputDimensions ) ){
+                errorLog << "predict(const MatrixView &inputMatrix) - Failed to resize the prediction buffer. FeatureExtractionModuleIndex: " << moduleIndex << endl;
+                return false;
+            }
 			
-			for(UINT i=0; i<inputMatrix.getNumRows(); i++){
-            	if( !featureExtractionModules[moduleIndex]->computeFeatures( inputMatrix.getRowVector(i) ) ){
-                    errorLog << "predict(const MatrixDouble &inputMatrix) - Failed to PreProcess Input Matrix. FeatureExtractionModuleIndex: " << moduleIndex << endl;
+			for(UINT i=0; i<numRows; i++){
+            	if( !featureExtractionModules[moduleIndex]->computeFeatures( inputMatrix.getRowSpan(i) ) ){
+                    errorLog << "predict(const MatrixView &inputMatrix) - Failed to PreProcess Input Matrix. FeatureExtractionModuleIndex: " << moduleIndex << endl;
                 	return false;
             	}
-            	tmpMatrix.setRowVector( featureExtractionModules[moduleIndex]->getFeatureVector(), i );
+                const VectorDouble &featureVector = featureExtractionModules[moduleIndex]->getFeatureVector();
+                if( featureVector.size() != numOutputDimensions ){
+                    errorLog << "predict(const MatrixView &inputMatrix) - The size of the feature vector (" << featureVector.size() << ") does not match the number of output dimensions. FeatureExtractionModuleIndex: " << moduleIndex << endl;
+                    return false;
+                }
+                std::copy( featureVector.begin(), featureVector.end(), (*predictionMatrix)[i] );
 			}
 			
 			//Update the input matrix with the preprocessed data
-			inputMatrix = tmpMatrix;
+			inputMatrix = MatrixView( *predictionMatrix );
+            bufferIndex = 1 - bufferIndex;
+        }
+    }
+    
+    //The classifier can modify the matrix it is given, so if no module has written to a prediction buffer then the input is copied to one
+    if( predictionMatrix == NULL ){
+        predictionMatrix = &predictionBuffers[ bufferIndex ];
+        if( !inputMatrix.copyTo( *predictionMatrix ) ){
+            errorLog << "predict(const MatrixView &inputMatrix) - Failed to copy the input matrix to the prediction buffer" << endl;
+            return false;
         }
     }
     
@@ -1354,8 +1535,8 @@ bool GestureRecognitionPipeline::predict(const MatrixDouble &input){
     //Todo
     
     //Perform the classification
-    if( !classifier->predict( inputMatrix ) ){
-        errorLog <<"predict(const MatrixDouble &inputMatrix) - Prediction Failed! " << classifier->getLastErrorMessage() << endl;
+    if( !classifier->predict_( *predictionMatrix ) ){
+        errorLog <<"predict(const MatrixView &inputMatrix) - Prediction Failed! " << classifier->getLastErrorMessage() << endl;
         return false;
     }
     predictedClassLabel = classifier->getPredictedClassLabel();
@@ -1368,11 +1549,11 @@ bool GestureRecognitionPipeline::predict(const MatrixDouble &input){
     if( getIsPostProcessingSet() ){
         
         if( pipelineMode != CLASSIFICATION_MODE){
-            errorLog << "predict_(const MatrixDouble &inputMatrix) - Pipeline Mode Is Not in CLASSIFICATION_MODE!" << endl;
+            errorLog << "predict(const MatrixView &inputMatrix) - Pipeline Mode Is Not in CLASSIFICATION_MODE!" << endl;
             return false;
         }
         
-        VectorDouble data;
+        VectorDouble &data = postProcessingVector;
         for(UINT moduleIndex=0; moduleIndex<postProcessingModules.size(); moduleIndex++){
             
             //Select which input we should give the postprocessing module
@@ -1383,13 +1564,13 @@ bool GestureRecognitionPipeline::predict(const MatrixDouble &input){
                 
                 //Verify that the input size is OK
                 if( data.size() != postProcessingModules[moduleIndex]->getNumInputDimensions() ){
-                    errorLog << "predict(const MatrixDouble &inputMatrix) - The size of the data vector (" << int(data.size()) << ") does not match that of the postProcessingModule (" << postProcessingModules[moduleIndex]->getNumInputDimensions() << ") at the moduleIndex: " << moduleIndex << endl;
+                    errorLog << "predict(const MatrixView &inputMatrix) - The size of the data vector (" << int(data.size()) << ") does not match that of the postProcessingModule (" << postProcessingModules[moduleIndex]->getNumInputDimensions() << ") at the moduleIndex: " << moduleIndex << endl;
                     return false;
                 }
                 
                 //Postprocess the data
                 if( !postProcessingModules[moduleIndex]->process( data ) ){
-                    errorLog << "predict(const MatrixDouble &inputMatrix) - Failed to post process data. PostProcessing moduleIndex: " << moduleIndex << endl;
+                    errorLog << "predict(const MatrixView &inputMatrix) - Failed to post process data. PostProcessing moduleIndex: " << moduleIndex << endl;
                     return false;
                 }
                 
@@ -1404,7 +1585,7 @@ bool GestureRecognitionPipeline::predict(const MatrixDouble &input){
                 
                 //Verify that the output size is OK
                 if( data.size() != 1 ){
-                    errorLog << "predict(const MatrixDouble &inputMatrix) - The size of the processed data vector (" << int(data.size()) << ") from postProcessingModule at the moduleIndex: " << moduleIndex << " is not equal to 1 even though it is in OutputModePredictedClassLabel!" << endl;
+                    errorLog << "predict(const MatrixView &inputMatrix) - The size of the processed data vector (" << int(data.size()) << ") from postProcessingModule at the moduleIndex: " << moduleIndex << " is not equal to 1 even though it is in OutputModePredictedClassLabel!" << endl;
                     return false;
                 }
                 
@@ -1429,7 +1610,9 @@ bool GestureRecognitionPipeline::map(const VectorDouble &inputVector){
 bool GestureRecognitionPipeline::predict_classifier(const VectorDouble &input){
     
     predictedClassLabel = 0;
-	VectorDouble inputVector = input;
+    //Use the member buffers rather than local vectors, so that once the buffers have grown to the size of the data no memory is allocated
+	VectorDouble &inputVector = predictionVector;
+    inputVector = input;
     
     //Update the context module
     predictionModuleIndex = START_OF_PIPELINE;
@@ -1501,7 +1684,7 @@ bool GestureRecognitionPipeline::predict_classifier(const VectorDouble &input){
     }
     
     //Perform the classification
-    if( !classifier->predict(inputVector) ){
+    if( !classifier->predict_(inputVector) ){
         errorLog << "predict_classifier(VectorDouble inputVector) - Prediction Failed! " << classifier->getLastErrorMessage() << endl;
         return false;
     }
@@ -1510,7 +1693,9 @@ bool GestureRecognitionPipeline::predict_classifier(const VectorDouble &input){
     //Update the context module
     if( contextModules[ AFTER_CLASSIFIER ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ AFTER_CLASSIFIER ].size(); moduleIndex++){
-            if( !contextModules[ AFTER_CLASSIFIER ][moduleIndex]->process( vector<double>(1,predictedClassLabel) ) ){
+            classLabelVector.resize(1);
+            classLabelVector[0] = predictedClassLabel;
+            if( !contextModules[ AFTER_CLASSIFIER ][moduleIndex]->process( classLabelVector ) ){
                 errorLog << "predict_classifier(VectorDouble inputVector) - Context Module Failed at AFTER_CLASSIFIER. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -1531,7 +1716,7 @@ bool GestureRecognitionPipeline::predict_classifier(const VectorDouble &input){
             return false;
         }
         
-        VectorDouble data;
+        VectorDouble &data = postProcessingVector;
         for(UINT moduleIndex=0; moduleIndex<postProcessingModules.size(); moduleIndex++){
             
             //Select which input we should give the postprocessing module
@@ -1578,7 +1763,9 @@ bool GestureRecognitionPipeline::predict_classifier(const VectorDouble &input){
     predictionModuleIndex = END_OF_PIPELINE;
     if( contextModules[ END_OF_PIPELINE ].size() ){
         for(UINT moduleIndex=0; moduleIndex<contextModules[ END_OF_PIPELINE ].size(); moduleIndex++){
-            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->process( vector<double>(1,predictedClassLabel) ) ){
+            classLabelVector.resize(1);
+            classLabelVector[0] = predictedClassLabel;
+            if( !contextModules[ END_OF_PIPELINE ][moduleIndex]->process( classLabelVector ) ){
                 errorLog << "predict_classifier(VectorDouble inputVector) - Context Module Failed at END_OF_PIPELINE. ModuleIndex: " << moduleIndex << endl;
                 return false;
             }
@@ -2484,6 +2671,10 @@ bool GestureRecognitionPipeline::getIsPipelineInRegressionMode() const{
     return pipelineMode==REGRESSION_MODE; 
 }
 
+bool GestureRecognitionPipeline::getParallelCrossValidationEnabled() const{
+    return useParallelCrossValidation;
+}
+
 UINT GestureRecognitionPipeline::getInputVectorDimensionsSize() const{ 
     
     if( getIsPreProcessingSet() ){
@@ -3229,6 +3420,11 @@ bool GestureRecognitionPipeline::setInfo(const string info){
     return true;
 }
 
+bool GestureRecognitionPipeline::enableParallelCrossValidation(const bool useParallelCrossValidation){
+    this->useParallelCrossValidation = useParallelCrossValidation;
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////  
 ///////////////////////////////////////////          PROTECTED FUNCTIONS              ///////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////// 
@@ -3434,6 +3630,24 @@ bool GestureRecognitionPipeline::computeTestMetrics(VectorDouble &precisionCount
     return true;
 }
     
+bool GestureRecognitionPipeline::trainAndTestFold(const ClassificationDataView &foldTrainingData,const ClassificationData &foldTestData){
+    
+    if( !train( foldTrainingData ) ){
+        return false;
+    }
+    
+    return test( foldTestData );
+}
+    
+bool GestureRecognitionPipeline::trainAndTestTimeSeriesFold(const TimeSeriesClassificationData &foldTrainingData,const TimeSeriesClassificationData &foldTestData){
+    
+    if( !train( foldTrainingData ) ){
+        return false;
+    }
+    
+    return test( foldTestData );
+}
+    
 string GestureRecognitionPipeline::getModelAsString() const{
     string model = "";
     
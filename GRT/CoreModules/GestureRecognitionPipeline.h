@@ -84,6 +84,17 @@ public:
 	*/
     bool train(const ClassificationData &trainingData);
 
+	/**
+     This is the training interface for training a Classifier with a view of some ClassificationData, such as a bootstrapped dataset or a cross
+     validation fold.  This works in the same way as the train(const ClassificationData &trainingData) function, but if the pipeline has no
+     PreProcessing or FeatureExtraction modules then the view is passed directly to the Classification module, so the samples are only copied
+     if the classifier needs to modify them.
+
+	@param const ClassificationDataView &trainingData: a view of the labelled classification training data that will be used to train the classifier
+	@return bool returns true if the classifier was trained successfully, false otherwise
+	*/
+    bool train(const ClassificationDataView &trainingData);
+
 	/**
      This is the main training interface for training a Classifier with ClassificationData using K-fold cross validation.  This function will pass
      the trainingData through any PreProcessing or FeatureExtraction modules that have been added to the GestureRecognitionPipeline, and then calls the 
@@ -215,6 +226,16 @@ public:
      @return bool returns true if the prediction was successful, false otherwise
      */
     bool predict(const MatrixDouble &inputMatrix);
+    
+    /**
+     This function is an interface for predictions using timeseries or Matrix data stored in a MatrixView.  The data is passed between the
+     modules in the pipeline using two buffers that are reused for every prediction, so the data is not copied to a new matrix by each module.
+     This only works for a pipeline with a classifier.
+     
+     @param const MatrixView &inputMatrix: a view of the input matrix that will be passed through the pipeline for classification
+     @return bool returns true if the prediction was successful, false otherwise
+     */
+    bool predict(const MatrixView &inputMatrix);
 
     /**
      This function is now depreciated, you should use the predict function instead.
@@ -369,6 +390,13 @@ public:
 	*/
     bool getIsPipelineInRegressionMode() const;
     
+    /**
+	 This function returns true if the folds of a k-fold cross validation training should be trained and tested in parallel.
+	
+	@return bool returns true if parallel cross validation is enabled, false otherwise.
+	*/
+    bool getParallelCrossValidationEnabled() const;
+    
     /**
 	 This function returns the size of the expected input vector to the pipeline.  This size comes from the size of the training data used to train the pipeline.
 	
@@ -1100,6 +1128,22 @@ public:
       @return returns true if the info text was updated successfully, false otherwise
      */
     bool setInfo(const string info);
+    
+    /**
+     Sets if the folds of a k-fold cross validation training should be trained and tested in parallel.  If enabled, the pipeline is deep copied
+     for each fold and the folds are run as separate tasks on a GRT ThreadPool.  The results of each fold are merged in fold order, so the
+     cross validation results do not depend on the order in which the folds finish.  After training the pipeline holds the model and test
+     results of the last fold, as it does when the folds are run one at a time.
+     
+     All the modules in the pipeline must be safe to train in separate copies at the same time.  Each fold starts from a copy of the pipeline
+     as it was before training, so a module that uses a random seed will see the same seed in each fold.  The parallel training of the classifier
+     (see MLBase::enableParallelTraining) is disabled in each fold, so the folds do not each start their own threads, and the setting is restored
+     once the folds have finished.  This is disabled by default.
+     
+     @param const bool useParallelCrossValidation: sets if parallel cross validation should be used
+     @return returns true if the parameter was set correctly, false otherwise
+     */
+    bool enableParallelCrossValidation(const bool useParallelCrossValidation);
 
 protected:
     bool predict_classifier(const VectorDouble &inputVector);
@@ -1114,6 +1158,8 @@ protected:
     void deleteAllContextModules();
     bool updateTestMetrics(const UINT classLabel,const UINT predictedClassLabel,VectorDouble &precisionCounter,VectorDouble &recallCounter,double &rejectionPrecisionCounter,double &rejectionRecallCounter,VectorDouble &confusionMatrixCounter);
     bool computeTestMetrics(VectorDouble &precisionCounter,VectorDouble &recallCounter,double &rejectionPrecisionCounter,double &rejectionRecallCounter,VectorDouble &confusionMatrixCounter,const UINT numTestSamples);
+    bool trainAndTestFold(const ClassificationDataView &foldTrainingData,const ClassificationData &foldTestData);
+    bool trainAndTestTimeSeriesFold(const TimeSeriesClassificationData &foldTrainingData,const TimeSeriesClassificationData &foldTestData);
     
     bool initialized;
     bool trained;
@@ -1138,8 +1184,14 @@ protected:
     double testRejectionPrecision;
     double testRejectionRecall;
     MatrixDouble testConfusionMatrix;
+    MatrixDouble predictionBuffers[2];
+    VectorDouble predictionVector;          ///< Buffer used by predict_classifier for the data that flows through the pipeline, reused so prediction does not allocate
+    VectorDouble postProcessingVector;      ///< Buffer used by the prediction functions for the input to the post processing modules
+    VectorDouble classLabelVector;          ///< Buffer used by predict_classifier to pass the predicted class label to the context modules
     vector< TestResult > crossValidationResults;
     vector< TestInstanceResult > testResults;
+    bool useParallelCrossValidation;
+    std::unique_ptr< ThreadPool > threadPool;   ///< The thread pool used to run the cross validation folds in parallel, this is only created when it is first needed
     
     vector< PreProcessing* > preProcessingModules;
     vector< FeatureExtraction* > featureExtractionModules;
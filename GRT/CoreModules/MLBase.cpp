@@ -80,6 +80,13 @@ bool MLBase::copyMLBaseVariables(const MLBase *mlBase){
 bool MLBase::train(ClassificationData trainingData){ return train_( trainingData ); }
 
 bool MLBase::train_(ClassificationData &trainingData){ return false; }
+
+bool MLBase::train(ClassificationDataView trainingData){ return train_( trainingData ); }
+
+bool MLBase::train_(ClassificationDataView &trainingData){
+    ClassificationData data = trainingData.getDataset();
+    return train_( data );
+}
     
 bool MLBase::train(RegressionData trainingData){ return train_( trainingData ); }
     
@@ -109,6 +116,16 @@ bool MLBase::predict(MatrixDouble inputMatrix){ return predict_( inputMatrix );
     
 bool MLBase::predict_(MatrixDouble &inputMatrix){ return false; }
 
+bool MLBase::predict(MatrixView inputMatrix){ return predict_( inputMatrix ); }
+
+bool MLBase::predict_(MatrixView &inputMatrix){
+    if( !inputMatrix.copyTo( viewInputMatrix ) ){
+        errorLog << "predict_(MatrixView &inputMatrix) - Failed to copy the input matrix!" << endl;
+        return false;
+    }
+    return predict_( viewInputMatrix );
+}
+
 bool MLBase::map(VectorDouble inputVector){ return map_( inputVector ); }
 
 bool MLBase::map_(VectorDouble &inputVector){ return false; }
@@ -126,6 +143,14 @@ bool MLBase::clear(){
     return true;
 }
 
+bool MLBase::enableParallelTraining(const bool useParallelTraining){ return false; }
+
+bool MLBase::getParallelTrainingEnabled() const{ return false; }
+
+bool MLBase::enableParallelPrediction(const bool useParallelPrediction){ return false; }
+
+bool MLBase::getParallelPredictionEnabled() const{ return false; }
+
 bool MLBase::print() const { cout << getModelAsString(); return true; }
     
 bool MLBase::save(const string filename) const {
@@ -34,6 +34,7 @@
 #include "GRTBase.h"
 #include "../DataStructures/UnlabelledData.h"
 #include "../DataStructures/ClassificationData.h"
+#include "../DataStructures/ClassificationDataView.h"
 #include "../DataStructures/RegressionData.h"
 #include "../DataStructures/TimeSeriesClassificationData.h"
 #include "../DataStructures/TimeSeriesClassificationDataStream.h"
@@ -104,6 +105,24 @@ public:
      @return returns true if the classifier was successfully trained, false otherwise
      */
     virtual bool train_(ClassificationData &trainingData);
+
+    /**
+     This is the main training interface for a ClassificationDataView.
+     By default it will call the train_ function, unless it is overwritten by the derived class.
+
+     @param ClassificationDataView trainingData: a view of the training data that will be used to train the ML model
+     @return returns true if the classifier was successfully trained, false otherwise
+     */
+    virtual bool train(ClassificationDataView trainingData);
+
+    /**
+     This is the training interface for a referenced ClassificationDataView.  By default this copies the samples in the view to a new
+     ClassificationData and trains the model with the copy, derived classes that can train directly from the view should overwrite it.
+
+     @param ClassificationDataView &trainingData: a reference to a view of the training data that will be used to train the ML model
+     @return returns true if the classifier was successfully trained, false otherwise
+     */
+    virtual bool train_(ClassificationDataView &trainingData);
     
     /**
      This is the main training interface for regression data.
@@ -224,6 +243,25 @@ public:
      */
     virtual bool predict_(MatrixDouble &inputMatrix);
     
+    /**
+     This is the prediction interface for time series data stored in a MatrixView, which does not copy the data.
+     By defaut it will call the predict_ function, unless it is overwritten by the derived class.
+     
+     @param MatrixView inputMatrix: a view of the new input matrix for prediction
+     @return returns true if the prediction was completed succesfully, false otherwise (the base class always returns false)
+     */
+    virtual bool predict(MatrixView inputMatrix);
+    
+    /**
+     This is the prediction interface for time series data stored in a MatrixView.  By default the view is copied to a matrix that is reused
+     for every prediction, which is then passed to the MatrixDouble predict_ function.  The derived class can overwrite this function to use
+     the view directly.
+     
+     @param MatrixView &inputMatrix: a reference to a view of the new input matrix for prediction
+     @return returns true if the prediction was completed succesfully, false otherwise
+     */
+    virtual bool predict_(MatrixView &inputMatrix);
+    
     /**
      This is the main mapping interface for all the GRT machine learning algorithms.
      By defaut it will call the map_ function, unless it is overwritten by the derived class.
@@ -258,6 +296,40 @@ public:
      */
     virtual bool clear();
     
+    /**
+     This is the main interface to set if the GRT machine learning algorithms should be trained in parallel on a GRT ThreadPool.  This should be
+     overwritten by the derived class if it supports parallel training.  Modules that run several trainings at the same time, such as the parallel
+     cross validation in the GestureRecognitionPipeline, use this to stop each training from starting its own parallel tasks.
+     
+     @param const bool useParallelTraining: sets if parallel training should be used
+     @return returns true if the parameter was set correctly, false otherwise (the base class always returns false)
+     */
+    virtual bool enableParallelTraining(const bool useParallelTraining);
+    
+    /**
+     Gets if the model should be trained in parallel.  This should be overwritten by the derived class if it supports parallel training.
+     
+     @return returns true if parallel training is enabled, false otherwise (the base class always returns false)
+     */
+    virtual bool getParallelTrainingEnabled() const;
+    
+    /**
+     This is the main interface to set if the GRT machine learning algorithms should compute their predictions in parallel on a GRT ThreadPool.
+     This should be overwritten by the derived class if it supports parallel prediction.  Modules that evaluate several models at the same time,
+     such as the parallel GridSearch, use this to stop each prediction from starting its own parallel tasks.
+     
+     @param const bool useParallelPrediction: sets if parallel prediction should be used
+     @return returns true if the parameter was set correctly, false otherwise (the base class always returns false)
+     */
+    virtual bool enableParallelPrediction(const bool useParallelPrediction);
+    
+    /**
+     Gets if the model should compute its predictions in parallel.  This should be overwritten by the derived class if it supports parallel prediction.
+     
+     @return returns true if parallel prediction is enabled, false otherwise (the base class always returns false)
+     */
+    virtual bool getParallelPredictionEnabled() const;
+    
     /**
      This is the main print interface for all the GRT machine learning algorithms. This should be overwritten by the derived class.
      It will print the model and settings to the display log.
@@ -676,6 +748,7 @@ protected:
     bool trained;
     bool useScaling;
     UINT baseType;
+    MatrixDouble viewInputMatrix;
     UINT numInputDimensions;
     UINT numOutputDimensions;
     UINT numTrainingIterationsToConverge;
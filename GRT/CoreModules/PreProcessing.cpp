@@ -204,7 +204,12 @@ bool PreProcessing::getInitialized() const{
     return initialized; 
 }
     
-VectorDouble PreProcessing::getProcessedData() const{ 
+bool PreProcessing::process(const RowSpan &inputVector){
+    inputVector.copyTo( spanInputVector );
+    return process( spanInputVector );
+}
+
+const VectorDouble& PreProcessing::getProcessedData() const{ 
     return processedData; 
 }
 
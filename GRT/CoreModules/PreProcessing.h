@@ -72,6 +72,16 @@ public:
      */
     virtual bool process(const VectorDouble &inputVector){ return false; }
     
+    /**
+     This function is called by the GestureRecognitionPipeline to process a row of a matrix without copying the row to a new vector.
+     By default the row is copied to a vector that is reused for every call, which is then passed to the VectorDouble process function.
+     The derived class can overwrite this function to use the span directly.
+     
+     @param const RowSpan &inputVector: a span of the input vector that should be processed
+     @return returns true if the data was processed, false otherwise
+     */
+    virtual bool process(const RowSpan &inputVector);
+    
     /**
      This is the main reset interface for all the GRT preprocessing modules. This should be overwritten by the derived class.
      
@@ -152,7 +162,7 @@ public:
     /**
      @return returns a VectorDouble containing the most recent processed data
      */
-	VectorDouble getProcessedData() const;
+	const VectorDouble& getProcessedData() const;
     
     /**
      This typedef defines a map between a string and a PreProcessing pointer.
@@ -198,6 +208,7 @@ protected:
     string preProcessingType;
     bool initialized;
     VectorDouble processedData;
+    VectorDouble spanInputVector;
 
 	static StringPreProcessingMap *getMap() {
         if( !stringPreProcessingMap ){ stringPreProcessingMap = new StringPreProcessingMap; } 
@@ -30,6 +30,8 @@ ClassificationData::ClassificationData(const UINT numDimensions,const string dat
     crossValidationSetup = false;
     useExternalRanges = false;
     allowNullGestureClass = true;
+    columnStride = 0;
+    columnOffset = 0;
     if( numDimensions > 0 ) setNumDimensions( numDimensions );
     infoLog.setProceedingText("[ClassificationData]");
     debugLog.setProceedingText("[DEBUG ClassificationData]");
@@ -38,6 +40,8 @@ ClassificationData::ClassificationData(const UINT numDimensions,const string dat
 }
 
 ClassificationData::ClassificationData(const ClassificationData &rhs){
+    columnStride = 0;
+    columnOffset = 0;
     *this = rhs;
 }
 
@@ -62,6 +66,9 @@ ClassificationData& ClassificationData::operator=(const ClassificationData &rhs)
         this->debugLog = rhs.debugLog;
         this->errorLog = rhs.errorLog;
         this->warningLog = rhs.warningLog;
+
+        //The columns are only kept for the duration of a training call, so they are not copied
+        clearColumnStorage();
     }
     return *this;
 }
@@ -72,6 +79,7 @@ void ClassificationData::clear(){
 	classTracker.clear();
     crossValidationSetup = false;
     crossValidationIndexs.clear();
+    clearColumnStorage();
 }
 
 bool ClassificationData::setNumDimensions(const UINT numDimensions){
@@ -129,6 +137,41 @@ bool ClassificationData::setAllowNullGestureClass(const bool allowNullGestureCla
     return true;
 }
 
+bool ClassificationData::buildColumnStorage(){
+
+    //Round the stride up to a multiple of 8 values, so every column starts on a 64 byte boundary
+    columnStride = ((totalNumSamples+7)/8)*8;
+
+    //Allocate 8 extra values so the first column can be moved to a 64 byte boundary
+    columnData.clear();
+    columnData.resize( columnStride*numDimensions + 8, 0 );
+    columnClassLabels.clear();
+    columnClassLabels.resize( columnStride, 0 );
+
+    const size_t address = (size_t)&columnData[0];
+    columnOffset = (UINT)( ((64 - address % 64) % 64) / sizeof(double) );
+
+    for(UINT i=0; i<totalNumSamples; i++){
+        columnClassLabels[i] = data[i].getClassLabel();
+        for(UINT j=0; j<numDimensions; j++){
+            columnData[ columnOffset + j*columnStride + i ] = data[i][j];
+        }
+    }
+
+    return true;
+}
+
+bool ClassificationData::clearColumnStorage(){
+
+    //Free the memory used by the columns
+    columnStride = 0;
+    columnOffset = 0;
+    VectorDouble().swap( columnData );
+    vector< UINT >().swap( columnClassLabels );
+
+    return true;
+}
+
 bool ClassificationData::addSample(const UINT classLabel,const VectorDouble &sample){
     
 	if( sample.size() != numDimensions ){
@@ -150,6 +193,9 @@ bool ClassificationData::addSample(const UINT classLabel,const VectorDouble &sam
 	data.push_back( newSample );
 	totalNumSamples++;
 
+    //The columns no longer match the samples, so free them rather than keeping a second copy of the data in sync
+    if( getColumnStorageBuilt() ) clearColumnStorage();
+
 	if( classTracker.size() == 0 ){
 		ClassTracker tracker(classLabel,1);
 		classTracker.push_back(tracker);
@@ -205,6 +251,8 @@ bool ClassificationData::removeSample( const UINT index ){
             break;
         }
     }
+
+    if( getColumnStorageBuilt() ) clearColumnStorage();
     
     return true;
 }
@@ -281,6 +329,8 @@ UINT ClassificationData::removeClass(const UINT classLabel){
     }
     
     totalNumSamples = (UINT)data.size();
+
+    if( getColumnStorageBuilt() ) clearColumnStorage();
     
     return numExamplesRemoved;
 }
@@ -315,6 +365,8 @@ bool ClassificationData::relabelAllSamplesWithClassLabel(const UINT oldClassLabe
         }
     }
 
+    if( getColumnStorageBuilt() ) clearColumnStorage();
+
     //Update the class tracler
     if( newClassLabelAllReadyExists ){
         //Add the old sample count to the new sample count
@@ -366,6 +418,8 @@ bool ClassificationData::scale(const vector<MinMax> &ranges,const double minTarg
         }
     }
 
+    if( getColumnStorageBuilt() ) clearColumnStorage();
+
     return true;
 }
     
@@ -567,6 +621,8 @@ bool ClassificationData::loadDatasetFromFile(const string &filename){
 	
     //Sort the class labels
     sortClassLabels();
+
+    if( getColumnStorageBuilt() ) clearColumnStorage();
 	
 	return true;
 }
@@ -672,6 +728,8 @@ bool ClassificationData::loadDatasetFromCSVFile(const string &filename,const UIN
 
     //Sort the class labels
     sortClassLabels();
+
+    if( getColumnStorageBuilt() ) clearColumnStorage();
     
     return true;
 }
@@ -942,20 +1000,15 @@ ClassificationData ClassificationData::getTrainingFoldData(const UINT foldIndex)
     if( foldIndex >= kFoldValue ) return trainingData;
 
     //Add the class labels to make sure they all exist
-    for(UINT k=0; k<getNumSamples(); k++){
+    for(UINT k=0; k<getNumClasses(); k++){
         trainingData.addClass( classTracker[k].classLabel, classTracker[k].className );
     }
 
     //Add the data to the training set, this will consist of all the data that is NOT in the foldIndex
-    UINT index = 0;
-    for(UINT k=0; k<kFoldValue; k++){
-        if( k != foldIndex ){
-            for(UINT i=0; i<crossValidationIndexs[k].size(); i++){
-
-                index = crossValidationIndexs[k][i];
-                trainingData.addSample( data[ index ].getClassLabel(), data[ index ].getSample() );
-            }
-        }
+    const vector< UINT > indexes = getTrainingFoldIndexes( foldIndex );
+    trainingData.reserve( (UINT)indexes.size() );
+    for(UINT i=0; i<indexes.size(); i++){
+        trainingData.addSample( data[ indexes[i] ].getClassLabel(), data[ indexes[i] ].getSample() );
     }
 
     //Sort the class labels
@@ -975,18 +1028,15 @@ ClassificationData ClassificationData::getTestFoldData(const UINT foldIndex) con
     if( foldIndex >= kFoldValue ) return testData;
 
     //Add the class labels to make sure they all exist
-    for(UINT k=0; k<getNumSamples(); k++){
+    for(UINT k=0; k<getNumClasses(); k++){
         testData.addClass( classTracker[k].classLabel, classTracker[k].className );
     }
-    
-    testData.reserve( (UINT)crossValidationIndexs[ foldIndex ].size() );
 
     //Add the data to the test fold
-    UINT index = 0;
-	for(UINT i=0; i<crossValidationIndexs[ foldIndex ].size(); i++){
-
-        index = crossValidationIndexs[ foldIndex ][i];
-		testData.addSample( data[ index ].getClassLabel(), data[ index ].getSample() );
+    const vector< UINT > indexes = getTestFoldIndexes( foldIndex );
+    testData.reserve( (UINT)indexes.size() );
+	for(UINT i=0; i<indexes.size(); i++){
+		testData.addSample( data[ indexes[i] ].getClassLabel(), data[ indexes[i] ].getSample() );
 	}
 	
     //Sort the class labels
@@ -995,6 +1045,35 @@ ClassificationData ClassificationData::getTestFoldData(const UINT foldIndex) con
     return testData;
 }
 
+vector< UINT > ClassificationData::getTrainingFoldIndexes(const UINT foldIndex) const{
+
+    vector< UINT > indexes;
+
+    if( !crossValidationSetup ){
+        errorLog << "getTrainingFoldIndexes(const UINT foldIndex) - Cross Validation has not been setup! You need to call the spiltDataIntoKFolds(UINT K,bool useStratifiedSampling) function first before calling this function!" << endl;
+        return indexes;
+    }
+
+    if( foldIndex >= kFoldValue ) return indexes;
+
+    //The training fold consists of all the data that is NOT in the foldIndex
+    indexes.reserve( totalNumSamples - crossValidationIndexs[ foldIndex ].size() );
+    for(UINT k=0; k<kFoldValue; k++){
+        if( k != foldIndex ){
+            indexes.insert( indexes.end(), crossValidationIndexs[k].begin(), crossValidationIndexs[k].end() );
+        }
+    }
+
+    return indexes;
+}
+
+vector< UINT > ClassificationData::getTestFoldIndexes(const UINT foldIndex) const{
+
+    if( !crossValidationSetup || foldIndex >= kFoldValue ) return vector< UINT >();
+
+    return crossValidationIndexs[ foldIndex ];
+}
+
 ClassificationData ClassificationData::getClassData(const UINT classLabel) const{
     
     ClassificationData classData;
@@ -1020,7 +1099,6 @@ ClassificationData ClassificationData::getClassData(const UINT classLabel) const
     
 ClassificationData ClassificationData::getBootstrappedDataset(UINT numSamples,bool balanceDataset) const{
     
-    Random rand;
     ClassificationData newDataset;
     newDataset.setNumDimensions( getNumDimensions() );
     newDataset.setAllowNullGestureClass( allowNullGestureClass );
@@ -1037,6 +1115,31 @@ ClassificationData ClassificationData::getBootstrappedDataset(UINT numSamples,bo
         newDataset.addClass( classTracker[k].classLabel );
     }
 
+    //Add the randomly selected samples to the new dataset
+    const vector< UINT > indexes = getBootstrappedIndexes( numSamples, balanceDataset );
+    for(UINT i=0; i<indexes.size(); i++){
+        newDataset.addSample( data[ indexes[i] ].getClassLabel(), data[ indexes[i] ].getSample() );
+    }
+
+    //Sort the class labels so they are in order
+    newDataset.sortClassLabels();
+    
+    return newDataset;
+}
+
+vector< UINT > ClassificationData::getBootstrappedIndexes(UINT numSamples,bool balanceDataset) const{
+    Random rand;
+    return getBootstrappedIndexes( rand, numSamples, balanceDataset );
+}
+
+vector< UINT > ClassificationData::getBootstrappedIndexes(Random &rand,UINT numSamples,bool balanceDataset) const{
+
+    const UINT K = getNumClasses();
+
+    if( numSamples == 0 ) numSamples = totalNumSamples;
+
+    vector< UINT > indexes( numSamples );
+
     if( balanceDataset ){
         //Group the class indexs
         std::vector< std::vector< UINT > > classIndexs( K );
@@ -1053,8 +1156,7 @@ ClassificationData ClassificationData::getBootstrappedDataset(UINT numSamples,bo
         UINT randomIndex = 0;
         for(UINT i=0; i<numSamples; i++){
             randomIndex = rand.getRandomNumberInt(0, (UINT)classIndexs[ classIndex ].size() );
-            randomIndex = classIndexs[ classIndex ][ randomIndex ];
-            newDataset.addSample(data[ randomIndex ].getClassLabel(), data[ randomIndex ].getSample());
+            indexes[i] = classIndexs[ classIndex ][ randomIndex ];
             if( classCounter++ >= numSamplesPerClass && classIndex+1 < K ){
                 classCounter = 0;
                 classIndex++;
@@ -1062,18 +1164,13 @@ ClassificationData ClassificationData::getBootstrappedDataset(UINT numSamples,bo
         }
 
     }else{
-        //Randomly select the training samples to add to the new data set
-        UINT randomIndex;
+        //Randomly select the training samples
         for(UINT i=0; i<numSamples; i++){
-            randomIndex = rand.getRandomNumberInt(0, totalNumSamples);
-            newDataset.addSample( data[randomIndex].getClassLabel(), data[randomIndex].getSample() );
+            indexes[i] = rand.getRandomNumberInt(0, totalNumSamples);
         }
     }
 
-    //Sort the class labels so they are in order
-    newDataset.sortClassLabels();
-    
-    return newDataset;
+    return indexes;
 }
 
 RegressionData ClassificationData::reformatAsRegressionData() const{
@@ -1207,7 +1304,19 @@ vector<MinMax> ClassificationData::getRanges() const{
 	vector< MinMax > ranges(numDimensions);
 
     //Otherwise return the min and max values for each column in the dataset
-    if( totalNumSamples > 0 ){
+    if( totalNumSamples > 0 && getColumnStorageBuilt() ){
+        for(UINT j=0; j<numDimensions; j++){
+            const double *x = getColumn(j);
+            double minValue = x[0];
+            double maxValue = x[0];
+            for(UINT i=0; i<totalNumSamples; i++){
+                if( x[i] < minValue ) minValue = x[i];
+                if( x[i] > maxValue ) maxValue = x[i];
+            }
+            ranges[j].minValue = minValue;
+            ranges[j].maxValue = maxValue;
+        }
+    }else if( totalNumSamples > 0 ){
         for(UINT j=0; j<numDimensions; j++){
             ranges[j].minValue = data[0][j];
             ranges[j].maxValue = data[0][j];
@@ -1247,6 +1356,18 @@ vector< UINT > ClassificationData::getNumSamplesPerClass() const{
 VectorDouble ClassificationData::getMean() const{
 	
 	VectorDouble mean(numDimensions,0);
+
+    if( getColumnStorageBuilt() ){
+        for(UINT j=0; j<numDimensions; j++){
+            const double *x = getColumn(j);
+            double sum = 0;
+            for(UINT i=0; i<totalNumSamples; i++){
+                sum += x[i];
+            }
+            mean[j] = sum / double(totalNumSamples);
+        }
+        return mean;
+    }
 	
 	for(UINT j=0; j<numDimensions; j++){
 		for(UINT i=0; i<totalNumSamples; i++){
@@ -1262,6 +1383,18 @@ VectorDouble ClassificationData::getStdDev() const{
 	
 	VectorDouble mean = getMean();
 	VectorDouble stdDev(numDimensions,0);
+
+    if( getColumnStorageBuilt() ){
+        for(UINT j=0; j<numDimensions; j++){
+            const double *x = getColumn(j);
+            double sum = 0;
+            for(UINT i=0; i<totalNumSamples; i++){
+                sum += SQR(x[i]-mean[j]);
+            }
+            stdDev[j] = sqrt( sum / double(totalNumSamples-1) );
+        }
+        return stdDev;
+    }
 	
 	for(UINT j=0; j<numDimensions; j++){
 		for(UINT i=0; i<totalNumSamples; i++){
@@ -1372,6 +1505,23 @@ MatrixDouble ClassificationData::getCovarianceMatrix() const{
 	
 	VectorDouble mean = getMean();
 	MatrixDouble covariance(numDimensions,numDimensions);
+
+    if( getColumnStorageBuilt() ){
+        for(UINT j=0; j<numDimensions; j++){
+            const double *x = getColumn(j);
+            for(UINT k=0; k<numDimensions; k++){
+                const double *y = getColumn(k);
+                double sum = 0;
+                for(UINT i=0; i<totalNumSamples; i++){
+                    sum += (x[i]-mean[j]) * (y[i]-mean[k]);
+                }
+                covariance[j][k] = sum / double(totalNumSamples-1);
+            }
+        }
+        return covariance;
+    }
+
+    covariance.setAllValues(0);
 	
 	for(UINT j=0; j<numDimensions; j++){
 		for(UINT k=0; k<numDimensions; k++){
@@ -1450,6 +1600,16 @@ vector< UINT > ClassificationData::getClassDataIndexes(UINT classLabel) const{
     return classIndexes;
 }
 
+const double* ClassificationData::getColumn(const UINT dimension) const{
+    if( dimension >= numDimensions || columnData.size() == 0 ) return NULL;
+    return &columnData[ columnOffset + dimension*columnStride ];
+}
+
+const UINT* ClassificationData::getClassLabelColumn() const{
+    if( columnClassLabels.size() == 0 ) return NULL;
+    return &columnClassLabels[0];
+}
+
 MatrixDouble ClassificationData::getDataAsMatrixDouble() const{
 
     const UINT M = getNumSamples();
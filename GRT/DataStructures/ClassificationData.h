@@ -75,6 +75,9 @@ public:
      Array Subscript Operator, returns the ClassificationSample at index i.  
      It is up to the user to ensure that i is within the range of [0 totalNumSamples-1]
 
+     If the columns have been built and the sample is modified through this reference, then buildColumnStorage() must be called before
+     the columns are used again.
+
      @param const UINT &i: the index of the training sample you want to access.  Must be within the range of [0 totalNumSamples-1]
      @return a reference to the i'th ClassificationSample
     */
@@ -147,6 +150,27 @@ public:
      */
     bool setAllowNullGestureClass(bool allowNullGestureClass);
 
+    /**
+     Builds a column-major copy of the data, with all the values of each dimension stored in one contiguous 64 byte aligned array and the
+     class labels stored in a separate array.  While the columns exist, functions such as getRanges, getMean and getCovarianceMatrix will
+     stream over the columns instead of the samples.
+
+     The columns are a second copy of the data, so they are meant to be built at the start of a training call and freed with
+     clearColumnStorage() when the training call ends.  Any function that modifies the dataset (addSample, removeSample, scale, etc.)
+     frees the columns, and they are not copied by the assignment operator.  If the samples are modified through the [] operator, then
+     the columns must be built again before they are used.
+
+     @return returns true if the columns were built, false otherwise
+     */
+    bool buildColumnStorage();
+
+    /**
+     Frees the memory used by the column-major copy of the data, see buildColumnStorage().
+
+     @return returns true if the columns were freed, false otherwise
+     */
+    bool clearColumnStorage();
+
     /**
      Adds a new labelled sample to the dataset.  
      The dimensionality of the sample should match the number of dimensions in the ClassificationData.
@@ -391,6 +415,45 @@ public:
      @return returns a bootstrapped ClassificationData
      */
     ClassificationData getBootstrappedDataset(UINT numSamples=0, bool balanceDataset=false ) const;
+
+    /**
+     Gets the indexes of the samples in a training fold, without copying the samples.  The indexes can be used to create a
+     ClassificationDataView of the training fold.  You should call the spiltDataIntoKFolds(UINT K) function first before calling this function.
+
+     @param const UINT foldIndex: the index of the fold you want the training indexes for, this should be in the range [0 K-1]
+     @return returns the indexes of the samples in the training fold, or an empty vector if the folds have not been setup
+     */
+    vector< UINT > getTrainingFoldIndexes(const UINT foldIndex) const;
+
+    /**
+     Gets the indexes of the samples in a test fold, without copying the samples.  The indexes can be used to create a
+     ClassificationDataView of the test fold.  You should call the spiltDataIntoKFolds(UINT K) function first before calling this function.
+
+     @param const UINT foldIndex: the index of the fold you want the test indexes for, this should be in the range [0 K-1]
+     @return returns the indexes of the samples in the test fold, or an empty vector if the folds have not been setup
+     */
+    vector< UINT > getTestFoldIndexes(const UINT foldIndex) const;
+
+    /**
+     Gets the indexes of a bootstrapped dataset, without copying the samples.  The samples are selected in the same way as
+     getBootstrappedDataset, and the indexes can be used to create a ClassificationDataView of the bootstrapped dataset.
+
+     @param UINT numSamples: the size of the bootstrapped dataset, if zero then the size will match the size of the current dataset
+     @param bool balanceDataset: if true will use stratified sampling to balance the dataset returned, otherwise will use random sampling
+     @return returns the indexes of the samples in the bootstrapped dataset, an index can appear more than once
+     */
+    vector< UINT > getBootstrappedIndexes(UINT numSamples=0, bool balanceDataset=false ) const;
+
+    /**
+     Gets the indexes of a bootstrapped dataset, using the random number generator to select the samples.  This can be used to get
+     the same bootstrapped dataset each time, by setting the seed of the random number generator first.
+
+     @param Random &rand: the random number generator that will be used to select the samples
+     @param UINT numSamples: the size of the bootstrapped dataset, if zero then the size will match the size of the current dataset
+     @param bool balanceDataset: if true will use stratified sampling to balance the dataset returned, otherwise will use random sampling
+     @return returns the indexes of the samples in the bootstrapped dataset, an index can appear more than once
+     */
+    vector< UINT > getBootstrappedIndexes(Random &rand, UINT numSamples=0, bool balanceDataset=false ) const;
     
 	/**
      Reformats the ClassificationData as LabelledRegressionData to enable regression algorithms like the MLP to be used as a classifier.
@@ -415,6 +478,27 @@ public:
      @return returns the name of the dataset
     */
     string getDatasetName() const{ return datasetName; }
+
+    /**
+     Gets if the user can add samples to the dataset with the label matching the GRT_DEFAULT_NULL_CLASS_LABEL.
+
+     @return returns true if samples with the null class label can be added, false otherwise
+    */
+    bool getAllowNullGestureClass() const{ return allowNullGestureClass; }
+
+    /**
+     Gets if the dataset should be scaled using the external ranges.
+
+     @return returns true if the external ranges should be used, false otherwise
+    */
+    bool getUseExternalRanges() const{ return useExternalRanges; }
+
+    /**
+     Gets the external ranges set by the user.
+
+     @return returns a vector of MinMax values with the external ranges, this will be empty if the external ranges have not been set
+    */
+    vector< MinMax > getExternalRanges() const{ return externalRanges; }
     
     /**
      Gets the infotext for the dataset
@@ -588,6 +672,30 @@ public:
      @return a MatrixDouble containing the data from the current dataset.
     */
     MatrixDouble getDataAsMatrixDouble() const;
+
+    /**
+     Gets if the column-major copy of the data has been built, see buildColumnStorage().
+
+     @return returns true if the columns have been built, false otherwise
+     */
+    bool getColumnStorageBuilt() const{ return columnData.size() > 0; }
+
+    /**
+     Gets a pointer to all the values of one dimension of the dataset.  The value of sample i is stored at index i, so the pointer can
+     be used to read the values for i in the range [0 totalNumSamples-1].  The pointer is only valid until the dataset is next modified.
+
+     @param const UINT dimension: the dimension you want the values for, this should be in the range [0 numDimensions-1]
+     @return returns a pointer to the values of the dimension, or NULL if the columns have not been built or the dimension is not valid
+     */
+    const double* getColumn(const UINT dimension) const;
+
+    /**
+     Gets a pointer to the class labels of all the samples in the dataset, the class label of sample i is stored at index i.  The pointer
+     is only valid until the dataset is next modified.
+
+     @return returns a pointer to the class labels, or NULL if the columns have not been built
+     */
+    const UINT* getClassLabelColumn() const;
     
     /**
      Generates a labeled dataset that can be used for basic training/testing/validation for ClassificationData.
@@ -609,7 +717,6 @@ public:
     static bool generateGaussDataset( const std::string filename, const UINT numSamples = 10000, const UINT numClasses = 10, const UINT numDimensions = 3, const double range = 10, const double sigma = 1 );
 
 private:
-    
     string datasetName;                                     ///< The name of the dataset
     string infoText;                                        ///< Some infoText about the dataset
 	UINT numDimensions;										///< The number of dimensions in the dataset
@@ -622,6 +729,10 @@ private:
 	vector< ClassTracker > classTracker;					///< A vector of ClassTracker, which keeps track of the number of samples of each class
 	vector< ClassificationSample > data;                    ///< The labelled classification data
     vector< vector< UINT > >    crossValidationIndexs;      ///< A vector to hold the indexs of the dataset for the cross validation    
+    UINT columnStride;                                      ///< The number of values between the start of each column, this is the number of samples rounded up to a multiple of 8
+    UINT columnOffset;                                      ///< The index in the columnData buffer of the first value of the first column, this aligns the columns to 64 bytes
+    VectorDouble columnData;                                ///< A buffer holding the column-major copy of the data, the j'th dimension of sample i is at columnOffset + j*columnStride + i
+    vector< UINT > columnClassLabels;                       ///< The class label of each sample, stored next to the columns
 };
 
 } //End of namespace GRT
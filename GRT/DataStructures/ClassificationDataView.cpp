@@ -0,0 +1,188 @@
+/*
+GRT MIT License
+Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ClassificationDataView.h"
+
+namespace GRT{
+
+ClassificationDataView::ClassificationDataView(){
+    data = NULL;
+    numDimensions = 0;
+}
+
+ClassificationDataView::ClassificationDataView(const ClassificationData &data){
+    this->data = &data;
+    this->numDimensions = data.getNumDimensions();
+    this->indexes.resize( data.getNumSamples() );
+    for(UINT i=0; i<data.getNumSamples(); i++){
+        this->indexes[i] = i;
+    }
+    this->classTracker = data.getClassTracker();
+}
+
+ClassificationDataView::ClassificationDataView(const ClassificationData &data,const vector< UINT > &indexes){
+    this->data = &data;
+    this->numDimensions = data.getNumDimensions();
+    this->indexes = indexes;
+    updateClassTracker();
+}
+
+ClassificationDataView::~ClassificationDataView(){
+}
+
+void ClassificationDataView::clear(){
+    indexes.clear();
+    for(UINT k=0; k<classTracker.size(); k++){
+        classTracker[k].counter = 0;
+    }
+}
+
+vector< UINT > ClassificationDataView::getClassLabels() const{
+    vector< UINT > classLabels( classTracker.size() );
+    for(UINT k=0; k<classTracker.size(); k++){
+        classLabels[k] = classTracker[k].classLabel;
+    }
+    return classLabels;
+}
+
+vector< UINT > ClassificationDataView::getNumSamplesPerClass() const{
+    vector< UINT > classSampleCounts( classTracker.size() );
+    for(UINT k=0; k<classTracker.size(); k++){
+        classSampleCounts[k] = classTracker[k].counter;
+    }
+    return classSampleCounts;
+}
+
+vector< MinMax > ClassificationDataView::getRanges() const{
+
+    const UINT M = getNumSamples();
+    vector< MinMax > ranges( numDimensions );
+
+    if( data == NULL ) return ranges;
+
+    //If the parent dataset should be scaled using the external ranges then return the external ranges
+    if( data->getUseExternalRanges() ) return data->getExternalRanges();
+
+    if( M == 0 ) return ranges;
+
+    for(UINT j=0; j<numDimensions; j++){
+        //Read the values from the column if the columns of the parent have been built, otherwise from the samples
+        const double *x = data->getColumn( j );
+        double value = x != NULL ? x[ indexes[0] ] : (*data)[ indexes[0] ][j];
+        ranges[j].minValue = value;
+        ranges[j].maxValue = value;
+        for(UINT i=0; i<M; i++){
+            value = x != NULL ? x[ indexes[i] ] : (*data)[ indexes[i] ][j];
+            if( value < ranges[j].minValue ) ranges[j].minValue = value;
+            if( value > ranges[j].maxValue ) ranges[j].maxValue = value;
+        }
+    }
+
+    return ranges;
+}
+
+VectorDouble ClassificationDataView::getMean() const{
+
+    const UINT M = getNumSamples();
+    VectorDouble mean( numDimensions, 0 );
+
+    if( data == NULL ) return mean;
+
+    for(UINT j=0; j<numDimensions; j++){
+        const double *x = data->getColumn( j );
+        for(UINT i=0; i<M; i++){
+            mean[j] += x != NULL ? x[ indexes[i] ] : (*data)[ indexes[i] ][j];
+        }
+        mean[j] /= double(M);
+    }
+
+    return mean;
+}
+
+VectorDouble ClassificationDataView::getClassProbabilities( const vector< UINT > &classLabels ) const{
+    const UINT K = (UINT)classLabels.size();
+    const UINT N = getNumClasses();
+    double sum = 0;
+    VectorDouble x(K,0);
+    for(UINT k=0; k<K; k++){
+        for(UINT n=0; n<N; n++){
+            if( classLabels[k] == classTracker[n].classLabel ){
+                x[k] = classTracker[n].counter;
+                sum += classTracker[n].counter;
+                break;
+            }
+        }
+    }
+
+    //Normalize the class probabilities
+    if( sum > 0 ){
+        for(UINT k=0; k<K; k++){
+            x[k] /= sum;
+        }
+    }
+
+    return x;
+}
+
+ClassificationData ClassificationDataView::getDataset() const{
+
+    const UINT M = getNumSamples();
+    ClassificationData dataset;
+
+    if( data == NULL ) return dataset;
+
+    dataset.setNumDimensions( numDimensions );
+    dataset.setAllowNullGestureClass( data->getAllowNullGestureClass() );
+    dataset.setExternalRanges( data->getExternalRanges(), data->getUseExternalRanges() );
+    dataset.reserve( M );
+
+    //Add all the class labels to the new dataset to ensure the dataset has a list of all the labels
+    for(UINT k=0; k<classTracker.size(); k++){
+        dataset.addClass( classTracker[k].classLabel, classTracker[k].className );
+    }
+
+    for(UINT i=0; i<M; i++){
+        const ClassificationSample &sample = (*data)[ indexes[i] ];
+        dataset.addSample( sample.getClassLabel(), sample.getSample() );
+    }
+
+    return dataset;
+}
+
+void ClassificationDataView::updateClassTracker(){
+
+    classTracker = data->getClassTracker();
+    for(UINT k=0; k<classTracker.size(); k++){
+        classTracker[k].counter = 0;
+    }
+
+    const UINT K = (UINT)classTracker.size();
+    for(UINT i=0; i<indexes.size(); i++){
+        const UINT classLabel = (*data)[ indexes[i] ].getClassLabel();
+        for(UINT k=0; k<K; k++){
+            if( classTracker[k].classLabel == classLabel ){
+                classTracker[k].counter++;
+                break;
+            }
+        }
+    }
+}
+
+}//End of namespace GRT
@@ -0,0 +1,191 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The ClassificationDataView class provides a lightweight view of a subset of the samples in a ClassificationData instance, such as a
+ bootstrapped dataset or a cross validation fold.  The view only stores a reference to the parent dataset and a list of sample indexes, so
+ creating a view does not copy any of the samples.  An index can appear more than once in a view, which is how bootstrapped datasets are
+ represented.
+
+ The view reports the same classes as the parent dataset (in the same order), even if some of the classes have no samples in the view.  This
+ matches the datasets returned by getBootstrappedDataset and getTrainingFoldData, so a classifier trained with a view has the same class
+ labels as a classifier trained with the parent dataset.
+
+ A view is only valid while the parent dataset is valid and is not modified.  If you need a copy of the data that can be modified (for example
+ to scale it), then use the getDataset function.
+
+ Example:
+ @code
+ ClassificationData trainingData;
+ //Load or record some data...
+
+ //Train a classifier with a bootstrapped subset of the training data, without copying the samples
+ ClassificationDataView bootstrappedData( trainingData, trainingData.getBootstrappedIndexes() );
+ DecisionTree tree;
+ tree.enableScaling( false );
+ tree.train_( bootstrappedData );
+ @endcode
+ */
+
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_CLASSIFICATION_DATA_VIEW_HEADER
+#define GRT_CLASSIFICATION_DATA_VIEW_HEADER
+
+#include "ClassificationData.h"
+
+namespace GRT{
+
+class ClassificationDataView{
+public:
+    /**
+     Default Constructor, creates an empty view.
+     */
+    ClassificationDataView();
+
+    /**
+     Creates a view of all the samples in the dataset.
+
+     @param const ClassificationData &data: the parent dataset, this must remain valid while the view is used
+     */
+    ClassificationDataView(const ClassificationData &data);
+
+    /**
+     Creates a view of the samples in the dataset at the indexes.  Each index must be in the range [0 data.getNumSamples()-1].
+
+     @param const ClassificationData &data: the parent dataset, this must remain valid while the view is used
+     @param const vector< UINT > &indexes: the indexes of the samples in the parent dataset that will be in the view
+     */
+    ClassificationDataView(const ClassificationData &data,const vector< UINT > &indexes);
+
+    /**
+     Default Destructor
+     */
+    ~ClassificationDataView();
+
+    /**
+     Const Array Subscript Operator, returns the ClassificationSample at index i of the view.
+     It is up to the user to ensure that i is within the range of [0 getNumSamples()-1]
+
+     @param const UINT &i: the index of the sample in the view
+     @return a const reference to the i'th ClassificationSample in the view
+     */
+    inline const ClassificationSample& operator[] (const UINT &i) const{
+        return (*data)[ indexes[i] ];
+    }
+
+    /**
+     Removes all the samples from the view, the parent dataset is not changed.
+     */
+    void clear();
+
+    /**
+     Gets the index in the parent dataset of the i'th sample in the view.
+
+     @param const UINT i: the index of the sample in the view, this should be in the range [0 getNumSamples()-1]
+     @return returns the index of the sample in the parent dataset
+     */
+    inline UINT getIndex(const UINT i) const{ return indexes[i]; }
+
+    /**
+     @return returns the indexes in the parent dataset of all the samples in the view
+     */
+    const vector< UINT >& getIndexes() const{ return indexes; }
+
+    /**
+     @return returns a pointer to the parent dataset, or NULL if the view has not been created from a dataset
+     */
+    const ClassificationData* getData() const{ return data; }
+
+    /**
+     @return returns the number of samples in the view
+     */
+    UINT inline getNumSamples() const{ return (UINT)indexes.size(); }
+
+    /**
+     @return returns the number of dimensions of the parent dataset
+     */
+    UINT inline getNumDimensions() const{ return numDimensions; }
+
+    /**
+     @return returns the number of classes in the parent dataset
+     */
+    UINT inline getNumClasses() const{ return (UINT)classTracker.size(); }
+
+    /**
+     @return returns a vector of ClassTracker, the counter of each class is the number of samples of that class in the view
+     */
+    vector< ClassTracker > getClassTracker() const{ return classTracker; }
+
+    /**
+     @return returns the class labels of the parent dataset
+     */
+    vector< UINT > getClassLabels() const;
+
+    /**
+     @return returns the number of samples of each class in the view
+     */
+    vector< UINT > getNumSamplesPerClass() const;
+
+    /**
+     Gets the ranges of the samples in the view.  If the parent dataset uses external ranges then these are returned instead.
+
+     @return returns a vector of MinMax values representing the ranges of each dimension
+     */
+    vector< MinMax > getRanges() const;
+
+    /**
+     @return returns the mean of each dimension of the samples in the view
+     */
+    VectorDouble getMean() const;
+
+    /**
+     Gets the probability of each class in the classLabels vector, based on the number of samples of each class in the view.
+
+     @param const vector< UINT > &classLabels: the class labels you want the probabilities for
+     @return returns a vector with the probability of each class in classLabels
+     */
+    VectorDouble getClassProbabilities( const vector< UINT > &classLabels ) const;
+
+    /**
+     Copies the samples in the view to a new ClassificationData instance, which can be modified without changing the parent dataset.
+     The new dataset contains all the classes of the parent dataset.
+
+     @return returns a new dataset containing a copy of the samples in the view
+     */
+    ClassificationData getDataset() const;
+
+protected:
+    /**
+     Counts the number of samples of each class of the parent dataset in the view.
+     */
+    void updateClassTracker();
+
+    const ClassificationData *data;                         ///< The parent dataset
+    UINT numDimensions;                                     ///< The number of dimensions of the parent dataset
+    vector< UINT > indexes;                                 ///< The index in the parent dataset of each sample in the view
+    vector< ClassTracker > classTracker;                    ///< The classes of the parent dataset, with the number of samples of each class in the view
+};
+
+} //End of namespace GRT
+
+#endif //GRT_CLASSIFICATION_DATA_VIEW_HEADER
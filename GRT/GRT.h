@@ -62,9 +62,14 @@
 #include "Util/PeakDetection.h"
 #include "Util/ThresholdCrossingDetector.h"
 #include "Util/CommandLineParser.h"
+#include "Util/DistanceKernels.h"
+#include "Util/MatrixKernels.h"
+#include "Util/AllocationCounter.h"
+#include "Util/MemoryMappedFile.h"
 
 //Include the data structures
 #include "DataStructures/ClassificationData.h"
+#include "DataStructures/ClassificationDataView.h"
 #include "DataStructures/TimeSeriesClassificationData.h"
 #include "DataStructures/TimeSeriesClassificationDataStream.h"
 #include "DataStructures/RegressionData.h"
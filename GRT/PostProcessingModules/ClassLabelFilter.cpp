@@ -119,8 +119,10 @@ bool ClassLabelFilter::reset(){
     processedData.clear();
     processedData.resize(1,0);
     buffer.clear();
+    classTracker.clear();
     if( bufferSize > 0 ){
         initialized = buffer.resize(bufferSize,0);
+        classTracker.reserve(bufferSize);
     }else initialized = false;
     return true;
 }
@@ -164,7 +166,8 @@ UINT ClassLabelFilter::filter(UINT predictedClassLabel){
     buffer.push_back( predictedClassLabel );
     
     //Count the class values in the buffer, automatically start with the first value in the buffer
-    vector< ClassTracker > classTracker( 1, ClassTracker( buffer[0], 1 ) );
+    classTracker.clear();
+    classTracker.push_back( ClassTracker( buffer[0], 1 ) );
     
     UINT maxCount = classTracker[0].counter;
     UINT maxClass = classTracker[0].classLabel;
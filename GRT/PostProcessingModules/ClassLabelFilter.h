@@ -190,6 +190,7 @@ protected:
     UINT minimumCount;                  ///< The minimum count sets the minimum number of class label values that must be present in the class labels buffer for that class label value to be output by the Class Label Filter
     UINT bufferSize;                    ///< The size of the Class Label Filter buffer
     CircularBuffer< UINT > buffer;      ///< The class label filter buffer
+    vector< ClassTracker > classTracker;///< Counts the class labels in the buffer, this is reserved in reset so filtering does not allocate
     
     static RegisterPostProcessingModule< ClassLabelFilter > registerModule;
 };
@@ -90,7 +90,7 @@ bool DeadZone::process(const VectorDouble &inputVector){
         return false;
     }
     
-    filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
     return false;
@@ -238,14 +238,21 @@ double DeadZone::filter(const double x){
     
 VectorDouble DeadZone::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool DeadZone::filter_(const VectorDouble &x){
+    
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - Not Initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The Number Of Input Dimensions (" << numInputDimensions << ") does not match the size of the input vector (" << x.size() << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     for(UINT n=0; n<numInputDimensions; n++){
@@ -256,7 +263,7 @@ VectorDouble DeadZone::filter(const VectorDouble &x){
             else processedData[n] = x[n] - lowerLimit;
         }
     }
-    return processedData;
+    return true;
 }
 
 bool DeadZone::setLowerLimit(double lowerLimit){ 
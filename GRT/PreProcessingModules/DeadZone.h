@@ -158,6 +158,15 @@ public:
      */
     VectorDouble filter(const VectorDouble &x);
     
+    /**
+     Filters the input and stores the results in the processedData vector. This is the same as filter(const VectorDouble &x), except that
+     the results are not copied, so it does not allocate any memory once the module has been initialized.
+     
+     @param const VectorDouble  &x: the input values, the dimensionality of the input vector should match that of the module
+	 @return returns true if the input was processed, false otherwise
+     */
+    bool filter_(const VectorDouble &x);
+    
     /**
      Sets the lower limit of the dead-zone region.
      
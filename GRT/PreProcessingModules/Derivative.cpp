@@ -111,7 +111,7 @@ bool Derivative::process(const VectorDouble &inputVector){
         return false;
     }
     
-    computeDerivative( inputVector );
+    if( !computeDerivative_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
     return false;
@@ -303,20 +303,30 @@ double Derivative::computeDerivative(const double x){
     
 VectorDouble Derivative::computeDerivative(const VectorDouble &x){
     
+    if( !computeDerivative_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool Derivative::computeDerivative_(const VectorDouble &x){
+    
     if( !initialized ){
         errorLog << "computeDerivative(const VectorDouble &x) - Not Initialized!" << endl;
-        return vector<double>();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "computeDerivative(const VectorDouble &x) - The Number Of Input Dimensions (" << numInputDimensions << ") does not match the size of the input vector (" << x.size() << ")!" << endl;
-        return vector<double>();
+        return false;
     }
     
-    VectorDouble y;
+    //Point y at the filtered data, or the raw input if the data is not being filtered, so the input is never copied
+    const VectorDouble *yPtr = &x;
     if( filterData ){
-        y = filter.filter( x );
-    }else y = x;
+        if( !filter.filter_( x ) ) return false;
+        yPtr = &filter.getProcessedData();
+    }
+    const VectorDouble &y = *yPtr;
     
     for(UINT n=0; n<numInputDimensions; n++){
         processedData[n] = (y[n]-yy[n])/delta;
@@ -332,7 +342,7 @@ VectorDouble Derivative::computeDerivative(const VectorDouble &x){
         }
     }
     
-    return processedData;
+    return true;
 }
     
 bool Derivative::setDerivativeOrder(UINT derivativeOrder){
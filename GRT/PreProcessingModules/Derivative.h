@@ -164,6 +164,15 @@ public:
      */
     VectorDouble computeDerivative(const VectorDouble &x);
     
+    /**
+     Computes the derivative of the input and stores the results in the processedData vector. This is the same as computeDerivative(const VectorDouble &x), except that
+     the results are not copied, so it does not allocate any memory once the module has been initialized.
+     
+     @param const VectorDouble  &x: the input values, the dimensionality of the input vector should match that of the module
+	 @return returns true if the input was processed, false otherwise
+     */
+    bool computeDerivative_(const VectorDouble &x);
+    
     /**
      Sets the derivative order.  This should either be FIRST_DERIVATIVE (1) or SECOND_DERIVATIVE (2).
      Setting the derivative order will re-initialize this instance.
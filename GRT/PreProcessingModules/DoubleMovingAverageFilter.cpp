@@ -109,7 +109,7 @@ bool DoubleMovingAverageFilter::process(const VectorDouble &inputVector){
         return false;
     }
     
-    processedData = filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
     return false;
@@ -271,34 +271,38 @@ double DoubleMovingAverageFilter::filter(const double x){
     
 VectorDouble DoubleMovingAverageFilter::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool DoubleMovingAverageFilter::filter_(const VectorDouble &x){
+    
     //If the filter has not been initialised then return 0, otherwise filter x and return y
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - The filter has not been initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The size of the input vector (" << x.size() << ") does not match that of the number of dimensions of the filter (" << numInputDimensions << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     //Perform the first filter
-    VectorDouble y = filter1.filter( x );
-    
-    if( y.size() == 0 ) return y;
+    if( !filter1.filter_( x ) ) return false;
+    const VectorDouble &y = filter1.getProcessedData();
     
     //Perform the second filter
-    VectorDouble yy = filter2.filter( y );
-    
-    if( yy.size() == 0 ) return y;
+    if( !filter2.filter_( y ) ) return false;
+    const VectorDouble &yy = filter2.getProcessedData();
     
     //Account for the filter lag
     for(UINT i=0; i<y.size(); i++){
-        yy[i] = y[i] + (y[i] - yy[i]); 
-        processedData[i] = yy[i];
+        processedData[i] = y[i] + (y[i] - yy[i]);
     }
     
-    return yy;
+    return true;
 }
 
 }//End of namespace GRT
\ No newline at end of file
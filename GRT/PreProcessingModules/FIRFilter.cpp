@@ -120,7 +120,7 @@ bool FIRFilter::process(const VectorDouble &inputVector){
     }
     
     //Run the filter
-    filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     //Check to ensure the size of the filter results match the number of dimensions
     if( processedData.size() == numOutputDimensions ) return true;
@@ -425,14 +425,21 @@ double FIRFilter::filter(const double x){
     
 VectorDouble FIRFilter::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool FIRFilter::filter_(const VectorDouble &x){
+    
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - Not Initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The Number Of Input Dimensions (" << numInputDimensions << ") does not match the size of the input vector (" << x.size() << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     //Add the new sample to the buffer
@@ -449,7 +456,7 @@ VectorDouble FIRFilter::filter(const VectorDouble &x){
         processedData[n] *= gain;
     }
     
-    return processedData;
+    return true;
 }
     
 UINT FIRFilter::getFilterType() const{
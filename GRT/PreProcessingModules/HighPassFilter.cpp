@@ -104,7 +104,7 @@ bool HighPassFilter::process(const VectorDouble &inputVector){
         return false;
     }
     
-    processedData = filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
     return false;
@@ -273,14 +273,21 @@ double HighPassFilter::filter(const double x){
     
 VectorDouble HighPassFilter::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool HighPassFilter::filter_(const VectorDouble &x){
+    
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - Not Initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The Number Of Input Dimensions (" << numInputDimensions << ") does not match the size of the input vector (" << x.size() << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     for(UINT n=0; n<numInputDimensions; n++){
@@ -293,7 +300,7 @@ VectorDouble HighPassFilter::filter(const VectorDouble &x){
         //Store the current output
         yy[n] = processedData[n];
     }
-    return processedData;
+    return true;
 }
     
 bool HighPassFilter::setGain(double gain){
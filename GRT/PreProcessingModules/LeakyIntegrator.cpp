@@ -94,7 +94,7 @@ bool LeakyIntegrator::process(const VectorDouble &inputVector){
         return false;
     }
     
-    update( inputVector );
+    if( !update_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
     return false;
@@ -199,14 +199,21 @@ double LeakyIntegrator::update(const double x){
     
 VectorDouble LeakyIntegrator::update(const VectorDouble &x){
     
+    if( !update_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool LeakyIntegrator::update_(const VectorDouble &x){
+    
     if( !initialized ){
         errorLog << "update(const VectorDouble &x) - Not Initialized!" << endl;
-        return vector<double>();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "update(const VectorDouble &x) - The Number Of Input Dimensions (" << numInputDimensions << ") does not match the size of the input vector (" << x.size() << ")!" << endl;
-        return vector<double>();
+        return false;
     }
     
     for(UINT n=0; n<numInputDimensions; n++){
@@ -214,7 +221,7 @@ VectorDouble LeakyIntegrator::update(const VectorDouble &x){
     }
     processedData = y;
     
-    return processedData;
+    return true;
 }
     
 bool LeakyIntegrator::setLeakRate(const double leakRate){
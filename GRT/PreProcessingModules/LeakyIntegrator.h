@@ -135,6 +135,15 @@ public:
      */
     VectorDouble update(const VectorDouble &x);
     
+    /**
+     Updates the integrator with the input and stores the results in the processedData vector. This is the same as update(const VectorDouble &x), except that
+     the results are not copied, so it does not allocate any memory once the module has been initialized.
+     
+     @param const VectorDouble  &x: the input values, the dimensionality of the input vector should match that of the module
+	 @return returns true if the input was processed, false otherwise
+     */
+    bool update_(const VectorDouble &x);
+    
     /**
      Sets the leak rate.  This should be in the range [0 1].
      Setting delta will re-initialize this instance.
@@ -91,7 +91,7 @@ bool LowPassFilter::process(const VectorDouble &inputVector){
         return false;
     }
     
-    processedData = filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
     return false;
@@ -258,21 +258,28 @@ double LowPassFilter::filter(double x){
     
 VectorDouble LowPassFilter::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool LowPassFilter::filter_(const VectorDouble &x){
+    
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - Not Initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The Number Of Input Dimensions (" << numInputDimensions << ") does not match the size of the input vector (" << x.size() << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     for(UINT n=0; n<numInputDimensions; n++){
         processedData[n] = (x[n] * filterFactor) + (yy[n] * (1.0 - filterFactor)) * gain;
         yy[n] = processedData[n];
     }
-    return processedData;
+    return true;
 }
     
 bool LowPassFilter::setGain(double gain){
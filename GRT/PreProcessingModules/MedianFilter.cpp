@@ -104,7 +104,7 @@ bool MedianFilter::process(const VectorDouble &inputVector){
         return false;
     }
     
-    filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
 
@@ -235,6 +235,8 @@ bool MedianFilter::init(UINT filterSize,UINT numDimensions){
     this->numOutputDimensions = numDimensions;
     processedData.clear();
     processedData.resize(numDimensions,0);
+    sortBuffer.clear();
+    sortBuffer.resize(filterSize,0);
     initialized = dataBuffer.resize( filterSize, VectorDouble(numInputDimensions,0) );
     
     if( !initialized ){
@@ -254,15 +256,22 @@ double MedianFilter::filter(const double x){
     
 VectorDouble MedianFilter::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool MedianFilter::filter_(const VectorDouble &x){
+    
     //If the filter has not been initialised then return 0, otherwise filter x and return y
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - The filter has not been initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The size of the input vector (" << x.size() << ") does not match that of the number of dimensions of the filter (" << numInputDimensions << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( ++inputSampleCounter > filterSize ) inputSampleCounter = filterSize;
@@ -271,19 +280,18 @@ VectorDouble MedianFilter::filter(const VectorDouble &x){
     dataBuffer.push_back( x );
     
     //Compute the median value for each dimension
-    vector< double > tmp( inputSampleCounter );
     for(unsigned int j=0; j<numInputDimensions; j++){
         for(unsigned int i=0; i<inputSampleCounter; i++) {
-            tmp[i] = dataBuffer[i][j];
+            sortBuffer[i] = dataBuffer[i][j];
         }
-        std::sort(tmp.begin(),tmp.end());
+        std::sort(sortBuffer.begin(),sortBuffer.begin()+inputSampleCounter);
         
         //Get the median value
         unsigned int medianIndex = (inputSampleCounter/2);
-        processedData[j] = tmp[ medianIndex ];
+        processedData[j] = sortBuffer[ medianIndex ];
     }
     
-    return processedData;
+    return true;
 }
     
 vector< VectorDouble > MedianFilter::getDataBuffer() const {
@@ -154,6 +154,15 @@ public:
 	 @return the filtered values.  An empty vector will be returned if the values were not filtered
      */
     VectorDouble filter(const VectorDouble &x);
+    
+    /**
+     Filters the input and stores the results in the processedData vector. This is the same as filter(const VectorDouble &x), except that
+     the results are not copied, so it does not allocate any memory once the module has been initialized.
+     
+     @param const VectorDouble  &x: the input values, the dimensionality of the input vector should match that of the module
+	 @return returns true if the input was processed, false otherwise
+     */
+    bool filter_(const VectorDouble &x);
 
 	/**
      Gets the current filter size.
@@ -183,6 +192,7 @@ protected:
     UINT filterSize;                                        ///< The size of the filter
     UINT inputSampleCounter;                                ///< A counter to keep track of the number of input samples
     CircularBuffer< VectorDouble > dataBuffer;          	///< A buffer to store the previous N values, N = filterSize
+    VectorDouble sortBuffer;                                ///< A buffer used to sort the values of each dimension, this is allocated once in init so filtering does not allocate
     
     static RegisterPreProcessingModule< MedianFilter > registerModule;
 };
@@ -104,7 +104,7 @@ bool MovingAverageFilter::process(const VectorDouble &inputVector){
         return false;
     }
     
-    filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
 
@@ -260,15 +260,22 @@ double MovingAverageFilter::filter(const double x){
     
 VectorDouble MovingAverageFilter::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool MovingAverageFilter::filter_(const VectorDouble &x){
+    
     //If the filter has not been initialised then return 0, otherwise filter x and return y
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - The filter has not been initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The size of the input vector (" << x.size() << ") does not match that of the number of dimensions of the filter (" << numInputDimensions << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( ++inputSampleCounter > filterSize ) inputSampleCounter = filterSize;
@@ -284,7 +291,7 @@ VectorDouble MovingAverageFilter::filter(const VectorDouble &x){
         processedData[j] /= double(inputSampleCounter);
     }
     
-    return processedData;
+    return true;
 }
 
 }//End of namespace GRT
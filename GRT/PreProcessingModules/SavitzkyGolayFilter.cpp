@@ -113,7 +113,7 @@ bool SavitzkyGolayFilter::process(const VectorDouble &inputVector){
         return false;
     }
     
-    processedData = filter( inputVector );
+    if( !filter_( inputVector ) ) return false;
     
     if( processedData.size() == numOutputDimensions ) return true;
     return false;
@@ -314,14 +314,21 @@ double SavitzkyGolayFilter::filter(const double x){
     
 VectorDouble SavitzkyGolayFilter::filter(const VectorDouble &x){
     
+    if( !filter_( x ) ) return VectorDouble();
+    
+    return processedData;
+}
+
+bool SavitzkyGolayFilter::filter_(const VectorDouble &x){
+    
     if( !initialized ){
         errorLog << "filter(const VectorDouble &x) - Not Initialized!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     if( x.size() != numInputDimensions ){
         errorLog << "filter(const VectorDouble &x) - The Number Of Input Dimensions (" << numInputDimensions << ") does not match the size of the input vector (" << x.size() << ")!" << endl;
-        return VectorDouble();
+        return false;
     }
     
     //Add the new input data to the data buffer
@@ -334,7 +341,7 @@ VectorDouble SavitzkyGolayFilter::filter(const VectorDouble &x){
             processedData[j] += data[i][j] * coeff[i];
     }
     
-    return processedData;
+    return true;
 }
     
 bool SavitzkyGolayFilter::calCoeff(){
@@ -45,6 +45,8 @@ MLP::MLP(){
     initialized = false;
     classificationModeActive = false;
     useNullRejection = true;
+    batchSize = 1;
+    useParallelTraining = false;
     clear();
     classType = "MLP";
     regressifierType = classType;
@@ -98,6 +100,8 @@ MLP& MLP::operator=(const MLP &rhs){
         this->nullRejectionThreshold = rhs.nullRejectionThreshold;
         this->maxLikelihood = rhs.maxLikelihood;
         this->classLikelihoods = rhs.classLikelihoods;
+        this->batchSize = rhs.batchSize;
+        this->useParallelTraining = rhs.useParallelTraining;
         
         //Copy the base variables
         copyBaseVariables( (Regressifier*)&rhs );
@@ -229,9 +233,6 @@ bool MLP::init(const UINT numInputNeurons,
     
     //Clear any previous models
     clear();
-
-	//Initialize the random seed
-	random.setSeed( (UINT)time(NULL) );
     
     if( numInputNeurons == 0 || numHiddenNeurons == 0 || numOutputNeurons == 0 ){
         if( numInputNeurons == 0 ){  errorLog << "init(...) - The number of input neurons is zero!" << endl; }
@@ -274,12 +275,12 @@ bool MLP::init(const UINT numInputNeurons,
     }
     
     for(UINT i=0; i<numHiddenNeurons; i++){
-        hiddenLayer[i].init(numInputNeurons,hiddenLayerActivationFunction);
+        hiddenLayer[i].init(numInputNeurons,hiddenLayerActivationFunction,random);
 		hiddenLayer[i].gamma = gamma;
     }
     
     for(UINT i=0; i<numOutputNeurons; i++){
-        outputLayer[i].init(numHiddenNeurons,outputLayerActivationFunction);
+        outputLayer[i].init(numHiddenNeurons,outputLayerActivationFunction,random);
 		outputLayer[i].gamma = gamma;
     }
     
@@ -299,6 +300,15 @@ bool MLP::clear(){
     inputLayer.clear();
     hiddenLayer.clear();
     outputLayer.clear();
+    hiddenWeights.clear();
+    hiddenBias.clear();
+    outputWeights.clear();
+    outputBias.clear();
+    outputWeightsTransposed.clear();
+    hiddenWeightsUpdate.clear();
+    hiddenBiasUpdate.clear();
+    outputWeightsUpdate.clear();
+    outputBiasUpdate.clear();
     initialized = false;
     
     return true;
@@ -450,83 +460,40 @@ bool MLP::trainOnlineGradientDescentClassification(const RegressionData &trainin
             accuracy = 0;
             totalSquaredTrainingError = 0;
             
-            for(UINT i=0; i<M; i++){
-                //Get the i'th training and target vectors
-                const VectorDouble &trainingExample = trainingData[ indexList[i] ].getInputVector();
-                const VectorDouble &targetVector = trainingData[ indexList[i] ].getTargetVector();
-                
-                //Perform the back propagation
-                double backPropError = back_prop(trainingExample,targetVector,alpha,beta);
-                
-                //debugLog << "i: " << i << " backPropError: " << backPropError << endl;
-                
-                if( isNAN(backPropError) ){
+            if( batchSize > 1 ){
+                //Perform one epoch of mini batch gradient descent, the accuracy is computed from the outputs of each batch before the weights are updated
+                UINT numCorrect = 0;
+                if( !trainMiniBatchEpoch(trainingData,indexList,alpha,beta,totalSquaredTrainingError,numCorrect) ){
                     keepTraining = false;
                     errorLog << "train(RegressionData trainingData) - NaN found!" << endl;
- 		    return false;
+                    return false;
                 }
-                
-                //Compute the error for the i'th example
-		if( classificationModeActive ){
-                    VectorDouble y = feedforward(trainingExample);
+                accuracy = numCorrect;
+            }else{
+                for(UINT i=0; i<M; i++){
+                    //Get the i'th training and target vectors
+                    const VectorDouble &trainingExample = trainingData[ indexList[i] ].getInputVector();
+                    const VectorDouble &targetVector = trainingData[ indexList[i] ].getTargetVector();
                     
-                    //Get the class label
-                    double bestValue = targetVector[0];
-                    UINT bestIndex = 0;
-                    for(UINT i=1; i<targetVector.size(); i++){
-                        if( targetVector[i] > bestValue ){
-                            bestValue = targetVector[i];
-                            bestIndex = i;
-                        }
-                    }
-                    UINT classLabel = bestIndex + 1;
+                    //Perform the back propagation
+                    double backPropError = back_prop(trainingExample,targetVector,alpha,beta);
                     
-                    //Get the predicted class label
-                    bestValue = y[0];
-                    bestIndex = 0;
-                    for(UINT i=1; i<numOutputNeurons; i++){
-                        if( y[i] > bestValue ){
-                            bestValue = y[i];
-                            bestIndex = i;
-                        }
-                    }
-                    predictedClassLabel = bestIndex+1;
+                    //debugLog << "i: " << i << " backPropError: " << backPropError << endl;
                     
-                    if( classLabel == predictedClassLabel ){
-                        accuracy++;
+                    if( isNAN(backPropError) ){
+                        keepTraining = false;
+                        errorLog << "train(RegressionData trainingData) - NaN found!" << endl;
+                        return false;
                     }
                     
-                }else{
-                    totalSquaredTrainingError += backPropError; //The backPropError is already squared
-                }
-            }
-            
-            if( checkForNAN() ){
-                keepTraining = false;
-                errorLog << "train(RegressionData trainingData) - NaN found!" << endl;
-                break;
-            }
-            
-            //Compute the error over all the training/validation examples
-	    if( useValidationSet ){
-                trainingSetAccuracy = accuracy;
-                trainingSetTotalSquaredError = totalSquaredTrainingError;
-		accuracy = 0;
-                totalSquaredTrainingError = 0;
-                
-                //Iterate over the validation samples
-                UINT numValidationSamples = validationData.getNumSamples();
-		for(UINT i=0; i<numValidationSamples; i++){
-		    const VectorDouble &trainingExample = validationData[i].getInputVector();
-		    const VectorDouble &targetVector = validationData[i].getTargetVector();
-                    
-                    VectorDouble y = feedforward(trainingExample);
-                    
+                    //Compute the error for the i'th example
                     if( classificationModeActive ){
+                        VectorDouble y = feedforward(trainingExample);
+                        
                         //Get the class label
                         double bestValue = targetVector[0];
                         UINT bestIndex = 0;
-                        for(UINT i=1; i<numInputNeurons; i++){
+                        for(UINT i=1; i<targetVector.size(); i++){
                             if( targetVector[i] > bestValue ){
                                 bestValue = targetVector[i];
                                 bestIndex = i;
@@ -550,12 +517,72 @@ bool MLP::trainOnlineGradientDescentClassification(const RegressionData &trainin
                         }
                         
                     }else{
-                        //Update the total squared error
-                        for(UINT j=0; j<T; j++){
-                            totalSquaredTrainingError += SQR( targetVector[j]-y[j] );
+                        totalSquaredTrainingError += backPropError; //The backPropError is already squared
+                    }
+                }
+            }
+            
+            if( checkForNAN() ){
+                keepTraining = false;
+                errorLog << "train(RegressionData trainingData) - NaN found!" << endl;
+                break;
+            }
+            
+            //Compute the error over all the training/validation examples
+	    if( useValidationSet ){
+                trainingSetAccuracy = accuracy;
+                trainingSetTotalSquaredError = totalSquaredTrainingError;
+		accuracy = 0;
+                totalSquaredTrainingError = 0;
+                
+                //Iterate over the validation samples
+                UINT numValidationSamples = validationData.getNumSamples();
+                if( batchSize > 1 ){
+                    UINT numCorrect = 0;
+                    computeMiniBatchErrors(validationData,totalSquaredTrainingError,numCorrect);
+                    accuracy = numCorrect;
+                }else{
+                    for(UINT i=0; i<numValidationSamples; i++){
+                        const VectorDouble &trainingExample = validationData[i].getInputVector();
+                        const VectorDouble &targetVector = validationData[i].getTargetVector();
+                        
+                        VectorDouble y = feedforward(trainingExample);
+                        
+                        if( classificationModeActive ){
+                            //Get the class label
+                            double bestValue = targetVector[0];
+                            UINT bestIndex = 0;
+                            for(UINT i=1; i<targetVector.size(); i++){
+                                if( targetVector[i] > bestValue ){
+                                    bestValue = targetVector[i];
+                                    bestIndex = i;
+                                }
+                            }
+                            UINT classLabel = bestIndex + 1;
+                            
+                            //Get the predicted class label
+                            bestValue = y[0];
+                            bestIndex = 0;
+                            for(UINT i=1; i<numOutputNeurons; i++){
+                                if( y[i] > bestValue ){
+                                    bestValue = y[i];
+                                    bestIndex = i;
+                                }
+                            }
+                            predictedClassLabel = bestIndex+1;
+                            
+                            if( classLabel == predictedClassLabel ){
+                                accuracy++;
+                            }
+                            
+                        }else{
+                            //Update the total squared error
+                            for(UINT j=0; j<T; j++){
+                                totalSquaredTrainingError += SQR( targetVector[j]-y[j] );
+                            }
                         }
                     }
-				}
+                }
                 
                 accuracy = (accuracy/double(numValidationSamples))*double(numValidationSamples);
                 rootMeanSquaredTrainingError = sqrt( totalSquaredTrainingError / double(numValidationSamples) );
@@ -725,23 +752,32 @@ bool MLP::trainOnlineGradientDescentRegression(const RegressionData &trainingDat
             //Perform one training epoch
             totalSquaredTrainingError = 0;
             
-            for(UINT i=0; i<M; i++){
-                //Get the i'th training and target vectors
-                const VectorDouble &trainingExample = trainingData[ indexList[i] ].getInputVector();
-                const VectorDouble &targetVector = trainingData[ indexList[i] ].getTargetVector();
-                
-                //Perform the back propagation
-                double backPropError = back_prop(trainingExample,targetVector,alpha,beta);
-                
-                //debugLog << "i: " << i << " backPropError: " << backPropError << endl;
-                
-                if( isNAN(backPropError) ){
+            if( batchSize > 1 ){
+                //Perform one epoch of mini batch gradient descent
+                UINT numCorrect = 0;
+                if( !trainMiniBatchEpoch(trainingData,indexList,alpha,beta,totalSquaredTrainingError,numCorrect) ){
                     keepTraining = false;
                     errorLog << "train(RegressionData trainingData) - NaN found!" << endl;
                 }
-                
-                //Compute the error for the i'th example
-                totalSquaredTrainingError += backPropError; //The backPropError is already squared
+            }else{
+                for(UINT i=0; i<M; i++){
+                    //Get the i'th training and target vectors
+                    const VectorDouble &trainingExample = trainingData[ indexList[i] ].getInputVector();
+                    const VectorDouble &targetVector = trainingData[ indexList[i] ].getTargetVector();
+                    
+                    //Perform the back propagation
+                    double backPropError = back_prop(trainingExample,targetVector,alpha,beta);
+                    
+                    //debugLog << "i: " << i << " backPropError: " << backPropError << endl;
+                    
+                    if( isNAN(backPropError) ){
+                        keepTraining = false;
+                        errorLog << "train(RegressionData trainingData) - NaN found!" << endl;
+                    }
+                    
+                    //Compute the error for the i'th example
+                    totalSquaredTrainingError += backPropError; //The backPropError is already squared
+                }
             }
             
             if( checkForNAN() ){
@@ -756,17 +792,22 @@ bool MLP::trainOnlineGradientDescentRegression(const RegressionData &trainingDat
                 totalSquaredTrainingError = 0;
                 
                 //Iterate over the validation samples
-                for(UINT i=0; i<numValidationSamples; i++){
-                    const VectorDouble &trainingExample = validationData[i].getInputVector();
-                    const VectorDouble &targetVector = validationData[i].getTargetVector();
-                    
-                    VectorDouble y = feedforward(trainingExample);
-                    
-                    //Update the total squared error
-                    for(UINT j=0; j<T; j++){
-                        totalSquaredTrainingError += SQR( targetVector[j]-y[j] );
+                if( batchSize > 1 ){
+                    UINT numCorrect = 0;
+                    computeMiniBatchErrors(validationData,totalSquaredTrainingError,numCorrect);
+                }else{
+                    for(UINT i=0; i<numValidationSamples; i++){
+                        const VectorDouble &trainingExample = validationData[i].getInputVector();
+                        const VectorDouble &targetVector = validationData[i].getTargetVector();
+                        
+                        VectorDouble y = feedforward(trainingExample);
+                        
+                        //Update the total squared error
+                        for(UINT j=0; j<T; j++){
+                            totalSquaredTrainingError += SQR( targetVector[j]-y[j] );
+                        }
+                        
                     }
-                    
                 }
             
                 rootMeanSquaredTrainingError = sqrt( totalSquaredTrainingError / double(numValidationSamples) );
@@ -984,6 +1025,317 @@ void MLP::feedforward(const VectorDouble &trainingExample,VectorDouble &inputNeu
     
 }
 
+bool MLP::trainMiniBatchEpoch(const RegressionData &trainingData,const vector< UINT > &indexList,const double alpha,const double beta,double &totalSquaredError,UINT &numCorrect){
+    
+    const UINT M = (UINT)indexList.size();
+    const UINT blockSize = MINI_BATCH_BLOCK_SIZE;
+    totalSquaredError = 0;
+    numCorrect = 0;
+    
+    //Copy the weights of the neurons into the layer matrices
+    packLayers();
+    
+    for(UINT startIndex=0; startIndex<M; startIndex+=batchSize){
+        const UINT endIndex = startIndex + batchSize < M ? startIndex + batchSize : M;
+        const UINT numBlocks = (endIndex - startIndex + blockSize - 1) / blockSize;
+        const double batchScale = 1.0 / double(endIndex - startIndex);
+        
+        //Run the forward and backward pass for each block of the batch
+        if( !processMiniBatch(trainingData,indexList,startIndex,endIndex,true) ){
+            unpackLayers();
+            return false;
+        }
+        
+        //Sum the errors and gradients of the blocks in order, so the result does not depend on how the blocks were scheduled
+        MiniBatchBlock &sum = miniBatchBlocks[0];
+        totalSquaredError += sum.squaredError;
+        numCorrect += sum.numCorrect;
+        for(UINT b=1; b<numBlocks; b++){
+            const MiniBatchBlock &block = miniBatchBlocks[b];
+            totalSquaredError += block.squaredError;
+            numCorrect += block.numCorrect;
+            for(UINT i=0; i<sum.hiddenWeightsGradient.size(); i++) sum.hiddenWeightsGradient[i] += block.hiddenWeightsGradient[i];
+            for(UINT i=0; i<sum.hiddenBiasGradient.size(); i++) sum.hiddenBiasGradient[i] += block.hiddenBiasGradient[i];
+            for(UINT i=0; i<sum.outputWeightsGradient.size(); i++) sum.outputWeightsGradient[i] += block.outputWeightsGradient[i];
+            for(UINT i=0; i<sum.outputBiasGradient.size(); i++) sum.outputBiasGradient[i] += block.outputBiasGradient[i];
+        }
+        
+        //Update the weights and bias using the mean gradient of the batch, the update has the same form as the online back propagation
+        for(UINT i=0; i<hiddenWeights.size(); i++){
+            hiddenWeightsUpdate[i] = alpha * (beta * hiddenWeightsUpdate[i] + (1.0 - beta) * sum.hiddenWeightsGradient[i] * batchScale);
+            hiddenWeights[i] += hiddenWeightsUpdate[i];
+        }
+        for(UINT i=0; i<outputWeights.size(); i++){
+            outputWeightsUpdate[i] = alpha * (beta * outputWeightsUpdate[i] + (1.0 - beta) * sum.outputWeightsGradient[i] * batchScale);
+            outputWeights[i] += outputWeightsUpdate[i];
+        }
+        for(UINT i=0; i<numHiddenNeurons; i++){
+            hiddenBiasUpdate[i] = alpha * (beta * hiddenBiasUpdate[i] + (1.0 - beta) * sum.hiddenBiasGradient[i] * batchScale);
+            hiddenBias[i] += hiddenBiasUpdate[i];
+        }
+        for(UINT i=0; i<numOutputNeurons; i++){
+            outputBiasUpdate[i] = alpha * (beta * outputBiasUpdate[i] + (1.0 - beta) * sum.outputBiasGradient[i] * batchScale);
+            outputBias[i] += outputBiasUpdate[i];
+        }
+    }
+    
+    //Copy the updated weights back into the neurons
+    unpackLayers();
+    
+    return !isNAN( totalSquaredError );
+}
+    
+bool MLP::computeMiniBatchErrors(const RegressionData &data,double &totalSquaredError,UINT &numCorrect){
+    
+    const UINT M = data.getNumSamples();
+    const UINT blockSize = MINI_BATCH_BLOCK_SIZE;
+    const UINT stepSize = batchSize > blockSize ? batchSize : blockSize;
+    totalSquaredError = 0;
+    numCorrect = 0;
+    
+    if( miniBatchIndexList.size() != M ){
+        miniBatchIndexList.resize( M );
+        for(UINT i=0; i<M; i++) miniBatchIndexList[i] = i;
+    }
+    
+    packLayers();
+    
+    for(UINT startIndex=0; startIndex<M; startIndex+=stepSize){
+        const UINT endIndex = startIndex + stepSize < M ? startIndex + stepSize : M;
+        const UINT numBlocks = (endIndex - startIndex + blockSize - 1) / blockSize;
+        
+        if( !processMiniBatch(data,miniBatchIndexList,startIndex,endIndex,false) ){
+            return false;
+        }
+        
+        for(UINT b=0; b<numBlocks; b++){
+            totalSquaredError += miniBatchBlocks[b].squaredError;
+            numCorrect += miniBatchBlocks[b].numCorrect;
+        }
+    }
+    
+    return true;
+}
+    
+bool MLP::processMiniBatch(const RegressionData &data,const vector< UINT > &indexList,const UINT startIndex,const UINT endIndex,const bool computeGradients){
+    
+    const UINT blockSize = MINI_BATCH_BLOCK_SIZE;
+    const UINT numBlocks = (endIndex - startIndex + blockSize - 1) / blockSize;
+    
+    if( miniBatchBlocks.size() < numBlocks ) miniBatchBlocks.resize( numBlocks );
+    
+    //The output error is back propagated using the transpose of the output weights
+    if( computeGradients ){
+        MatrixKernels::transpose(numHiddenNeurons,numOutputNeurons,&outputWeights[0],&outputWeightsTransposed[0]);
+    }
+    
+    bool result = true;
+    if( useParallelTraining && numBlocks > 1 && ThreadPool::getThreadPoolSize() > 1 ){
+        if( threadPool.get() == NULL ) threadPool.reset( new ThreadPool( ThreadPool::getThreadPoolSize() ) );
+        
+        //Each block writes to its own MiniBatchBlock, so the blocks can be processed in any order
+        vector< std::future< bool > > blockTasks;
+        blockTasks.reserve( numBlocks );
+        for(UINT b=0; b<numBlocks; b++){
+            const UINT blockStart = startIndex + b*blockSize;
+            const UINT blockEnd = blockStart + blockSize < endIndex ? blockStart + blockSize : endIndex;
+            blockTasks.push_back( threadPool->enqueue( &MLP::processMiniBatchBlock, this, std::cref(data), std::cref(indexList), blockStart, blockEnd, b, computeGradients ) );
+        }
+        for(UINT b=0; b<numBlocks; b++){
+            if( !blockTasks[b].get() ) result = false;
+        }
+    }else{
+        for(UINT b=0; b<numBlocks; b++){
+            const UINT blockStart = startIndex + b*blockSize;
+            const UINT blockEnd = blockStart + blockSize < endIndex ? blockStart + blockSize : endIndex;
+            if( !processMiniBatchBlock(data,indexList,blockStart,blockEnd,b,computeGradients) ) result = false;
+        }
+    }
+    
+    return result;
+}
+    
+//Applies the activation function to the weighted sum y, this matches Neuron::fire
+static inline double activate(const UINT activationFunction,const double gamma,const double y){
+    switch( activationFunction ){
+        case(Neuron::SIGMOID):
+            if( y < -45.0 ) return 0;
+            if( y > 45.0 ) return 1.0;
+            return 1.0/(1.0+exp(-y));
+        case(Neuron::BIPOLAR_SIGMOID):
+            if( y < -45.0 ) return 0;
+            if( y > 45.0 ) return 1.0;
+            return (2.0 / (1.0 + exp(-gamma * y))) - 1.0;
+        default:
+            break;
+    }
+    return y;
+}
+    
+//Computes the derivative of the activation function from the output y, this matches Neuron::getDerivative
+static inline double activationDerivative(const UINT activationFunction,const double gamma,const double y){
+    switch( activationFunction ){
+        case(Neuron::SIGMOID):
+            return y * (1.0 - y);
+        case(Neuron::BIPOLAR_SIGMOID):
+            return (gamma * (1.0 - (y*y))) / 2.0;
+        default:
+            break;
+    }
+    return 1.0;
+}
+    
+bool MLP::processMiniBatchBlock(const RegressionData &data,const vector< UINT > &indexList,const UINT startIndex,const UINT endIndex,const UINT blockIndex,const bool computeGradients){
+    
+    MiniBatchBlock &block = miniBatchBlocks[ blockIndex ];
+    const UINT R = endIndex - startIndex;
+    const UINT I = numInputNeurons;
+    const UINT H = numHiddenNeurons;
+    const UINT O = numOutputNeurons;
+    
+    block.numRows = R;
+    block.squaredError = 0;
+    block.numCorrect = 0;
+    if( R == 0 ) return true;
+    
+    block.inputs.resize( R*I );
+    block.hiddenOutputs.resize( R*H );
+    block.outputs.resize( R*O );
+    
+    //Input layer
+    for(UINT r=0; r<R; r++){
+        const VectorDouble &x = data[ indexList[startIndex+r] ].getInputVector();
+        for(UINT j=0; j<I; j++){
+            block.inputs[ r*I+j ] = activate( inputLayerActivationFunction, gamma, inputLayer[j].bias + x[j] * inputLayer[j].weights[0] );
+        }
+    }
+    
+    //Hidden layer, each sum starts at the bias and the weighted inputs are added in order, so the sums match Neuron::fire
+    for(UINT r=0; r<R; r++){
+        std::copy(hiddenBias.begin(),hiddenBias.end(),block.hiddenOutputs.begin()+r*H);
+    }
+    MatrixKernels::multiply(R,H,I,&block.inputs[0],I,1,&hiddenWeights[0],H,&block.hiddenOutputs[0],H,true);
+    for(UINT i=0; i<R*H; i++){
+        block.hiddenOutputs[i] = activate( hiddenLayerActivationFunction, gamma, block.hiddenOutputs[i] );
+    }
+    
+    //Output layer
+    for(UINT r=0; r<R; r++){
+        std::copy(outputBias.begin(),outputBias.end(),block.outputs.begin()+r*O);
+    }
+    MatrixKernels::multiply(R,O,H,&block.hiddenOutputs[0],H,1,&outputWeights[0],O,&block.outputs[0],O,true);
+    for(UINT i=0; i<R*O; i++){
+        block.outputs[i] = activate( outputLayerActivationFunction, gamma, block.outputs[i] );
+    }
+    
+    //Compute the error of the output layer: the derivative of the function times the error of the output
+    if( computeGradients ) block.deltaO.resize( R*O );
+    for(UINT r=0; r<R; r++){
+        const VectorDouble &targetVector = data[ indexList[startIndex+r] ].getTargetVector();
+        const double *y = &block.outputs[ r*O ];
+        UINT classIndex = 0;
+        UINT predictedIndex = 0;
+        for(UINT j=0; j<O; j++){
+            const double error = targetVector[j] - y[j];
+            block.squaredError += error*error;
+            if( computeGradients ) block.deltaO[ r*O+j ] = activationDerivative( outputLayerActivationFunction, gamma, y[j] ) * error;
+            if( targetVector[j] > targetVector[classIndex] ) classIndex = j;
+            if( y[j] > y[predictedIndex] ) predictedIndex = j;
+        }
+        if( classificationModeActive && classIndex == predictedIndex ) block.numCorrect++;
+    }
+    
+    if( !computeGradients ) return true;
+    
+    //Compute the error of the hidden layer
+    block.deltaH.resize( R*H );
+    MatrixKernels::multiply(R,H,O,&block.deltaO[0],O,1,&outputWeightsTransposed[0],H,&block.deltaH[0],H,false);
+    for(UINT i=0; i<R*H; i++){
+        block.deltaH[i] *= activationDerivative( hiddenLayerActivationFunction, gamma, block.hiddenOutputs[i] );
+    }
+    
+    //Compute the gradients of the weights, summed over the rows of the block
+    block.hiddenWeightsGradient.resize( I*H );
+    block.outputWeightsGradient.resize( H*O );
+    MatrixKernels::multiply(I,H,R,&block.inputs[0],1,I,&block.deltaH[0],H,&block.hiddenWeightsGradient[0],H,false);
+    MatrixKernels::multiply(H,O,R,&block.hiddenOutputs[0],1,H,&block.deltaO[0],O,&block.outputWeightsGradient[0],O,false);
+    
+    block.hiddenBiasGradient.assign( H, 0 );
+    block.outputBiasGradient.assign( O, 0 );
+    for(UINT r=0; r<R; r++){
+        for(UINT j=0; j<H; j++) block.hiddenBiasGradient[j] += block.deltaH[ r*H+j ];
+        for(UINT j=0; j<O; j++) block.outputBiasGradient[j] += block.deltaO[ r*O+j ];
+    }
+    
+    return true;
+}
+    
+bool MLP::packLayers(){
+    
+    const UINT I = numInputNeurons;
+    const UINT H = numHiddenNeurons;
+    const UINT O = numOutputNeurons;
+    
+    hiddenWeights.resize( I*H );
+    hiddenWeightsUpdate.resize( I*H );
+    hiddenBias.resize( H );
+    hiddenBiasUpdate.resize( H );
+    outputWeights.resize( H*O );
+    outputWeightsUpdate.resize( H*O );
+    outputWeightsTransposed.resize( O*H );
+    outputBias.resize( O );
+    outputBiasUpdate.resize( O );
+    
+    for(UINT i=0; i<H; i++){
+        hiddenBias[i] = hiddenLayer[i].bias;
+        hiddenBiasUpdate[i] = hiddenLayer[i].previousBiasUpdate;
+        for(UINT j=0; j<I; j++){
+            hiddenWeights[ j*H+i ] = hiddenLayer[i].weights[j];
+            hiddenWeightsUpdate[ j*H+i ] = hiddenLayer[i].previousUpdate[j];
+        }
+    }
+    
+    for(UINT i=0; i<O; i++){
+        outputBias[i] = outputLayer[i].bias;
+        outputBiasUpdate[i] = outputLayer[i].previousBiasUpdate;
+        for(UINT j=0; j<H; j++){
+            outputWeights[ j*O+i ] = outputLayer[i].weights[j];
+            outputWeightsUpdate[ j*O+i ] = outputLayer[i].previousUpdate[j];
+        }
+    }
+    
+    return true;
+}
+    
+bool MLP::unpackLayers(){
+    
+    const UINT I = numInputNeurons;
+    const UINT H = numHiddenNeurons;
+    const UINT O = numOutputNeurons;
+    
+    if( hiddenWeights.size() != I*H || outputWeights.size() != H*O ) return false;
+    
+    for(UINT i=0; i<H; i++){
+        hiddenLayer[i].bias = hiddenBias[i];
+        hiddenLayer[i].previousBiasUpdate = hiddenBiasUpdate[i];
+        for(UINT j=0; j<I; j++){
+            hiddenLayer[i].weights[j] = hiddenWeights[ j*H+i ];
+            hiddenLayer[i].previousUpdate[j] = hiddenWeightsUpdate[ j*H+i ];
+        }
+    }
+    
+    for(UINT i=0; i<O; i++){
+        outputLayer[i].bias = outputBias[i];
+        outputLayer[i].previousBiasUpdate = outputBiasUpdate[i];
+        for(UINT j=0; j<H; j++){
+            outputLayer[i].weights[j] = outputWeights[ j*O+i ];
+            outputLayer[i].previousUpdate[j] = outputWeightsUpdate[ j*O+i ];
+        }
+    }
+    
+    return true;
+}
+
 void MLP::printNetwork() const{
     cout<<"***************** MLP *****************\n";
     cout<<"NumInputNeurons: "<<numInputNeurons<<endl;
@@ -1710,6 +2062,28 @@ bool MLP::setNullRejectionCoeff(const double nullRejectionCoeff){
     return false;
 }
     
+bool MLP::setBatchSize(const UINT batchSize){
+    if( batchSize > 0 ){
+        this->batchSize = batchSize;
+        return true;
+    }
+    warningLog << "setBatchSize(const UINT batchSize) - The batch size must be greater than zero!" << endl;
+    return false;
+}
+    
+UINT MLP::getBatchSize() const{
+    return batchSize;
+}
+    
+bool MLP::enableParallelTraining(const bool useParallelTraining){
+    this->useParallelTraining = useParallelTraining;
+    return true;
+}
+    
+bool MLP::getParallelTrainingEnabled() const{
+    return useParallelTraining;
+}
+    
 bool MLP::loadLegacyModelFromFile( fstream &file ){
     
     string word;
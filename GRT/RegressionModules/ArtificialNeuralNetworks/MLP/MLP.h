@@ -35,6 +35,7 @@
 
 #include "Neuron.h"
 #include "../../../CoreModules/Regressifier.h"
+#include "../../../Util/MatrixKernels.h"
 
 namespace GRT{
 
@@ -478,6 +479,42 @@ public:
      */
     bool setNullRejectionCoeff(const double nullRejectionCoeff);
     
+    /**
+     Sets the number of training examples in each mini batch.  If the batch size is 1 (the default) then the MLP is trained using online
+     gradient descent, updating the weights after each training example.  If the batch size is greater than 1 then the weights are updated
+     once per batch, using the mean gradient of the batch, and the forward and backward passes for the whole batch are computed as
+     matrix-matrix products.  This is much faster for large datasets, but as there are fewer updates per epoch you might need a larger
+     training rate or more epochs.
+     
+     @param const UINT batchSize: the number of training examples in each mini batch, must be greater than zero
+     @return returns true if the value was updated successfully, false otherwise
+     */
+    bool setBatchSize(const UINT batchSize);
+    
+    /**
+     Gets the number of training examples in each mini batch.
+     
+     @return returns the batch size
+     */
+    UINT getBatchSize() const;
+    
+    /**
+     Sets if each mini batch should be processed in parallel.  If enabled, each mini batch is split into blocks of rows that are
+     processed as separate tasks on the GRT ThreadPool.  The gradients of the blocks are summed in order, so the trained model is the
+     same as the serial training.  This is only used if the batch size is greater than 1.  Parallel training is disabled by default.
+     
+     @param const bool useParallelTraining: if true then each mini batch will be processed in parallel
+     @return returns true if the parallel training parameter was updated successfully, false otherwise
+     */
+    virtual bool enableParallelTraining(const bool useParallelTraining);
+    
+    /**
+     Gets if each mini batch should be processed in parallel.
+     
+     @return returns true if parallel training is enabled, false otherwise
+     */
+    virtual bool getParallelTrainingEnabled() const;
+    
     //Tell the compiler we are using the following functions from the MLBase class to stop hidden virtual function warnings
     using MLBase::saveModelToFile;
     using MLBase::loadModelFromFile;
@@ -526,6 +563,58 @@ protected:
      */
     void feedforward(const VectorDouble &trainingExample,VectorDouble &inputNeuronsOuput,VectorDouble &hiddenNeuronsOutput,VectorDouble &outputNeuronsOutput);
     
+    /**
+     Performs one epoch of mini batch gradient descent.  The weights of the neurons are packed into the layer matrices at the start of
+     the epoch, and copied back into the neurons at the end of the epoch.
+     
+     @param const RegressionData &trainingData: the training data
+     @param const vector< UINT > &indexList: the order the training examples should be used in
+     @param const double alpha: the training rate
+     @param const double beta: the momentum
+     @param double &totalSquaredError: this will store the total squared error of the training examples, computed before each weight update
+     @param UINT &numCorrect: this will store the number of training examples that were classified correctly, computed before each weight update
+     @return returns true if the epoch was completed, false if a NaN was found
+     */
+    bool trainMiniBatchEpoch(const RegressionData &trainingData,const vector< UINT > &indexList,const double alpha,const double beta,double &totalSquaredError,UINT &numCorrect);
+    
+    /**
+     Computes the total squared error and number of correctly classified examples of a dataset, using the layer matrices.
+     
+     @param const RegressionData &data: the dataset to test
+     @param double &totalSquaredError: this will store the total squared error of the dataset
+     @param UINT &numCorrect: this will store the number of examples that were classified correctly
+     @return returns true if the errors were computed, false otherwise
+     */
+    bool computeMiniBatchErrors(const RegressionData &data,double &totalSquaredError,UINT &numCorrect);
+    
+    /**
+     Runs the forward pass (and optionally the backward pass) for the examples [startIndex endIndex) of the indexList, using the
+     layer matrices.  The outputs, errors and gradients are stored in the miniBatchBlocks[ blockIndex ].
+     
+     @return returns true if the block was processed, false otherwise
+     */
+    bool processMiniBatchBlock(const RegressionData &data,const vector< UINT > &indexList,const UINT startIndex,const UINT endIndex,const UINT blockIndex,const bool computeGradients);
+    
+    bool processMiniBatch(const RegressionData &data,const vector< UINT > &indexList,const UINT startIndex,const UINT endIndex,const bool computeGradients);
+    bool packLayers();
+    bool unpackLayers();
+    
+    //The intermediate results of one block of rows of a mini batch, each matrix is row-major with one row per example
+    struct MiniBatchBlock{
+        UINT numRows;
+        VectorDouble inputs;                    ///< numRows x numInputNeurons
+        VectorDouble hiddenOutputs;             ///< numRows x numHiddenNeurons
+        VectorDouble outputs;                   ///< numRows x numOutputNeurons
+        VectorDouble deltaH;                    ///< numRows x numHiddenNeurons
+        VectorDouble deltaO;                    ///< numRows x numOutputNeurons
+        VectorDouble hiddenWeightsGradient;     ///< numInputNeurons x numHiddenNeurons
+        VectorDouble hiddenBiasGradient;
+        VectorDouble outputWeightsGradient;     ///< numHiddenNeurons x numOutputNeurons
+        VectorDouble outputBiasGradient;
+        double squaredError;
+        UINT numCorrect;
+    };
+    
     UINT numInputNeurons;
     UINT numHiddenNeurons;
     UINT numOutputNeurons;
@@ -563,8 +652,25 @@ protected:
     VectorDouble deltaO;
     VectorDouble deltaH;
     
+    //Mini batch training stuff, the weights of each layer are packed into a row-major matrix with one row per input and one column per neuron
+    UINT batchSize;                             ///< The number of training examples in each mini batch, 1 means online gradient descent
+    bool useParallelTraining;                   ///< A flag to check if the blocks of each mini batch should be processed on the thread pool
+    std::unique_ptr< ThreadPool > threadPool;   ///< The thread pool used for parallel training, this is only created when it is first needed
+    VectorDouble hiddenWeights;                 ///< numInputNeurons x numHiddenNeurons
+    VectorDouble hiddenBias;
+    VectorDouble outputWeights;                 ///< numHiddenNeurons x numOutputNeurons
+    VectorDouble outputBias;
+    VectorDouble outputWeightsTransposed;       ///< numOutputNeurons x numHiddenNeurons, used to back propagate the output error
+    VectorDouble hiddenWeightsUpdate;           ///< The previous update of each weight, used for the momentum
+    VectorDouble hiddenBiasUpdate;
+    VectorDouble outputWeightsUpdate;
+    VectorDouble outputBiasUpdate;
+    vector< MiniBatchBlock > miniBatchBlocks;
+    vector< UINT > miniBatchIndexList;
+    
 public:
     enum TrainingModes{ONLINE_GRADIENT_DESCENT};
+    enum MiniBatchSettings{MINI_BATCH_BLOCK_SIZE=64};
     
 };
 
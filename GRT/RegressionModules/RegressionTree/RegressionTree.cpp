@@ -409,6 +409,29 @@ RegressionTreeNode* RegressionTree::buildTree(const RegressionData &trainingData
         return node;
     }
     
+    //Compute the regression data and RMS error of this node, if the error is below the minRMSError then there is no need to split the node
+    computeNodeRegressionData( trainingData, regressionData );
+    double nodeError = 0;
+    for(UINT i=0; i<M; i++){
+        for(UINT j=0; j<T; j++){
+            nodeError += Regressifier::SQR( trainingData[i].getTargetVector()[j] - regressionData[j] );
+        }
+    }
+    nodeError = sqrt( nodeError / M );
+    
+    if( nodeError <= minRMSErrorPerNode ){
+        
+        //Flag that this is a leaf node
+        node->setIsLeafNode( true );
+        
+        //Set the node
+        node->set( trainingData.getNumSamples(), 0, 0, regressionData );
+        
+        Regressifier::trainingLog << "Reached leaf node, the RMS error is below the minRMSErrorPerNode. Depth: " << depth << " NumSamples: " << M << " RMSError: " << nodeError << endl;
+        
+        return node;
+    }
+    
     //Compute the best spilt point
     UINT featureIndex = 0;
     double threshold = 0;
@@ -420,19 +443,6 @@ RegressionTreeNode* RegressionTree::buildTree(const RegressionData &trainingData
     
     Regressifier::trainingLog << "Depth: " << depth << " FeatureIndex: " << featureIndex << " Threshold: " << threshold << " MinError: " << minError << endl;
     
-    //If the minError is below the minRMSError then create a leaf node and return
-    if( minError <= minRMSErrorPerNode ){
-        //Compute the regression data that will be stored at this node
-        computeNodeRegressionData( trainingData, regressionData );
-        
-        //Set the node
-        node->set( trainingData.getNumSamples(), featureIndex, threshold, regressionData );
-        
-        Regressifier::trainingLog << "Reached leaf node. Depth: " << depth << " NumSamples: " << M << endl;
-        
-        return node;
-    }
-    
     //Set the node
     node->set( trainingData.getNumSamples(), featureIndex, threshold, regressionData );
     
@@ -455,7 +465,17 @@ RegressionTreeNode* RegressionTree::buildTree(const RegressionData &trainingData
             rhs.addSample(trainingData[i].getInputVector(), trainingData[i].getTargetVector());
         }else lhs.addSample(trainingData[i].getInputVector(), trainingData[i].getTargetVector());
     }
-    
+
+    //If the best split does not separate the data (for example because none of the features reduce the error) then create a leaf node
+    if( lhs.getNumSamples() == 0 || rhs.getNumSamples() == 0 ){
+        node->setIsLeafNode( true );
+        node->set( trainingData.getNumSamples(), featureIndex, threshold, regressionData );
+
+        Regressifier::trainingLog << "Reached leaf node, the split does not separate the data. Depth: " << depth << " NumSamples: " << M << endl;
+
+        return node;
+    }
+
     //Run the recursive tree building on the children
     node->setLeftChild( buildTree( lhs, node, features, nodeID ) );
     node->setRightChild( buildTree( rhs, node, features, nodeID ) );
@@ -485,60 +505,49 @@ bool RegressionTree::computeBestSpiltBestIterativeSpilt( const RegressionData &t
     
     const UINT M = trainingData.getNumSamples();
     const UINT N = (UINT)features.size();
+    const UINT T = trainingData.getNumTargetDimensions();
     
-    if( N == 0 ) return false;
+    if( N == 0 || M == 0 ) return false;
     
     minError = numeric_limits<double>::max();
     UINT bestFeatureIndex = 0;
-    UINT groupID = 0;
     double bestThreshold = 0;
-    double error = 0;
-    double minRange = 0;
-    double maxRange = 0;
-    double step = 0;
-    vector< UINT > groupIndex(M);
-    VectorDouble groupCounter(2,0);
-    VectorDouble groupMean(2,0);
-    VectorDouble groupMSE(2,0);
     vector< MinMax > ranges = trainingData.getInputRanges();
+    VectorDouble featureBuffer( M );
+    VectorDouble targets( M*T );
+    VectorDouble thresholds;
+    VectorDouble errors;
+    SplitSearch splitSearch;
+    
+    //Copy the targets to a M x T buffer, the error of a split is the RMS error of the targets after the samples are split into the lhs and rhs groups
+    for(UINT i=0; i<M; i++){
+        for(UINT j=0; j<T; j++){
+            targets[ i*T + j ] = trainingData[i].getTargetVector()[j];
+        }
+    }
     
     //Loop over each feature and try and find the best split point
     for(UINT n=0; n<N; n++){
-        minRange = ranges[n].minValue;
-        maxRange = ranges[n].maxValue;
-        step = (maxRange-minRange)/double(numSplittingSteps);
-        threshold = minRange;
         featureIndex = features[n];
-        while( threshold <= maxRange ){
-            
-            //Iterate over each sample and work out what group it falls into
-            for(UINT i=0; i<M; i++){
-                groupID = trainingData[i].getInputVector()[featureIndex] >= threshold ? 1 : 0;
-                groupIndex[i] = groupID;
-                groupMean[ groupID ] += trainingData[i].getInputVector()[featureIndex];
-                groupCounter[ groupID ]++;
-            }
-            groupMean[0] /= groupCounter[0] > 0 ? groupCounter[0] : 1;
-            groupMean[1] /= groupCounter[1] > 0 ? groupCounter[1] : 1;
-            
-            //Compute the MSE for each group
-            for(UINT i=0; i<M; i++){
-                groupMSE[ groupIndex[i] ] += Regressifier::SQR( groupMean[ groupIndex[i] ] - trainingData[ i ].getInputVector()[features[n]] );
-            }
-            groupMSE[0] /= groupCounter[0] > 0 ? groupCounter[0] : 1;
-            groupMSE[1] /= groupCounter[1] > 0 ? groupCounter[1] : 1;
-            
-            error = sqrt( groupMSE[0] + groupMSE[1] );
-            
-            //Store the best threshold and feature index
-            if( error < minError ){
-                minError = error;
-                bestThreshold = threshold;
+        
+        //Step through the range of the feature, the values are sorted once and then swept to find the error of every threshold
+        for(UINT i=0; i<M; i++){
+            featureBuffer[i] = trainingData[i].getInputVector()[featureIndex];
+        }
+        SplitSearch::getIterativeThresholds( ranges[featureIndex].minValue, ranges[featureIndex].maxValue, numSplittingSteps, thresholds );
+        splitSearch.sortFeature( &featureBuffer[0], M );
+        if( !splitSearch.computeMeanSquaredErrors( &targets[0], T, thresholds, errors, true ) ){
+            Regressifier::errorLog << "computeBestSpiltBestIterativeSpilt(...) - Failed to compute the split errors for feature: " << featureIndex << endl;
+            return false;
+        }
+        
+        //Store the best threshold and feature index
+        for(UINT t=0; t<errors.size(); t++){
+            if( errors[t] < minError ){
+                minError = errors[t];
+                bestThreshold = thresholds[t];
                 bestFeatureIndex = featureIndex;
             }
-            
-            //Update the threshold
-            threshold += step;
         }
     }
     
@@ -625,7 +634,6 @@ bool RegressionTree::computeBestSpiltBestRandomSpilt( const RegressionData &trai
 bool RegressionTree::computeNodeRegressionData( const RegressionData &trainingData, VectorDouble &regressionData ){
     
     const UINT M = trainingData.getNumSamples();
-    const UINT N = trainingData.getNumInputDimensions();
     const UINT T = trainingData.getNumTargetDimensions();
     
     if( M == 0 ){
@@ -638,7 +646,7 @@ bool RegressionTree::computeNodeRegressionData( const RegressionData &trainingDa
     regressionData.resize( T, 0 );
     
     //The regression data at this node is simply an average over all the training data at this node
-    for(unsigned int j=0; j<N; j++){
+    for(unsigned int j=0; j<T; j++){
         for(unsigned int i=0; i<M; i++){
             regressionData[j] += trainingData[i].getTargetVector()[j];
         }
@@ -0,0 +1,92 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace GRT{
+
+static std::atomic< unsigned long long > numAllocations(0);
+
+bool AllocationCounter::getEnabled(){
+#ifdef GRT_ALLOCATION_COUNTER
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned long long AllocationCounter::getNumAllocations(){
+    return numAllocations.load( std::memory_order_relaxed );
+}
+
+bool AllocationCounter::reset(){
+    numAllocations.store( 0, std::memory_order_relaxed );
+    return true;
+}
+
+void AllocationCounter::addAllocation(){
+    numAllocations.fetch_add( 1, std::memory_order_relaxed );
+}
+
+}//End of namespace GRT
+
+#ifdef GRT_ALLOCATION_COUNTER
+
+//Replace the global new and delete operators so every heap allocation is counted
+void* operator new(std::size_t size){
+    GRT::AllocationCounter::addAllocation();
+    void *ptr = std::malloc( size > 0 ? size : 1 );
+    if( ptr == NULL ) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size){
+    return operator new( size );
+}
+
+void* operator new(std::size_t size,const std::nothrow_t&) noexcept{
+    GRT::AllocationCounter::addAllocation();
+    return std::malloc( size > 0 ? size : 1 );
+}
+
+void* operator new[](std::size_t size,const std::nothrow_t&) noexcept{
+    return operator new( size, std::nothrow );
+}
+
+void operator delete(void *ptr) noexcept{
+    std::free( ptr );
+}
+
+void operator delete[](void *ptr) noexcept{
+    std::free( ptr );
+}
+
+void operator delete(void *ptr,const std::nothrow_t&) noexcept{
+    std::free( ptr );
+}
+
+void operator delete[](void *ptr,const std::nothrow_t&) noexcept{
+    std::free( ptr );
+}
+
+#endif //GRT_ALLOCATION_COUNTER
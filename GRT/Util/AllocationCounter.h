@@ -0,0 +1,77 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The AllocationCounter class counts the number of heap allocations made by the program, so you can check that a realtime loop (such
+ as the GestureRecognitionPipeline predict function) does not allocate memory once it has warmed up.
+
+ The counter is only active if the GRT is built with GRT_ALLOCATION_COUNTER defined, in which case the global new and delete operators are
+ replaced by versions that count each allocation.  This should only be used for debug or test builds.  If GRT_ALLOCATION_COUNTER is not
+ defined then getEnabled() returns false and the number of allocations will always be zero.
+
+ Example:
+ @code
+ AllocationCounter::reset();
+ pipeline.predict( inputVector );
+ if( AllocationCounter::getNumAllocations() > 0 ) cout << "The pipeline allocated memory!" << endl;
+ @endcode
+ */
+
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_ALLOCATION_COUNTER_HEADER
+#define GRT_ALLOCATION_COUNTER_HEADER
+
+namespace GRT{
+
+class AllocationCounter{
+public:
+    /**
+     Returns true if the GRT was built with GRT_ALLOCATION_COUNTER defined, in which case every heap allocation is counted.
+
+     @return returns true if the allocation counter is enabled, false otherwise
+     */
+    static bool getEnabled();
+
+    /**
+     Gets the number of heap allocations made by any thread since the counter was last reset.
+
+     @return returns the number of heap allocations, this will always be zero if the counter is not enabled
+     */
+    static unsigned long long getNumAllocations();
+
+    /**
+     Resets the number of heap allocations to zero.
+
+     @return returns true if the counter was reset, false otherwise
+     */
+    static bool reset();
+
+    /**
+     Adds one allocation to the counter, this is called by the global new operators when the counter is enabled.
+     */
+    static void addAllocation();
+};
+
+}//End of namespace GRT
+
+#endif //GRT_ALLOCATION_COUNTER_HEADER
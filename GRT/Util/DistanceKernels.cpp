@@ -0,0 +1,277 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "DistanceKernels.h"
+#include <cmath>
+
+//The SIMD kernels are only built for x86 CPUs, any other CPU will use the scalar kernels
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define GRT_DISTANCE_KERNELS_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define GRT_TARGET_SSE2
+        #define GRT_TARGET_AVX2
+    #else
+        #define GRT_TARGET_SSE2 __attribute__((target("sse2")))
+        #define GRT_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace GRT{
+
+//Initialize the instruction set to the best instruction set supported by the CPU
+unsigned int DistanceKernels::instructionSet = DistanceKernels::detectInstructionSet();
+
+////////////////////////// SCALAR KERNELS //////////////////////////
+
+template< class T >
+static inline void computeDistancesScalar(const unsigned int metric,const T *a,const T *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances){
+    for(unsigned int j=start; j<=end; j++){
+        T dist = 0;
+        if( metric == DistanceKernels::ABSOLUTE_DISTANCE ){
+            for(unsigned int k=0; k<numDimensions; k++){
+                dist += std::fabs( a[k]-b[k*stride+j] );
+            }
+        }else if( metric == DistanceKernels::DOT_PRODUCT ){
+            for(unsigned int k=0; k<numDimensions; k++){
+                dist += a[k]*b[k*stride+j];
+            }
+        }else{
+            for(unsigned int k=0; k<numDimensions; k++){
+                const T delta = a[k]-b[k*stride+j];
+                dist += delta*delta;
+            }
+        }
+        distances[j-start] = metric == DistanceKernels::EUCLIDEAN_DISTANCE ? std::sqrt( dist ) : dist;
+    }
+}
+
+#ifdef GRT_DISTANCE_KERNELS_X86
+
+////////////////////////// SSE2 KERNELS //////////////////////////
+
+GRT_TARGET_SSE2
+static unsigned int computeDistancesSSE2(const unsigned int metric,const double *a,const double *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances){
+    const __m128d signMask = _mm_set1_pd( -0.0 );
+    unsigned int j = start;
+    for(; j+1<=end; j+=2){
+        __m128d dist = _mm_setzero_pd();
+        for(unsigned int k=0; k<numDimensions; k++){
+            const __m128d x = _mm_loadu_pd( b+k*stride+j );
+            if( metric == DistanceKernels::DOT_PRODUCT ){
+                dist = _mm_add_pd( dist, _mm_mul_pd( _mm_set1_pd( a[k] ), x ) );
+                continue;
+            }
+            const __m128d delta = _mm_sub_pd( _mm_set1_pd( a[k] ), x );
+            if( metric == DistanceKernels::ABSOLUTE_DISTANCE ) dist = _mm_add_pd( dist, _mm_andnot_pd( signMask, delta ) );
+            else dist = _mm_add_pd( dist, _mm_mul_pd( delta, delta ) );
+        }
+        if( metric == DistanceKernels::EUCLIDEAN_DISTANCE ) dist = _mm_sqrt_pd( dist );
+        _mm_storeu_pd( distances+(j-start), dist );
+    }
+    return j;
+}
+
+GRT_TARGET_SSE2
+static unsigned int computeDistancesSSE2(const unsigned int metric,const float *a,const float *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances){
+    const __m128 signMask = _mm_set1_ps( -0.0f );
+    unsigned int j = start;
+    for(; j+3<=end; j+=4){
+        __m128 dist = _mm_setzero_ps();
+        for(unsigned int k=0; k<numDimensions; k++){
+            const __m128 x = _mm_loadu_ps( b+k*stride+j );
+            if( metric == DistanceKernels::DOT_PRODUCT ){
+                dist = _mm_add_ps( dist, _mm_mul_ps( _mm_set1_ps( a[k] ), x ) );
+                continue;
+            }
+            const __m128 delta = _mm_sub_ps( _mm_set1_ps( a[k] ), x );
+            if( metric == DistanceKernels::ABSOLUTE_DISTANCE ) dist = _mm_add_ps( dist, _mm_andnot_ps( signMask, delta ) );
+            else dist = _mm_add_ps( dist, _mm_mul_ps( delta, delta ) );
+        }
+        if( metric == DistanceKernels::EUCLIDEAN_DISTANCE ) dist = _mm_sqrt_ps( dist );
+        _mm_storeu_pd( distances+(j-start), _mm_cvtps_pd( dist ) );
+        _mm_storeu_pd( distances+(j-start)+2, _mm_cvtps_pd( _mm_movehl_ps( dist, dist ) ) );
+    }
+    return j;
+}
+
+////////////////////////// AVX2 KERNELS //////////////////////////
+
+GRT_TARGET_AVX2
+static unsigned int computeDistancesAVX2(const unsigned int metric,const double *a,const double *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances){
+    const __m256d signMask = _mm256_set1_pd( -0.0 );
+    unsigned int j = start;
+    for(; j+3<=end; j+=4){
+        __m256d dist = _mm256_setzero_pd();
+        for(unsigned int k=0; k<numDimensions; k++){
+            const __m256d x = _mm256_loadu_pd( b+k*stride+j );
+            if( metric == DistanceKernels::DOT_PRODUCT ){
+                dist = _mm256_add_pd( dist, _mm256_mul_pd( _mm256_set1_pd( a[k] ), x ) );
+                continue;
+            }
+            const __m256d delta = _mm256_sub_pd( _mm256_set1_pd( a[k] ), x );
+            if( metric == DistanceKernels::ABSOLUTE_DISTANCE ) dist = _mm256_add_pd( dist, _mm256_andnot_pd( signMask, delta ) );
+            else dist = _mm256_add_pd( dist, _mm256_mul_pd( delta, delta ) );
+        }
+        if( metric == DistanceKernels::EUCLIDEAN_DISTANCE ) dist = _mm256_sqrt_pd( dist );
+        _mm256_storeu_pd( distances+(j-start), dist );
+    }
+    return j;
+}
+
+GRT_TARGET_AVX2
+static unsigned int computeDistancesAVX2(const unsigned int metric,const float *a,const float *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances){
+    const __m256 signMask = _mm256_set1_ps( -0.0f );
+    unsigned int j = start;
+    for(; j+7<=end; j+=8){
+        __m256 dist = _mm256_setzero_ps();
+        for(unsigned int k=0; k<numDimensions; k++){
+            const __m256 x = _mm256_loadu_ps( b+k*stride+j );
+            if( metric == DistanceKernels::DOT_PRODUCT ){
+                dist = _mm256_add_ps( dist, _mm256_mul_ps( _mm256_set1_ps( a[k] ), x ) );
+                continue;
+            }
+            const __m256 delta = _mm256_sub_ps( _mm256_set1_ps( a[k] ), x );
+            if( metric == DistanceKernels::ABSOLUTE_DISTANCE ) dist = _mm256_add_ps( dist, _mm256_andnot_ps( signMask, delta ) );
+            else dist = _mm256_add_ps( dist, _mm256_mul_ps( delta, delta ) );
+        }
+        if( metric == DistanceKernels::EUCLIDEAN_DISTANCE ) dist = _mm256_sqrt_ps( dist );
+        _mm256_storeu_pd( distances+(j-start), _mm256_cvtps_pd( _mm256_castps256_ps128( dist ) ) );
+        _mm256_storeu_pd( distances+(j-start)+4, _mm256_cvtps_pd( _mm256_extractf128_ps( dist, 1 ) ) );
+    }
+    return j;
+}
+
+#endif //GRT_DISTANCE_KERNELS_X86
+
+////////////////////////// PUBLIC FUNCTIONS //////////////////////////
+
+bool DistanceKernels::computeDistances(const unsigned int metric,const double *a,const double *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances){
+
+    if( metric != ABSOLUTE_DISTANCE && metric != SQUARED_DISTANCE && metric != DOT_PRODUCT && metric != EUCLIDEAN_DISTANCE ) return false;
+    if( end < start ) return true;
+
+    //Compute as many distances as possible with the SIMD kernels, the remaining distances are computed with the scalar kernel
+    unsigned int j = start;
+#ifdef GRT_DISTANCE_KERNELS_X86
+    switch( instructionSet ){
+        case AVX2:
+            j = computeDistancesAVX2(metric,a,b,stride,numDimensions,j,end,distances);
+            if( j <= end ) j = computeDistancesSSE2(metric,a,b,stride,numDimensions,j,end,distances+(j-start));
+            break;
+        case SSE2:
+            j = computeDistancesSSE2(metric,a,b,stride,numDimensions,j,end,distances);
+            break;
+        default:
+            break;
+    }
+#endif
+    if( j <= end ) computeDistancesScalar(metric,a,b,stride,numDimensions,j,end,distances+(j-start));
+
+    return true;
+}
+
+bool DistanceKernels::computeDistances(const unsigned int metric,const float *a,const float *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances){
+
+    if( metric != ABSOLUTE_DISTANCE && metric != SQUARED_DISTANCE && metric != DOT_PRODUCT && metric != EUCLIDEAN_DISTANCE ) return false;
+    if( end < start ) return true;
+
+    //Compute as many distances as possible with the SIMD kernels, the remaining distances are computed with the scalar kernel
+    unsigned int j = start;
+#ifdef GRT_DISTANCE_KERNELS_X86
+    switch( instructionSet ){
+        case AVX2:
+            j = computeDistancesAVX2(metric,a,b,stride,numDimensions,j,end,distances);
+            if( j <= end ) j = computeDistancesSSE2(metric,a,b,stride,numDimensions,j,end,distances+(j-start));
+            break;
+        case SSE2:
+            j = computeDistancesSSE2(metric,a,b,stride,numDimensions,j,end,distances);
+            break;
+        default:
+            break;
+    }
+#endif
+    if( j <= end ) computeDistancesScalar(metric,a,b,stride,numDimensions,j,end,distances+(j-start));
+
+    return true;
+}
+
+unsigned int DistanceKernels::getInstructionSet(){
+    return instructionSet;
+}
+
+std::string DistanceKernels::getInstructionSetName(){
+    switch( instructionSet ){
+        case AVX2:
+            return "AVX2";
+        case SSE2:
+            return "SSE2";
+        default:
+            break;
+    }
+    return "SCALAR";
+}
+
+bool DistanceKernels::setInstructionSet(const unsigned int instructionSet){
+    if( !getInstructionSetSupported( instructionSet ) ) return false;
+    DistanceKernels::instructionSet = instructionSet;
+    return true;
+}
+
+bool DistanceKernels::getInstructionSetSupported(const unsigned int instructionSet){
+    switch( instructionSet ){
+        case SCALAR:
+            return true;
+        case SSE2:
+            return detectInstructionSet() >= SSE2;
+        case AVX2:
+            return detectInstructionSet() >= AVX2;
+        default:
+            break;
+    }
+    return false;
+}
+
+unsigned int DistanceKernels::detectInstructionSet(){
+#if defined(GRT_DISTANCE_KERNELS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info,0);
+    const int maxLeaf = info[0];
+    __cpuid(info,1);
+    const bool sse2 = (info[3] & (1<<26)) != 0;
+    const bool osxsave = (info[2] & (1<<27)) != 0;
+    const bool avx = (info[2] & (1<<28)) != 0;
+    bool avx2 = false;
+    if( maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6 ){
+        __cpuidex(info,7,0);
+        avx2 = (info[1] & (1<<5)) != 0;
+    }
+    if( avx2 ) return AVX2;
+    if( sse2 ) return SSE2;
+#elif defined(GRT_DISTANCE_KERNELS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx2") ) return AVX2;
+    if( __builtin_cpu_supports("sse2") ) return SSE2;
+#endif
+    return SCALAR;
+}
+
+}//End of namespace GRT
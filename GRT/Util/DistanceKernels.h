@@ -0,0 +1,121 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The DistanceKernels class computes the distance between one sample and a block of other samples, using SSE2 or AVX2 instructions
+ when they are supported by the CPU the code is running on, or a portable scalar loop otherwise.  The instruction set is selected at runtime.
+
+ The block of samples must be stored column-major (i.e. all the values for the first dimension, followed by all the values for the second
+ dimension, etc.), so the distance to several samples can be computed at once.  Each distance is computed by summing over the dimensions in
+ order, so the results are the same for every instruction set.
+
+ The EUCLIDEAN_DISTANCE metric is the square root of the SQUARED_DISTANCE.  The DOT_PRODUCT metric computes the dot product of the sample
+ and each sample in the block, which can be used to compute the cosine distance.
+ */
+
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_DISTANCE_KERNELS_HEADER
+#define GRT_DISTANCE_KERNELS_HEADER
+
+#include <string>
+
+namespace GRT{
+
+class DistanceKernels{
+public:
+
+    /**
+     Computes the distance between the sample a and each sample j in [start end] of the column-major block b.  The k'th dimension of
+     sample j is stored at b[ k*stride + j ].  The distance to sample j is written to distances[ j-start ].
+
+     @param const unsigned int metric: the distance metric, this should be one of the DistanceMetrics enums
+     @param const double *a: a pointer to the sample, this should have numDimensions values
+     @param const double *b: a pointer to the column-major block of samples
+     @param const unsigned int stride: the number of samples stored for each dimension in b
+     @param const unsigned int numDimensions: the number of dimensions of each sample
+     @param const unsigned int start: the index of the first sample in b to compute the distance to
+     @param const unsigned int end: the index of the last sample in b to compute the distance to
+     @param double *distances: a pointer to a buffer with at least (end-start+1) values, the distances will be written to this buffer
+     @return returns true if the distances were computed, false otherwise
+     */
+    static bool computeDistances(const unsigned int metric,const double *a,const double *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances);
+
+    /**
+     Computes the distance between the sample a and each sample j in [start end] of the column-major block b, using single precision.
+     The distance for each sample is summed in single precision and then written to distances[ j-start ] as a double.
+
+     @param const unsigned int metric: the distance metric, this should be one of the DistanceMetrics enums
+     @param const float *a: a pointer to the sample, this should have numDimensions values
+     @param const float *b: a pointer to the column-major block of samples
+     @param const unsigned int stride: the number of samples stored for each dimension in b
+     @param const unsigned int numDimensions: the number of dimensions of each sample
+     @param const unsigned int start: the index of the first sample in b to compute the distance to
+     @param const unsigned int end: the index of the last sample in b to compute the distance to
+     @param double *distances: a pointer to a buffer with at least (end-start+1) values, the distances will be written to this buffer
+     @return returns true if the distances were computed, false otherwise
+     */
+    static bool computeDistances(const unsigned int metric,const float *a,const float *b,const unsigned int stride,const unsigned int numDimensions,const unsigned int start,const unsigned int end,double *distances);
+
+    /**
+     Gets the instruction set used by the distance kernels.  By default this is the best instruction set supported by the CPU.
+
+     @return returns the instruction set used by the distance kernels, this will be one of the InstructionSets enums
+     */
+    static unsigned int getInstructionSet();
+
+    /**
+     Gets the name of the instruction set used by the distance kernels.
+
+     @return returns the name of the instruction set used by the distance kernels
+     */
+    static std::string getInstructionSetName();
+
+    /**
+     Sets the instruction set used by the distance kernels.  This can be used to force the scalar kernels, but the instruction set can only
+     be set to an instruction set that is supported by the CPU.
+
+     @param const unsigned int instructionSet: the new instruction set, this should be one of the InstructionSets enums
+     @return returns true if the instruction set was updated successfully, false otherwise
+     */
+    static bool setInstructionSet(const unsigned int instructionSet);
+
+    /**
+     Gets if the instruction set is supported by the CPU the code is running on.
+
+     @param const unsigned int instructionSet: the instruction set to test, this should be one of the InstructionSets enums
+     @return returns true if the instruction set is supported, false otherwise
+     */
+    static bool getInstructionSetSupported(const unsigned int instructionSet);
+
+    enum DistanceMetrics{ABSOLUTE_DISTANCE=0,SQUARED_DISTANCE,DOT_PRODUCT,EUCLIDEAN_DISTANCE};
+    enum InstructionSets{SCALAR=0,SSE2,AVX2};
+
+protected:
+    static unsigned int detectInstructionSet();
+
+    static unsigned int instructionSet;
+};
+
+}//End of namespace GRT
+
+#endif //GRT_DISTANCE_KERNELS_HEADER
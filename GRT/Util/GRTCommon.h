@@ -48,6 +48,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //Include the common GRT classes
 #include "GRTException.h"
 #include "MatrixDouble.h"
+#include "MatrixView.h"
 #include "MinMax.h"
 #include "ClassTracker.h"
 #include "IndexedDouble.h"
@@ -61,6 +62,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "TestInstanceResult.h"
 #include "TestResult.h"
 #include "CircularBuffer.h"
+#include "LockFreeRingBuffer.h"
 #include "Timer.h"
 #include "TimeStamp.h"
 #include "Random.h"
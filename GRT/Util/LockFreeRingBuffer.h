@@ -0,0 +1,147 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The LockFreeRingBuffer class provides a fixed size FIFO buffer that can be shared between exactly one producer thread and
+ exactly one consumer thread without any locks.  The producer adds values with push(...) and the consumer removes them with pop(...).
+ Neither function ever blocks or allocates memory, so the buffer can be filled from a realtime callback (such as a sensor callback)
+ while another thread processes the values.
+
+ Unlike the CircularBuffer, values are never overwritten: if the buffer is full then push(...) fails and the value is counted as dropped,
+ so the consumer never sees a value twice and can check if any values were lost.
+ */
+
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_LOCK_FREE_RING_BUFFER_HEADER
+#define GRT_LOCK_FREE_RING_BUFFER_HEADER
+#include <vector>
+#include <atomic>
+
+namespace GRT{
+
+template <class T>
+class LockFreeRingBuffer{
+public:
+
+    /**
+     Default Constructor. The buffer must be resized before it can be used.
+
+     @param unsigned int bufferSize: sets the maximum number of values that can be stored in the buffer
+     */
+    LockFreeRingBuffer(unsigned int bufferSize = 0) : readPtr(0), writePtr(0), numDroppedValues(0){
+        resize( bufferSize );
+    }
+
+    /**
+     Default Destructor.
+     */
+    ~LockFreeRingBuffer(){
+    }
+
+    /**
+     Resizes the buffer and removes any values in it.  The buffer is rounded up to the next power of two, so the read and write positions
+     can be wrapped with a mask.  This function allocates memory, so it must not be called while the producer or consumer is using the buffer.
+
+     @param unsigned int bufferSize: the minimum number of values that can be stored in the buffer
+     @return returns true if the buffer was resized, false otherwise
+     */
+    bool resize(unsigned int bufferSize){
+        unsigned int size = 1;
+        while( size < bufferSize ) size <<= 1;
+        buffer.clear();
+        buffer.resize( bufferSize > 0 ? size : 0 );
+        readPtr.store( 0 );
+        writePtr.store( 0 );
+        numDroppedValues.store( 0 );
+        return true;
+    }
+
+    /**
+     Adds a value to the end of the buffer.  This must only be called by the producer thread.  If the buffer is full then the value is not
+     added and the number of dropped values is incremented.
+
+     @param const T &value: the value to add to the buffer
+     @return returns true if the value was added to the buffer, false if the buffer was full
+     */
+    bool push(const T &value){
+        const unsigned int write = writePtr.load( std::memory_order_relaxed );
+        if( write - readPtr.load( std::memory_order_acquire ) >= buffer.size() ){
+            numDroppedValues.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+        buffer[ write & (buffer.size()-1) ] = value;
+        writePtr.store( write+1, std::memory_order_release );
+        return true;
+    }
+
+    /**
+     Removes the oldest value from the buffer.  This must only be called by the consumer thread.
+
+     @param T &value: the oldest value in the buffer will be copied to this value
+     @return returns true if a value was removed from the buffer, false if the buffer was empty
+     */
+    bool pop(T &value){
+        const unsigned int read = readPtr.load( std::memory_order_relaxed );
+        if( read == writePtr.load( std::memory_order_acquire ) ) return false;
+        value = buffer[ read & (buffer.size()-1) ];
+        readPtr.store( read+1, std::memory_order_release );
+        return true;
+    }
+
+    /**
+     Gets the maximum number of values that can be stored in the buffer.
+
+     @return returns the size of the buffer
+     */
+    unsigned int getSize() const{
+        return (unsigned int)buffer.size();
+    }
+
+    /**
+     Gets the number of values currently in the buffer.  If the producer or consumer is running then this is only a snapshot.
+
+     @return returns the number of values in the buffer
+     */
+    unsigned int getNumValuesInBuffer() const{
+        return writePtr.load( std::memory_order_acquire ) - readPtr.load( std::memory_order_acquire );
+    }
+
+    /**
+     Gets the number of values that could not be added because the buffer was full, since the buffer was last resized.
+
+     @return returns the number of dropped values
+     */
+    unsigned int getNumDroppedValues() const{
+        return numDroppedValues.load( std::memory_order_relaxed );
+    }
+
+protected:
+    std::vector< T > buffer;
+    std::atomic< unsigned int > readPtr;            //The total number of values removed by the consumer, only written by the consumer
+    std::atomic< unsigned int > writePtr;           //The total number of values added by the producer, only written by the producer
+    std::atomic< unsigned int > numDroppedValues;   //The number of values that could not be added because the buffer was full
+};
+
+}//End of namespace GRT
+
+#endif //GRT_LOCK_FREE_RING_BUFFER_HEADER
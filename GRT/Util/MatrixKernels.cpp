@@ -0,0 +1,291 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "MatrixKernels.h"
+#include "DistanceKernels.h"
+#include <cstddef>
+
+//The SIMD kernels are only built for x86 CPUs, any other CPU will use the scalar kernels
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define GRT_MATRIX_KERNELS_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #define GRT_TARGET_SSE2
+        #define GRT_TARGET_AVX2
+    #else
+        #define GRT_TARGET_SSE2 __attribute__((target("sse2")))
+        #define GRT_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace GRT{
+
+////////////////////////// SCALAR KERNELS //////////////////////////
+
+static void multiplyScalar(const unsigned int M,const unsigned int N,const unsigned int K,const double *A,const unsigned int rowStrideA,const unsigned int colStrideA,const double *B,const unsigned int ldb,double *C,const unsigned int ldc,const bool accumulate,const unsigned int startColumn){
+    for(unsigned int i=0; i<M; i++){
+        const double *a = A + i*rowStrideA;
+        double *c = C + i*ldc;
+        for(unsigned int j=startColumn; j<N; j++){
+            double sum = accumulate ? c[j] : 0;
+            for(unsigned int k=0; k<K; k++){
+                sum += a[k*colStrideA] * B[k*ldb+j];
+            }
+            c[j] = sum;
+        }
+    }
+}
+
+static void solveLowerTriangularScalar(const unsigned int N,const unsigned int M,const double *L,const unsigned int ldl,double *B,const unsigned int ldb,const unsigned int startColumn){
+    for(unsigned int i=0; i<N; i++){
+        double *bi = B + i*ldb;
+        for(unsigned int j=0; j<i; j++){
+            const double l = L[i*ldl+j];
+            const double *bj = B + j*ldb;
+            for(unsigned int c=startColumn; c<M; c++) bi[c] -= l * bj[c];
+        }
+        const double d = L[i*ldl+i];
+        for(unsigned int c=startColumn; c<M; c++) bi[c] /= d;
+    }
+}
+
+#ifdef GRT_MATRIX_KERNELS_X86
+
+////////////////////////// SSE2 KERNELS //////////////////////////
+
+//Solves the columns [startColumn M) in steps of 2 columns, returns the first column that was not solved
+GRT_TARGET_SSE2
+static unsigned int solveLowerTriangularSSE2(const unsigned int N,const unsigned int M,const double *L,const unsigned int ldl,double *B,const unsigned int ldb,const unsigned int startColumn){
+    const unsigned int endColumn = startColumn + ((M-startColumn)/2)*2;
+    for(unsigned int i=0; i<N; i++){
+        double *bi = B + i*ldb;
+        for(unsigned int j=0; j<i; j++){
+            const __m128d l = _mm_set1_pd( L[i*ldl+j] );
+            const double *bj = B + j*ldb;
+            for(unsigned int c=startColumn; c<endColumn; c+=2){
+                _mm_storeu_pd( bi+c, _mm_sub_pd( _mm_loadu_pd( bi+c ), _mm_mul_pd( l, _mm_loadu_pd( bj+c ) ) ) );
+            }
+        }
+        const __m128d d = _mm_set1_pd( L[i*ldl+i] );
+        for(unsigned int c=startColumn; c<endColumn; c+=2){
+            _mm_storeu_pd( bi+c, _mm_div_pd( _mm_loadu_pd( bi+c ), d ) );
+        }
+    }
+    return endColumn;
+}
+
+//Computes the columns [startColumn N) in blocks of 4 rows x 4 columns, returns the first column that was not computed
+GRT_TARGET_SSE2
+static unsigned int multiplySSE2(const unsigned int M,const unsigned int N,const unsigned int K,const double *A,const unsigned int rowStrideA,const unsigned int colStrideA,const double *B,const unsigned int ldb,double *C,const unsigned int ldc,const bool accumulate,const unsigned int startColumn){
+    unsigned int j = startColumn;
+    for(; j+4<=N; j+=4){
+        unsigned int i = 0;
+        for(; i+4<=M; i+=4){
+            const double *a = A + i*rowStrideA;
+            double *c = C + i*ldc + j;
+            __m128d c00, c01, c10, c11, c20, c21, c30, c31;
+            if( accumulate ){
+                c00 = _mm_loadu_pd( c );          c01 = _mm_loadu_pd( c+2 );
+                c10 = _mm_loadu_pd( c+ldc );      c11 = _mm_loadu_pd( c+ldc+2 );
+                c20 = _mm_loadu_pd( c+2*ldc );    c21 = _mm_loadu_pd( c+2*ldc+2 );
+                c30 = _mm_loadu_pd( c+3*ldc );    c31 = _mm_loadu_pd( c+3*ldc+2 );
+            }else{
+                c00 = c01 = c10 = c11 = c20 = c21 = c30 = c31 = _mm_setzero_pd();
+            }
+            for(unsigned int k=0; k<K; k++){
+                const __m128d b0 = _mm_loadu_pd( B+k*ldb+j );
+                const __m128d b1 = _mm_loadu_pd( B+k*ldb+j+2 );
+                const double *ak = a + k*colStrideA;
+                __m128d av = _mm_set1_pd( ak[0] );
+                c00 = _mm_add_pd( c00, _mm_mul_pd( av, b0 ) ); c01 = _mm_add_pd( c01, _mm_mul_pd( av, b1 ) );
+                av = _mm_set1_pd( ak[rowStrideA] );
+                c10 = _mm_add_pd( c10, _mm_mul_pd( av, b0 ) ); c11 = _mm_add_pd( c11, _mm_mul_pd( av, b1 ) );
+                av = _mm_set1_pd( ak[2*rowStrideA] );
+                c20 = _mm_add_pd( c20, _mm_mul_pd( av, b0 ) ); c21 = _mm_add_pd( c21, _mm_mul_pd( av, b1 ) );
+                av = _mm_set1_pd( ak[3*rowStrideA] );
+                c30 = _mm_add_pd( c30, _mm_mul_pd( av, b0 ) ); c31 = _mm_add_pd( c31, _mm_mul_pd( av, b1 ) );
+            }
+            _mm_storeu_pd( c, c00 );          _mm_storeu_pd( c+2, c01 );
+            _mm_storeu_pd( c+ldc, c10 );      _mm_storeu_pd( c+ldc+2, c11 );
+            _mm_storeu_pd( c+2*ldc, c20 );    _mm_storeu_pd( c+2*ldc+2, c21 );
+            _mm_storeu_pd( c+3*ldc, c30 );    _mm_storeu_pd( c+3*ldc+2, c31 );
+        }
+        for(; i<M; i++){
+            const double *a = A + i*rowStrideA;
+            double *c = C + i*ldc + j;
+            __m128d c0 = accumulate ? _mm_loadu_pd( c ) : _mm_setzero_pd();
+            __m128d c1 = accumulate ? _mm_loadu_pd( c+2 ) : _mm_setzero_pd();
+            for(unsigned int k=0; k<K; k++){
+                const __m128d av = _mm_set1_pd( a[k*colStrideA] );
+                c0 = _mm_add_pd( c0, _mm_mul_pd( av, _mm_loadu_pd( B+k*ldb+j ) ) );
+                c1 = _mm_add_pd( c1, _mm_mul_pd( av, _mm_loadu_pd( B+k*ldb+j+2 ) ) );
+            }
+            _mm_storeu_pd( c, c0 );
+            _mm_storeu_pd( c+2, c1 );
+        }
+    }
+    return j;
+}
+
+////////////////////////// AVX2 KERNELS //////////////////////////
+
+//Computes the columns [startColumn N) in blocks of 4 rows x 8 columns, returns the first column that was not computed
+GRT_TARGET_AVX2
+static unsigned int multiplyAVX2(const unsigned int M,const unsigned int N,const unsigned int K,const double *A,const unsigned int rowStrideA,const unsigned int colStrideA,const double *B,const unsigned int ldb,double *C,const unsigned int ldc,const bool accumulate,const unsigned int startColumn){
+    unsigned int j = startColumn;
+    for(; j+8<=N; j+=8){
+        unsigned int i = 0;
+        for(; i+4<=M; i+=4){
+            const double *a = A + i*rowStrideA;
+            double *c = C + i*ldc + j;
+            __m256d c00, c01, c10, c11, c20, c21, c30, c31;
+            if( accumulate ){
+                c00 = _mm256_loadu_pd( c );          c01 = _mm256_loadu_pd( c+4 );
+                c10 = _mm256_loadu_pd( c+ldc );      c11 = _mm256_loadu_pd( c+ldc+4 );
+                c20 = _mm256_loadu_pd( c+2*ldc );    c21 = _mm256_loadu_pd( c+2*ldc+4 );
+                c30 = _mm256_loadu_pd( c+3*ldc );    c31 = _mm256_loadu_pd( c+3*ldc+4 );
+            }else{
+                c00 = c01 = c10 = c11 = c20 = c21 = c30 = c31 = _mm256_setzero_pd();
+            }
+            for(unsigned int k=0; k<K; k++){
+                const __m256d b0 = _mm256_loadu_pd( B+k*ldb+j );
+                const __m256d b1 = _mm256_loadu_pd( B+k*ldb+j+4 );
+                const double *ak = a + k*colStrideA;
+                __m256d av = _mm256_set1_pd( ak[0] );
+                c00 = _mm256_add_pd( c00, _mm256_mul_pd( av, b0 ) ); c01 = _mm256_add_pd( c01, _mm256_mul_pd( av, b1 ) );
+                av = _mm256_set1_pd( ak[rowStrideA] );
+                c10 = _mm256_add_pd( c10, _mm256_mul_pd( av, b0 ) ); c11 = _mm256_add_pd( c11, _mm256_mul_pd( av, b1 ) );
+                av = _mm256_set1_pd( ak[2*rowStrideA] );
+                c20 = _mm256_add_pd( c20, _mm256_mul_pd( av, b0 ) ); c21 = _mm256_add_pd( c21, _mm256_mul_pd( av, b1 ) );
+                av = _mm256_set1_pd( ak[3*rowStrideA] );
+                c30 = _mm256_add_pd( c30, _mm256_mul_pd( av, b0 ) ); c31 = _mm256_add_pd( c31, _mm256_mul_pd( av, b1 ) );
+            }
+            _mm256_storeu_pd( c, c00 );          _mm256_storeu_pd( c+4, c01 );
+            _mm256_storeu_pd( c+ldc, c10 );      _mm256_storeu_pd( c+ldc+4, c11 );
+            _mm256_storeu_pd( c+2*ldc, c20 );    _mm256_storeu_pd( c+2*ldc+4, c21 );
+            _mm256_storeu_pd( c+3*ldc, c30 );    _mm256_storeu_pd( c+3*ldc+4, c31 );
+        }
+        for(; i<M; i++){
+            const double *a = A + i*rowStrideA;
+            double *c = C + i*ldc + j;
+            __m256d c0 = accumulate ? _mm256_loadu_pd( c ) : _mm256_setzero_pd();
+            __m256d c1 = accumulate ? _mm256_loadu_pd( c+4 ) : _mm256_setzero_pd();
+            for(unsigned int k=0; k<K; k++){
+                const __m256d av = _mm256_set1_pd( a[k*colStrideA] );
+                c0 = _mm256_add_pd( c0, _mm256_mul_pd( av, _mm256_loadu_pd( B+k*ldb+j ) ) );
+                c1 = _mm256_add_pd( c1, _mm256_mul_pd( av, _mm256_loadu_pd( B+k*ldb+j+4 ) ) );
+            }
+            _mm256_storeu_pd( c, c0 );
+            _mm256_storeu_pd( c+4, c1 );
+        }
+    }
+    return j;
+}
+
+//Solves the columns [startColumn M) in steps of 4 columns, returns the first column that was not solved
+GRT_TARGET_AVX2
+static unsigned int solveLowerTriangularAVX2(const unsigned int N,const unsigned int M,const double *L,const unsigned int ldl,double *B,const unsigned int ldb,const unsigned int startColumn){
+    const unsigned int endColumn = startColumn + ((M-startColumn)/4)*4;
+    for(unsigned int i=0; i<N; i++){
+        double *bi = B + i*ldb;
+        for(unsigned int j=0; j<i; j++){
+            const __m256d l = _mm256_set1_pd( L[i*ldl+j] );
+            const double *bj = B + j*ldb;
+            for(unsigned int c=startColumn; c<endColumn; c+=4){
+                _mm256_storeu_pd( bi+c, _mm256_sub_pd( _mm256_loadu_pd( bi+c ), _mm256_mul_pd( l, _mm256_loadu_pd( bj+c ) ) ) );
+            }
+        }
+        const __m256d d = _mm256_set1_pd( L[i*ldl+i] );
+        for(unsigned int c=startColumn; c<endColumn; c+=4){
+            _mm256_storeu_pd( bi+c, _mm256_div_pd( _mm256_loadu_pd( bi+c ), d ) );
+        }
+    }
+    return endColumn;
+}
+
+#endif //GRT_MATRIX_KERNELS_X86
+
+////////////////////////// PUBLIC FUNCTIONS //////////////////////////
+
+bool MatrixKernels::multiply(const unsigned int M,const unsigned int N,const unsigned int K,const double *A,const unsigned int rowStrideA,const unsigned int colStrideA,const double *B,const unsigned int ldb,double *C,const unsigned int ldc,const bool accumulate){
+
+    if( M == 0 || N == 0 ) return true;
+    if( A == NULL || B == NULL || C == NULL || ldb < N || ldc < N ) return false;
+
+    //Compute as many columns as possible with the SIMD kernels, the remaining columns are computed with the scalar kernel
+    unsigned int j = 0;
+#ifdef GRT_MATRIX_KERNELS_X86
+    switch( DistanceKernels::getInstructionSet() ){
+        case DistanceKernels::AVX2:
+            j = multiplyAVX2(M,N,K,A,rowStrideA,colStrideA,B,ldb,C,ldc,accumulate,j);
+            if( j < N ) j = multiplySSE2(M,N,K,A,rowStrideA,colStrideA,B,ldb,C,ldc,accumulate,j);
+            break;
+        case DistanceKernels::SSE2:
+            j = multiplySSE2(M,N,K,A,rowStrideA,colStrideA,B,ldb,C,ldc,accumulate,j);
+            break;
+        default:
+            break;
+    }
+#endif
+    if( j < N ) multiplyScalar(M,N,K,A,rowStrideA,colStrideA,B,ldb,C,ldc,accumulate,j);
+
+    return true;
+}
+
+bool MatrixKernels::solveLowerTriangular(const unsigned int N,const unsigned int M,const double *L,const unsigned int ldl,double *B,const unsigned int ldb){
+
+    if( N == 0 || M == 0 ) return true;
+    if( L == NULL || B == NULL || ldl < N || ldb < M ) return false;
+
+    //Solve as many columns as possible with the SIMD kernels, the remaining columns are solved with the scalar kernel
+    unsigned int c = 0;
+#ifdef GRT_MATRIX_KERNELS_X86
+    switch( DistanceKernels::getInstructionSet() ){
+        case DistanceKernels::AVX2:
+            c = solveLowerTriangularAVX2(N,M,L,ldl,B,ldb,c);
+            if( c < M ) c = solveLowerTriangularSSE2(N,M,L,ldl,B,ldb,c);
+            break;
+        case DistanceKernels::SSE2:
+            c = solveLowerTriangularSSE2(N,M,L,ldl,B,ldb,c);
+            break;
+        default:
+            break;
+    }
+#endif
+    if( c < M ) solveLowerTriangularScalar(N,M,L,ldl,B,ldb,c);
+
+    return true;
+}
+
+bool MatrixKernels::transpose(const unsigned int M,const unsigned int N,const double *A,double *B){
+
+    if( M == 0 || N == 0 ) return true;
+    if( A == NULL || B == NULL ) return false;
+
+    for(unsigned int i=0; i<M; i++){
+        for(unsigned int j=0; j<N; j++){
+            B[ j*M + i ] = A[ i*N + j ];
+        }
+    }
+
+    return true;
+}
+
+}//End of namespace GRT
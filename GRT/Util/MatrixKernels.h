@@ -0,0 +1,92 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The MatrixKernels class computes the product of two dense row-major matrices and solves lower triangular systems, using SSE2 or
+ AVX2 instructions when they are supported by the CPU the code is running on, or a portable scalar loop otherwise.
+
+ The product is computed in small blocks of rows and columns that are kept in registers while the inner dimension is summed, so each value
+ of the right-hand matrix is loaded once for every block of rows.  Each value of the result is summed over the inner dimension in order, so
+ the results are the same for every instruction set.  The MatrixKernels use the same instruction set as the DistanceKernels, so calling
+ DistanceKernels::setInstructionSet( DistanceKernels::SCALAR ) will also force the scalar matrix kernels.
+ */
+
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_MATRIX_KERNELS_HEADER
+#define GRT_MATRIX_KERNELS_HEADER
+
+namespace GRT{
+
+class MatrixKernels{
+public:
+
+    /**
+     Computes the M x N matrix C = A * B, where A is an M x K matrix and B is a K x N matrix.  The value at row i and column k of A is
+     read from A[ i*rowStrideA + k*colStrideA ], so the transpose of a row-major matrix can be used for A by swapping its strides.
+     B and C must be row-major.  If accumulate is true then the product is added to the values that are already in C.
+
+     @param const unsigned int M: the number of rows in A and C
+     @param const unsigned int N: the number of columns in B and C
+     @param const unsigned int K: the number of columns in A and rows in B
+     @param const double *A: a pointer to the first value of A
+     @param const unsigned int rowStrideA: the distance between two rows of A
+     @param const unsigned int colStrideA: the distance between two columns of A
+     @param const double *B: a pointer to the first value of B
+     @param const unsigned int ldb: the distance between two rows of B, this must be at least N
+     @param double *C: a pointer to the first value of C
+     @param const unsigned int ldc: the distance between two rows of C, this must be at least N
+     @param const bool accumulate: if true then the product is added to C, otherwise C is overwritten
+     @return returns true if the product was computed, false otherwise
+     */
+    static bool multiply(const unsigned int M,const unsigned int N,const unsigned int K,const double *A,const unsigned int rowStrideA,const unsigned int colStrideA,const double *B,const unsigned int ldb,double *C,const unsigned int ldc,const bool accumulate);
+
+    /**
+     Solves L * X = B for X, where L is an N x N lower triangular matrix and B is an N x M row-major matrix, so each column of B is a
+     separate right-hand side.  The solution is written over B.  The columns of B are solved together, so this is much faster than solving
+     each column on its own when M is large.  Only the lower triangle (including the diagonal) of L is used, and the diagonal must not be zero.
+
+     @param const unsigned int N: the number of rows and columns of L, and the number of rows of B
+     @param const unsigned int M: the number of columns of B
+     @param const double *L: a pointer to the first value of L
+     @param const unsigned int ldl: the distance between two rows of L, this must be at least N
+     @param double *B: a pointer to the first value of B, this will be overwritten with the solution
+     @param const unsigned int ldb: the distance between two rows of B, this must be at least M
+     @return returns true if the system was solved, false otherwise
+     */
+    static bool solveLowerTriangular(const unsigned int N,const unsigned int M,const double *L,const unsigned int ldl,double *B,const unsigned int ldb);
+
+    /**
+     Writes the transpose of the M x N row-major matrix A to the N x M row-major matrix B.
+
+     @param const unsigned int M: the number of rows in A
+     @param const unsigned int N: the number of columns in A
+     @param const double *A: a pointer to the first value of A
+     @param double *B: a pointer to a buffer with at least M*N values, the transpose will be written to this buffer
+     @return returns true if the transpose was computed, false otherwise
+     */
+    static bool transpose(const unsigned int M,const unsigned int N,const double *A,double *B);
+};
+
+}//End of namespace GRT
+
+#endif //GRT_MATRIX_KERNELS_HEADER
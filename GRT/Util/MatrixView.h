@@ -0,0 +1,185 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The RowSpan and MatrixView classes provide non-owning views of data that is stored somewhere else, such as a row of a MatrixDouble
+ or a set of rows from a buffer.  Creating a view never allocates memory or copies the data, so views can be used to pass data between the
+ modules in the prediction path of the GestureRecognitionPipeline without any copies.
+
+ A view is only valid while the data it points to is valid, so views should not be stored once the data they point to has been resized or
+ deleted.
+ */
+
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_MATRIX_VIEW_HEADER
+#define GRT_MATRIX_VIEW_HEADER
+
+#include "MatrixDouble.h"
+
+namespace GRT{
+
+class RowSpan{
+public:
+    /**
+     Default Constructor, creates an empty span.
+     */
+    RowSpan() : data(NULL), size(0){}
+
+    /**
+     Creates a span of size values starting at data.
+
+     @param const double *data: a pointer to the first value in the span
+     @param const UINT size: the number of values in the span
+     */
+    RowSpan(const double *data,const UINT size) : data(data), size(size){}
+
+    /**
+     Creates a span of all the values in the vector.
+
+     @param const VectorDouble &vector: the vector the span will point to
+     */
+    explicit RowSpan(const VectorDouble &vector) : data(vector.size() > 0 ? &vector[0] : NULL), size((UINT)vector.size()){}
+
+    /**
+     Returns the value at index i, which should be in the range [0 size-1].
+
+     @param const UINT i: the index of the value
+     @return returns a const reference to the value at index i
+     */
+    inline const double& operator[](const UINT i) const{ return data[i]; }
+
+    /**
+     @return returns a pointer to the first value in the span
+     */
+    inline const double* getData() const{ return data; }
+
+    /**
+     @return returns the number of values in the span
+     */
+    inline UINT getSize() const{ return size; }
+
+    /**
+     Copies the values in the span to the vector.  The vector is only reallocated if its capacity is smaller than the span.
+
+     @param VectorDouble &vector: the vector the values will be copied to
+     @return returns true if the values were copied, false otherwise
+     */
+    bool copyTo(VectorDouble &vector) const{
+        vector.assign(data,data+size);
+        return true;
+    }
+
+protected:
+    const double *data;
+    UINT size;
+};
+
+class MatrixView{
+public:
+    /**
+     Default Constructor, creates an empty view.
+     */
+    MatrixView() : rowPtr(NULL), rows(0), cols(0){}
+
+    /**
+     Creates a view of rows rows, each with cols values.  The rows do not need to be stored one after the other, so a view can be
+     created from the rows of a circular buffer or from a subset of the rows of a matrix.
+
+     @param double **rowPtr: an array with a pointer to each row, this array must be valid for as long as the view is used
+     @param const UINT rows: the number of rows in the view
+     @param const UINT cols: the number of columns in the view
+     */
+    MatrixView(double **rowPtr,const UINT rows,const UINT cols) : rowPtr(rowPtr), rows(rows), cols(cols){}
+
+    /**
+     Creates a view of all the rows in the matrix.
+
+     @param MatrixDouble &matrix: the matrix the view will point to
+     */
+    explicit MatrixView(MatrixDouble &matrix) : rowPtr(NULL), rows(matrix.getNumRows()), cols(matrix.getNumCols()){
+        if( rows > 0 ) rowPtr = matrix.getDataPointer();
+    }
+
+    /**
+     Returns a pointer to the data at row r
+
+     @param const UINT r: the index of the row you want, should be in the range [0 rows-1]
+     @return a pointer to the data at row r
+     */
+    inline double* operator[](const UINT r){ return rowPtr[r]; }
+
+    /**
+     Returns a const pointer to the data at row r
+
+     @param const UINT r: the index of the row you want, should be in the range [0 rows-1]
+     @return a const pointer to the data at row r
+     */
+    inline const double* operator[](const UINT r) const{ return rowPtr[r]; }
+
+    /**
+     Gets a span of the row at the row index r, this does not copy the row.
+
+     @param const UINT r: the index of the row, this should be in the range [0 rows-1]
+     @return returns a span of the row at the row index r
+     */
+    inline RowSpan getRowSpan(const UINT r) const{ return RowSpan(rowPtr[r],cols); }
+
+    /**
+     @return returns the number of rows in the view
+     */
+    inline UINT getNumRows() const{ return rows; }
+
+    /**
+     @return returns the number of columns in the view
+     */
+    inline UINT getNumCols() const{ return cols; }
+
+    /**
+     Copies the data in the view to the matrix.  The matrix is only reallocated if its size does not match the size of the view.
+
+     @param MatrixDouble &matrix: the matrix the data will be copied to
+     @return returns true if the data was copied, false otherwise
+     */
+    bool copyTo(MatrixDouble &matrix) const{
+        if( rows == 0 || cols == 0 ){
+            matrix.clear();
+            return true;
+        }
+        if( !matrix.resize(rows,cols) ) return false;
+        for(UINT i=0; i<rows; i++){
+            const double *row = rowPtr[i];
+            double *matrixRow = matrix[i];
+            for(UINT j=0; j<cols; j++) matrixRow[j] = row[j];
+        }
+        return true;
+    }
+
+protected:
+    double **rowPtr;
+    UINT rows;
+    UINT cols;
+};
+
+}//End of namespace GRT
+
+#endif //GRT_MATRIX_VIEW_HEADER
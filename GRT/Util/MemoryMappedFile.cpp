@@ -0,0 +1,148 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "MemoryMappedFile.h"
+
+#ifdef __GRT_WINDOWS_BUILD__
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace GRT{
+
+MemoryMappedFile::MemoryMappedFile(){
+    data = NULL;
+    size = 0;
+#ifdef __GRT_WINDOWS_BUILD__
+    fileHandle = NULL;
+    mappingHandle = NULL;
+#endif
+    errorLog.setProceedingText("[ERROR MemoryMappedFile]");
+}
+
+MemoryMappedFile::~MemoryMappedFile(){
+    close();
+}
+
+bool MemoryMappedFile::open(const std::string &filename){
+
+    close();
+
+#ifdef __GRT_WINDOWS_BUILD__
+    HANDLE file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( file == INVALID_HANDLE_VALUE ){
+        errorLog << "open(const std::string &filename) - Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart == 0 ){
+        errorLog << "open(const std::string &filename) - The file is empty or the size could not be read: " << filename << std::endl;
+        CloseHandle( file );
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    if( mapping == NULL ){
+        errorLog << "open(const std::string &filename) - Failed to create the file mapping: " << filename << std::endl;
+        CloseHandle( file );
+        return false;
+    }
+
+    const void *ptr = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    if( ptr == NULL ){
+        errorLog << "open(const std::string &filename) - Failed to map the file: " << filename << std::endl;
+        CloseHandle( mapping );
+        CloseHandle( file );
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = (const char*)ptr;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fileDescriptor = ::open( filename.c_str(), O_RDONLY );
+    if( fileDescriptor < 0 ){
+        errorLog << "open(const std::string &filename) - Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    struct stat fileInfo;
+    if( fstat( fileDescriptor, &fileInfo ) != 0 || fileInfo.st_size == 0 ){
+        errorLog << "open(const std::string &filename) - The file is empty or the size could not be read: " << filename << std::endl;
+        ::close( fileDescriptor );
+        return false;
+    }
+
+    void *ptr = mmap( NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+
+    //The mapping keeps its own reference to the file, so the descriptor is not needed once the file is mapped
+    ::close( fileDescriptor );
+
+    if( ptr == MAP_FAILED ){
+        errorLog << "open(const std::string &filename) - Failed to map the file: " << filename << std::endl;
+        return false;
+    }
+
+    data = (const char*)ptr;
+    size = (size_t)fileInfo.st_size;
+#endif
+
+    return true;
+}
+
+bool MemoryMappedFile::close(){
+
+    if( data == NULL ) return true;
+
+#ifdef __GRT_WINDOWS_BUILD__
+    UnmapViewOfFile( data );
+    CloseHandle( (HANDLE)mappingHandle );
+    CloseHandle( (HANDLE)fileHandle );
+    mappingHandle = NULL;
+    fileHandle = NULL;
+#else
+    munmap( (void*)data, size );
+#endif
+
+    data = NULL;
+    size = 0;
+
+    return true;
+}
+
+bool MemoryMappedFile::getIsOpen() const{
+    return data != NULL;
+}
+
+const char* MemoryMappedFile::getData() const{
+    return data;
+}
+
+size_t MemoryMappedFile::getSize() const{
+    return size;
+}
+
+}//End of namespace GRT
@@ -0,0 +1,112 @@
+/**
+ @file
+ @author  Nicholas Gillian <ngillian@media.mit.edu>
+ @version 1.0
+
+ @brief The MemoryMappedFile class maps a file into memory for read-only access.  The contents of the file are not read when the file is opened,
+ instead the operating system loads each page of the file the first time it is accessed, so large binary model files can be opened without
+ reading and parsing them with a stream.
+
+ The data pointer is only valid while the file is open.  The file is closed automatically when the instance is destroyed.
+
+ Example:
+ @code
+ MemoryMappedFile file;
+ if( file.open( "model.bin" ) ){
+     const char *data = file.getData();
+     size_t size = file.getSize();
+     //Read the data...
+     file.close();
+ }
+ @endcode
+ */
+
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GRT_MEMORY_MAPPED_FILE_HEADER
+#define GRT_MEMORY_MAPPED_FILE_HEADER
+
+#include <string>
+#include <cstddef>
+#include "GRTVersionInfo.h"
+#include "ErrorLog.h"
+
+namespace GRT{
+
+class MemoryMappedFile{
+public:
+    /**
+     Default Constructor
+     */
+    MemoryMappedFile();
+
+    /**
+     Default Destructor, closes the file if it is open.
+     */
+    ~MemoryMappedFile();
+
+    /**
+     Maps the file into memory for reading.  If another file is already open then it will be closed first.
+
+     @param const std::string &filename: the name of the file to open
+     @return returns true if the file was opened and mapped, false otherwise
+     */
+    bool open(const std::string &filename);
+
+    /**
+     Unmaps and closes the file.  The data pointer must not be used after the file has been closed.
+
+     @return returns true if the file was closed, false otherwise
+     */
+    bool close();
+
+    /**
+     @return returns true if a file is currently mapped, false otherwise
+     */
+    bool getIsOpen() const;
+
+    /**
+     @return returns a pointer to the start of the mapped file, or NULL if no file is open
+     */
+    const char* getData() const;
+
+    /**
+     @return returns the size of the mapped file in bytes, or zero if no file is open
+     */
+    size_t getSize() const;
+
+protected:
+    //The mapping can not be shared between two instances, so copying is disabled
+    MemoryMappedFile(const MemoryMappedFile &rhs);
+    MemoryMappedFile& operator=(const MemoryMappedFile &rhs);
+
+    const char *data;
+    size_t size;
+#ifdef __GRT_WINDOWS_BUILD__
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+    ErrorLog errorLog;
+};
+
+}//End of namespace GRT
+
+#endif //GRT_MEMORY_MAPPED_FILE_HEADER
@@ -276,11 +276,13 @@ public:
         std::vector< unsigned int > indexs( rangeSize );
         std::vector< unsigned int > subset ( subsetSize );
         
-        //Fill up the range buffer and the randomly suffle it
+        //Fill up the range buffer and the randomly suffle it, using this generator so the subset only depends on the seed
         for(i=startRange; i<endRange; i++){
-            indexs[i] = i;
+            indexs[i-startRange] = i;
+        }
+        for(i=rangeSize-1; i>0; i--){
+            std::swap( indexs[i], indexs[ getRandomNumberInt(0,i+1) ] );
         }
-        std::random_shuffle(indexs.begin(), indexs.end());
         
         //Select the first X values from the randomly shuffled range buffer as the subset
         for(i=0; i<subsetSize; i++){
@@ -257,6 +257,8 @@ void recordGesture(string gesturename, int t) {
         while(1) {
             // In each iteration of our main loop, we run the Myo event loop for a set number of milliseconds.
             // In this case, we wish to update our display 20 times a second, so we run for 1000/20 milliseconds.
+            // One row is recorded per loop, so the recordings have a row every 10ms. GestureDeviceListener resamples the live sensor
+            // samples to the same period, see GestureDeviceListener::setSamplePeriod(), so keep the two in step if this is changed.
             hub.run(10);
        //     if(!calibrated) {
       //          collector.calibrate();
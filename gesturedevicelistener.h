@@ -13,6 +13,9 @@
 #include <fstream>
 #include <windows.h>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 #define NUMPARAM 6
 
@@ -22,6 +25,16 @@
 #include <myo/myo.hpp>
 using namespace GRT;
 
+// A timestamped sample from one of the Myo sensors. The Myo callbacks push these into the sensor buffer, so the classifier can process
+// every sample in the order it arrived, without the callbacks waiting for the classifier.
+struct MyoSensorSample {
+    enum SensorTypes { ACCELEROMETER = 0, ORIENTATION };
+
+    uint64_t timestamp;
+    int type;
+    float values[3];
+};
+
 // Classes that inherit from myo::DeviceListener can be used to receive events from Myo devices. DeviceListener
 // provides several virtual functions for handling different kinds of events. If you do not override an event, the
 // default behavior is to do nothing.
@@ -69,7 +82,8 @@ public:
         onWarmupCompleted2(myo, timestamp, warmupResult);
     }
 
-    /* Called by recData when a gesture is detected. The lower the value of "confidence", the more likely the gesture was activated. */
+    /* Called when a gesture is detected. The lower the value of "confidence", the more likely the gesture was activated.
+       If the classifier thread is running, this is called on the classifier thread rather than the thread calling hub.run. */
     void onGesture(double confidence, string gesturename) {
         cout << confidence << " " << gesturename << endl;
     }
@@ -88,9 +102,37 @@ public:
     // These values are set by onAccelerometerData().
     float ax, ay, az;
 
-    // These are the buffers storing the past maxbufsize acceleration and orientation values.
+    // The sensor samples pushed by the Myo callbacks, waiting to be classified. The Myo hub thread is the only producer and
+    // the classifier (either the classifier thread or recData) is the only consumer.
+    LockFreeRingBuffer<MyoSensorSample> sensorBuffer;
+
+    // The latest acceleration and orientation values read from the sensor buffer. These are only used by the classifier.
+    float sampleAx, sampleAy, sampleAz;
+    float sampleRoll, samplePitch, sampleYaw;
+
+    // The time, in microseconds, between the rows added to data, see setSamplePeriod(). nextSampleTimestamp is the Myo timestamp of
+    // the next row, and is only valid once sampleClockStarted is true.
+    uint64_t samplePeriod;
+    uint64_t nextSampleTimestamp;
+    bool sampleClockStarted;
+
+    // The number of dropped samples the classifier has already warned about, see processSensorSamples().
+    unsigned int numReportedDroppedSamples;
+
+    // The thread that classifies the samples in the sensor buffer, see startClassifierThread().
+    std::thread classifierThread;
+    std::atomic<bool> classifierThreadRunning;
+
+    // This is the buffer storing the past maxbufsize acceleration and orientation values. The oldest sample is overwritten once
+    // the buffer is full, so the memory used does not grow however long the listener runs.
     int maxbufsize;
-    vector<vector<double> > data;
+    CircularBuffer<VectorDouble> data;
+
+    // The sample being added to data, and the last maxbufsize acceleration values passed to the classifier. These are allocated
+    // once in the constructor and reused for every sample.
+    VectorDouble currentSample;
+    VectorDouble streamingSample;
+    MatrixDouble window;
 
     // This pose data is set by onOrientation(). It can only take on the values allowed by the standard Myo connect API.
     myo::Pose currentPose;
@@ -101,15 +143,31 @@ public:
     //Create a new DTW instance, using the default parameters.
     DTW dtw;
 
+    // If true, each new sample is fed to the streaming DTW search instead of rerunning DTW over the last 100 samples. This is an opt-in
+    // low-latency mode: the streaming search matches the best subsequence ending at the current sample rather than the last 100 samples,
+    // so its predictions differ from the window search, and the null rejection thresholds of the model are computed for the window search.
+    // See enableStreamingDTW().
+    bool useStreamingDTW;
+
     vector<string> gesturenames;
 
     // Our constructor.
-    GestureDeviceListener(string datalabelsfile, string datamodelfile) : onArm(false), isUnlocked(false), roll_w(0), pitch_w(0), yaw_w(0), currentPose()
+    GestureDeviceListener(string datalabelsfile, string datamodelfile) : onArm(false), isUnlocked(false), roll_w(0), pitch_w(0), yaw_w(0), sensorBuffer(4096), classifierThreadRunning(false), currentPose(), useStreamingDTW(false)
     {
-        data = vector<vector<double> >(0, vector<double>(0, 0));
         roll = 0; pitch = 0; yaw = 0;
         ax = ay = az = 0;
+        sampleAx = sampleAy = sampleAz = 0;
+        sampleRoll = samplePitch = sampleYaw = 0;
+        // collectraw.cpp records one row each time hub.run(10) returns, so the rows are resampled to the same 10ms period here
+        samplePeriod = 10000;
+        nextSampleTimestamp = 0;
+        sampleClockStarted = false;
+        numReportedDroppedSamples = 0;
         maxbufsize = 100;
+        data.resize(maxbufsize, VectorDouble(NUMPARAM, 0));
+        currentSample.resize(NUMPARAM, 0);
+        streamingSample.resize(3, 0);
+        window.resize(maxbufsize, 3);
         gx = gy = gz = 0;
         sync = totsync;
 
@@ -137,52 +195,162 @@ public:
 //        dtw.enableNullRejection(true);
         //Train the classifier
 
-        //Load the DTW model from a file
+        //Load the DTW model from a file, this can either be the text model or the binary model saved by ProcessRaw
         if( !dtw.loadModelFromFile(datamodelfile) ){
             cerr << "Failed to load the classifier model!\n";
             exit(EXIT_FAILURE);
         }
+
+        dtw.enableStreamingPrediction(useStreamingDTW);
         cerr << "Device listener constructed!" << endl;
 
     }
 
+    // Sets if each new sample should be fed to the streaming DTW search, which updates the DTW cost columns once per sample so the cost of
+    // each prediction does not depend on the window length. The streaming search can not be used with models that use z-normalization,
+    // smoothing or offset the samples by the first sample, in which case the window search is kept and false is returned. The null
+    // rejection thresholds of the model should be checked against the streaming search before this is used. This should be called before
+    // startClassifierThread().
+    bool enableStreamingDTW(bool useStreaming) {
+        if(useStreaming && !dtw.getStreamingPredictionSupported()) {
+            cerr << "The classifier model does not support the streaming DTW search, the window search will be used instead!" << endl;
+            useStreamingDTW = false;
+            dtw.enableStreamingPrediction(false);
+            return false;
+        }
+        useStreamingDTW = useStreaming;
+        dtw.enableStreamingPrediction(useStreamingDTW);
+        return true;
+    }
+
+
+
+    // Sets the time, in microseconds, between the rows passed to the classifier. The Myo sends accelerometer samples at 50Hz, but
+    // collectraw.cpp records the latest values once per hub.run(10) loop, so the templates in the model have a row every 10ms. To
+    // match the templates, each row holds the latest acceleration and orientation at its timestamp, whatever rate the samples arrive
+    // at. If the templates were recorded with one row per accelerometer sample, set this to 0. This should be called before
+    // startClassifierThread().
+    void setSamplePeriod(uint64_t period) {
+        samplePeriod = period;
+        sampleClockStarted = false;
+    }
+
+    ~GestureDeviceListener() {
+        stopClassifierThread();
+    }
+
+    // Starts a thread that classifies each sensor sample as soon as it arrives, so recData() does not need to be called.
+    bool startClassifierThread() {
+        if(classifierThreadRunning) return false;
+        classifierThreadRunning = true;
+        classifierThread = std::thread(&GestureDeviceListener::runClassifierThread, this);
+        return true;
+    }
 
+    // Stops the classifier thread, any samples that have not been classified yet are left in the sensor buffer.
+    void stopClassifierThread() {
+        if(!classifierThreadRunning) return;
+        classifierThreadRunning = false;
+        classifierThread.join();
+    }
 
-    // Append current data to stored vectors. Should be called each time that hub.run is called.
+    // Classifies the samples received since the last call. Should be called each time that hub.run is called, unless the
+    // classifier thread is running.
     void recData() {
-  //      if(sync) {
-           // sync--;
-  //          gx += ax;
-   //         gy += ay;
-    //        gz += az;
-     //       if(!sync) {
-      //          gx /= totsync;
-       //         gy /= totsync;
-        //        gz /= totsync;
-         //   }
-          //  return;
-       // }
-
-        vector<double> tempaddition;
-        tempaddition.push_back(ax);
-        tempaddition.push_back(ay);
-        tempaddition.push_back(az);
-        tempaddition.push_back(roll);
-        tempaddition.push_back(pitch);
-        tempaddition.push_back(yaw);
-        data.push_back(tempaddition);
+        if(classifierThreadRunning) return;
+        processSensorSamples();
+    }
+
+    // Reads every sample from the sensor buffer, in the order they arrived, and classifies a row every samplePeriod microseconds of
+    // Myo time, see setSamplePeriod(). A warning is printed if any samples were dropped since the last call. Returns the number of
+    // samples read.
+    int processSensorSamples() {
+        MyoSensorSample sample;
+        int numSamples = 0;
+        while(sensorBuffer.pop(sample)) {
+            // The rows due before this sample hold the values from the earlier samples
+            classifyRowsBefore(sample.timestamp);
+            switch(sample.type) {
+                case MyoSensorSample::ACCELEROMETER:
+                    sampleAx = sample.values[0];
+                    sampleAy = sample.values[1];
+                    sampleAz = sample.values[2];
+                    if(samplePeriod == 0) {
+                        classifySample();
+                    } else if(!sampleClockStarted) {
+                        // The first row is added one period after the first acceleration, as collectraw.cpp does after hub.run(10)
+                        nextSampleTimestamp = sample.timestamp + samplePeriod;
+                        sampleClockStarted = true;
+                    }
+                    break;
+                case MyoSensorSample::ORIENTATION:
+                    sampleRoll = sample.values[0];
+                    samplePitch = sample.values[1];
+                    sampleYaw = sample.values[2];
+                    break;
+            }
+            numSamples++;
+        }
+        unsigned int numDroppedSamples = getNumDroppedSamples();
+        if(numDroppedSamples != numReportedDroppedSamples) {
+            cerr << "The classifier fell behind and " << numDroppedSamples - numReportedDroppedSamples << " sensor samples were dropped!" << endl;
+            numReportedDroppedSamples = numDroppedSamples;
+        }
+        return numSamples;
+    }
+
+    // Returns the number of samples the Myo callbacks could not add because the sensor buffer was full.
+    unsigned int getNumDroppedSamples() const {
+        return sensorBuffer.getNumDroppedValues();
+    }
+
+    // Classifies a row for each sample period that ended at or before timestamp. If the Myo timestamps jump, for example after the
+    // Myo reconnects, only the last maxbufsize rows are classified, as the earlier rows would be pushed out of the buffer anyway.
+    void classifyRowsBefore(uint64_t timestamp) {
+        if(samplePeriod == 0 || !sampleClockStarted || timestamp < nextSampleTimestamp) return;
+        const uint64_t maxSkippedTime = (uint64_t)maxbufsize * samplePeriod;
+        if(timestamp - nextSampleTimestamp >= maxSkippedTime) {
+            nextSampleTimestamp = timestamp - maxSkippedTime + samplePeriod;
+        }
+        while(nextSampleTimestamp <= timestamp) {
+            classifySample();
+            nextSampleTimestamp += samplePeriod;
+        }
+    }
+
+    // Appends the latest acceleration and orientation to the stored data and runs the classifier.
+    void classifySample() {
+        currentSample[0] = sampleAx;
+        currentSample[1] = sampleAy;
+        currentSample[2] = sampleAz;
+        currentSample[3] = sampleRoll;
+        currentSample[4] = samplePitch;
+        currentSample[5] = sampleYaw;
+        // The buffer slots are preallocated with NUMPARAM values, so this copies the values without allocating.
+        data.push_back(currentSample);
     //    cerr << ax << " " << ay << " " << az << endl;
 
-        int buffersize = 100;
-        if(data.size() > buffersize+1) {
-            MatrixDouble window;
-            for(int i = 0; i < buffersize; i++) {
+        if(useStreamingDTW) {
+            for(int j = 0; j < 3; j++) {
+                streamingSample[j] = currentSample[j];
+            }
+            // Perform a prediction using the streaming DTW search, if this fails then the window search is used from now on
+            if( dtw.predict(streamingSample) ){
+                check_gesture();
+                return;
+            }
+            cerr << "Failed to perform the streaming prediction, the window search will be used instead!" << endl;
+            useStreamingDTW = false;
+            dtw.enableStreamingPrediction(false);
+        }
+
+        if(data.getBufferFilled()) {
+            // data[0] is the oldest sample in the buffer, so this copies the last maxbufsize samples in order.
+            for(int i = 0; i < maxbufsize; i++) {
              //   cerr << "ABOUT TO MAKE THE PREDICTION! " << i << endl;
-                VectorDouble currv;
                 for(int j = 0; j < 3; j++) {
-                    currv.push_back(data[data.size()-buffersize+i][j]);
+                    window[i][j] = data[i][j];
                 }
-                window.push_back(currv);
             }
 		// Perform a prediction using the classifier
             if( !dtw.predict(window) ){
@@ -190,23 +358,15 @@ public:
                 exit(EXIT_FAILURE);
             }
 
-            //Get the predicted class label
-            UINT predictedClassLabel = dtw.getPredictedClassLabel();
-            double maximumLikelihood = dtw.getMaximumLikelihood();
-           // cerr << predictedClassLabel << endl;
-          //  VectorDouble classLikelihoods = dtw.getClassLikelihoods();
-          //  VectorDouble classDistances = dtw.getClassDistances();
-            if(predictedClassLabel)
-                onGesture(maximumLikelihood, gesturenames[predictedClassLabel]);// "\tMaximumLikelihood: " << maximumLikelihood << endl;
+            check_gesture();
         }
 
     }
 
     // Clear current data vectors.
     void clearData() {
-        for(int i = 0; i < NUMPARAM; i++) {
-            data[i].clear();
-        }
+        data.reset();
+        sampleClockStarted = false;
     }
   /*  void clearGestureKernels() {
         gesturekernels.clear();
@@ -232,6 +392,8 @@ public:
         ax = acceleration[0];
         ay = acceleration[1];
         az = acceleration[2];
+        float values[3] = { ax, ay, az };
+        pushSensorSample(timestamp, MyoSensorSample::ACCELEROMETER, values, 3);
         onAccelerometerData2(myo, timestamp, acceleration);
     }
 
@@ -251,6 +413,8 @@ public:
         roll_w = static_cast<int>((roll + (float)M_PI)/(M_PI * 2.0f) * 18);
         pitch_w = static_cast<int>((pitch + (float)M_PI/2.0f)/M_PI * 18);
         yaw_w = static_cast<int>((yaw + (float)M_PI)/(M_PI * 2.0f) * 18);
+        float values[3] = { roll, pitch, yaw };
+        pushSensorSample(timestamp, MyoSensorSample::ORIENTATION, values, 3);
         onOrientationData2(myo, timestamp, quat);
     }
 
@@ -310,6 +474,25 @@ public:
     }
 
 private:
+    // Adds a sensor sample to the sensor buffer. This never blocks, if the classifier has fallen too far behind the sample is dropped and
+    // counted, and the classifier prints a warning the next time it reads the buffer.
+    void pushSensorSample(uint64_t timestamp, int type, const float *values, int numValues) {
+        MyoSensorSample sample;
+        sample.timestamp = timestamp;
+        sample.type = type;
+        for(int j = 0; j < 3; j++) sample.values[j] = j < numValues ? values[j] : 0;
+        sensorBuffer.push(sample);
+    }
+
+    // Classifies the samples in the sensor buffer until stopClassifierThread() is called.
+    void runClassifierThread() {
+        while(classifierThreadRunning) {
+            if(processSensorSamples() == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
     // We define this function to print the current values that were updated by the on...() functions above.
     void print()
     {
@@ -340,8 +523,16 @@ private:
         std::cout << std::flush;
     }
 
+    // Reports the gesture found by the last DTW prediction, if any.
     void check_gesture() {
-
+        //Get the predicted class label
+        UINT predictedClassLabel = dtw.getPredictedClassLabel();
+        double maximumLikelihood = dtw.getMaximumLikelihood();
+       // cerr << predictedClassLabel << endl;
+      //  VectorDouble classLikelihoods = dtw.getClassLikelihoods();
+      //  VectorDouble classDistances = dtw.getClassDistances();
+        if(predictedClassLabel)
+            onGesture(maximumLikelihood, gesturenames[predictedClassLabel]);// "\tMaximumLikelihood: " << maximumLikelihood << endl;
     }
 
 };
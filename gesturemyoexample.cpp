@@ -86,9 +86,12 @@ int main(int argc, char** argv)
 	// Add a GestureDeviceListener to the hub. See instructions in Readme if you want to extend GestureDeviceListener.
 	// The files passed to the GestureDeviceListener are generated by the ProcessRaw and CollectRaw executables in the bin folder.
 	// You can also build ProcessRaw and CollectRaw by building processraw.cpp and collectraw.cpp.
-    GestureDeviceListener collector("processed\\GestureTrainingDataLabels.txt", "processed\\DTWModel.txt");
+    GestureDeviceListener collector("processed\\GestureTrainingDataLabels.txt", "processed\\DTWModel.bin");
     hub.addListener(&collector);
 
+    // Classify the sensor samples on their own thread, so hub.run() is never held up by the classifier.
+    collector.startClassifierThread();
+
     while(1) {
 		// Query every 10 milliseconds.
         hub.run(10);
@@ -96,9 +99,6 @@ int main(int argc, char** argv)
             cout << "!!!!!!!!!!!!!!Please sync the Myo!!!!!!!!!!!!!!!!!!!!!" << endl;
             return 0;
         }
-		// Remember to call collector.recData() each time you call hub.run()!
-        collector.recData();
-		
 		// Quit with the Esc key.
         if(GetAsyncKeyState(VK_ESCAPE)) break;
     }
@@ -199,6 +199,12 @@ int main() {
         exit(EXIT_FAILURE);
     }
 
+    //Also save the model in the binary format, which the GestureDeviceListener can load much faster than the text file
+    if( !dtw.saveModelToBinaryFile("processed\\DTWModel.bin") ){
+        cerr << "Failed to save the binary classifier model!\n";
+        exit(EXIT_FAILURE);
+    }
+
     trainingData.clear();
 
     return EXIT_SUCCESS;